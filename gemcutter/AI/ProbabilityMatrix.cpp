@@ -1,9 +1,33 @@
 ﻿// Copyright (c) 2017 Emilian Cioca
 #include "ProbabilityMatrix.h"
 #include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
 #include "gemcutter/Utilities/Random.h"
 
+#include <algorithm>
 #include <cstring>
+#include <execution>
+
+namespace
+{
+	// Batches smaller than this are not worth distributing across threads.
+	constexpr size_t PARALLEL_THRESHOLD = 64;
+	// The number of queries processed by each parallel job.
+	constexpr size_t QUERY_JOB_SIZE = 4096;
+
+	template<typename Container, typename Func>
+	void ForEach(Container& container, Func&& func)
+	{
+		if (container.size() >= PARALLEL_THRESHOLD)
+		{
+			std::for_each(std::execution::par, container.begin(), container.end(), std::forward<Func>(func));
+		}
+		else
+		{
+			std::for_each(container.begin(), container.end(), std::forward<Func>(func));
+		}
+	}
+}
 
 namespace gem
 {
@@ -15,6 +39,7 @@ namespace gem
 		numStates = _numStates;
 		numActions = _numActions;
 		data = static_cast<float*>(malloc(sizeof(float) * numStates * numActions));
+		aliasTable.resize(numStates * numActions);
 
 		Reset();
 	}
@@ -28,6 +53,7 @@ namespace gem
 		: numStates(other.numStates)
 		, numActions(other.numActions)
 		, data(other.data)
+		, aliasTable(std::move(other.aliasTable))
 	{
 		other.numStates = 0;
 		other.numActions = 0;
@@ -51,15 +77,22 @@ namespace gem
 		}
 
 		std::memcpy(data, other.data, sizeof(float) * numStates * numActions);
+		aliasTable = other.aliasTable;
 
 		return *this;
 	}
 
 	ProbabilityMatrix& ProbabilityMatrix::operator=(ProbabilityMatrix&& other) noexcept
 	{
+		if (this == &other)
+			return *this;
+
+		free(data);
+
 		numStates = other.numStates;
 		numActions = other.numActions;
 		data = other.data;
+		aliasTable = std::move(other.aliasTable);
 
 		other.numStates = 0;
 		other.numActions = 0;
@@ -68,24 +101,32 @@ namespace gem
 		return *this;
 	}
 
-	void ProbabilityMatrix::Normalize()
+	void ProbabilityMatrix::Normalize(unsigned state)
 	{
-		// Accumulate sum for each row in order to normalize.
-		for (unsigned i = 0; i < numStates; ++i)
-		{
-			float sum = 0.0f;
+		float* row = data + state * numActions;
 
-			for (unsigned j = 0; j < numActions; ++j)
-			{
-				sum += GetValue(i, j);
-			}
+		float sum = 0.0f;
+		for (unsigned j = 0; j < numActions; ++j)
+		{
+			sum += row[j];
+		}
 
+		if (sum > 0.0f)
+		{
+			const float inverseSum = 1.0f / sum;
 			for (unsigned j = 0; j < numActions; ++j)
 			{
-				float value = GetValue(i, j);
-				SetValue(i, j, value / sum);
+				row[j] *= inverseSum;
 			}
 		}
+		else
+		{
+			// Every action has been reinforced to zero, so they are all equally likely again.
+			std::fill(row, row + numActions, 1.0f / numActions);
+		}
+
+		// Rebuilt immediately so that queries never write to the matrix, and can safely run concurrently.
+		BuildAliasTable(state);
 	}
 
 	void ProbabilityMatrix::Reset()
@@ -96,27 +137,67 @@ namespace gem
 		{
 			data[i] = value;
 		}
+
+		// A uniform distribution never needs to defer to an alias.
+		for (unsigned i = 0; i < numStates; ++i)
+		{
+			for (unsigned j = 0; j < numActions; ++j)
+			{
+				aliasTable[j + (i * numActions)] = { 1.0f, j };
+			}
+		}
 	}
 
 	int ProbabilityMatrix::QueryAction(unsigned state) const
 	{
-		// Because the probabilities are normalized we can use a range of [0 - 1].
-		float randomVal = RandomRange(0.0f, 1.0f);
+		return QueryAction(state, GetThreadRandomStream());
+	}
 
-		// Cascade through all the actions until our random value is larger.
-		// This effectively incorporates the weight of each option.
-		float sum = 0.0f;
-		for (unsigned i = 0; i < numActions; ++i)
+	int ProbabilityMatrix::QueryAction(unsigned state, RandomStream& stream) const
+	{
+		return SampleAction(state, stream);
+	}
+
+	void ProbabilityMatrix::QueryActions(std::span<const unsigned> states, std::span<unsigned> outActions) const
+	{
+		QueryActions(states, outActions, GetThreadRandomStream());
+	}
+
+	void ProbabilityMatrix::QueryActions(std::span<const unsigned> states, std::span<unsigned> outActions, RandomStream& stream) const
+	{
+		ASSERT(states.size() == outActions.size(), "Expected one output action per state.");
+
+		if (states.size() <= QUERY_JOB_SIZE)
 		{
-			sum += GetValue(state, i);
-			if (randomVal <= sum)
+			for (size_t i = 0; i < states.size(); ++i)
 			{
-				return i;
+				outActions[i] = SampleAction(states[i], stream);
 			}
+
+			return;
 		}
 
-		// If we made it out of the loop we must take the last action.
-		return numActions - 1;
+		// Each job gets its own stream, split in order, so the results do not depend on the scheduling.
+		struct Job
+		{
+			size_t begin;
+			size_t end;
+			RandomStream stream;
+		};
+
+		std::vector<Job> jobs;
+		jobs.reserve((states.size() + QUERY_JOB_SIZE - 1) / QUERY_JOB_SIZE);
+		for (size_t begin = 0; begin < states.size(); begin += QUERY_JOB_SIZE)
+		{
+			jobs.push_back({ begin, Min(begin + QUERY_JOB_SIZE, states.size()), stream.Split() });
+		}
+
+		std::for_each(std::execution::par, jobs.begin(), jobs.end(), [&](Job& job) {
+			for (size_t i = job.begin; i < job.end; ++i)
+			{
+				outActions[i] = SampleAction(states[i], job.stream);
+			}
+		});
 	}
 
 	void ProbabilityMatrix::ReinforceScale(unsigned state, unsigned action, float percentage)
@@ -135,7 +216,7 @@ namespace gem
 		}
 
 		// Ensure normalization is maintained.
-		Normalize();
+		Normalize(state);
 	}
 
 	void ProbabilityMatrix::ReinforceLinear(unsigned state, unsigned action, float value)
@@ -153,7 +234,31 @@ namespace gem
 		}
 
 		// Ensure normalization is maintained.
-		Normalize();
+		Normalize(state);
+	}
+
+	void ProbabilityMatrix::ReinforceBatch(std::span<const Reinforcement> reinforcements)
+	{
+		std::vector<unsigned> affectedStates;
+		affectedStates.reserve(reinforcements.size());
+
+		for (const Reinforcement& reinforcement : reinforcements)
+		{
+			ASSERT(reinforcement.state < numStates, "'state' is out of range.");
+			ASSERT(reinforcement.action < numActions, "'action' is out of range.");
+
+			const float value = GetValue(reinforcement.state, reinforcement.action) * reinforcement.scale + reinforcement.offset;
+			SetValue(reinforcement.state, reinforcement.action, Max(value, 0.0f));
+
+			affectedStates.push_back(reinforcement.state);
+		}
+
+		std::sort(affectedStates.begin(), affectedStates.end());
+		affectedStates.erase(std::unique(affectedStates.begin(), affectedStates.end()), affectedStates.end());
+
+		ForEach(affectedStates, [this](unsigned state) {
+			Normalize(state);
+		});
 	}
 
 	float ProbabilityMatrix::GetValue(unsigned state, unsigned action) const
@@ -175,4 +280,71 @@ namespace gem
 	{
 		return numActions;
 	}
+
+	void ProbabilityMatrix::BuildAliasTable(unsigned state)
+	{
+		// Vose's alias method. Each column is split between its own action and at most one other
+		// action, so a query is a single column lookup and a biased coin flip.
+		thread_local std::vector<float> scaled;
+		thread_local std::vector<unsigned> small;
+		thread_local std::vector<unsigned> large;
+
+		const float* row = data + state * numActions;
+		AliasEntry* table = aliasTable.data() + state * numActions;
+
+		scaled.resize(numActions);
+		small.clear();
+		large.clear();
+
+		for (unsigned i = 0; i < numActions; ++i)
+		{
+			scaled[i] = row[i] * numActions;
+			if (scaled[i] < 1.0f)
+			{
+				small.push_back(i);
+			}
+			else
+			{
+				large.push_back(i);
+			}
+		}
+
+		while (!small.empty() && !large.empty())
+		{
+			const unsigned less = small.back();
+			const unsigned more = large.back();
+			small.pop_back();
+
+			table[less] = { scaled[less], more };
+
+			// The larger action donates the remainder of the smaller action's column.
+			scaled[more] = (scaled[more] + scaled[less]) - 1.0f;
+			if (scaled[more] < 1.0f)
+			{
+				large.pop_back();
+				small.push_back(more);
+			}
+		}
+
+		// Whatever remains fills its column entirely. Leftover small entries are only due to rounding errors.
+		for (unsigned i : large)
+		{
+			table[i] = { 1.0f, i };
+		}
+
+		for (unsigned i : small)
+		{
+			table[i] = { 1.0f, i };
+		}
+	}
+
+	unsigned ProbabilityMatrix::SampleAction(unsigned state, RandomStream& stream) const
+	{
+		ASSERT(state < numStates, "'state' is out of range.");
+
+		const unsigned column = static_cast<unsigned>(stream.Range(0, static_cast<int>(numActions) - 1));
+		const AliasEntry& entry = aliasTable[column + (state * numActions)];
+
+		return stream.Range(0.0f, 1.0f) < entry.threshold ? column : entry.alias;
+	}
 }
@@ -1,9 +1,25 @@
 ﻿// Copyright (c) 2017 Emilian Cioca
 #pragma once
+#include <span>
+#include <vector>
 
 namespace gem
 {
+	class RandomStream;
+
+	// A change to a single entry of a ProbabilityMatrix.
+	// The new value will be: (value * scale) + offset.
+	struct Reinforcement
+	{
+		unsigned state = 0;
+		unsigned action = 0;
+		float scale = 1.0f;
+		float offset = 0.0f;
+	};
+
 	// Stores and manages a probability matrix of States vs Actions.
+	// Queries are O(1) using an alias table per state, which is rebuilt as soon as the state is reinforced.
+	// Queries never modify the matrix, so they can safely run concurrently with each other.
 	class ProbabilityMatrix
 	{
 	public:
@@ -20,6 +36,12 @@ namespace gem
 
 		// Based on the given state, returns a random action with respect to the probabilities.
 		int QueryAction(unsigned state) const;
+		int QueryAction(unsigned state, RandomStream& stream) const;
+
+		// Queries an action for each of the states. Large batches are processed in parallel.
+		// The results are deterministic for a given stream, regardless of how the work is scheduled.
+		void QueryActions(std::span<const unsigned> states, std::span<unsigned> outActions) const;
+		void QueryActions(std::span<const unsigned> states, std::span<unsigned> outActions, RandomStream& stream) const;
 
 		// Reinforces (positively or negatively) an action by the scalar, percentage.
 		void ReinforceScale(unsigned state, unsigned action, float percentage);
@@ -27,17 +49,31 @@ namespace gem
 		// Reinforces (positively or negatively) an action by the additive, value.
 		void ReinforceLinear(unsigned state, unsigned action, float value);
 
+		// Applies all reinforcements in order, then normalizes each affected state once, in parallel.
+		void ReinforceBatch(std::span<const Reinforcement> reinforcements);
+
 		// Returns the probability of taking an action from a given state.
 		float GetValue(unsigned state, unsigned action) const;
 		int GetNumStates() const;
 		int GetNumActions() const;
 
 	private:
+		// A single column of a state's alias table.
+		struct AliasEntry
+		{
+			float threshold;
+			unsigned alias;
+		};
+
 		unsigned numStates  = 0;
 		unsigned numActions = 0;
 		float* data = nullptr;
 
-		void Normalize();
+		std::vector<AliasEntry> aliasTable;
+
+		void Normalize(unsigned state);
+		void BuildAliasTable(unsigned state);
+		unsigned SampleAction(unsigned state, RandomStream& stream) const;
 		void SetValue(unsigned state, unsigned action, float value);
 	};
 }
@@ -3,18 +3,25 @@
 #include "gemcutter/Application/Logging.h"
 #include "gemcutter/Application/Reflection.h"
 #include "gemcutter/Application/Timer.h"
+#include "gemcutter/Entity/SpatialIndex.h"
 #include "gemcutter/GUI/Button.h"
 #include "gemcutter/GUI/Widget.h"
 #include "gemcutter/Input/Input.h"
+#include "gemcutter/Rendering/ClusteredLighting.h"
+#include "gemcutter/Rendering/DebugDraw.h"
 #include "gemcutter/Rendering/Light.h"
 #include "gemcutter/Rendering/ParticleEmitter.h"
 #include "gemcutter/Rendering/Primitives.h"
 #include "gemcutter/Rendering/Rendering.h"
 #include "gemcutter/Rendering/RenderTarget.h"
+#include "gemcutter/Rendering/StateCache.h"
 #include "gemcutter/Resource/Font.h"
 #include "gemcutter/Resource/Model.h"
+#include "gemcutter/Resource/ResourceCache.h"
+#include "gemcutter/Resource/ResourceLoader.h"
 #include "gemcutter/Resource/Shader.h"
 #include "gemcutter/Resource/Texture.h"
+#include "gemcutter/Resource/TextureStreamer.h"
 #include "gemcutter/Resource/VertexArray.h"
 #include "gemcutter/Sound/SoundSystem.h"
 
@@ -553,6 +560,7 @@ namespace gem
 		Log("-- Application Shutting Down --");
 #endif
 
+		ResourceLoader.Shutdown();
 		SoundSystem.Unload();
 
 #ifdef GEM_DEBUG
@@ -726,6 +734,7 @@ namespace gem
 		UnloadAll<Model>();
 
 		Primitives.Unload();
+		ClusteredLighting.Unload();
 
 		if (IsFullscreen())
 		{
@@ -823,6 +832,8 @@ namespace gem
 #if IMGUI_ENABLED
 					ImGui::Render();
 					ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+					// ImGui changes OpenGL state directly.
+					GLState.Invalidate();
 #endif
 					SwapBuffers(deviceContext);
 
@@ -838,6 +849,15 @@ namespace gem
 		// Distribute all queued events to their listeners.
 		EventQueue.Dispatch();
 
+		// Finish any asynchronous loads which are ready for the GPU.
+		ResourceLoader.Update();
+
+		// Release unused assets if the memory budgets have been exceeded.
+		ResourceCache.Update();
+
+		// Stream texture mip levels in and out, based on how large they were drawn last frame.
+		TextureStreamer.Update();
+
 		// Update engine components.
 		Widget::UpdateAll();
 
@@ -856,6 +876,19 @@ namespace gem
 			light.Update();
 		}
 
+		for (auto& bounds : All<SpatialBounds>())
+		{
+			bounds.Update();
+		}
+
+		// Remove the debugging primitives which were only meant to be drawn for the last frame,
+		// and expire those which have outlived their lifetime.
+		DebugDraw.EndFrame();
+		DebugDraw.Update(GetDeltaTime());
+
+		// Fence the debugging geometry streamed by the last frame, so it is not overwritten while in use.
+		Primitives.EndFrame();
+
 		// Step the SoundSystem.
 		SoundSystem.Update();
 	}
@@ -58,7 +58,11 @@ namespace gem
 
 		// Updates systems provided by the engine.
 		// - Dispatches the event queue.
+		// - Finishes asynchronous resource loads, within the ResourceLoader's upload budget.
+		// - Evicts unused resources if the ResourceCache is over budget.
+		// - Streams texture mip levels in and out with the TextureStreamer.
 		// - Updates all Engine-Side components.
+		// - Removes the DebugDraw primitives from the last frame, and ages the rest.
 		// - Steps the Sound System.
 		void UpdateEngine();
 
@@ -99,7 +103,7 @@ namespace gem
 		// If the game's update rate has fallen behind the target updates per second,
 		// this will skip the fast-forwarding effect caused by the update loop catching up to real time.
 		// The lost time is ignored. This should be called at the start of a real-time gameplay segment
-		// or after loading a high volume of assets and stalling the game loop.
+		// or after loading a high volume of assets and stalling the game loop. Consider using LoadAsync() instead.
 		void SkipToPresentTime();
 
 		const Viewport& GetScreenViewport() const;
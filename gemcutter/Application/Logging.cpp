@@ -5,6 +5,7 @@
 #include <fstream>
 #include <iostream>
 #include <loupe/loupe.h>
+#include <mutex>
 #include <stacktrace>
 #include <Windows.h>
 
@@ -13,8 +14,13 @@ namespace
 	std::ofstream logOutput;
 	HANDLE stdOutputHandle = GetStdHandle(STD_OUTPUT_HANDLE);
 
+	// Messages can be pushed from background threads, such as while loading resources.
+	std::recursive_mutex logMutex;
+
 	void PushMessage(std::string_view header, std::string_view message)
 	{
+		std::scoped_lock lock(logMutex);
+
 		if (logOutput.is_open())
 		{
 			logOutput << header << message << std::endl;
@@ -34,6 +40,8 @@ namespace
 
 	void PushMessage(std::string_view header, std::string_view message, gem::ConsoleColor color)
 	{
+		std::scoped_lock lock(logMutex);
+
 		gem::SetConsoleColor(color);
 		PushMessage(header, message);
 		gem::ResetConsoleColor();
@@ -1,6 +1,7 @@
 // Copyright (c) 2022 Emilian Cioca
 #pragma once
 #include "gemcutter/Application/Logging.h"
+#include "gemcutter/Utilities/ScopeGuard.h"
 
 #include <loupe/loupe.h>
 #include <loupe/metadata.h>
@@ -50,7 +51,11 @@ namespace gem
 }
 
 #define REFLECT_RESOURCE(resource)         REFLECT(resource)  BASES { REF_BASE(gem::ResourceBase) }
-#define REFLECT_COMPONENT(component, base) REFLECT(component) BASES { REF_BASE(base) } USER_CONSTRUCTOR(gem::Entity&)
-#define REFLECT_TAG(tag)                   REFLECT(tag)       BASES { REF_BASE(gem::TagBase) } REF_END
+#define REFLECT_COMPONENT(component, base) \
+	static const bool ANONYMOUS_VARIABLE(COMPONENT_REGISTRATION_) = gem::detail::RegisterComponent<component>(); \
+	REFLECT(component) BASES { REF_BASE(base) } USER_CONSTRUCTOR(gem::Entity&)
+#define REFLECT_TAG(tag) \
+	static const bool ANONYMOUS_VARIABLE(TAG_REGISTRATION_) = gem::detail::RegisterTag<tag>(); \
+	REFLECT(tag) BASES { REF_BASE(gem::TagBase) } REF_END
 
 #include "Reflection.inl"
@@ -6,6 +6,46 @@
 
 #include <algorithm>
 
+namespace
+{
+	// Invokes the functor with the component's type, followed by each of its base component types.
+	template<class Functor>
+	void ForEachIndexedType(const gem::ComponentBase& comp, Functor&& func)
+	{
+		func(comp.GetType());
+
+		auto implementation = [&](this auto self, const loupe::structure& structure) -> bool {
+			for (const loupe::base& base : structure.bases)
+			{
+				if (base.type == gem::BaseComponentTypeId)
+				{
+					return true;
+				}
+
+				if (self(std::get<loupe::structure>(base.type->data)))
+				{
+					func(*base.type);
+					return true;
+				}
+			}
+
+			return false;
+		};
+
+		implementation(std::get<loupe::structure>(comp.GetType().data));
+	}
+
+	// Merges the unsorted additions into the sorted table.
+	void MergeIntoTable(std::vector<gem::Entity*>& table, std::vector<gem::Entity*>& additions)
+	{
+		std::sort(additions.begin(), additions.end());
+
+		const std::size_t middle = table.size();
+		table.insert(table.end(), additions.begin(), additions.end());
+		std::inplace_merge(table.begin(), table.begin() + middle, table.end());
+	}
+}
+
 namespace gem
 {
 	namespace detail
@@ -13,6 +53,18 @@ namespace gem
 		std::unordered_map<ComponentId, std::vector<Entity*>> tagIndex;
 		std::unordered_map<const loupe::type*, std::vector<Entity*>> typeIndex;
 		std::unordered_map<const loupe::type*, std::vector<ComponentBase*>> componentLists;
+
+		std::vector<TagRecord>& GetTagRecords()
+		{
+			static std::vector<TagRecord> records;
+			return records;
+		}
+
+		std::vector<const loupe::type&(*)()>& GetTriviallyClonableRecords()
+		{
+			static std::vector<const loupe::type&(*)()> records;
+			return records;
+		}
 	}
 
 	ComponentBase::ComponentBase(Entity& _owner, detail::ComponentId id)
@@ -291,6 +343,64 @@ namespace gem
 		return isEnabled;
 	}
 
+	void Entity::BulkEnable(std::span<Entity* const> entities)
+	{
+		std::unordered_map<detail::ComponentId, std::vector<Entity*>> newTags;
+		std::unordered_map<const loupe::type*, std::vector<Entity*>> newTypes;
+
+		std::vector<Entity*> enabled;
+		enabled.reserve(entities.size());
+
+		for (Entity* entity : entities)
+		{
+			ASSERT(entity, "Cannot enable a null Entity.");
+			if (entity->isEnabled)
+			{
+				continue;
+			}
+
+			entity->isEnabled = true;
+			enabled.push_back(entity);
+
+			for (auto tag : entity->tags)
+			{
+				newTags[tag].push_back(entity);
+			}
+
+			for (auto* comp : entity->components)
+			{
+				if (comp->IsComponentEnabled())
+				{
+					ForEachIndexedType(*comp, [&](const loupe::type& type) {
+						newTypes[&type].push_back(entity);
+						detail::componentLists[&type].push_back(comp);
+					});
+				}
+			}
+		}
+
+		for (auto& [tagId, additions] : newTags)
+		{
+			MergeIntoTable(detail::tagIndex[tagId], additions);
+		}
+
+		for (auto& [type, additions] : newTypes)
+		{
+			MergeIntoTable(detail::typeIndex[type], additions);
+		}
+
+		for (Entity* entity : enabled)
+		{
+			for (auto* comp : entity->components)
+			{
+				if (comp->IsComponentEnabled())
+				{
+					comp->OnEnable();
+				}
+			}
+		}
+	}
+
 	bool Entity::CanAdd(const loupe::type& compType) const
 	{
 		ASSERT(compType.is_a(*BaseComponentTypeId), "\"compType\" must refer to a component type.");
@@ -473,52 +583,16 @@ namespace gem
 
 	void Entity::IndexWithBases(ComponentBase& comp)
 	{
-		Index(comp, *comp.typeId);
-
-		auto implementation = [this](this auto self, ComponentBase& comp, const loupe::structure& structure) -> bool {
-			for (const loupe::base& base : structure.bases)
-			{
-				if (base.type == BaseComponentTypeId)
-				{
-					return true;
-				}
-
-				if (self(comp, std::get<loupe::structure>(base.type->data)))
-				{
-					Index(comp, *base.type);
-					return true;
-				}
-			}
-
-			return false;
-		};
-
-		implementation(comp, std::get<loupe::structure>(comp.typeId->data));
+		ForEachIndexedType(comp, [&](const loupe::type& type) {
+			Index(comp, type);
+		});
 	}
 
 	void Entity::UnindexWithBases(const ComponentBase& comp)
 	{
-		Unindex(comp, *comp.typeId);
-
-		auto implementation = [this](this auto self, const ComponentBase& comp, const loupe::structure& structure) -> bool {
-			for (const loupe::base& base : structure.bases)
-			{
-				if (base.type == BaseComponentTypeId)
-				{
-					return true;
-				}
-
-				if (self(comp, std::get<loupe::structure>(base.type->data)))
-				{
-					Unindex(comp, *base.type);
-					return true;
-				}
-			}
-
-			return false;
-		};
-
-		implementation(comp, std::get<loupe::structure>(comp.typeId->data));
+		ForEachIndexedType(comp, [&](const loupe::type& type) {
+			Unindex(comp, type);
+		});
 	}
 
 	bool operator==(const Entity& lhs, const Entity& rhs)
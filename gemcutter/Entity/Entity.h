@@ -10,6 +10,7 @@
 
 #include <span>
 #include <string>
+#include <string_view>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -72,6 +73,8 @@ namespace gem
 	// Derive from this to create a new component.
 	// Your class should pass itself as the template argument.
 	// All components must be constructible with just an Entity reference.
+	// Components which derive directly from Component<> and only add trivially-copyable members can declare
+	// "using TriviallyClonable = derived;" in order to be cloned with a memcpy, rather than member by member through reflection.
 	template<class derived>
 	class Component : public ComponentBase
 	{
@@ -90,12 +93,31 @@ namespace gem
 	// Base class for all tags. Cannot be instantiated.
 	template<class derived> class Tag : public Component<derived>, public TagBase {};
 
+	namespace detail
+	{
+		// Type information gathered by the reflection macros during static initialization.
+		// These are used when saving and cloning Entities, and are resolved after the reflection tables are built.
+		struct TagRecord
+		{
+			ComponentId(*getId)();
+			std::string_view name;
+		};
+
+		std::vector<TagRecord>& GetTagRecords();
+		std::vector<const loupe::type&(*)()>& GetTriviallyClonableRecords();
+
+		template<class T> bool RegisterTag();
+		template<class T> bool RegisterComponent();
+	}
+
 	// An Entity is a container for Components.
 	// This is the primary object representing an element of a scene.
 	// All Entities MUST be created through Entity::MakeNew().
 	class Entity : public Transform, public Shareable<Entity>
 	{
 		friend ShareableAlloc;
+		friend class Snapshot;
+		friend Ptr Instantiate(const Entity& prefab);
 
 		Entity() = default;
 		Entity(std::string name);
@@ -179,6 +201,11 @@ namespace gem
 		// Whether or not this Entity is visible to queries.
 		bool IsEnabled() const;
 
+		// Enables all of the given Entities at once. Rather than inserting each of them into the query
+		// tables one by one, they are sorted and merged into each table in a single pass.
+		// Prefer this over Enable() when bringing many Entities into the scene at the same time.
+		static void BulkEnable(std::span<Entity* const> entities);
+
 		// Returns false when the Component type (or one sharing a hierarchy) already exists on this entity.
 		// This is required since Reflection API does not have access to the efficient staticComponentId check.
 		bool CanAdd(const loupe::type&) const;
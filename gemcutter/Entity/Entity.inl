@@ -50,6 +50,33 @@ namespace gem
 	{
 	}
 
+	template<class T>
+	bool detail::RegisterTag()
+	{
+		GetTagRecords().push_back({ []() -> ComponentId { return T::staticComponentId; }, GetTypeName<T>() });
+
+		return true;
+	}
+
+	template<class T>
+	bool detail::RegisterComponent()
+	{
+		// The alias must name the type itself so that it is not inherited by derived components.
+		if constexpr (requires { typename T::TriviallyClonable; })
+		{
+			if constexpr (std::is_same_v<typename T::TriviallyClonable, T>)
+			{
+				// Raw copies begin right after the ComponentBase, so they would also overwrite the data of any intermediate base.
+				static_assert(std::is_same_v<typename T::StaticComponentType, T>,
+					"TriviallyClonable components must derive directly from Component<>.");
+
+				GetTriviallyClonableRecords().push_back(&ReflectType<T>);
+			}
+		}
+
+		return true;
+	}
+
 	template<class T, typename... Args>
 	T& Entity::Add(Args&&... constructorParams)
 	{
@@ -0,0 +1,756 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "Snapshot.h"
+#include "gemcutter/Application/FileSystem.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Application/Reflection.h"
+#include "gemcutter/Entity/Hierarchy.h"
+#include "gemcutter/Math/AABB.h"
+#include "gemcutter/Math/Matrix.h"
+#include "gemcutter/Math/Quaternion.h"
+#include "gemcutter/Math/Vector.h"
+#include "gemcutter/Utilities/BinaryReader.h"
+#include "gemcutter/Utilities/ScopeGuard.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+using namespace gem;
+
+namespace
+{
+	constexpr uint32_t SNAPSHOT_MAGIC   = 0x504E5347; // "GSNP"
+	constexpr uint32_t SNAPSHOT_VERSION = 1;
+	constexpr uint32_t NO_PARENT        = ~0u;
+
+	constexpr uint8_t FLAG_ENABLED = 1 << 0;
+	constexpr uint8_t FLAG_RAW     = 1 << 1;
+
+	// Some ABIs place the members of a derived class inside the tail padding of its base, so the first
+	// byte after the ComponentBase's own data is found with a member that has no alignment requirement.
+	// TriviallyClonable components derive directly from Component<>, so all of their data follows it.
+	struct ComponentDataProbe : ComponentBase { char first; };
+	constexpr std::size_t COMPONENT_DATA_OFFSET = offsetof(ComponentDataProbe, first);
+
+	// Member types which can be saved and copied. The index of each type is stored in the file,
+	// so new types must only ever be appended to the end.
+	using ValueTypes = std::tuple<
+		bool, char, signed char, unsigned char, short, unsigned short, int, unsigned, long long, unsigned long long,
+		float, double, vec2, vec3, vec4, quat, mat2, mat3, mat4, AABB, std::string>;
+
+	constexpr unsigned NUM_VALUE_TYPES = std::tuple_size_v<ValueTypes>;
+	constexpr uint8_t UNSUPPORTED_VALUE = 0xFF;
+
+	// Invokes the templated functor with the ValueType at the given index.
+	template<class Functor>
+	void VisitValueType(uint8_t index, Functor&& func)
+	{
+		[&]<std::size_t... I>(std::index_sequence<I...>) {
+			((index == I ? (func.template operator()<std::tuple_element_t<I, ValueTypes>>(), 0) : 0), ...);
+		}(std::make_index_sequence<NUM_VALUE_TYPES>());
+	}
+
+	uint8_t FindValueType(const loupe::member& member)
+	{
+		static const auto properties = []<std::size_t... I>(std::index_sequence<I...>) {
+			return std::array { reflection_tables.find_property<std::tuple_element_t<I, ValueTypes>>()... };
+		}(std::make_index_sequence<NUM_VALUE_TYPES>());
+
+		for (unsigned i = 0; i < NUM_VALUE_TYPES; ++i)
+		{
+			if (properties[i] && properties[i] == member.data)
+			{
+				return static_cast<uint8_t>(i);
+			}
+		}
+
+		return UNSUPPORTED_VALUE;
+	}
+
+	struct MemberInfo
+	{
+		const loupe::member* member;
+		uint8_t valueType;
+	};
+
+	// Returns the members of the component type, and its base types, which can be saved and copied.
+	const std::vector<MemberInfo>& GetMembers(const loupe::type& type)
+	{
+		static std::unordered_map<const loupe::type*, std::vector<MemberInfo>> cache;
+
+		auto [itr, inserted] = cache.try_emplace(&type);
+		if (!inserted)
+		{
+			return itr->second;
+		}
+
+		std::vector<MemberInfo>& members = itr->second;
+		auto gather = [&](this auto self, const loupe::type& current) -> void {
+			const auto& structure = std::get<loupe::structure>(current.data);
+			for (const loupe::member& member : structure.members)
+			{
+				if (member.metadata.find<loupe::metadata::readonly>())
+				{
+					continue;
+				}
+
+				const bool duplicate = std::ranges::any_of(members, [&](const MemberInfo& info) {
+					return info.member->name == member.name;
+				});
+				if (duplicate)
+				{
+					continue;
+				}
+
+				const uint8_t valueType = FindValueType(member);
+				if (valueType != UNSUPPORTED_VALUE)
+				{
+					members.push_back({ &member, valueType });
+				}
+			}
+
+			for (const loupe::base& base : structure.bases)
+			{
+				if (base.type != BaseComponentTypeId)
+				{
+					self(*base.type);
+				}
+			}
+		};
+
+		gather(type);
+
+		return members;
+	}
+
+	bool IsTriviallyClonable(const loupe::type& type)
+	{
+		static const std::unordered_set<const loupe::type*> types = [] {
+			std::unordered_set<const loupe::type*> result;
+			for (auto reflectType : detail::GetTriviallyClonableRecords())
+			{
+				result.insert(&reflectType());
+			}
+
+			return result;
+		}();
+
+		return types.contains(&type);
+	}
+
+	std::string_view FindTagName(detail::ComponentId id)
+	{
+		static const std::unordered_map<detail::ComponentId, std::string_view> names = [] {
+			std::unordered_map<detail::ComponentId, std::string_view> result;
+			for (const detail::TagRecord& record : detail::GetTagRecords())
+			{
+				result.emplace(record.getId(), record.name);
+			}
+
+			return result;
+		}();
+
+		auto itr = names.find(id);
+		return itr != names.end() ? itr->second : std::string_view{};
+	}
+
+	detail::ComponentId FindTagId(std::string_view name)
+	{
+		for (const detail::TagRecord& record : detail::GetTagRecords())
+		{
+			if (record.name == name)
+			{
+				return record.getId();
+			}
+		}
+
+		return {};
+	}
+
+	void* GetObject(const ComponentBase& comp)
+	{
+		return const_cast<void*>(static_cast<const void*>(&comp));
+	}
+
+	std::byte* GetComponentData(ComponentBase& comp)
+	{
+		return reinterpret_cast<std::byte*>(&comp) + COMPONENT_DATA_OFFSET;
+	}
+
+	const std::byte* GetComponentData(const ComponentBase& comp)
+	{
+		return reinterpret_cast<const std::byte*>(&comp) + COMPONENT_DATA_OFFSET;
+	}
+
+	void CopyComponent(const ComponentBase& source, ComponentBase& target)
+	{
+		const loupe::type& type = source.GetType();
+		if (IsTriviallyClonable(type))
+		{
+			std::memcpy(GetComponentData(target), GetComponentData(source), type.size - COMPONENT_DATA_OFFSET);
+			return;
+		}
+
+		for (const MemberInfo& info : GetMembers(type))
+		{
+			VisitValueType(info.valueType, [&]<class T>() {
+				info.member->set_on<T>(GetObject(target), info.member->get_copy_from<T>(GetObject(source)));
+			});
+		}
+	}
+
+	class Writer
+	{
+	public:
+		template<typename T>
+		void Write(const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			WriteBytes(&value, sizeof(T));
+		}
+
+		void WriteBytes(const void* source, std::size_t size)
+		{
+			const std::size_t start = body.size();
+			body.resize(start + size);
+			std::memcpy(body.data() + start, source, size);
+		}
+
+		void WriteString(std::string_view str)
+		{
+			Write(static_cast<uint32_t>(str.size()));
+			WriteBytes(str.data(), str.size());
+		}
+
+		// Adds the string to the table and writes its index.
+		void WriteName(std::string_view name)
+		{
+			auto [itr, inserted] = stringIndices.try_emplace(name, static_cast<uint16_t>(strings.size()));
+			if (inserted)
+			{
+				ASSERT(strings.size() < UINT16_MAX, "Snapshot has too many unique names.");
+				strings.push_back(name);
+			}
+
+			Write(itr->second);
+		}
+
+		// Writes a placeholder to be filled in later with Patch().
+		template<typename T>
+		std::size_t Reserve()
+		{
+			const std::size_t position = body.size();
+			body.resize(position + sizeof(T));
+
+			return position;
+		}
+
+		template<typename T>
+		void Patch(std::size_t position, const T& value)
+		{
+			std::memcpy(body.data() + position, &value, sizeof(T));
+		}
+
+		std::size_t GetPosition() const { return body.size(); }
+
+		std::vector<std::byte> body;
+		std::vector<std::string_view> strings;
+		std::unordered_map<std::string_view, uint16_t> stringIndices;
+	};
+
+	bool ReadString(BinaryReader& reader, std::string& str)
+	{
+		uint32_t length;
+		std::span<const std::byte> chars;
+		if (!reader.Read(length) || !reader.View(length, chars))
+		{
+			return false;
+		}
+
+		str.assign(reinterpret_cast<const char*>(chars.data()), chars.size());
+
+		return true;
+	}
+
+	void WriteComponent(Writer& writer, const ComponentBase& comp)
+	{
+		const loupe::type& type = comp.GetType();
+		const bool isRaw = IsTriviallyClonable(type);
+
+		uint8_t flags = 0;
+		if (comp.IsComponentEnabled()) flags |= FLAG_ENABLED;
+		if (isRaw)                     flags |= FLAG_RAW;
+
+		writer.WriteName(type.name);
+		writer.Write(flags);
+
+		const std::size_t sizePosition = writer.Reserve<uint32_t>();
+		const std::size_t start = writer.GetPosition();
+
+		if (isRaw)
+		{
+			writer.WriteBytes(GetComponentData(comp), type.size - COMPONENT_DATA_OFFSET);
+		}
+		else
+		{
+			const std::vector<MemberInfo>& members = GetMembers(type);
+			writer.Write(static_cast<uint16_t>(members.size()));
+
+			for (const MemberInfo& info : members)
+			{
+				writer.WriteName(info.member->name);
+				writer.Write(info.valueType);
+
+				const std::size_t valueSizePosition = writer.Reserve<uint32_t>();
+				const std::size_t valueStart = writer.GetPosition();
+
+				VisitValueType(info.valueType, [&]<class T>() {
+					const T value = info.member->get_copy_from<T>(GetObject(comp));
+					if constexpr (std::is_same_v<T, std::string>)
+					{
+						writer.WriteString(value);
+					}
+					else
+					{
+						writer.Write(value);
+					}
+				});
+
+				writer.Patch(valueSizePosition, static_cast<uint32_t>(writer.GetPosition() - valueStart));
+			}
+		}
+
+		writer.Patch(sizePosition, static_cast<uint32_t>(writer.GetPosition() - start));
+	}
+
+	bool ReadMembers(BinaryReader& reader, ComponentBase& comp, std::span<const std::string_view> strings)
+	{
+		uint16_t numMembers;
+		if (!reader.Read(numMembers))
+		{
+			return false;
+		}
+
+		const std::vector<MemberInfo>& members = GetMembers(comp.GetType());
+		for (unsigned i = 0; i < numMembers; ++i)
+		{
+			uint16_t nameIndex;
+			uint8_t valueType;
+			uint32_t size;
+			if (!reader.Read(nameIndex) || !reader.Read(valueType) || !reader.Read(size) || nameIndex >= strings.size())
+			{
+				return false;
+			}
+
+			auto itr = std::ranges::find_if(members, [&](const MemberInfo& info) {
+				return info.member->name == strings[nameIndex];
+			});
+
+			// Members which were removed or changed type since the snapshot was taken are skipped.
+			if (itr == members.end() || itr->valueType != valueType)
+			{
+				if (!reader.Skip(size))
+				{
+					return false;
+				}
+
+				continue;
+			}
+
+			bool success = true;
+			VisitValueType(valueType, [&]<class T>() {
+				T value;
+				if constexpr (std::is_same_v<T, std::string>)
+				{
+					success = ReadString(reader, value);
+				}
+				else
+				{
+					success = reader.Read(value);
+				}
+
+				if (success)
+				{
+					itr->member->set_on<T>(GetObject(comp), std::move(value));
+				}
+			});
+
+			if (!success)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+namespace gem
+{
+	Snapshot Snapshot::Capture(const Entity& root)
+	{
+		Writer writer;
+		uint32_t numEntities = 0;
+
+		// Entities are written depth-first, so that parents are always created before their children.
+		auto captureEntity = [&](this auto self, const Entity& entity, uint32_t parent) -> void {
+			const uint32_t index = numEntities++;
+
+			writer.Write(parent);
+			writer.Write(entity.position);
+			writer.Write(entity.rotation);
+			writer.Write(entity.scale);
+			writer.Write(static_cast<uint8_t>(entity.isEnabled ? FLAG_ENABLED : 0));
+
+			uint16_t numTags = 0;
+			const std::size_t numTagsPosition = writer.Reserve<uint16_t>();
+			for (detail::ComponentId tag : entity.tags)
+			{
+				std::string_view name = FindTagName(tag);
+				if (name.empty())
+				{
+					Warning("Snapshot: A Tag on the Entity was not registered with REFLECT_TAG and will not be saved.");
+					continue;
+				}
+
+				writer.WriteName(name);
+				++numTags;
+			}
+			writer.Patch(numTagsPosition, numTags);
+
+			writer.Write(static_cast<uint16_t>(entity.components.size()));
+			for (const ComponentBase* comp : entity.components)
+			{
+				WriteComponent(writer, *comp);
+			}
+
+			if (auto* hierarchy = entity.Try<Hierarchy>())
+			{
+				for (const Entity::Ptr& child : hierarchy->GetChildren())
+				{
+					self(*child, index);
+				}
+			}
+		};
+
+		captureEntity(root, NO_PARENT);
+
+		// Assemble the header and string table ahead of the body.
+		Writer header;
+		header.Write(SNAPSHOT_MAGIC);
+		header.Write(SNAPSHOT_VERSION);
+		header.Write(static_cast<uint32_t>(writer.strings.size()));
+		header.Write(numEntities);
+		for (std::string_view str : writer.strings)
+		{
+			header.Write(static_cast<uint16_t>(str.size()));
+			header.WriteBytes(str.data(), str.size());
+		}
+
+		Snapshot result;
+		result.data = std::move(header.body);
+		result.data.insert(result.data.end(), writer.body.begin(), writer.body.end());
+
+		return result;
+	}
+
+	bool Snapshot::Load(std::string_view filePath)
+	{
+		data.clear();
+
+		if (!LoadFileAsBinary(filePath, data))
+		{
+			Error("Snapshot: ( %s )\nUnable to open file.", filePath.data());
+			return false;
+		}
+
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		BinaryReader reader(data);
+		if (!reader.Read(magic) || !reader.Read(version) || magic != SNAPSHOT_MAGIC)
+		{
+			Error("Snapshot: ( %s )\nThe file is not a snapshot.", filePath.data());
+			data.clear();
+			return false;
+		}
+
+		if (version != SNAPSHOT_VERSION)
+		{
+			Error("Snapshot: ( %s )\nThe file was saved with an unsupported version (%u).", filePath.data(), version);
+			data.clear();
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Snapshot::Save(std::string_view filePath) const
+	{
+		ASSERT(!IsEmpty(), "Cannot save an empty Snapshot.");
+
+		FILE* file = fopen(filePath.data(), "wb");
+		if (file == nullptr)
+		{
+			Error("Snapshot: ( %s )\nUnable to open file for writing.", filePath.data());
+			return false;
+		}
+		defer { fclose(file); };
+
+		if (fwrite(data.data(), 1, data.size(), file) != data.size())
+		{
+			Error("Snapshot: ( %s )\nFailed to write file.", filePath.data());
+			return false;
+		}
+
+		return true;
+	}
+
+	Entity::Ptr Snapshot::Instantiate() const
+	{
+		ASSERT(!IsEmpty(), "Cannot instantiate an empty Snapshot.");
+
+		BinaryReader reader(data);
+
+		uint32_t magic, version, numStrings, numEntities;
+		if (!reader.Read(magic) || !reader.Read(version) || !reader.Read(numStrings) || !reader.Read(numEntities) ||
+			magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION || numEntities == 0)
+		{
+			Error("Snapshot: The data is corrupt.");
+			return nullptr;
+		}
+
+		std::vector<std::string_view> strings(numStrings);
+		for (std::string_view& str : strings)
+		{
+			uint16_t length;
+			std::span<const std::byte> chars;
+			if (!reader.Read(length) || !reader.View(length, chars))
+			{
+				Error("Snapshot: The data is corrupt.");
+				return nullptr;
+			}
+
+			str = std::string_view(reinterpret_cast<const char*>(chars.data()), chars.size());
+		}
+
+		// Names are resolved once each, rather than once per use.
+		std::vector<const loupe::type*> componentTypes(numStrings, nullptr);
+		std::vector<bool> resolved(numStrings, false);
+		auto resolveComponent = [&](uint16_t nameIndex) -> const loupe::type* {
+			if (!resolved[nameIndex])
+			{
+				const loupe::type* type = reflection_tables.find(strings[nameIndex]);
+				if (type == nullptr || !type->is_a(*BaseComponentTypeId))
+				{
+					Warning("Snapshot: Component type ( %.*s ) is not reflected and will be skipped.",
+						static_cast<int>(strings[nameIndex].size()), strings[nameIndex].data());
+					type = nullptr;
+				}
+
+				componentTypes[nameIndex] = type;
+				resolved[nameIndex] = true;
+			}
+
+			return componentTypes[nameIndex];
+		};
+
+		std::vector<Entity::Ptr> entities;
+		entities.reserve(numEntities);
+		std::vector<Entity*> enabled;
+		enabled.reserve(numEntities);
+
+		for (uint32_t i = 0; i < numEntities; ++i)
+		{
+			uint32_t parent;
+			Transform pose;
+			uint8_t entityFlags;
+			uint16_t numTags;
+			if (!reader.Read(parent) || !reader.Read(pose.position) || !reader.Read(pose.rotation) || !reader.Read(pose.scale) ||
+				!reader.Read(entityFlags) || !reader.Read(numTags) || (parent != NO_PARENT && parent >= i))
+			{
+				Error("Snapshot: The data is corrupt.");
+				return nullptr;
+			}
+
+			// The Entity is assembled while disabled so that nothing is indexed until everything is in place.
+			Entity::Ptr entity = Entity::MakeNew(pose);
+			entity->Disable();
+
+			for (unsigned t = 0; t < numTags; ++t)
+			{
+				uint16_t nameIndex;
+				if (!reader.Read(nameIndex) || nameIndex >= numStrings)
+				{
+					Error("Snapshot: The data is corrupt.");
+					return nullptr;
+				}
+
+				const detail::ComponentId tagId = FindTagId(strings[nameIndex]);
+				if (tagId.IsValid())
+				{
+					entity->AddTag(tagId);
+				}
+			}
+
+			uint16_t numComponents;
+			if (!reader.Read(numComponents))
+			{
+				Error("Snapshot: The data is corrupt.");
+				return nullptr;
+			}
+			entity->components.reserve(numComponents);
+
+			for (unsigned c = 0; c < numComponents; ++c)
+			{
+				uint16_t nameIndex;
+				uint8_t flags;
+				uint32_t size;
+				if (!reader.Read(nameIndex) || !reader.Read(flags) || !reader.Read(size) || nameIndex >= numStrings)
+				{
+					Error("Snapshot: The data is corrupt.");
+					return nullptr;
+				}
+
+				const loupe::type* type = resolveComponent(nameIndex);
+				if (type == nullptr || !entity->CanAdd(*type))
+				{
+					if (!reader.Skip(size))
+					{
+						Error("Snapshot: The data is corrupt.");
+						return nullptr;
+					}
+
+					continue;
+				}
+
+				ComponentBase& comp = entity->Require(*type);
+				const std::size_t end = reader.GetPosition() + size;
+
+				bool success;
+				if (flags & FLAG_RAW)
+				{
+					// Raw data is only valid if the layout of the component has not changed.
+					const bool layoutMatches = IsTriviallyClonable(*type) && size == type->size - COMPONENT_DATA_OFFSET;
+					std::span<const std::byte> source;
+
+					success = reader.View(size, source);
+					if (success && layoutMatches)
+					{
+						std::memcpy(GetComponentData(comp), source.data(), size);
+					}
+					else if (success)
+					{
+						Warning("Snapshot: The layout of component ( %.*s ) has changed. Its data will not be loaded.",
+							static_cast<int>(type->name.size()), type->name.data());
+					}
+				}
+				else
+				{
+					success = ReadMembers(reader, comp, strings) && reader.GetPosition() == end;
+				}
+
+				if (!success)
+				{
+					Error("Snapshot: The data is corrupt.");
+					return nullptr;
+				}
+
+				if (!(flags & FLAG_ENABLED))
+				{
+					entity->Disable(comp);
+				}
+			}
+
+			if (parent != NO_PARENT)
+			{
+				entities[parent]->Require<Hierarchy>().AddChild(entity);
+			}
+
+			if (entityFlags & FLAG_ENABLED)
+			{
+				enabled.push_back(entity.get());
+			}
+
+			entities.push_back(std::move(entity));
+		}
+
+		Entity::BulkEnable(enabled);
+
+		return entities.front();
+	}
+
+	bool Snapshot::IsEmpty() const
+	{
+		return data.empty();
+	}
+
+	std::span<const std::byte> Snapshot::GetData() const
+	{
+		return data;
+	}
+
+	Entity::Ptr Instantiate(const Entity& prefab)
+	{
+		std::vector<Entity*> enabled;
+
+		auto cloneEntity = [&](this auto self, const Entity& source, Hierarchy* parent) -> Entity::Ptr {
+			// The clone is assembled while disabled so that nothing is indexed until everything is in place.
+			Entity::Ptr clone = Entity::MakeNew(static_cast<const Transform&>(source));
+			clone->Disable();
+			clone->components.reserve(source.components.size());
+
+			for (const ComponentBase* comp : source.components)
+			{
+				ComponentBase& newComp = clone->Require(comp->GetType());
+				CopyComponent(*comp, newComp);
+
+				if (!comp->IsComponentEnabled())
+				{
+					clone->Disable(newComp);
+				}
+			}
+
+			for (detail::ComponentId tag : source.tags)
+			{
+				if (std::ranges::find(clone->tags, tag) == clone->tags.end())
+				{
+					clone->AddTag(tag);
+				}
+			}
+
+			if (parent)
+			{
+				parent->AddChild(clone);
+			}
+
+			if (source.isEnabled)
+			{
+				enabled.push_back(clone.get());
+			}
+
+			if (auto* hierarchy = source.Try<Hierarchy>())
+			{
+				auto& cloneHierarchy = clone->Get<Hierarchy>();
+				for (const Entity::Ptr& child : hierarchy->GetChildren())
+				{
+					self(*child, &cloneHierarchy);
+				}
+			}
+
+			return clone;
+		};
+
+		Entity::Ptr root = cloneEntity(prefab, nullptr);
+		Entity::BulkEnable(enabled);
+
+		return root;
+	}
+}
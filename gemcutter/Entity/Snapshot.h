@@ -0,0 +1,41 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Entity/Entity.h"
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace gem
+{
+	// A compact binary capture of an Entity and its descendants, including their Transforms, components, and tags.
+	// Components are recreated through reflection, and their writable reflected members are restored if they are
+	// fundamentals, math types, or strings. Any other state is left as initialized by the component's constructor.
+	class Snapshot
+	{
+	public:
+		Snapshot() = default;
+
+		// Captures the Entity and all of its descendants through their Hierarchy components.
+		[[nodiscard]] static Snapshot Capture(const Entity& root);
+
+		bool Load(std::string_view filePath);
+		bool Save(std::string_view filePath) const;
+
+		// Recreates the captured Entities in a single pass, and returns the new root.
+		// All Entities are created disabled and then indexed for queries together at the end.
+		// Returns null if the data is corrupt.
+		Entity::Ptr Instantiate() const;
+
+		bool IsEmpty() const;
+		std::span<const std::byte> GetData() const;
+
+	private:
+		std::vector<std::byte> data;
+	};
+
+	// Creates a deep copy of the Entity and all of its descendants.
+	// Components declaring TriviallyClonable are copied with a memcpy, others member by member through reflection.
+	Entity::Ptr Instantiate(const Entity& prefab);
+}
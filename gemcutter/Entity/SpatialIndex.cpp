@@ -0,0 +1,670 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "SpatialIndex.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace
+{
+	// Reused between queries to avoid allocating a traversal stack each time.
+	thread_local std::vector<unsigned> stack;
+
+	struct Candidate
+	{
+		float distanceSquared;
+		unsigned node;
+	};
+
+	struct NearestFirst
+	{
+		bool operator()(const Candidate& a, const Candidate& b) const { return a.distanceSquared > b.distanceSquared; }
+	};
+
+	struct FarthestFirst
+	{
+		bool operator()(const Candidate& a, const Candidate& b) const { return a.distanceSquared < b.distanceSquared; }
+	};
+}
+
+namespace gem
+{
+	SpatialIndex SceneIndex;
+
+	SpatialIndex::SpatialIndex(float _margin)
+		: margin(_margin)
+	{
+		ASSERT(margin >= 0.0f, "Margin must be positive.");
+	}
+
+	unsigned SpatialIndex::Insert(Entity& entity, const AABB& bounds)
+	{
+		const unsigned leaf = AllocateNode();
+
+		Node& node = nodes[leaf];
+		node.entity = &entity;
+		node.bounds = bounds;
+		node.fatBounds = bounds;
+		node.fatBounds.Expand(margin);
+		node.height = 0;
+
+		InsertLeaf(leaf);
+		++numProxies;
+
+		return leaf;
+	}
+
+	void SpatialIndex::Remove(unsigned proxy)
+	{
+		ASSERT(proxy < nodes.size() && nodes[proxy].entity, "Invalid proxy.");
+
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		--numProxies;
+	}
+
+	bool SpatialIndex::Move(unsigned proxy, const AABB& bounds)
+	{
+		ASSERT(proxy < nodes.size() && nodes[proxy].entity, "Invalid proxy.");
+
+		Node& node = nodes[proxy];
+		node.bounds = bounds;
+
+		if (node.fatBounds.Contains(bounds))
+		{
+			// The proxy is only reinserted if it has shrunk well within its fattened bounds.
+			AABB largest = bounds;
+			largest.Expand(margin * 4.0f);
+			if (largest.Contains(node.fatBounds))
+			{
+				return false;
+			}
+		}
+
+		RemoveLeaf(proxy);
+
+		node.fatBounds = bounds;
+		node.fatBounds.Expand(margin);
+
+		InsertLeaf(proxy);
+
+		return true;
+	}
+
+	void SpatialIndex::Clear()
+	{
+		nodes.clear();
+		root = NullProxy;
+		freeList = NullProxy;
+		numProxies = 0;
+	}
+
+	void SpatialIndex::QueryAABB(const AABB& box, std::vector<Entity*>& results) const
+	{
+		if (root == NullProxy)
+		{
+			return;
+		}
+
+		stack.clear();
+		stack.push_back(root);
+		while (!stack.empty())
+		{
+			const Node& node = nodes[stack.back()];
+			stack.pop_back();
+
+			if (!node.fatBounds.Intersects(box))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				if (node.bounds.Intersects(box))
+				{
+					results.push_back(node.entity);
+				}
+			}
+			else
+			{
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+	}
+
+	void SpatialIndex::QuerySphere(const vec3& center, float radius, std::vector<Entity*>& results) const
+	{
+		ASSERT(radius >= 0.0f, "Radius must be positive.");
+
+		if (root == NullProxy)
+		{
+			return;
+		}
+
+		stack.clear();
+		stack.push_back(root);
+		while (!stack.empty())
+		{
+			const Node& node = nodes[stack.back()];
+			stack.pop_back();
+
+			if (!node.fatBounds.IntersectsSphere(center, radius))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				if (node.bounds.IntersectsSphere(center, radius))
+				{
+					results.push_back(node.entity);
+				}
+			}
+			else
+			{
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+	}
+
+	RaycastHit SpatialIndex::Raycast(const vec3& origin, const vec3& direction, float maxDistance) const
+	{
+		ASSERT(direction != vec3::Zero, "Ray direction cannot be zero.");
+
+		RaycastHit hit;
+		if (root == NullProxy)
+		{
+			return hit;
+		}
+
+		// Each hit shortens the ray, culling any subtrees which are farther away.
+		float closest = maxDistance;
+
+		stack.clear();
+		stack.push_back(root);
+		while (!stack.empty())
+		{
+			const Node& node = nodes[stack.back()];
+			stack.pop_back();
+
+			if (node.fatBounds.IntersectRay(origin, direction, closest) < 0.0f)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				const float distance = node.bounds.IntersectRay(origin, direction, closest);
+				if (distance >= 0.0f)
+				{
+					closest = distance;
+					hit.entity = node.entity;
+					hit.distance = distance;
+				}
+			}
+			else
+			{
+				stack.push_back(node.children[0]);
+				stack.push_back(node.children[1]);
+			}
+		}
+
+		return hit;
+	}
+
+	void SpatialIndex::QueryNearest(const vec3& point, unsigned count, std::vector<Entity*>& results) const
+	{
+		if (root == NullProxy || count == 0)
+		{
+			return;
+		}
+
+		// Best-first search. A node's fattened bounds are never farther than anything inside of it,
+		// so the search can stop as soon as the next node is farther than the worst candidate found so far.
+		std::priority_queue<Candidate, std::vector<Candidate>, NearestFirst> open;
+		std::priority_queue<Candidate, std::vector<Candidate>, FarthestFirst> found;
+
+		open.push({ nodes[root].fatBounds.DistanceSquared(point), root });
+		while (!open.empty())
+		{
+			const Candidate next = open.top();
+			open.pop();
+
+			if (found.size() == count && next.distanceSquared >= found.top().distanceSquared)
+			{
+				break;
+			}
+
+			const Node& node = nodes[next.node];
+			if (node.IsLeaf())
+			{
+				const float distanceSquared = node.bounds.DistanceSquared(point);
+				if (found.size() < count)
+				{
+					found.push({ distanceSquared, next.node });
+				}
+				else if (distanceSquared < found.top().distanceSquared)
+				{
+					found.pop();
+					found.push({ distanceSquared, next.node });
+				}
+			}
+			else
+			{
+				for (unsigned child : node.children)
+				{
+					open.push({ nodes[child].fatBounds.DistanceSquared(point), child });
+				}
+			}
+		}
+
+		// The heap yields the farthest first, so the results are filled in from the back.
+		const std::size_t start = results.size();
+		results.resize(start + found.size());
+		for (std::size_t i = results.size(); i-- > start;)
+		{
+			results[i] = nodes[found.top().node].entity;
+			found.pop();
+		}
+	}
+
+	Entity& SpatialIndex::GetEntity(unsigned proxy) const
+	{
+		ASSERT(proxy < nodes.size() && nodes[proxy].entity, "Invalid proxy.");
+
+		return *nodes[proxy].entity;
+	}
+
+	const AABB& SpatialIndex::GetBounds(unsigned proxy) const
+	{
+		ASSERT(proxy < nodes.size() && nodes[proxy].entity, "Invalid proxy.");
+
+		return nodes[proxy].bounds;
+	}
+
+	const AABB& SpatialIndex::GetFatBounds(unsigned proxy) const
+	{
+		ASSERT(proxy < nodes.size() && nodes[proxy].entity, "Invalid proxy.");
+
+		return nodes[proxy].fatBounds;
+	}
+
+	unsigned SpatialIndex::GetNumProxies() const
+	{
+		return numProxies;
+	}
+
+	unsigned SpatialIndex::GetHeight() const
+	{
+		if (root == NullProxy)
+		{
+			return 0;
+		}
+
+		return static_cast<unsigned>(nodes[root].height);
+	}
+
+	float SpatialIndex::GetMargin() const
+	{
+		return margin;
+	}
+
+	unsigned SpatialIndex::AllocateNode()
+	{
+		unsigned index;
+		if (freeList != NullProxy)
+		{
+			index = freeList;
+			freeList = nodes[index].parent;
+			nodes[index] = Node();
+		}
+		else
+		{
+			index = static_cast<unsigned>(nodes.size());
+			nodes.emplace_back();
+		}
+
+		return index;
+	}
+
+	void SpatialIndex::FreeNode(unsigned index)
+	{
+		Node& node = nodes[index];
+		node.entity = nullptr;
+		node.height = -1;
+		node.parent = freeList;
+
+		freeList = index;
+	}
+
+	void SpatialIndex::InsertLeaf(unsigned leaf)
+	{
+		if (root == NullProxy)
+		{
+			root = leaf;
+			nodes[leaf].parent = NullProxy;
+			return;
+		}
+
+		// Descend towards the sibling which minimizes the total surface area of the tree.
+		const AABB leafBounds = nodes[leaf].fatBounds;
+		unsigned index = root;
+		while (!nodes[index].IsLeaf())
+		{
+			const Node& node = nodes[index];
+
+			const float area = node.fatBounds.GetSurfaceArea();
+			const float combinedArea = Union(node.fatBounds, leafBounds).GetSurfaceArea();
+
+			// The cost of pairing the leaf with this node directly.
+			const float cost = 2.0f * combinedArea;
+			// The minimum cost added to every ancestor by pushing the leaf further down.
+			const float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float childCosts[2];
+			for (unsigned i = 0; i < 2; ++i)
+			{
+				const Node& child = nodes[node.children[i]];
+				const float childCombinedArea = Union(child.fatBounds, leafBounds).GetSurfaceArea();
+
+				if (child.IsLeaf())
+				{
+					childCosts[i] = childCombinedArea + inheritanceCost;
+				}
+				else
+				{
+					childCosts[i] = childCombinedArea - child.fatBounds.GetSurfaceArea() + inheritanceCost;
+				}
+			}
+
+			if (cost < childCosts[0] && cost < childCosts[1])
+			{
+				break;
+			}
+
+			index = childCosts[0] < childCosts[1] ? node.children[0] : node.children[1];
+		}
+
+		// Replace the sibling with a new parent holding both nodes.
+		const unsigned sibling = index;
+		const unsigned oldParent = nodes[sibling].parent;
+		const unsigned newParent = AllocateNode();
+
+		Node& parent = nodes[newParent];
+		parent.parent = oldParent;
+		parent.fatBounds = Union(leafBounds, nodes[sibling].fatBounds);
+		parent.height = nodes[sibling].height + 1;
+		parent.children[0] = sibling;
+		parent.children[1] = leaf;
+
+		if (oldParent != NullProxy)
+		{
+			Node& grandParent = nodes[oldParent];
+			grandParent.children[grandParent.children[0] == sibling ? 0 : 1] = newParent;
+		}
+		else
+		{
+			root = newParent;
+		}
+
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+
+		Refit(newParent);
+	}
+
+	void SpatialIndex::RemoveLeaf(unsigned leaf)
+	{
+		if (leaf == root)
+		{
+			root = NullProxy;
+			return;
+		}
+
+		// The leaf's sibling takes the place of their shared parent.
+		const unsigned parent = nodes[leaf].parent;
+		const unsigned grandParent = nodes[parent].parent;
+		const unsigned sibling = nodes[parent].children[0] == leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+
+		nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		if (grandParent != NullProxy)
+		{
+			Node& node = nodes[grandParent];
+			node.children[node.children[0] == parent ? 0 : 1] = sibling;
+
+			Refit(grandParent);
+		}
+		else
+		{
+			root = sibling;
+		}
+	}
+
+	void SpatialIndex::Refit(unsigned index)
+	{
+		while (index != NullProxy)
+		{
+			index = Balance(index);
+
+			Node& node = nodes[index];
+			const Node& child0 = nodes[node.children[0]];
+			const Node& child1 = nodes[node.children[1]];
+
+			node.height = 1 + Max(child0.height, child1.height);
+			node.fatBounds = Union(child0.fatBounds, child1.fatBounds);
+
+			index = node.parent;
+		}
+	}
+
+	unsigned SpatialIndex::Balance(unsigned indexA)
+	{
+		Node& A = nodes[indexA];
+		if (A.IsLeaf() || A.height < 2)
+		{
+			return indexA;
+		}
+
+		const unsigned indexB = A.children[0];
+		const unsigned indexC = A.children[1];
+		Node& B = nodes[indexB];
+		Node& C = nodes[indexC];
+
+		const int balance = C.height - B.height;
+		if (balance > 1)
+		{
+			// Rotate C up.
+			const unsigned indexF = C.children[0];
+			const unsigned indexG = C.children[1];
+			Node& F = nodes[indexF];
+			Node& G = nodes[indexG];
+
+			C.children[0] = indexA;
+			C.parent = A.parent;
+			A.parent = indexC;
+
+			if (C.parent != NullProxy)
+			{
+				Node& parent = nodes[C.parent];
+				parent.children[parent.children[0] == indexA ? 0 : 1] = indexC;
+			}
+			else
+			{
+				root = indexC;
+			}
+
+			// The taller of C's children stays with C.
+			if (F.height > G.height)
+			{
+				C.children[1] = indexF;
+				A.children[1] = indexG;
+				G.parent = indexA;
+				A.fatBounds = Union(B.fatBounds, G.fatBounds);
+				C.fatBounds = Union(A.fatBounds, F.fatBounds);
+
+				A.height = 1 + Max(B.height, G.height);
+				C.height = 1 + Max(A.height, F.height);
+			}
+			else
+			{
+				C.children[1] = indexG;
+				A.children[1] = indexF;
+				F.parent = indexA;
+				A.fatBounds = Union(B.fatBounds, F.fatBounds);
+				C.fatBounds = Union(A.fatBounds, G.fatBounds);
+
+				A.height = 1 + Max(B.height, F.height);
+				C.height = 1 + Max(A.height, G.height);
+			}
+
+			return indexC;
+		}
+
+		if (balance < -1)
+		{
+			// Rotate B up.
+			const unsigned indexD = B.children[0];
+			const unsigned indexE = B.children[1];
+			Node& D = nodes[indexD];
+			Node& E = nodes[indexE];
+
+			B.children[0] = indexA;
+			B.parent = A.parent;
+			A.parent = indexB;
+
+			if (B.parent != NullProxy)
+			{
+				Node& parent = nodes[B.parent];
+				parent.children[parent.children[0] == indexA ? 0 : 1] = indexB;
+			}
+			else
+			{
+				root = indexB;
+			}
+
+			// The taller of B's children stays with B.
+			if (D.height > E.height)
+			{
+				B.children[1] = indexD;
+				A.children[0] = indexE;
+				E.parent = indexA;
+				A.fatBounds = Union(C.fatBounds, E.fatBounds);
+				B.fatBounds = Union(A.fatBounds, D.fatBounds);
+
+				A.height = 1 + Max(C.height, E.height);
+				B.height = 1 + Max(A.height, D.height);
+			}
+			else
+			{
+				B.children[1] = indexE;
+				A.children[0] = indexD;
+				D.parent = indexA;
+				A.fatBounds = Union(C.fatBounds, D.fatBounds);
+				B.fatBounds = Union(A.fatBounds, E.fatBounds);
+
+				A.height = 1 + Max(C.height, D.height);
+				B.height = 1 + Max(A.height, E.height);
+			}
+
+			return indexB;
+		}
+
+		return indexA;
+	}
+
+	SpatialBounds::SpatialBounds(Entity& _owner)
+		: Component(_owner)
+	{
+		if (IsEnabled())
+		{
+			Register();
+		}
+	}
+
+	SpatialBounds::SpatialBounds(Entity& _owner, float radius)
+		: Component(_owner)
+		, localBounds(AABB::FromSphere(vec3::Zero, radius))
+	{
+		if (IsEnabled())
+		{
+			Register();
+		}
+	}
+
+	SpatialBounds::SpatialBounds(Entity& _owner, const AABB& _localBounds)
+		: Component(_owner)
+		, localBounds(_localBounds)
+	{
+		if (IsEnabled())
+		{
+			Register();
+		}
+	}
+
+	SpatialBounds::~SpatialBounds()
+	{
+		Unregister();
+	}
+
+	void SpatialBounds::SetLocalBounds(const AABB& bounds)
+	{
+		localBounds = bounds;
+	}
+
+	const AABB& SpatialBounds::GetLocalBounds() const
+	{
+		return localBounds;
+	}
+
+	const AABB& SpatialBounds::GetWorldBounds() const
+	{
+		return worldBounds;
+	}
+
+	void SpatialBounds::Update()
+	{
+		ASSERT(proxy != SpatialIndex::NullProxy, "SpatialBounds must be enabled to be updated.");
+
+		worldBounds = TransformBounds(owner.GetWorldTransform(), localBounds);
+		SceneIndex.Move(proxy, worldBounds);
+	}
+
+	void SpatialBounds::OnEnable()
+	{
+		Register();
+	}
+
+	void SpatialBounds::OnDisable()
+	{
+		Unregister();
+	}
+
+	void SpatialBounds::Register()
+	{
+		ASSERT(proxy == SpatialIndex::NullProxy, "SpatialBounds is already registered.");
+
+		worldBounds = TransformBounds(owner.GetWorldTransform(), localBounds);
+		proxy = SceneIndex.Insert(owner, worldBounds);
+	}
+
+	void SpatialBounds::Unregister()
+	{
+		if (proxy != SpatialIndex::NullProxy)
+		{
+			SceneIndex.Remove(proxy);
+			proxy = SpatialIndex::NullProxy;
+		}
+	}
+}
+
+REFLECT_COMPONENT(gem::SpatialBounds, gem::ComponentBase)
+	MEMBERS {
+		REF_MEMBER(localBounds,
+			description("The local-space bounds of the Entity, used for spatial queries."))
+	}
+REF_END;
@@ -0,0 +1,138 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Entity/Entity.h"
+#include "gemcutter/Math/AABB.h"
+#include "gemcutter/Math/Vector.h"
+
+#include <vector>
+
+namespace gem
+{
+	struct RaycastHit
+	{
+		// Null if nothing was hit.
+		Entity* entity = nullptr;
+		float distance = 0.0f;
+	};
+
+	// A dynamic bounding volume hierarchy of Entity bounds.
+	// Each Entity's box is stored fattened by a margin, so that small movements do not restructure the tree.
+	// The tree is kept balanced with rotations, so queries remain logarithmic as Entities move around.
+	class SpatialIndex
+	{
+	public:
+		static constexpr unsigned NullProxy = ~0u;
+
+		SpatialIndex(float margin = 0.1f);
+
+		// Adds the Entity with the given world-space bounds. Returns a handle to its new proxy.
+		unsigned Insert(Entity& entity, const AABB& bounds);
+
+		// Removes the proxy from the index. The handle becomes invalid.
+		void Remove(unsigned proxy);
+
+		// Updates the world-space bounds of the proxy.
+		// Returns true if the proxy escaped its fattened bounds and had to be reinserted.
+		bool Move(unsigned proxy, const AABB& bounds);
+
+		// Removes all proxies.
+		void Clear();
+
+		// Appends all Entities whose bounds overlap the box.
+		void QueryAABB(const AABB& box, std::vector<Entity*>& results) const;
+
+		// Appends all Entities whose bounds overlap the sphere.
+		void QuerySphere(const vec3& center, float radius, std::vector<Entity*>& results) const;
+
+		// Returns the closest Entity whose bounds are hit by the ray within 'maxDistance'.
+		// Distances are scaled by the length of the direction, which should usually be normalized.
+		RaycastHit Raycast(const vec3& origin, const vec3& direction, float maxDistance) const;
+
+		// Appends up to 'count' Entities whose bounds are the closest to the point, sorted from nearest to farthest.
+		void QueryNearest(const vec3& point, unsigned count, std::vector<Entity*>& results) const;
+
+		Entity& GetEntity(unsigned proxy) const;
+		// Returns the exact bounds last given for the proxy.
+		const AABB& GetBounds(unsigned proxy) const;
+		// Returns the fattened bounds used to place the proxy in the tree.
+		const AABB& GetFatBounds(unsigned proxy) const;
+
+		unsigned GetNumProxies() const;
+		// Returns the height of the tree. An empty tree or a single proxy has a height of zero.
+		unsigned GetHeight() const;
+		float GetMargin() const;
+
+	private:
+		struct Node
+		{
+			bool IsLeaf() const { return children[0] == NullProxy; }
+
+			// The fattened bounds for leaves, or the union of the children's bounds.
+			AABB fatBounds;
+			// The exact bounds of a leaf's Entity.
+			AABB bounds;
+			Entity* entity = nullptr;
+			// Doubles as the next free node while the node is unused.
+			unsigned parent = NullProxy;
+			unsigned children[2] = { NullProxy, NullProxy };
+			// Leaves are at height zero. Free nodes are at height -1.
+			int height = 0;
+		};
+
+		unsigned AllocateNode();
+		void FreeNode(unsigned node);
+
+		void InsertLeaf(unsigned leaf);
+		void RemoveLeaf(unsigned leaf);
+
+		// Refits the bounds and heights of all ancestors of the node, balancing them along the way.
+		void Refit(unsigned node);
+
+		// Rotates the subtree if it is imbalanced. Returns the new root of the subtree.
+		unsigned Balance(unsigned node);
+
+		std::vector<Node> nodes;
+		unsigned root = NullProxy;
+		unsigned freeList = NullProxy;
+		unsigned numProxies = 0;
+		float margin;
+	};
+
+	// Registers the Entity with the SceneIndex so that it can be found with spatial queries.
+	// The bounds are specified in local-space and follow the Entity's world transform.
+	class SpatialBounds : public Component<SpatialBounds>
+	{
+	public:
+		SpatialBounds(Entity& owner);
+		SpatialBounds(Entity& owner, float radius);
+		SpatialBounds(Entity& owner, const AABB& localBounds);
+		~SpatialBounds();
+
+		void SetLocalBounds(const AABB& bounds);
+		const AABB& GetLocalBounds() const;
+
+		// Returns the world-space bounds as of the last update.
+		const AABB& GetWorldBounds() const;
+
+		// Recomputes the world-space bounds and moves the Entity within the SceneIndex.
+		// Called automatically by the engine every frame.
+		void Update();
+
+	private:
+		void OnEnable() override;
+		void OnDisable() override;
+
+		void Register();
+		void Unregister();
+
+		AABB localBounds = AABB(vec3(-0.5f), vec3(0.5f));
+		AABB worldBounds;
+		unsigned proxy = SpatialIndex::NullProxy;
+
+	public:
+		PRIVATE_MEMBER(SpatialBounds, localBounds);
+	};
+
+	// The engine-maintained index of all enabled SpatialBounds components.
+	extern SpatialIndex SceneIndex;
+}
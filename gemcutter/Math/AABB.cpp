@@ -0,0 +1,164 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "AABB.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
+#include "gemcutter/Math/Matrix.h"
+
+#include <loupe/loupe.h>
+#include <utility>
+
+namespace gem
+{
+	AABB::AABB(const vec3& _min, const vec3& _max)
+		: min(_min), max(_max)
+	{
+		ASSERT(min.x <= max.x && min.y <= max.y && min.z <= max.z, "Invalid bounds.");
+	}
+
+	AABB AABB::FromSphere(const vec3& center, float radius)
+	{
+		ASSERT(radius >= 0.0f, "Radius must be positive.");
+
+		return { center - vec3(radius), center + vec3(radius) };
+	}
+
+	bool AABB::operator==(const AABB& other) const
+	{
+		return min == other.min && max == other.max;
+	}
+
+	bool AABB::operator!=(const AABB& other) const
+	{
+		return min != other.min || max != other.max;
+	}
+
+	vec3 AABB::GetCenter() const
+	{
+		return (min + max) * 0.5f;
+	}
+
+	vec3 AABB::GetExtents() const
+	{
+		return (max - min) * 0.5f;
+	}
+
+	float AABB::GetSurfaceArea() const
+	{
+		const vec3 size = max - min;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	void AABB::Expand(float amount)
+	{
+		min -= vec3(amount);
+		max += vec3(amount);
+	}
+
+	bool AABB::Contains(const vec3& point) const
+	{
+		return
+			point.x >= min.x && point.x <= max.x &&
+			point.y >= min.y && point.y <= max.y &&
+			point.z >= min.z && point.z <= max.z;
+	}
+
+	bool AABB::Contains(const AABB& other) const
+	{
+		return
+			other.min.x >= min.x && other.max.x <= max.x &&
+			other.min.y >= min.y && other.max.y <= max.y &&
+			other.min.z >= min.z && other.max.z <= max.z;
+	}
+
+	bool AABB::Intersects(const AABB& other) const
+	{
+		return
+			other.min.x <= max.x && other.max.x >= min.x &&
+			other.min.y <= max.y && other.max.y >= min.y &&
+			other.min.z <= max.z && other.max.z >= min.z;
+	}
+
+	bool AABB::IntersectsSphere(const vec3& center, float radius) const
+	{
+		return DistanceSquared(center) <= radius * radius;
+	}
+
+	float AABB::IntersectRay(const vec3& origin, const vec3& direction, float maxDistance) const
+	{
+		float tMin = 0.0f;
+		float tMax = maxDistance;
+
+		// Slab test. Each axis clips the range of the ray which could be inside the box.
+		for (unsigned i = 0; i < 3; ++i)
+		{
+			if (direction[i] == 0.0f)
+			{
+				// The ray is parallel to the slab, so it must already be between the planes.
+				if (origin[i] < min[i] || origin[i] > max[i])
+				{
+					return -1.0f;
+				}
+
+				continue;
+			}
+
+			const float inverse = 1.0f / direction[i];
+			float t1 = (min[i] - origin[i]) * inverse;
+			float t2 = (max[i] - origin[i]) * inverse;
+			if (t1 > t2)
+			{
+				std::swap(t1, t2);
+			}
+
+			tMin = Max(tMin, t1);
+			tMax = Min(tMax, t2);
+			if (tMin > tMax)
+			{
+				return -1.0f;
+			}
+		}
+
+		return tMin;
+	}
+
+	float AABB::DistanceSquared(const vec3& point) const
+	{
+		return gem::DistanceSquared(point, Clamp(point, min, max));
+	}
+
+	AABB Union(const AABB& a, const AABB& b)
+	{
+		AABB result;
+		result.min = Min(a.min, b.min);
+		result.max = Max(a.max, b.max);
+
+		return result;
+	}
+
+	AABB TransformBounds(const mat4& transform, const AABB& bounds)
+	{
+		// Project the extents onto each world axis (Arvo's method).
+		const vec3 center  = bounds.GetCenter();
+		const vec3 extents = bounds.GetExtents();
+
+		const vec3 right   = transform.GetRight();
+		const vec3 up      = transform.GetUp();
+		const vec3 forward = transform.GetForward();
+
+		const vec3 worldCenter = transform.GetTranslation() + right * center.x + up * center.y + forward * center.z;
+		const vec3 worldExtents = Abs(right) * extents.x + Abs(up) * extents.y + Abs(forward) * extents.z;
+
+		AABB result;
+		result.min = worldCenter - worldExtents;
+		result.max = worldCenter + worldExtents;
+
+		return result;
+	}
+}
+
+REFLECT(gem::AABB)
+	MEMBERS {
+		REF_MEMBER(min)
+		REF_MEMBER(max)
+	}
+REF_END;
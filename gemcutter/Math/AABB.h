@@ -0,0 +1,50 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Math/Vector.h"
+
+namespace gem
+{
+	struct mat4;
+
+	// An axis-aligned bounding box.
+	struct AABB
+	{
+		AABB() = default;
+		AABB(const vec3& min, const vec3& max);
+
+		// Returns the smallest box enclosing the sphere.
+		[[nodiscard]] static AABB FromSphere(const vec3& center, float radius);
+
+		bool operator==(const AABB&) const;
+		bool operator!=(const AABB&) const;
+
+		vec3 GetCenter() const;
+		// Returns half of the size of the box along each axis.
+		vec3 GetExtents() const;
+		float GetSurfaceArea() const;
+
+		// Grows the box by the given amount in every direction.
+		void Expand(float amount);
+
+		bool Contains(const vec3& point) const;
+		bool Contains(const AABB&) const;
+		bool Intersects(const AABB&) const;
+		bool IntersectsSphere(const vec3& center, float radius) const;
+
+		// Returns the distance along the ray to the first intersection with the box, or a negative value if there is none.
+		// The direction does not need to be normalized, in which case the distance is scaled by its length.
+		float IntersectRay(const vec3& origin, const vec3& direction, float maxDistance) const;
+
+		// Returns the squared distance from the point to the closest point on the box. Zero if the point is inside.
+		float DistanceSquared(const vec3& point) const;
+
+		vec3 min;
+		vec3 max;
+	};
+
+	// Returns the smallest box enclosing both boxes.
+	[[nodiscard]] AABB Union(const AABB&, const AABB&);
+
+	// Returns the smallest axis-aligned box enclosing the transformed box.
+	[[nodiscard]] AABB TransformBounds(const mat4& transform, const AABB&);
+}
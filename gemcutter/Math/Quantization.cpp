@@ -0,0 +1,124 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "Quantization.h"
+#include "gemcutter/Math/Math.h"
+
+#include <bit>
+#include <cmath>
+
+namespace
+{
+	// Returns 1.0 for positive values and zero.
+	float SignNotZero(float value)
+	{
+		return (value >= 0.0f) ? 1.0f : -1.0f;
+	}
+}
+
+namespace gem
+{
+	uint16_t FloatToHalf(float value)
+	{
+		const uint32_t bits = std::bit_cast<uint32_t>(value);
+		const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+		uint32_t magnitude = bits & 0x7FFFFFFF;
+
+		// Infinity and NaN.
+		if (magnitude >= 0x7F800000)
+		{
+			return static_cast<uint16_t>(sign | ((magnitude > 0x7F800000) ? 0x7E00 : 0x7C00));
+		}
+
+		// Anything from 65520 rounds up to infinity.
+		if (magnitude >= 0x477FF000)
+		{
+			return static_cast<uint16_t>(sign | 0x7C00);
+		}
+
+		// Values smaller than 2^-14 become subnormal.
+		if (magnitude < 0x38800000)
+		{
+			const float scaled = std::bit_cast<float>(magnitude) * 16777216.0f; // 2^24
+			return static_cast<uint16_t>(sign | static_cast<uint16_t>(std::nearbyint(scaled)));
+		}
+
+		// Rebias the exponent, then round the mantissa to the nearest even value.
+		magnitude -= (127 - 15) << 23;
+		magnitude += 0x0FFF + ((magnitude >> 13) & 1);
+
+		return static_cast<uint16_t>(sign | (magnitude >> 13));
+	}
+
+	float HalfToFloat(uint16_t value)
+	{
+		const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+		const uint32_t exponent = (value >> 10) & 0x1F;
+		const uint32_t mantissa = value & 0x03FF;
+
+		if (exponent == 0)
+		{
+			const float subnormal = static_cast<float>(mantissa) / 16777216.0f; // 2^24
+			return sign ? -subnormal : subnormal;
+		}
+
+		if (exponent == 0x1F)
+		{
+			return std::bit_cast<float>(sign | 0x7F800000 | (mantissa << 13));
+		}
+
+		return std::bit_cast<float>(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+	}
+
+	int16_t QuantizeSNorm16(float value)
+	{
+		return static_cast<int16_t>(std::lround(Clamp(value, -1.0f, 1.0f) * 32767.0f));
+	}
+
+	float DequantizeSNorm16(int16_t value)
+	{
+		return Max(static_cast<float>(value) / 32767.0f, -1.0f);
+	}
+
+	uint16_t QuantizeUNorm16(float value)
+	{
+		return static_cast<uint16_t>(std::lround(Clamp(value, 0.0f, 1.0f) * 65535.0f));
+	}
+
+	float DequantizeUNorm16(uint16_t value)
+	{
+		return static_cast<float>(value) / 65535.0f;
+	}
+
+	vec2 EncodeOctahedral(const vec3& direction)
+	{
+		const float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+		if (length == 0.0f)
+		{
+			return vec2(0.0f, 0.0f);
+		}
+
+		vec2 result(direction.x / length, direction.y / length);
+
+		// The lower hemisphere is folded over the diagonals.
+		if (direction.z < 0.0f)
+		{
+			result = vec2(
+				(1.0f - std::abs(result.y)) * SignNotZero(result.x),
+				(1.0f - std::abs(result.x)) * SignNotZero(result.y));
+		}
+
+		return result;
+	}
+
+	vec3 DecodeOctahedral(const vec2& encoded)
+	{
+		vec3 result(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+
+		if (result.z < 0.0f)
+		{
+			result.x = (1.0f - std::abs(encoded.y)) * SignNotZero(encoded.x);
+			result.y = (1.0f - std::abs(encoded.x)) * SignNotZero(encoded.y);
+		}
+
+		return Normalize(result);
+	}
+}
@@ -0,0 +1,27 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Math/Vector.h"
+
+#include <cstdint>
+
+namespace gem
+{
+	// Converts to an IEEE 754 half-precision float, rounding to the nearest representable value.
+	// Values too large for a half-float become infinity.
+	[[nodiscard]] uint16_t FloatToHalf(float value);
+	[[nodiscard]] float HalfToFloat(uint16_t value);
+
+	// Converts a value in the range [-1, 1] to a normalized 16-bit integer, as read by OpenGL.
+	[[nodiscard]] int16_t QuantizeSNorm16(float value);
+	[[nodiscard]] float DequantizeSNorm16(int16_t value);
+
+	// Converts a value in the range [0, 1] to a normalized 16-bit integer, as read by OpenGL.
+	[[nodiscard]] uint16_t QuantizeUNorm16(float value);
+	[[nodiscard]] float DequantizeUNorm16(uint16_t value);
+
+	// Maps a unit vector onto the unfolded faces of an octahedron. Each component of the result is in the range [-1, 1].
+	// This stores directions in two components, with an even distribution of precision.
+	[[nodiscard]] vec2 EncodeOctahedral(const vec3& direction);
+	// Returns the normalized direction.
+	[[nodiscard]] vec3 DecodeOctahedral(const vec2& encoded);
+}
@@ -0,0 +1,211 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "ClusteredLighting.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
+#include "gemcutter/Rendering/Camera.h"
+#include "gemcutter/Rendering/Light.h"
+#include "gemcutter/Rendering/Rendering.h"
+#include "gemcutter/Rendering/StateCache.h"
+#include "gemcutter/Rendering/Viewport.h"
+
+#include <GL/glew.h>
+#include <cstddef>
+
+namespace
+{
+	// The initial capacity of the light grid, in elements.
+	constexpr unsigned INITIAL_GRID_SIZE = 16 * 1024;
+}
+
+namespace gem
+{
+	ClusteredLightingSingleton ClusteredLighting;
+
+	bool ClusteredLightingSingleton::Load()
+	{
+		if (isLoaded)
+		{
+			return true;
+		}
+
+		static_assert(sizeof(LightBlock) <= 16384, "The light buffer must fit in the minimum uniform block size.");
+
+		glGenBuffers(1, &lightBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, lightBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlock), nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_UNIFORM_BUFFER, GL_NONE);
+
+		gridBufferSize = INITIAL_GRID_SIZE;
+		glGenBuffers(1, &gridBuffer);
+		glBindBuffer(GL_TEXTURE_BUFFER, gridBuffer);
+		glBufferData(GL_TEXTURE_BUFFER, gridBufferSize * sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+		glBindBuffer(GL_TEXTURE_BUFFER, GL_NONE);
+
+		glGenTextures(1, &gridTexture);
+		GLState.BindTexture(TextureUnit, GL_TEXTURE_BUFFER, gridTexture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, gridBuffer);
+
+		isGridDirty = true;
+		isLoaded = true;
+		return true;
+	}
+
+	bool ClusteredLightingSingleton::IsLoaded() const
+	{
+		return isLoaded;
+	}
+
+	void ClusteredLightingSingleton::Unload()
+	{
+		GLState.OnBufferDeleted(lightBuffer);
+		GLState.OnTextureDeleted(gridTexture);
+		glDeleteBuffers(1, &lightBuffer);
+		glDeleteBuffers(1, &gridBuffer);
+		glDeleteTextures(1, &gridTexture);
+
+		lightBuffer = GL_NONE;
+		gridBuffer = GL_NONE;
+		gridTexture = GL_NONE;
+		gridBufferSize = 0;
+		gridData = {};
+		numLights = 0;
+
+		isLoaded = false;
+	}
+
+	void ClusteredLightingSingleton::SetGridSize(unsigned x, unsigned y, unsigned z)
+	{
+		ASSERT(x > 0 && y > 0 && z > 0, "The grid must have at least one cluster along each axis.");
+
+		gridX = x;
+		gridY = y;
+		gridZ = z;
+		isGridDirty = true;
+	}
+
+	void ClusteredLightingSingleton::Update(const Camera& camera, const Viewport& viewport)
+	{
+		ASSERT(IsLoaded(), "ClusteredLighting must be loaded to call this function.");
+		ASSERT(camera.IsPerspective(), "Clustered lighting requires a perspective camera.");
+
+		// The cluster bounds only change along with the projection.
+		const mat4 projection = camera.GetProjMatrix();
+		if (isGridDirty || projection != gridProjection)
+		{
+			clusters.SetGrid(gridX, gridY, gridZ, camera.GetInverseProjMatrix(), camera.GetNearPlane(), camera.GetFarPlane());
+			gridProjection = projection;
+			isGridDirty = false;
+		}
+
+		const mat4 view = camera.GetViewMatrix();
+		clusters.Clear();
+		numLights = 0;
+
+		auto Pack = [this](const Light& light, const vec3& position, const vec3& direction) {
+			PackedLight& packed = block.lights[numLights++];
+			packed.position = vec4(position, light.attenuationLinear.Get());
+			packed.color = vec4(light.color.Get(), light.attenuationQuadratic.Get());
+			packed.direction = vec4(direction, std::cos(ToRadian(light.angle * 0.5f)));
+			packed.type = static_cast<uint32_t>(light.type);
+		};
+
+		// Directional lights reach every cluster, so they are listed first and applied to all surfaces.
+		for (const Light& light : All<Light>())
+		{
+			if (light.type == Light::Type::Directional && numLights < MaxLights)
+			{
+				Pack(light, vec3(0.0f), light.owner.GetWorldRotation().GetForward());
+			}
+		}
+
+		const unsigned numDirectional = numLights;
+		for (const Light& light : All<Light>())
+		{
+			if (light.type == Light::Type::Directional)
+			{
+				continue;
+			}
+
+			if (numLights == MaxLights) [[unlikely]]
+			{
+				if (!hasReportedOverflow)
+				{
+					Warning("ClusteredLighting: The maximum of ( %u ) lights has been reached. The remaining lights are ignored.", MaxLights);
+					hasReportedOverflow = true;
+				}
+				break;
+			}
+
+			const float range = light.GetRange();
+			if (range <= 0.0f)
+			{
+				continue;
+			}
+
+			const unsigned index = numLights;
+			const vec3 position = light.owner.GetWorldPosition();
+			const vec4 viewPosition = view * vec4(position, 1.0f);
+
+			if (light.type == Light::Type::Spot)
+			{
+				const vec3 direction = light.owner.GetWorldRotation().GetForward();
+				const vec4 viewDirection = view * vec4(direction, 0.0f);
+
+				Pack(light, position, direction);
+				clusters.AddSpotLight(index, vec3(viewPosition.x, viewPosition.y, viewPosition.z),
+					vec3(viewDirection.x, viewDirection.y, viewDirection.z), range, block.lights[index].direction.w);
+			}
+			else
+			{
+				Pack(light, position, vec3(0.0f));
+				clusters.AddPointLight(index, vec3(viewPosition.x, viewPosition.y, viewPosition.z), range);
+			}
+		}
+
+		clusters.Build();
+
+		block.clusterSize[0] = clusters.GetSizeX();
+		block.clusterSize[1] = clusters.GetSizeY();
+		block.clusterSize[2] = clusters.GetSizeZ();
+		block.clusterSize[3] = numDirectional;
+		block.clusterScale = vec4(
+			static_cast<float>(clusters.GetSizeX()) / static_cast<float>(viewport.width),
+			static_cast<float>(clusters.GetSizeY()) / static_cast<float>(viewport.height),
+			clusters.GetSliceScale(),
+			clusters.GetSliceBias());
+		block.clusterOffset = vec4(static_cast<float>(viewport.x), static_cast<float>(viewport.y), 0.0f, 0.0f);
+
+		// Only the lights in use are uploaded.
+		const size_t blockSize = offsetof(LightBlock, lights) + sizeof(PackedLight) * numLights;
+		glBindBuffer(GL_UNIFORM_BUFFER, lightBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, blockSize, &block);
+		glBindBuffer(GL_UNIFORM_BUFFER, GL_NONE);
+
+		const std::vector<uint32_t>& grid = clusters.GetGrid();
+		const std::vector<uint32_t>& indices = clusters.GetIndices();
+		gridData.assign(grid.begin(), grid.end());
+		gridData.insert(gridData.end(), indices.begin(), indices.end());
+
+		glBindBuffer(GL_TEXTURE_BUFFER, gridBuffer);
+		if (gridData.size() > gridBufferSize)
+		{
+			gridBufferSize = Max(static_cast<unsigned>(gridData.size()), gridBufferSize * 2);
+			glBufferData(GL_TEXTURE_BUFFER, gridBufferSize * sizeof(uint32_t), nullptr, GL_STREAM_DRAW);
+		}
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, gridData.size() * sizeof(uint32_t), gridData.data());
+		glBindBuffer(GL_TEXTURE_BUFFER, GL_NONE);
+
+		GLState.BindUniformBuffer(static_cast<unsigned>(UniformBufferSlot::Lights), lightBuffer);
+		GLState.BindTexture(TextureUnit, GL_TEXTURE_BUFFER, gridTexture);
+	}
+
+	const LightClusters& ClusteredLightingSingleton::GetClusters() const
+	{
+		return clusters;
+	}
+
+	unsigned ClusteredLightingSingleton::GetNumLights() const
+	{
+		return numLights;
+	}
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Math/Matrix.h"
+#include "gemcutter/Math/Vector.h"
+#include "gemcutter/Rendering/LightClusters.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace gem
+{
+	class Camera;
+	struct Viewport;
+
+	// Packs all enabled Lights into a single buffer, and lists the lights which reach each cluster of a camera's view.
+	// Shaders can then use compute_clustered_lighting() to shade a surface with every light affecting it.
+	extern class ClusteredLightingSingleton ClusteredLighting;
+	class ClusteredLightingSingleton
+	{
+	public:
+		// Keeps the light buffer within the minimum uniform block size guaranteed by OpenGL.
+		static constexpr unsigned MaxLights = 255;
+		// The texture unit of the light grid. It cannot be used by shader Samplers.
+		static constexpr unsigned TextureUnit = 15;
+
+		bool Load();
+		bool IsLoaded() const;
+		void Unload();
+
+		// Sets the number of clusters along each axis. Defaults to 16x9 tiles, each cut into 24 slices.
+		void SetGridSize(unsigned x, unsigned y, unsigned z);
+
+		// Gathers the enabled Lights, assigns them to the clusters of the camera's view, then uploads and binds the results.
+		// Must be called before rendering with each camera. The camera must use a perspective projection.
+		void Update(const Camera& camera, const Viewport& viewport);
+
+		const LightClusters& GetClusters() const;
+		unsigned GetNumLights() const;
+
+	private:
+		// Matches the layout of Gem_Light in the shader header.
+		struct PackedLight
+		{
+			vec4 position;  // w: AttenuationLinear
+			vec4 color;     // w: AttenuationQuadratic
+			vec4 direction; // w: cosine of the half-angle
+			uint32_t type;
+			uint32_t padding[3];
+		};
+
+		// Matches the layout of Gem_Light_Uniforms in the shader header.
+		struct LightBlock
+		{
+			// The number of clusters along each axis, and the number of directional lights.
+			uint32_t clusterSize[4];
+			// Converts window coordinates to tiles, and view depths to slices.
+			vec4 clusterScale;
+			vec4 clusterOffset;
+			PackedLight lights[MaxLights];
+		};
+
+		bool isLoaded = false;
+		bool hasReportedOverflow = false;
+
+		unsigned gridX = 16;
+		unsigned gridY = 9;
+		unsigned gridZ = 24;
+
+		// The projection the cluster bounds were built for.
+		mat4 gridProjection;
+		bool isGridDirty = true;
+
+		LightClusters clusters;
+		LightBlock block;
+		unsigned numLights = 0;
+
+		// The cluster entries followed by the light indices, as uploaded to the light grid.
+		std::vector<uint32_t> gridData;
+
+		unsigned lightBuffer = 0;
+		unsigned gridBuffer = 0;
+		unsigned gridBufferSize = 0;
+		unsigned gridTexture = 0;
+	};
+}
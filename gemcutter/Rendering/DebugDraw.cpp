@@ -0,0 +1,245 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "DebugDraw.h"
+#include "gemcutter/Math/Math.h"
+#include "gemcutter/Math/Matrix.h"
+#include "gemcutter/Math/Quantization.h"
+
+#include <algorithm>
+
+namespace
+{
+	std::array<uint16_t, 4> PackColor(const gem::vec4& color)
+	{
+		return {
+			gem::QuantizeUNorm16(color.x),
+			gem::QuantizeUNorm16(color.y),
+			gem::QuantizeUNorm16(color.z),
+			gem::QuantizeUNorm16(color.w)
+		};
+	}
+
+	gem::vec3 TransformPoint(const gem::mat4& transform, const gem::vec3& point)
+	{
+		gem::vec4 result = transform * gem::vec4(point, 1.0f);
+		return gem::vec3(result.x, result.y, result.z) / result.w;
+	}
+
+	// The corners of a cube spanning from -1 to 1, in the order expected by AddCorners().
+	constexpr float unitCorners[8][3] = {
+		{ -1.0f, -1.0f, -1.0f }, { 1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, -1.0f }, { -1.0f, 1.0f, -1.0f },
+		{ -1.0f, -1.0f,  1.0f }, { 1.0f, -1.0f,  1.0f }, { 1.0f, 1.0f,  1.0f }, { -1.0f, 1.0f,  1.0f }
+	};
+}
+
+namespace gem
+{
+	DebugDrawList DebugDraw;
+
+	template<typename Predicate>
+	void DebugDrawList::Batch::Remove(Predicate predicate)
+	{
+		const size_t verticesPerPrimitive = vertices.size() / lifetimes.size();
+
+		// Compacts the remaining primitives in place, preserving their order.
+		size_t kept = 0;
+		numTimed = 0;
+		for (size_t i = 0; i < lifetimes.size(); ++i)
+		{
+			if (predicate(lifetimes[i]))
+			{
+				continue;
+			}
+
+			if (kept != i)
+			{
+				lifetimes[kept] = lifetimes[i];
+				std::copy_n(vertices.begin() + i * verticesPerPrimitive, verticesPerPrimitive, vertices.begin() + kept * verticesPerPrimitive);
+			}
+
+			if (lifetimes[kept] > 0.0f)
+			{
+				numTimed++;
+			}
+
+			kept++;
+		}
+
+		lifetimes.resize(kept);
+		vertices.resize(kept * verticesPerPrimitive);
+	}
+
+	void DebugDrawList::AddLine(const vec3& p1, const vec3& p2, const vec4& color, float lifetime, DebugDepth depth)
+	{
+		const auto packed = PackColor(color);
+		AddLineUnchecked(p1, p2, packed, packed, lifetime, depth);
+	}
+
+	void DebugDrawList::AddLine(const vec3& p1, const vec3& p2, const vec4& color1, const vec4& color2, float lifetime, DebugDepth depth)
+	{
+		AddLineUnchecked(p1, p2, PackColor(color1), PackColor(color2), lifetime, depth);
+	}
+
+	void DebugDrawList::AddTriangle(const vec3& p1, const vec3& p2, const vec3& p3, const vec4& color, float lifetime, DebugDepth depth)
+	{
+		const auto packed = PackColor(color);
+		lifetime = Max(lifetime, 0.0f);
+
+		Batch& batch = GetTriangles(depth);
+		batch.vertices.push_back({ p1, packed });
+		batch.vertices.push_back({ p2, packed });
+		batch.vertices.push_back({ p3, packed });
+		batch.lifetimes.push_back(lifetime);
+		if (lifetime > 0.0f)
+		{
+			batch.numTimed++;
+		}
+	}
+
+	void DebugDrawList::AddBox(const vec3& min, const vec3& max, const vec4& color, float lifetime, DebugDepth depth)
+	{
+		const vec3 corners[8] = {
+			{ min.x, min.y, min.z }, { max.x, min.y, min.z }, { max.x, max.y, min.z }, { min.x, max.y, min.z },
+			{ min.x, min.y, max.z }, { max.x, min.y, max.z }, { max.x, max.y, max.z }, { min.x, max.y, max.z }
+		};
+
+		AddCorners(corners, color, lifetime, depth);
+	}
+
+	void DebugDrawList::AddBox(const mat4& transform, const vec4& color, float lifetime, DebugDepth depth)
+	{
+		vec3 corners[8];
+		for (unsigned i = 0; i < 8; ++i)
+		{
+			corners[i] = TransformPoint(transform, vec3(unitCorners[i][0], unitCorners[i][1], unitCorners[i][2]));
+		}
+
+		AddCorners(corners, color, lifetime, depth);
+	}
+
+	void DebugDrawList::AddSphere(const vec3& center, float radius, const vec4& color, float lifetime, DebugDepth depth)
+	{
+		const auto packed = PackColor(color);
+		constexpr float step = (M_PI * 2.0f) / static_cast<float>(SphereSegments);
+
+		vec2 previous(radius, 0.0f);
+		for (unsigned i = 1; i <= SphereSegments; ++i)
+		{
+			const float angle = step * static_cast<float>(i);
+			const vec2 current(std::cos(angle) * radius, std::sin(angle) * radius);
+
+			AddLineUnchecked(center + vec3(previous.x, previous.y, 0.0f), center + vec3(current.x, current.y, 0.0f), packed, packed, lifetime, depth);
+			AddLineUnchecked(center + vec3(previous.x, 0.0f, previous.y), center + vec3(current.x, 0.0f, current.y), packed, packed, lifetime, depth);
+			AddLineUnchecked(center + vec3(0.0f, previous.x, previous.y), center + vec3(0.0f, current.x, current.y), packed, packed, lifetime, depth);
+
+			previous = current;
+		}
+	}
+
+	void DebugDrawList::AddFrustum(const mat4& inverseViewProj, const vec4& color, float lifetime, DebugDepth depth)
+	{
+		// The corners of the normalized device coordinates, from the near plane to the far plane.
+		AddBox(inverseViewProj, color, lifetime, depth);
+	}
+
+	void DebugDrawList::Update(float deltaTime)
+	{
+		for (Batch* batch : { &lines[0], &lines[1], &triangles[0], &triangles[1] })
+		{
+			if (batch->numTimed == 0)
+			{
+				continue;
+			}
+
+			for (float& lifetime : batch->lifetimes)
+			{
+				if (lifetime > 0.0f)
+				{
+					// Expired primitives are marked with a negative lifetime, so they are not mistaken for single-frame primitives.
+					lifetime = lifetime > deltaTime ? lifetime - deltaTime : -1.0f;
+				}
+			}
+
+			batch->Remove([](float lifetime) { return lifetime < 0.0f; });
+		}
+	}
+
+	void DebugDrawList::EndFrame()
+	{
+		for (Batch* batch : { &lines[0], &lines[1], &triangles[0], &triangles[1] })
+		{
+			if (batch->numTimed == 0)
+			{
+				batch->vertices.clear();
+				batch->lifetimes.clear();
+			}
+			else
+			{
+				batch->Remove([](float lifetime) { return lifetime == 0.0f; });
+			}
+		}
+	}
+
+	void DebugDrawList::Clear()
+	{
+		for (Batch* batch : { &lines[0], &lines[1], &triangles[0], &triangles[1] })
+		{
+			batch->vertices.clear();
+			batch->lifetimes.clear();
+			batch->numTimed = 0;
+		}
+	}
+
+	const std::vector<DebugVertex>& DebugDrawList::GetLineVertices(DebugDepth depth) const
+	{
+		return lines[static_cast<unsigned>(depth)].vertices;
+	}
+
+	const std::vector<DebugVertex>& DebugDrawList::GetTriangleVertices(DebugDepth depth) const
+	{
+		return triangles[static_cast<unsigned>(depth)].vertices;
+	}
+
+	bool DebugDrawList::IsEmpty() const
+	{
+		return
+			lines[0].lifetimes.empty() && lines[1].lifetimes.empty() &&
+			triangles[0].lifetimes.empty() && triangles[1].lifetimes.empty();
+	}
+
+	void DebugDrawList::AddLineUnchecked(const vec3& p1, const vec3& p2, const std::array<uint16_t, 4>& color1, const std::array<uint16_t, 4>& color2, float lifetime, DebugDepth depth)
+	{
+		lifetime = Max(lifetime, 0.0f);
+
+		Batch& batch = GetLines(depth);
+		batch.vertices.push_back({ p1, color1 });
+		batch.vertices.push_back({ p2, color2 });
+		batch.lifetimes.push_back(lifetime);
+		if (lifetime > 0.0f)
+		{
+			batch.numTimed++;
+		}
+	}
+
+	void DebugDrawList::AddCorners(const vec3 (&corners)[8], const vec4& color, float lifetime, DebugDepth depth)
+	{
+		const auto packed = PackColor(color);
+
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			const unsigned next = (i + 1) % 4;
+			AddLineUnchecked(corners[i], corners[next], packed, packed, lifetime, depth);
+			AddLineUnchecked(corners[i + 4], corners[next + 4], packed, packed, lifetime, depth);
+			AddLineUnchecked(corners[i], corners[i + 4], packed, packed, lifetime, depth);
+		}
+	}
+
+	DebugDrawList::Batch& DebugDrawList::GetLines(DebugDepth depth)
+	{
+		return lines[static_cast<unsigned>(depth)];
+	}
+
+	DebugDrawList::Batch& DebugDrawList::GetTriangles(DebugDepth depth)
+	{
+		return triangles[static_cast<unsigned>(depth)];
+	}
+}
@@ -0,0 +1,88 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Math/Vector.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace gem
+{
+	struct mat4;
+
+	enum class DebugDepth : uint16_t
+	{
+		// Hidden behind solid geometry.
+		Tested,
+		// Drawn on top of everything.
+		Overlay
+	};
+
+	// A vertex as uploaded to the GPU. The color is a normalized RGBA value.
+	struct DebugVertex
+	{
+		vec3 position;
+		std::array<uint16_t, 4> color;
+	};
+
+	// Collects debugging primitives into CPU-side vertex arrays, so that they can be rendered with one draw call per type.
+	// Primitives without a lifetime are removed by EndFrame(), after they have been rendered once.
+	// Primitives with a lifetime, in seconds, persist until enough time has been passed to Update().
+	// Everything is rendered with Primitives.DrawDebug().
+	class DebugDrawList
+	{
+	public:
+		void AddLine(const vec3& p1, const vec3& p2, const vec4& color, float lifetime = 0.0f, DebugDepth depth = DebugDepth::Tested);
+		void AddLine(const vec3& p1, const vec3& p2, const vec4& color1, const vec4& color2, float lifetime = 0.0f, DebugDepth depth = DebugDepth::Tested);
+		// A filled triangle.
+		void AddTriangle(const vec3& p1, const vec3& p2, const vec3& p3, const vec4& color, float lifetime = 0.0f, DebugDepth depth = DebugDepth::Tested);
+		// The outline of an axis-aligned box.
+		void AddBox(const vec3& min, const vec3& max, const vec4& color, float lifetime = 0.0f, DebugDepth depth = DebugDepth::Tested);
+		// The outline of a cube spanning from -1 to 1 on all axes, after being transformed.
+		void AddBox(const mat4& transform, const vec4& color, float lifetime = 0.0f, DebugDepth depth = DebugDepth::Tested);
+		// Three circles, one around each axis.
+		void AddSphere(const vec3& center, float radius, const vec4& color, float lifetime = 0.0f, DebugDepth depth = DebugDepth::Tested);
+		// The outline of the volume seen by a camera. Use the camera's inverse view-projection matrix.
+		void AddFrustum(const mat4& inverseViewProj, const vec4& color, float lifetime = 0.0f, DebugDepth depth = DebugDepth::Tested);
+
+		// Ages the primitives with a lifetime, removing the ones which have expired.
+		void Update(float deltaTime);
+		// Removes the primitives without a lifetime. Should be called once per frame, after the list is rendered.
+		void EndFrame();
+		void Clear();
+
+		const std::vector<DebugVertex>& GetLineVertices(DebugDepth depth) const;
+		const std::vector<DebugVertex>& GetTriangleVertices(DebugDepth depth) const;
+		bool IsEmpty() const;
+
+		// The number of segments used to approximate each circle of a sphere.
+		static constexpr unsigned SphereSegments = 24;
+
+	private:
+		struct Batch
+		{
+			// Removes the primitives for which 'predicate(lifetime)' is true.
+			template<typename Predicate>
+			void Remove(Predicate predicate);
+
+			std::vector<DebugVertex> vertices;
+			// One entry per primitive.
+			std::vector<float> lifetimes;
+			unsigned numTimed = 0;
+		};
+
+		void AddLineUnchecked(const vec3& p1, const vec3& p2, const std::array<uint16_t, 4>& color1, const std::array<uint16_t, 4>& color2, float lifetime, DebugDepth depth);
+		// Connects 8 corners as the edges of a box. The first 4 corners, and the last 4 corners, form a loop.
+		void AddCorners(const vec3 (&corners)[8], const vec4& color, float lifetime, DebugDepth depth);
+
+		Batch& GetLines(DebugDepth depth);
+		Batch& GetTriangles(DebugDepth depth);
+
+		Batch lines[2];
+		Batch triangles[2];
+	};
+
+	// The list used by the engine. Application.UpdateEngine() ages the lifetimes and calls EndFrame() automatically,
+	// so primitives without a lifetime should be added after it, to be drawn by the following render.
+	extern DebugDrawList DebugDraw;
+}
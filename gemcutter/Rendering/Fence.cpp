@@ -0,0 +1,92 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "Fence.h"
+#include "gemcutter/Application/Logging.h"
+
+#include <GL/glew.h>
+#include <utility>
+
+namespace
+{
+	// One second, in nanoseconds.
+	constexpr GLuint64 WAIT_TIMEOUT = 1'000'000'000;
+}
+
+namespace gem
+{
+	Fence::Fence(Fence&& other) noexcept
+		: sync(std::exchange(other.sync, nullptr))
+	{
+	}
+
+	Fence& Fence::operator=(Fence&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Clear();
+			sync = std::exchange(other.sync, nullptr);
+		}
+
+		return *this;
+	}
+
+	Fence::~Fence()
+	{
+		Clear();
+	}
+
+	void Fence::Insert()
+	{
+		Clear();
+		sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	void Fence::Wait()
+	{
+		if (!sync)
+			return;
+
+		// The first wait flushes the command stream so the fence is guaranteed to eventually signal.
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while (true)
+		{
+			const GLenum result = glClientWaitSync(sync, flags, WAIT_TIMEOUT);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+				break;
+
+			if (result == GL_WAIT_FAILED)
+			{
+				Error("Fence: Failed to wait on GPU synchronization point.");
+				break;
+			}
+
+			flags = 0;
+		}
+
+		Clear();
+	}
+
+	void Fence::Clear()
+	{
+		if (sync)
+		{
+			glDeleteSync(sync);
+			sync = nullptr;
+		}
+	}
+
+	bool Fence::IsPending() const
+	{
+		return sync != nullptr;
+	}
+
+	bool Fence::IsSignalled() const
+	{
+		if (!sync)
+			return true;
+
+		GLint status = GL_UNSIGNALED;
+		glGetSynciv(sync, GL_SYNC_STATUS, sizeof(status), nullptr, &status);
+
+		return status == GL_SIGNALED;
+	}
+}
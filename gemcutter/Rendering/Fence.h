@@ -0,0 +1,38 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+
+struct __GLsync; typedef __GLsync* GLsync;
+
+namespace gem
+{
+	// A synchronization point in the GPU's command stream.
+	// Allows the CPU to determine when the GPU has finished with the commands issued before the fence.
+	class Fence
+	{
+	public:
+		Fence() = default;
+		Fence(Fence&&) noexcept;
+		Fence& operator=(Fence&&) noexcept;
+		~Fence();
+
+		Fence(const Fence&) = delete;
+		Fence& operator=(const Fence&) = delete;
+
+		// Places the fence after all currently issued GPU commands.
+		// Any previously inserted fence is discarded.
+		void Insert();
+		// Blocks until the GPU has processed all commands issued before the fence.
+		// Returns immediately if the fence was never inserted.
+		void Wait();
+		// Discards the fence without waiting on it.
+		void Clear();
+
+		// Returns true if the fence has been inserted and has not yet been waited on.
+		bool IsPending() const;
+		// Returns true if the GPU has passed the fence, or if the fence is not pending.
+		bool IsSignalled() const;
+
+	private:
+		GLsync sync = nullptr;
+	};
+}
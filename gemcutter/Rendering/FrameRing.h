@@ -0,0 +1,45 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <array>
+
+namespace gem
+{
+	// Cycles through a fixed number of regions of a GPU resource that is rewritten every frame.
+	// While the CPU writes to one region, the GPU is free to read from the others.
+	// Each region is protected by a fence so that it is never overwritten while still in use.
+	//
+	// 'FenceType' must provide Insert() and Wait(). The Fence class is used for GPU resources,
+	// but any type matching the interface can be used to test the synchronization in isolation.
+	template<class FenceType, unsigned Count = 3>
+	class FrameRing
+	{
+		static_assert(Count > 1, "A FrameRing requires at least two regions.");
+	public:
+		// Fences the current region to protect the commands which have been issued with it,
+		// then waits for the GPU to release the next region and makes it current.
+		// Should be called before writing the new data for a frame.
+		void Advance()
+		{
+			if (hasStarted)
+			{
+				fences[current].Insert();
+				current = (current + 1) % Count;
+			}
+
+			fences[current].Wait();
+			hasStarted = true;
+		}
+
+		// The index of the region which is currently safe to write to.
+		unsigned GetCurrentRegion() const { return current; }
+
+		const FenceType& GetFence(unsigned region) const { return fences[region]; }
+
+		static constexpr unsigned RegionCount = Count;
+
+	private:
+		std::array<FenceType, Count> fences;
+		unsigned current = 0;
+		bool hasStarted = false;
+	};
+}
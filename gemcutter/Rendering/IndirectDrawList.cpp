@@ -0,0 +1,65 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "IndirectDrawList.h"
+
+#include <algorithm>
+
+namespace gem
+{
+	void IndirectDrawList::Add(unsigned group, unsigned pool, const DrawElementsIndirectCommand& command, const IndirectDrawData& data)
+	{
+		draws.push_back({ group, pool, command, data });
+	}
+
+	void IndirectDrawList::Build()
+	{
+		std::ranges::stable_sort(draws, [](const Draw& a, const Draw& b) {
+			return (a.group != b.group) ? a.group < b.group : a.pool < b.pool;
+		});
+
+		commands.clear();
+		drawData.clear();
+		batches.clear();
+		commands.reserve(draws.size());
+		drawData.reserve(draws.size());
+
+		for (const Draw& draw : draws)
+		{
+			if (batches.empty() || batches.back().group != draw.group || batches.back().pool != draw.pool)
+			{
+				batches.push_back({ draw.group, draw.pool, static_cast<unsigned>(commands.size()), 0 });
+			}
+
+			batches.back().numCommands++;
+			commands.push_back(draw.command);
+			drawData.push_back(draw.data);
+		}
+	}
+
+	void IndirectDrawList::Clear()
+	{
+		draws.clear();
+		commands.clear();
+		drawData.clear();
+		batches.clear();
+	}
+
+	std::span<const DrawElementsIndirectCommand> IndirectDrawList::GetCommands() const
+	{
+		return commands;
+	}
+
+	std::span<const IndirectDrawData> IndirectDrawList::GetDrawData() const
+	{
+		return drawData;
+	}
+
+	std::span<const IndirectDrawList::Batch> IndirectDrawList::GetBatches() const
+	{
+		return batches;
+	}
+
+	unsigned IndirectDrawList::GetNumDraws() const
+	{
+		return static_cast<unsigned>(draws.size());
+	}
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Math/Matrix.h"
+
+#include <span>
+#include <vector>
+
+namespace gem
+{
+	// Matches the layout read by glMultiDrawElementsIndirect().
+	struct DrawElementsIndirectCommand
+	{
+		unsigned count = 0;
+		unsigned instanceCount = 1;
+		unsigned firstIndex = 0;
+		int baseVertex = 0;
+		unsigned baseInstance = 0;
+	};
+	static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+	// The transforms of a single draw. Shaders read these from a storage buffer using gl_DrawID,
+	// in place of the Gem_Model_Uniforms block. The normal matrix is padded to a mat4 to match std430.
+	struct IndirectDrawData
+	{
+		mat4 MVP;
+		mat4 modelView;
+		mat4 model;
+		mat4 invModel;
+		mat4 normalToWorld;
+	};
+	static_assert(sizeof(IndirectDrawData) == sizeof(float) * 16 * 5);
+
+	// Gathers the visible draws of a frame and arranges them into contiguous batches which can each be
+	// submitted with a single multi-draw. Culled draws are simply never added, so the commands are always compact.
+	// Building the list has no dependency on OpenGL.
+	class IndirectDrawList
+	{
+	public:
+		// A run of commands sharing the same render state and geometry pool.
+		struct Batch
+		{
+			unsigned group;
+			unsigned pool;
+			unsigned firstCommand;
+			unsigned numCommands;
+		};
+
+		// 'group' identifies the render state, such as the Material, and 'pool' identifies the shared buffers the command reads from.
+		void Add(unsigned group, unsigned pool, const DrawElementsIndirectCommand& command, const IndirectDrawData& data);
+
+		// Sorts the draws by group, then by pool, and splits them into batches.
+		// Draws within a batch keep the order they were added in.
+		void Build();
+		void Clear();
+
+		// Only valid after Build(). The draw data is in the same order as the commands.
+		std::span<const DrawElementsIndirectCommand> GetCommands() const;
+		std::span<const IndirectDrawData> GetDrawData() const;
+		std::span<const Batch> GetBatches() const;
+
+		unsigned GetNumDraws() const;
+
+	private:
+		struct Draw
+		{
+			unsigned group;
+			unsigned pool;
+			DrawElementsIndirectCommand command;
+			IndirectDrawData data;
+		};
+
+		std::vector<Draw> draws;
+
+		std::vector<DrawElementsIndirectCommand> commands;
+		std::vector<IndirectDrawData> drawData;
+		std::vector<Batch> batches;
+	};
+}
@@ -2,6 +2,8 @@
 #include "Light.h"
 #include "gemcutter/Math/Math.h"
 
+#include <limits>
+
 namespace gem
 {
 	Light::Light(Entity& _owner)
@@ -62,6 +64,32 @@ namespace gem
 		}
 	}
 
+	float Light::GetRange() const
+	{
+		// The brightest channel must be attenuated below 1/256th.
+		// This matches the attenuation in the shader header: 1 / (0.75 + linear * d + quadratic * d^2).
+		const vec3 rgb = color.Get();
+		const float constant = 0.75f - Max(rgb.x, rgb.y, rgb.z) * 256.0f;
+		if (constant >= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		const float linear = attenuationLinear.Get();
+		const float quadratic = attenuationQuadratic.Get();
+		if (quadratic > 0.0f)
+		{
+			return (-linear + std::sqrt(linear * linear - 4.0f * quadratic * constant)) / (2.0f * quadratic);
+		}
+
+		if (linear > 0.0f)
+		{
+			return -constant / linear;
+		}
+
+		return std::numeric_limits<float>::infinity();
+	}
+
 	UniformBuffer::Ptr& Light::GetBuffer()
 	{
 		return lightBuffer;
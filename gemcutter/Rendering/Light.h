@@ -34,6 +34,10 @@ namespace gem
 		// Keeps the internal buffer up to date with the light's transform.
 		void Update();
 
+		// Returns the distance at which the light's contribution becomes imperceptible.
+		// Returns zero if the light is too dim to be seen, and infinity if it is not attenuated.
+		float GetRange() const;
+
 		UniformBuffer::Ptr& GetBuffer();
 
 	private:
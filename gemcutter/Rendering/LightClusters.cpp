@@ -0,0 +1,301 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "LightClusters.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
+#include "gemcutter/Math/Matrix.h"
+
+#include <limits>
+
+namespace
+{
+	gem::vec3 Unproject(const gem::mat4& inverseProjection, float x, float y, float z)
+	{
+		gem::vec4 result = inverseProjection * gem::vec4(x, y, z, 1.0f);
+		return gem::vec3(result.x, result.y, result.z) / result.w;
+	}
+}
+
+namespace gem
+{
+	void LightClusters::SetGrid(unsigned _sizeX, unsigned _sizeY, unsigned _sizeZ, const mat4& inverseProjection, float _zNear, float _zFar)
+	{
+		ASSERT(_sizeX > 0 && _sizeY > 0 && _sizeZ > 0, "The grid must have at least one cluster along each axis.");
+		ASSERT(_zNear > 0.0f && _zFar > _zNear, "Invalid depth range ( %f, %f ).", _zNear, _zFar);
+
+		sizeX = _sizeX;
+		sizeY = _sizeY;
+		sizeZ = _sizeZ;
+		zNear = _zNear;
+		zFar = _zFar;
+
+		const float logRange = std::log(zFar / zNear);
+		sliceScale = static_cast<float>(sizeZ) / logRange;
+		sliceBias = sliceScale * std::log(zNear);
+
+		const unsigned numClusters = GetNumClusters();
+		for (auto* array : { &minX, &minY, &minZ, &maxX, &maxY, &maxZ, &centerX, &centerY, &centerZ, &radius })
+		{
+			array->resize(numClusters);
+		}
+		hits.resize(numClusters);
+
+		std::vector<float> sliceDepths(sizeZ + 1);
+		for (unsigned z = 0; z <= sizeZ; ++z)
+		{
+			sliceDepths[z] = zNear * std::exp(logRange * static_cast<float>(z) / static_cast<float>(sizeZ));
+		}
+
+		for (unsigned y = 0; y < sizeY; ++y)
+		{
+			for (unsigned x = 0; x < sizeX; ++x)
+			{
+				// The tile's corners on the near and far planes. Each edge between them is a line of constant screen position.
+				vec3 nearCorners[4];
+				vec3 farCorners[4];
+				for (unsigned i = 0; i < 4; ++i)
+				{
+					const float ndcX = -1.0f + 2.0f * static_cast<float>(x + (i & 1)) / static_cast<float>(sizeX);
+					const float ndcY = -1.0f + 2.0f * static_cast<float>(y + (i >> 1)) / static_cast<float>(sizeY);
+					nearCorners[i] = Unproject(inverseProjection, ndcX, ndcY, -1.0f);
+					farCorners[i] = Unproject(inverseProjection, ndcX, ndcY, 1.0f);
+				}
+
+				for (unsigned z = 0; z < sizeZ; ++z)
+				{
+					vec3 min(std::numeric_limits<float>::max());
+					vec3 max(std::numeric_limits<float>::lowest());
+
+					for (float depth : { sliceDepths[z], sliceDepths[z + 1] })
+					{
+						for (unsigned i = 0; i < 4; ++i)
+						{
+							const float t = (depth + nearCorners[i].z) / (nearCorners[i].z - farCorners[i].z);
+							const vec3 point = nearCorners[i] + (farCorners[i] - nearCorners[i]) * t;
+
+							min = Min(min, point);
+							max = Max(max, point);
+						}
+					}
+
+					const unsigned cluster = GetCluster(x, y, z);
+					minX[cluster] = min.x;
+					minY[cluster] = min.y;
+					minZ[cluster] = min.z;
+					maxX[cluster] = max.x;
+					maxY[cluster] = max.y;
+					maxZ[cluster] = max.z;
+
+					const vec3 center = (min + max) * 0.5f;
+					centerX[cluster] = center.x;
+					centerY[cluster] = center.y;
+					centerZ[cluster] = center.z;
+					radius[cluster] = Length(max - center);
+				}
+			}
+		}
+
+		Clear();
+		Build();
+	}
+
+	void LightClusters::Clear()
+	{
+		assignments.clear();
+	}
+
+	void LightClusters::AddPointLight(unsigned index, const vec3& position, float lightRadius)
+	{
+		unsigned first, last;
+		if (!GetSliceRange(-position.z, lightRadius, first, last))
+		{
+			return;
+		}
+
+		const float radiusSquared = lightRadius * lightRadius;
+
+		// Kept free of branches, so that the compiler can test several clusters at once.
+		for (unsigned i = first; i < last; ++i)
+		{
+			const float dx = Max(minX[i] - position.x, 0.0f, position.x - maxX[i]);
+			const float dy = Max(minY[i] - position.y, 0.0f, position.y - maxY[i]);
+			const float dz = Max(minZ[i] - position.z, 0.0f, position.z - maxZ[i]);
+
+			hits[i] = (dx * dx + dy * dy + dz * dz) <= radiusSquared;
+		}
+
+		Assign(index, first, last);
+	}
+
+	void LightClusters::AddSpotLight(unsigned index, const vec3& position, const vec3& direction, float lightRadius, float cosHalfAngle)
+	{
+		// The cone test only holds for cones narrower than a hemisphere.
+		if (cosHalfAngle <= 0.0f)
+		{
+			AddPointLight(index, position, lightRadius);
+			return;
+		}
+
+		unsigned first, last;
+		if (!GetSliceRange(-position.z, lightRadius, first, last))
+		{
+			return;
+		}
+
+		const float radiusSquared = lightRadius * lightRadius;
+		const float sinHalfAngle = std::sqrt(1.0f - cosHalfAngle * cosHalfAngle);
+
+		for (unsigned i = first; i < last; ++i)
+		{
+			const float dx = Max(minX[i] - position.x, 0.0f, position.x - maxX[i]);
+			const float dy = Max(minY[i] - position.y, 0.0f, position.y - maxY[i]);
+			const float dz = Max(minZ[i] - position.z, 0.0f, position.z - maxZ[i]);
+			const bool inSphere = (dx * dx + dy * dy + dz * dz) <= radiusSquared;
+
+			// Tests the cluster's bounding sphere against the cone.
+			const float vx = centerX[i] - position.x;
+			const float vy = centerY[i] - position.y;
+			const float vz = centerZ[i] - position.z;
+			const float lengthSquared = vx * vx + vy * vy + vz * vz;
+			const float alongAxis = vx * direction.x + vy * direction.y + vz * direction.z;
+			const float fromAxis = std::sqrt(Max(lengthSquared - alongAxis * alongAxis, 0.0f));
+			const float distanceToCone = cosHalfAngle * fromAxis - alongAxis * sinHalfAngle;
+			const bool inCone = distanceToCone <= radius[i] && alongAxis >= -radius[i];
+
+			hits[i] = inSphere & inCone;
+		}
+
+		Assign(index, first, last);
+	}
+
+	void LightClusters::Build()
+	{
+		const unsigned numClusters = GetNumClusters();
+
+		// Count the lights of each cluster.
+		grid.assign(numClusters, 0);
+		for (const Assignment& assignment : assignments)
+		{
+			grid[assignment.cluster]++;
+		}
+
+		// Reserve a contiguous range of indices for each cluster.
+		uint32_t offset = 0;
+		for (uint32_t& entry : grid)
+		{
+			const uint32_t count = Min(entry, MaxLightsPerCluster);
+			entry = offset << 8;
+			offset += count;
+		}
+
+		ASSERT(offset < (1u << 24), "Too many light assignments ( %u ) to be packed.", offset);
+
+		// Lights were added in order, so each cluster's list is sorted.
+		indices.resize(offset);
+		for (const Assignment& assignment : assignments)
+		{
+			uint32_t& entry = grid[assignment.cluster];
+			const uint32_t count = entry & 0xFF;
+			if (count < MaxLightsPerCluster)
+			{
+				indices[(entry >> 8) + count] = assignment.light;
+				entry++;
+			}
+		}
+	}
+
+	unsigned LightClusters::GetCluster(unsigned x, unsigned y, unsigned z) const
+	{
+		ASSERT(x < sizeX && y < sizeY && z < sizeZ, "Cluster ( %u, %u, %u ) is out of bounds.", x, y, z);
+
+		return x + sizeX * (y + sizeY * z);
+	}
+
+	std::span<const uint32_t> LightClusters::GetLights(unsigned cluster) const
+	{
+		ASSERT(cluster < grid.size(), "Cluster ( %u ) is out of bounds.", cluster);
+
+		const uint32_t entry = grid[cluster];
+		return { indices.data() + (entry >> 8), entry & 0xFF };
+	}
+
+	unsigned LightClusters::GetSlice(float depth) const
+	{
+		if (depth <= zNear)
+		{
+			return 0;
+		}
+
+		const float slice = std::floor(std::log(depth) * sliceScale - sliceBias);
+		return static_cast<unsigned>(Clamp(slice, 0.0f, static_cast<float>(sizeZ - 1)));
+	}
+
+	const std::vector<uint32_t>& LightClusters::GetGrid() const
+	{
+		return grid;
+	}
+
+	const std::vector<uint32_t>& LightClusters::GetIndices() const
+	{
+		return indices;
+	}
+
+	unsigned LightClusters::GetSizeX() const
+	{
+		return sizeX;
+	}
+
+	unsigned LightClusters::GetSizeY() const
+	{
+		return sizeY;
+	}
+
+	unsigned LightClusters::GetSizeZ() const
+	{
+		return sizeZ;
+	}
+
+	unsigned LightClusters::GetNumClusters() const
+	{
+		return sizeX * sizeY * sizeZ;
+	}
+
+	float LightClusters::GetSliceScale() const
+	{
+		return sliceScale;
+	}
+
+	float LightClusters::GetSliceBias() const
+	{
+		return sliceBias;
+	}
+
+	bool LightClusters::GetSliceRange(float centerDepth, float lightRadius, unsigned& first, unsigned& last) const
+	{
+		ASSERT(sizeX > 0, "SetGrid() must be called before lights are added.");
+
+		const float nearest = centerDepth - lightRadius;
+		const float farthest = centerDepth + lightRadius;
+		if (farthest < zNear || nearest > zFar)
+		{
+			return false;
+		}
+
+		// Slices are stored contiguously, so the range can be converted directly to clusters.
+		const unsigned sliceSize = sizeX * sizeY;
+		first = GetSlice(nearest) * sliceSize;
+		last = (GetSlice(farthest) + 1) * sliceSize;
+
+		return true;
+	}
+
+	void LightClusters::Assign(unsigned index, unsigned first, unsigned last)
+	{
+		for (unsigned i = first; i < last; ++i)
+		{
+			if (hits[i])
+			{
+				assignments.push_back({ i, index });
+			}
+		}
+	}
+}
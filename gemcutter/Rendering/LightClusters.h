@@ -0,0 +1,84 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Math/Vector.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gem
+{
+	struct mat4;
+
+	// Divides a camera's view volume into a grid of clusters, and lists the lights which can reach each one.
+	// Clusters are tiles of the screen, cut into slices which grow exponentially deeper along the view direction.
+	// All positions and directions are in view-space. This has no dependency on OpenGL.
+	class LightClusters
+	{
+	public:
+		// Lights beyond this count are not listed in a cluster.
+		static constexpr unsigned MaxLightsPerCluster = 255;
+
+		// Sets the number of clusters along each axis, and rebuilds their bounds for the given projection.
+		// Tiles are ordered from the bottom-left of the screen, and slices from the near plane.
+		void SetGrid(unsigned sizeX, unsigned sizeY, unsigned sizeZ, const mat4& inverseProjection, float zNear, float zFar);
+
+		// Removes the lights of the previous frame.
+		void Clear();
+		// 'index' is the light's position in the packed light buffer. Lights must be added in order of their index.
+		void AddPointLight(unsigned index, const vec3& position, float lightRadius);
+		void AddSpotLight(unsigned index, const vec3& position, const vec3& direction, float lightRadius, float cosHalfAngle);
+		// Gathers the lights of each cluster into contiguous lists.
+		void Build();
+
+		unsigned GetCluster(unsigned x, unsigned y, unsigned z) const;
+		// Returns the indices of the lights reaching the cluster, in ascending order. Only valid after Build().
+		std::span<const uint32_t> GetLights(unsigned cluster) const;
+		// Returns the slice containing the given distance from the camera.
+		unsigned GetSlice(float depth) const;
+
+		// One element per cluster, packed as (offset << 8) | count. The offset indexes into GetIndices().
+		const std::vector<uint32_t>& GetGrid() const;
+		const std::vector<uint32_t>& GetIndices() const;
+
+		unsigned GetSizeX() const;
+		unsigned GetSizeY() const;
+		unsigned GetSizeZ() const;
+		unsigned GetNumClusters() const;
+
+		// A depth's slice is floor(log(depth) * scale - bias).
+		float GetSliceScale() const;
+		float GetSliceBias() const;
+
+	private:
+		// Returns the range of clusters in the slices overlapped by a sphere, or false if it is outside of the view volume.
+		bool GetSliceRange(float centerDepth, float lightRadius, unsigned& first, unsigned& last) const;
+		// Assigns the light to each cluster in the range whose flag has been set in 'hits'.
+		void Assign(unsigned index, unsigned first, unsigned last);
+
+		unsigned sizeX = 0;
+		unsigned sizeY = 0;
+		unsigned sizeZ = 0;
+		float zNear = 1.0f;
+		float zFar = 1000.0f;
+		float sliceScale = 0.0f;
+		float sliceBias = 0.0f;
+
+		// The view-space bounds of each cluster, stored as separate arrays so that tests can be vectorized.
+		std::vector<float> minX, minY, minZ;
+		std::vector<float> maxX, maxY, maxZ;
+		// Bounding spheres of the clusters, for cone tests.
+		std::vector<float> centerX, centerY, centerZ, radius;
+		std::vector<uint8_t> hits;
+
+		struct Assignment
+		{
+			uint32_t cluster;
+			uint32_t light;
+		};
+		std::vector<Assignment> assignments;
+
+		std::vector<uint32_t> grid;
+		std::vector<uint32_t> indices;
+	};
+}
@@ -2,6 +2,17 @@
 #include "ParticleEmitter.h"
 #include "gemcutter/Application/Application.h"
 #include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
+
+namespace
+{
+	const gem::ShaderKeyword GEM_PARTICLE_LOCAL_SPACE("GEM_PARTICLE_LOCAL_SPACE");
+	const gem::ShaderKeyword GEM_PARTICLE_SIZE("GEM_PARTICLE_SIZE");
+	const gem::ShaderKeyword GEM_PARTICLE_COLOR("GEM_PARTICLE_COLOR");
+	const gem::ShaderKeyword GEM_PARTICLE_ALPHA("GEM_PARTICLE_ALPHA");
+	const gem::ShaderKeyword GEM_PARTICLE_ROTATION("GEM_PARTICLE_ROTATION");
+	const gem::ShaderKeyword GEM_PARTICLE_AGERATIO("GEM_PARTICLE_AGERATIO");
+}
 
 namespace gem
 {
@@ -125,7 +136,7 @@ namespace gem
 		if (localSpace == isLocal)
 			return;
 
-		variants.Switch("GEM_PARTICLE_LOCAL_SPACE", isLocal);
+		variants.Switch(GEM_PARTICLE_LOCAL_SPACE, isLocal);
 
 		vec3 transform;
 		if (isLocal)
@@ -162,6 +173,11 @@ namespace gem
 		return *particleParameters;
 	}
 
+	RandomStream& ParticleEmitter::GetRandomStream()
+	{
+		return random;
+	}
+
 	void ParticleEmitter::UpdateInternal(float deltaTime)
 	{
 		ASSERT(spawnPerSecond >= 0.0f, "'spawnPerSecond' cannot be a negative value.");
@@ -180,11 +196,11 @@ namespace gem
 				!requirements.Has(ParticleAttributes::Alpha);
 
 			/* Update shader variant to match the buffers and effect requirements */
-			variants.Switch("GEM_PARTICLE_SIZE", requirements.Has(ParticleAttributes::Size));
-			variants.Switch("GEM_PARTICLE_COLOR", requirements.Has(ParticleAttributes::Color));
-			variants.Switch("GEM_PARTICLE_ALPHA", requirements.Has(ParticleAttributes::Alpha));
-			variants.Switch("GEM_PARTICLE_ROTATION", requirements.Has(ParticleAttributes::Rotation));
-			variants.Switch("GEM_PARTICLE_AGERATIO", requiresAgeRatio);
+			variants.Switch(GEM_PARTICLE_SIZE, requirements.Has(ParticleAttributes::Size));
+			variants.Switch(GEM_PARTICLE_COLOR, requirements.Has(ParticleAttributes::Color));
+			variants.Switch(GEM_PARTICLE_ALPHA, requirements.Has(ParticleAttributes::Alpha));
+			variants.Switch(GEM_PARTICLE_ROTATION, requirements.Has(ParticleAttributes::Rotation));
+			variants.Switch(GEM_PARTICLE_AGERATIO, requiresAgeRatio);
 
 			if (requiresAgeRatio)
 			{
@@ -220,32 +236,39 @@ namespace gem
 
 		/* Create new particles */
 		numToSpawn += spawnPerSecond * deltaTime;
-		unsigned initialCount = numCurrentParticles;
-
-		while (
-			// We have not reached the particle cap and...
-			numCurrentParticles < maxParticles &&
-			// We have more particles to generate this frame...
-			numToSpawn >= 1.0f)
+		const unsigned initialCount = numCurrentParticles;
+		// Spawn as many whole particles as we can without exceeding the particle cap.
+		const unsigned spawnCount = Min(static_cast<unsigned>(numToSpawn), maxParticles - numCurrentParticles);
+		numToSpawn -= static_cast<float>(spawnCount);
+		numCurrentParticles += spawnCount;
+
+		const std::span newPositions(data.positions + initialCount, spawnCount);
+		if (spawnType == Type::Omni)
 		{
-			if (spawnType == Type::Omni)
+			random.FillDirections(newPositions);
+			for (vec3& position : newPositions)
 			{
-				data.positions[numCurrentParticles] = RandomDirection() * radius.Random();
+				position *= radius.Random(random);
 			}
-			else
+		}
+		else
+		{
+			for (vec3& position : newPositions)
 			{
-				data.positions[numCurrentParticles] = vec3(axisX.Random(), axisY.Random(), axisZ.Random());
+				position = vec3(axisX.Random(random), axisY.Random(random), axisZ.Random(random));
 			}
+		}
 
-			// Distribute lifetime between frames.
-			data.ages[numCurrentParticles] = RandomRange(0.0f, deltaTime);
-			data.lifetimes[numCurrentParticles] = lifetime.Random();
-
-			// Send the particle in a random direction, with a velocity between our range.
-			data.velocities[numCurrentParticles] = RandomDirection() * velocity.Random();
+		// Distribute lifetime between frames.
+		random.FillRange({ data.ages + initialCount, spawnCount }, 0.0f, deltaTime);
+		random.FillRange({ data.lifetimes + initialCount, spawnCount }, lifetime.min, lifetime.max);
 
-			numCurrentParticles++;
-			numToSpawn -= 1.0f;
+		// Send the particles in a random direction, with a velocity between our range.
+		const std::span newVelocities(data.velocities + initialCount, spawnCount);
+		random.FillDirections(newVelocities);
+		for (vec3& newVelocity : newVelocities)
+		{
+			newVelocity *= velocity.Random(random);
 		}
 
 		// Transform new particles into the correct space.
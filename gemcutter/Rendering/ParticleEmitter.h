@@ -51,6 +51,9 @@ namespace gem
 		const UniformBuffer& GetBuffer() const;
 		UniformBuffer& GetBuffer();
 
+		// The emitter's own random sequence. Can be used by ParticleFunctors when initializing particles.
+		RandomStream& GetRandomStream();
+
 		// Custom Particle Functors can be added her to customize the behaviour of the emitter.
 		FunctorList functors;
 
@@ -75,6 +78,7 @@ namespace gem
 		void InitUniformBuffer();
 
 		ParticleBuffer data;
+		RandomStream random;
 
 		float numToSpawn = 0.0f;
 		bool requiresAgeRatio = false;
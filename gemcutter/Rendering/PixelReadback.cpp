@@ -0,0 +1,221 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "PixelReadback.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
+#include "gemcutter/Rendering/Rendering.h"
+#include "gemcutter/Rendering/RenderTarget.h"
+
+#include <GL/glew.h>
+
+namespace
+{
+	struct ReadFormat
+	{
+		GLenum format;
+		GLenum type;
+		unsigned pixelSize;
+	};
+
+	// Pixels are always read as four channels so that they are tightly packed, regardless of the texture's format.
+	ReadFormat ResolveReadFormat(gem::TextureFormat format)
+	{
+		using gem::TextureFormat;
+
+		switch (format)
+		{
+		case TextureFormat::R_8:
+		case TextureFormat::RGB_8:
+		case TextureFormat::RGBA_8:
+		case TextureFormat::sRGB_8:
+		case TextureFormat::sRGBA_8:
+			return { GL_RGBA, GL_UNSIGNED_BYTE, 4 };
+
+		case TextureFormat::R_16:
+		case TextureFormat::RGB_16:
+		case TextureFormat::RGBA_16:
+			return { GL_RGBA, GL_UNSIGNED_SHORT, 8 };
+
+		case TextureFormat::R_32:
+		case TextureFormat::RGB_32:
+		case TextureFormat::RGBA_32:
+			return { GL_RGBA_INTEGER, GL_UNSIGNED_INT, 16 };
+
+		default:
+			return { GL_RGBA, GL_FLOAT, 16 };
+		}
+	}
+}
+
+namespace gem
+{
+	PixelReadback::~PixelReadback()
+	{
+		Unload();
+	}
+
+	ReadbackHandle PixelReadback::ReadRegion(const RenderTarget& target, unsigned index, int x, int y, unsigned width, unsigned height)
+	{
+		ASSERT(width > 0 && height > 0, "The region must contain at least one pixel.");
+		ASSERT(x >= 0 && y >= 0 && static_cast<unsigned>(x) + width <= target.GetWidth() && static_cast<unsigned>(y) + height <= target.GetHeight(),
+			"The region must be within the bounds of the RenderTarget.");
+
+		const ReadFormat read = ResolveReadFormat(target.GetColorTexture(index)->GetFormat());
+
+		const ReadbackHandle handle = Begin(target, index, static_cast<size_t>(width) * height * read.pixelSize);
+		if (handle.IsValid())
+		{
+			glReadPixels(x, y, width, height, read.format, read.type, nullptr);
+			End(handle);
+		}
+
+		return handle;
+	}
+
+	ReadbackHandle PixelReadback::ReadAll(const RenderTarget& target, unsigned index)
+	{
+		return ReadRegion(target, index, 0, 0, target.GetWidth(), target.GetHeight());
+	}
+
+	ReadbackHandle PixelReadback::ReadPixels(const RenderTarget& target, unsigned index, std::span<const Coord> pixels)
+	{
+		ASSERT(!pixels.empty(), "Must provide at least one pixel to read.");
+
+		const ReadFormat read = ResolveReadFormat(target.GetColorTexture(index)->GetFormat());
+
+		const ReadbackHandle handle = Begin(target, index, pixels.size() * read.pixelSize);
+		if (handle.IsValid())
+		{
+			// Each copy is written into the pixel buffer at its own offset, so nothing waits on the GPU.
+			size_t offset = 0;
+			for (const Coord& pixel : pixels)
+			{
+				ASSERT(pixel.x >= 0 && pixel.y >= 0 &&
+					static_cast<unsigned>(pixel.x) < target.GetWidth() && static_cast<unsigned>(pixel.y) < target.GetHeight(),
+					"Pixel ( %d, %d ) is not within the bounds of the RenderTarget.", pixel.x, pixel.y);
+
+				glReadPixels(pixel.x, pixel.y, 1, 1, read.format, read.type, reinterpret_cast<void*>(offset));
+				offset += read.pixelSize;
+			}
+
+			End(handle);
+		}
+
+		return handle;
+	}
+
+	bool PixelReadback::IsReady(ReadbackHandle handle) const
+	{
+		return ring.IsReady(handle);
+	}
+
+	std::span<const std::byte> PixelReadback::Map(ReadbackHandle handle)
+	{
+		if (!ring.IsValid(handle))
+		{
+			Error("PixelReadback: The readback has already been released, or was never issued.");
+			return {};
+		}
+
+		Buffer& buffer = buffers[handle.slot];
+		if (!buffer.mapped)
+		{
+			ring.Wait(handle);
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+			buffer.mapped = static_cast<const std::byte*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, buffer.size, GL_MAP_READ_BIT));
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, GL_NONE);
+
+			if (!buffer.mapped)
+			{
+				Error("PixelReadback: Failed to map the pixel buffer.");
+				return {};
+			}
+		}
+
+		return { buffer.mapped, buffer.size };
+	}
+
+	void PixelReadback::Release(ReadbackHandle handle)
+	{
+		if (!ring.IsValid(handle))
+		{
+			return;
+		}
+
+		Buffer& buffer = buffers[handle.slot];
+		if (buffer.mapped)
+		{
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, GL_NONE);
+
+			buffer.mapped = nullptr;
+		}
+
+		ring.Release(handle);
+	}
+
+	void PixelReadback::Unload()
+	{
+		for (unsigned i = 0; i < SlotCount; ++i)
+		{
+			Buffer& buffer = buffers[i];
+			if (buffer.handle == GL_NONE)
+			{
+				continue;
+			}
+
+			if (buffer.mapped)
+			{
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+				glBindBuffer(GL_PIXEL_PACK_BUFFER, GL_NONE);
+			}
+
+			glDeleteBuffers(1, &buffer.handle);
+			buffer = {};
+		}
+
+		ring.ReleaseAll();
+	}
+
+	ReadbackHandle PixelReadback::Begin(const RenderTarget& target, unsigned index, size_t size)
+	{
+		ASSERT(index < target.GetNumColorTextures(), "'index' must specify a valid color texture.");
+		ASSERT(!target.IsMultisampled(), "RenderTarget must not be multi-sampled.");
+
+		const ReadbackHandle handle = ring.Acquire();
+		if (!handle.IsValid())
+		{
+			return handle;
+		}
+
+		Buffer& buffer = buffers[handle.slot];
+		if (buffer.handle == GL_NONE)
+		{
+			glGenBuffers(1, &buffer.handle);
+		}
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.handle);
+		if (size > buffer.capacity)
+		{
+			// Slots are reused for reads of all sizes, so they only ever grow.
+			buffer.capacity = Max(size, buffer.capacity * 2);
+			glBufferData(GL_PIXEL_PACK_BUFFER, buffer.capacity, nullptr, GL_STREAM_READ);
+		}
+		buffer.size = size;
+
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, target.FBO);
+		glReadBuffer(GL_COLOR_ATTACHMENT0 + index);
+
+		return handle;
+	}
+
+	void PixelReadback::End(ReadbackHandle handle)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, GL_NONE);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, GL_NONE);
+
+		ring.Submit(handle);
+	}
+}
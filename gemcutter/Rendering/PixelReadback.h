@@ -0,0 +1,96 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Rendering/Fence.h"
+#include "gemcutter/Rendering/ReadbackRing.h"
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+namespace gem
+{
+	class RenderTarget;
+
+	// Copies pixels from a RenderTarget into pixel buffers without waiting for the GPU to finish rendering them.
+	// The results can be collected once IsReady() returns true, usually a frame or two later.
+	// Usage for object picking:
+	// {
+	//    if (!pending.IsValid())
+	//        pending = readback.ReadRegion(*target, 1, mouseX, mouseY, 1, 1);
+	//
+	//    if (readback.IsReady(pending))
+	//    {
+	//        unsigned id = readback.MapAs<unsigned>(pending)[0];
+	//        readback.Release(pending);
+	//        pending = {};
+	//    }
+	// }
+	// Each pixel is returned as four channels, of the same type used by RenderTarget::ReadPixel() for the texture's format.
+	// Single channel textures return zero for green and blue, and one for alpha.
+	class PixelReadback
+	{
+	public:
+		// The number of readbacks which can be in flight at once.
+		static constexpr unsigned SlotCount = 4;
+
+		struct Coord
+		{
+			int x = 0;
+			int y = 0;
+		};
+
+		PixelReadback() = default;
+		~PixelReadback();
+
+		PixelReadback(const PixelReadback&) = delete;
+		PixelReadback(PixelReadback&&) = delete;
+		PixelReadback& operator=(const PixelReadback&) = delete;
+		PixelReadback& operator=(PixelReadback&&) = delete;
+
+		// Starts copying a region of the specified color texture. Rows are returned from the bottom of the region up.
+		// Returns an invalid handle if every slot is still in use.
+		ReadbackHandle ReadRegion(const RenderTarget& target, unsigned index, int x, int y, unsigned width, unsigned height);
+		// Starts copying the entire color texture, such as for a screenshot or a frame of video capture.
+		ReadbackHandle ReadAll(const RenderTarget& target, unsigned index);
+		// Starts copying each of the given pixels. The results are packed together in the same order.
+		ReadbackHandle ReadPixels(const RenderTarget& target, unsigned index, std::span<const Coord> pixels);
+
+		// Returns true once the GPU has finished the copy, and the result can be mapped without blocking.
+		bool IsReady(ReadbackHandle handle) const;
+		// Returns the result of the readback, which remains valid until it is released.
+		// If the copy has not yet finished, this blocks until it does.
+		std::span<const std::byte> Map(ReadbackHandle handle);
+		// Returns the result of the readback as channels of the given type.
+		template<typename T>
+		std::span<const T> MapAs(ReadbackHandle handle);
+		// Frees the slot of the readback. The handle, along with any previously mapped result, becomes invalid.
+		void Release(ReadbackHandle handle);
+
+		// Releases all readbacks and deletes the pixel buffers.
+		void Unload();
+
+	private:
+		// Claims a slot with enough room for the result, and binds it for the copy.
+		ReadbackHandle Begin(const RenderTarget& target, unsigned index, size_t size);
+		// Fences the copy and restores the bindings.
+		void End(ReadbackHandle handle);
+
+		struct Buffer
+		{
+			unsigned handle = 0;
+			size_t capacity = 0;
+			size_t size = 0;
+			const std::byte* mapped = nullptr;
+		};
+
+		ReadbackRing<Fence, SlotCount> ring;
+		std::array<Buffer, SlotCount> buffers;
+	};
+
+	template<typename T>
+	std::span<const T> PixelReadback::MapAs(ReadbackHandle handle)
+	{
+		std::span<const std::byte> bytes = Map(handle);
+		return { reinterpret_cast<const T*>(bytes.data()), bytes.size() / sizeof(T) };
+	}
+}
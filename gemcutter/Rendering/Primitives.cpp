@@ -1,10 +1,13 @@
 // Copyright (c) 2017 Emilian Cioca
 #include "Primitives.h"
 #include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
 #include "gemcutter/Math/Vector.h"
+#include "gemcutter/Rendering/StateCache.h"
 #include "gemcutter/Resource/Texture.h"
 
 #include <GL/glew.h>
+#include <cstddef>
 
 namespace
 {
@@ -290,6 +293,34 @@ namespace
 		}
 	)";
 
+	constexpr std::string_view DEBUG_PROGRAM = R"(
+		Attributes{
+			vec3 a_vert : 0;
+			vec4 a_color : 1;
+		}
+		Vertex{
+			out vec4 color;
+			void main()
+			{
+				color = a_color;
+				gl_Position = Gem_ViewProj * vec4(a_vert, 1.0);
+			}
+		}
+		Fragment{
+			in vec4 color;
+			out vec4 outColor;
+			void main()
+			{
+				outColor = color;
+			}
+		}
+	)";
+
+	// The initial capacity of the debug vertex stream, in vertices per frame.
+	constexpr unsigned DEBUG_VERTEX_CAPACITY = 4096;
+	// The number of frames of debug vertices which fit in the stream at once.
+	constexpr unsigned DEBUG_STREAM_FRAMES = 3;
+
 	constexpr float unitQuad_Data[30] =
 	{
 		-1.0f, -1.0f, 0.0f, // vec3 Vertex
@@ -451,6 +482,13 @@ namespace gem
 			return false;
 		}
 
+		if (!debugProgram.LoadFromSource(DEBUG_PROGRAM))
+		{
+			Error("Primitives: ( Debug )\nFailed to initialize.");
+			Unload();
+			return false;
+		}
+
 		{
 			auto buffer = VertexBuffer::MakeNew(static_cast<unsigned>(sizeof(quad_Data)), quad_Data, BufferUsage::Static, VertexBufferType::Data);
 
@@ -514,9 +552,13 @@ namespace gem
 			unitCubeArray->SetVertexCount(36);
 		}
 
+		debugStream.emplace(DEBUG_VERTEX_CAPACITY * DEBUG_STREAM_FRAMES * static_cast<unsigned>(sizeof(DebugVertex)));
+		debugArray = VertexArray::MakeNew();
+		CreateDebugStreams();
+
+		// The first bind creates the vertex array object.
 		glGenVertexArrays(1, &dummyVAO);
-		glBindVertexArray(dummyVAO);
-		glBindVertexArray(GL_NONE);
+		GLState.BindVertexArray(dummyVAO);
 
 		isLoaded = true;
 		return true;
@@ -536,11 +578,15 @@ namespace gem
 		texturedTriangleProgram.Unload();
 		texturedRectangleProgram.Unload();
 		texturedFullScreenQuadProgram.Unload();
+		debugProgram.Unload();
 
 		quadArray.reset();
 		unitQuadArray.reset();
 		unitCubeArray.reset();
+		debugArray.reset();
+		debugStream.reset();
 
+		GLState.OnVertexArrayDeleted(dummyVAO);
 		glDeleteVertexArrays(1, &dummyVAO);
 		dummyVAO = GL_NONE;
 
@@ -562,9 +608,8 @@ namespace gem
 		lineProgram.buffers[0].SetUniform("uC2", color2);
 		lineProgram.Bind();
 
-		glBindVertexArray(dummyVAO);
+		GLState.BindVertexArray(dummyVAO);
 		glDrawArrays(GL_POINTS, 0, 1);
-		glBindVertexArray(GL_NONE);
 
 		lineProgram.UnBind();
 	}
@@ -579,9 +624,8 @@ namespace gem
 		lineProgram.buffers[0].SetUniform("uP2", vec4(p2, 1.0f));
 		lineProgram.Bind();
 
-		glBindVertexArray(dummyVAO);
+		GLState.BindVertexArray(dummyVAO);
 		glDrawArrays(GL_POINTS, 0, 1);
-		glBindVertexArray(GL_NONE);
 
 		lineProgram.UnBind();
 
@@ -605,9 +649,8 @@ namespace gem
 		triangleProgram.buffers[0].SetUniform("uC3", color3);
 		triangleProgram.Bind();
 
-		glBindVertexArray(dummyVAO);
+		GLState.BindVertexArray(dummyVAO);
 		glDrawArrays(GL_POINTS, 0, 1);
-		glBindVertexArray(GL_NONE);
 
 		triangleProgram.UnBind();
 	}
@@ -623,9 +666,8 @@ namespace gem
 		texturedTriangleProgram.buffers[0].SetUniform("uP3", vec4(p3, 1.0f));
 		texturedTriangleProgram.Bind();
 
-		glBindVertexArray(dummyVAO);
+		GLState.BindVertexArray(dummyVAO);
 		glDrawArrays(GL_POINTS, 0, 1);
-		glBindVertexArray(GL_NONE);
 
 		texturedTriangleProgram.UnBind();
 
@@ -651,9 +693,8 @@ namespace gem
 		rectangleProgram.buffers[0].SetUniform("uC4", color4);
 		rectangleProgram.Bind();
 
-		glBindVertexArray(dummyVAO);
+		GLState.BindVertexArray(dummyVAO);
 		glDrawArrays(GL_POINTS, 0, 1);
-		glBindVertexArray(GL_NONE);
 
 		rectangleProgram.UnBind();
 	}
@@ -670,9 +711,8 @@ namespace gem
 		rectangleProgram.buffers[0].SetUniform("uP4", vec4(p4, 1.0f));
 		rectangleProgram.Bind();
 
-		glBindVertexArray(dummyVAO);
+		GLState.BindVertexArray(dummyVAO);
 		glDrawArrays(GL_POINTS, 0, 1);
-		glBindVertexArray(GL_NONE);
 
 		rectangleProgram.UnBind();
 
@@ -705,6 +745,108 @@ namespace gem
 		}
 	}
 
+	void PrimitivesSingleton::DrawDebug(const DebugDrawList& list)
+	{
+		ASSERT(IsLoaded(), "Primitives must be initialized to call this function.");
+
+		if (list.IsEmpty())
+		{
+			return;
+		}
+
+		const std::vector<DebugVertex>* batches[] = {
+			&list.GetLineVertices(DebugDepth::Tested),
+			&list.GetLineVertices(DebugDepth::Overlay),
+			&list.GetTriangleVertices(DebugDepth::Tested),
+			&list.GetTriangleVertices(DebugDepth::Overlay)
+		};
+
+		unsigned numVertices = 0;
+		for (const std::vector<DebugVertex>* batch : batches)
+		{
+			numVertices += static_cast<unsigned>(batch->size());
+		}
+
+		// Everything is written into one range of the stream, aligned so that it starts on a whole vertex.
+		constexpr unsigned vertexSize = sizeof(DebugVertex);
+		const unsigned size = numVertices * vertexSize;
+		unsigned offset = debugStream->Allocate(size, vertexSize);
+		if (offset == StreamBuffer::InvalidOffset)
+		{
+			debugStream->Resize(Max(size * DEBUG_STREAM_FRAMES, debugStream->GetCapacity() * 2));
+			CreateDebugStreams();
+
+			offset = debugStream->Allocate(size, vertexSize);
+		}
+
+		unsigned writeOffset = offset;
+		for (const std::vector<DebugVertex>* batch : batches)
+		{
+			const auto batchSize = static_cast<unsigned>(batch->size()) * vertexSize;
+			if (batchSize != 0)
+			{
+				debugStream->SetData(writeOffset, batchSize, batch->data());
+				writeOffset += batchSize;
+			}
+		}
+
+		SetBlendFunc(BlendFunc::Linear);
+		SetCullFunc(CullFunc::None);
+		debugProgram.Bind();
+		debugArray->Bind();
+
+		// Then each batch is drawn with a single call.
+		unsigned first = offset / vertexSize;
+		for (unsigned i = 0; i < std::size(batches); ++i)
+		{
+			const auto count = static_cast<unsigned>(batches[i]->size());
+			if (count != 0)
+			{
+				const bool isOverlay = (i % 2) == 1;
+				const bool isLine = i < 2;
+
+				SetDepthFunc(isOverlay ? DepthFunc::None : DepthFunc::TestOnly);
+				debugArray->SetVertexCount(count);
+				debugArray->Draw(first, isLine ? VertexArrayFormat::Line : VertexArrayFormat::Triangle);
+			}
+
+			first += count;
+		}
+
+		debugArray->UnBind();
+		debugProgram.UnBind();
+	}
+
+	void PrimitivesSingleton::EndFrame()
+	{
+		if (debugStream)
+		{
+			debugStream->EndFrame();
+		}
+	}
+
+	void PrimitivesSingleton::CreateDebugStreams()
+	{
+		debugArray->RemoveStreams();
+
+		debugArray->AddStream({
+			.buffer      = debugStream->GetBuffer(),
+			.bindingUnit = 0,
+			.format      = VertexFormat::Vec3,
+			.startOffset = offsetof(DebugVertex, position),
+			.stride      = sizeof(DebugVertex)
+		});
+
+		debugArray->AddStream({
+			.buffer      = debugStream->GetBuffer(),
+			.bindingUnit = 1,
+			.format      = VertexFormat::uShortVec4,
+			.normalized  = true,
+			.startOffset = offsetof(DebugVertex, color),
+			.stride      = sizeof(DebugVertex)
+		});
+	}
+
 	void PrimitivesSingleton::DrawFullScreenQuad(Shader& program)
 	{
 		ASSERT(IsLoaded(), "Primitives must be initialized to call this function.");
@@ -1,8 +1,12 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
+#include "gemcutter/Rendering/DebugDraw.h"
 #include "gemcutter/Resource/Shader.h"
+#include "gemcutter/Resource/StreamBuffer.h"
 #include "gemcutter/Resource/VertexArray.h"
 
+#include <optional>
+
 namespace gem
 {
 	struct vec3;
@@ -10,6 +14,7 @@ namespace gem
 
 	// Provides simple, intimidate, geometry rendering.
 	// Line, Triangle, Rectangle, and Grid functions are intended for debugging; they are not particularly efficient.
+	// Large amounts of debugging geometry should instead be collected into a DebugDrawList and drawn with DrawDebug().
 	extern class PrimitivesSingleton Primitives;
 	class PrimitivesSingleton
 	{
@@ -32,6 +37,14 @@ namespace gem
 
 		void DrawGrid(const vec3& p1, const vec3& p2, const vec3& p3, const vec3& p4, const vec4& color, unsigned numDivisions);
 
+		// Renders all primitives in the list with a single upload. Uses the currently bound camera.
+		// The list can be drawn any number of times per frame, such as once for each camera.
+		void DrawDebug(const DebugDrawList& list);
+
+		// Fences the debugging geometry streamed during the current frame.
+		// Called once per frame by Application.UpdateEngine(), after the previous frame's draws have been issued.
+		void EndFrame();
+
 		void DrawFullScreenQuad(Shader& program);
 		void DrawFullScreenQuad(Texture& tex);
 
@@ -43,6 +56,9 @@ namespace gem
 		VertexArray::Ptr GetUnitCubeArray() const;
 
 	private:
+		// Points the debug vertex array at the current buffer of the debug stream.
+		void CreateDebugStreams();
+
 		bool isLoaded = false;
 
 		Shader lineProgram;
@@ -52,11 +68,16 @@ namespace gem
 		Shader texturedTriangleProgram;
 		Shader texturedRectangleProgram;
 		Shader texturedFullScreenQuadProgram;
+		Shader debugProgram;
 
 		VertexArray::Ptr quadArray;
 		VertexArray::Ptr unitQuadArray;
 		VertexArray::Ptr unitCubeArray;
 
+		// Streams the vertices of DebugDrawLists. Grows as needed.
+		VertexArray::Ptr debugArray;
+		std::optional<StreamBuffer> debugStream;
+
 		// Allows the rendering of primitives without vertex attributes.
 		unsigned dummyVAO = 0;
 	};
@@ -0,0 +1,122 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "RangeAllocator.h"
+#include "gemcutter/Application/Logging.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace gem
+{
+	RangeAllocator::RangeAllocator(unsigned _capacity)
+	{
+		Reset(_capacity);
+	}
+
+	unsigned RangeAllocator::Allocate(unsigned size)
+	{
+		if (size == 0)
+		{
+			return InvalidOffset;
+		}
+
+		auto itr = std::ranges::find_if(freeRanges, [size](const Range& range) { return range.size >= size; });
+		if (itr == freeRanges.end())
+		{
+			return InvalidOffset;
+		}
+
+		const unsigned offset = itr->offset;
+		if (itr->size == size)
+		{
+			freeRanges.erase(itr);
+		}
+		else
+		{
+			itr->offset += size;
+			itr->size -= size;
+		}
+
+		used += size;
+		return offset;
+	}
+
+	void RangeAllocator::Free(unsigned offset, unsigned size)
+	{
+		ASSERT(size > 0, "Cannot free an empty range.");
+		ASSERT(offset + size <= capacity, "Range is outside of the allocator.");
+
+		auto next = std::ranges::upper_bound(freeRanges, offset, {}, &Range::offset);
+
+		// Check that the range was not already freed.
+		ASSERT(next == freeRanges.end() || offset + size <= next->offset, "Range overlaps a free range.");
+		ASSERT(next == freeRanges.begin() || std::prev(next)->offset + std::prev(next)->size <= offset, "Range overlaps a free range.");
+
+		const bool mergesPrev = next != freeRanges.begin() && std::prev(next)->offset + std::prev(next)->size == offset;
+		const bool mergesNext = next != freeRanges.end() && offset + size == next->offset;
+
+		if (mergesPrev && mergesNext)
+		{
+			std::prev(next)->size += size + next->size;
+			freeRanges.erase(next);
+		}
+		else if (mergesPrev)
+		{
+			std::prev(next)->size += size;
+		}
+		else if (mergesNext)
+		{
+			next->offset = offset;
+			next->size += size;
+		}
+		else
+		{
+			freeRanges.insert(next, { offset, size });
+		}
+
+		used -= size;
+	}
+
+	void RangeAllocator::Grow(unsigned newCapacity)
+	{
+		ASSERT(newCapacity >= capacity, "A RangeAllocator cannot shrink without being reset.");
+
+		if (newCapacity == capacity)
+		{
+			return;
+		}
+
+		if (!freeRanges.empty() && freeRanges.back().offset + freeRanges.back().size == capacity)
+		{
+			freeRanges.back().size += newCapacity - capacity;
+		}
+		else
+		{
+			freeRanges.push_back({ capacity, newCapacity - capacity });
+		}
+
+		capacity = newCapacity;
+	}
+
+	void RangeAllocator::Reset(unsigned newCapacity)
+	{
+		freeRanges.clear();
+		if (newCapacity > 0)
+		{
+			freeRanges.push_back({ 0, newCapacity });
+		}
+
+		capacity = newCapacity;
+		used = 0;
+	}
+
+	unsigned RangeAllocator::GetLargestFreeRange() const
+	{
+		unsigned largest = 0;
+		for (const Range& range : freeRanges)
+		{
+			largest = std::max(largest, range.size);
+		}
+
+		return largest;
+	}
+}
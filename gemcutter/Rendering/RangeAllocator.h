@@ -0,0 +1,46 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <limits>
+#include <vector>
+
+namespace gem
+{
+	// Sub-allocates ranges of a larger buffer, such as the shared vertex and index buffers of StaticGeometry.
+	// Sizes are in whatever unit the caller chooses, such as vertices or indices.
+	// Ranges are placed at the first gap large enough to hold them, and freed ranges are merged with their neighbours.
+	class RangeAllocator
+	{
+	public:
+		static constexpr unsigned InvalidOffset = std::numeric_limits<unsigned>::max();
+
+		RangeAllocator() = default;
+		explicit RangeAllocator(unsigned capacity);
+
+		// Returns the offset of a new range of 'size' units, or InvalidOffset if no gap is large enough.
+		unsigned Allocate(unsigned size);
+		// Returns a range to the allocator. 'offset' and 'size' must match a previous allocation.
+		void Free(unsigned offset, unsigned size);
+
+		// Extends the capacity, keeping all current allocations in place.
+		void Grow(unsigned newCapacity);
+		// Frees every range and changes the capacity.
+		void Reset(unsigned newCapacity);
+
+		unsigned GetCapacity() const { return capacity; }
+		unsigned GetUsedSize() const { return used; }
+		// The largest range which can currently be allocated.
+		unsigned GetLargestFreeRange() const;
+
+	private:
+		struct Range
+		{
+			unsigned offset;
+			unsigned size;
+		};
+
+		// Sorted by offset. Adjacent ranges are always merged.
+		std::vector<Range> freeRanges;
+		unsigned capacity = 0;
+		unsigned used = 0;
+	};
+}
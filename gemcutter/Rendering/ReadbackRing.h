@@ -0,0 +1,128 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <array>
+
+namespace gem
+{
+	// Identifies a readback which has been issued to the GPU.
+	// Handles become stale once their readback is released, even if the slot is later reused.
+	struct ReadbackHandle
+	{
+		bool IsValid() const { return generation != 0; }
+
+		unsigned slot = 0;
+		unsigned generation = 0;
+	};
+
+	// Tracks a fixed number of slots which the GPU copies results into, so that the CPU can
+	// collect them a frame or two later instead of stalling the pipeline to wait for them.
+	// Each slot stays in use from the moment it is acquired until its result is released.
+	//
+	// 'FenceType' must provide Insert(), Wait(), Clear(), and IsSignalled(). The Fence class is
+	// used for GPU resources, but any type matching the interface can be used to test this in isolation.
+	template<class FenceType, unsigned Count = 4>
+	class ReadbackRing
+	{
+		static_assert(Count > 0, "A ReadbackRing requires at least one slot.");
+	public:
+		// Claims the oldest free slot. Returns an invalid handle if every slot is still in use.
+		ReadbackHandle Acquire()
+		{
+			for (unsigned i = 0; i < Count; ++i)
+			{
+				const unsigned index = (next + i) % Count;
+				Slot& slot = slots[index];
+				if (!slot.isInUse)
+				{
+					slot.isInUse = true;
+					next = (index + 1) % Count;
+
+					return { index, slot.generation };
+				}
+			}
+
+			return {};
+		}
+
+		// Fences the commands which have been issued to copy into the slot.
+		void Submit(ReadbackHandle handle)
+		{
+			slots[handle.slot].fence.Insert();
+		}
+
+		// Returns true if the handle refers to a readback which has not yet been released.
+		bool IsValid(ReadbackHandle handle) const
+		{
+			return handle.IsValid() && handle.slot < Count &&
+				slots[handle.slot].isInUse && slots[handle.slot].generation == handle.generation;
+		}
+
+		// Returns true if the GPU has finished copying into the slot. Does not block.
+		bool IsReady(ReadbackHandle handle) const
+		{
+			return IsValid(handle) && slots[handle.slot].fence.IsSignalled();
+		}
+
+		// Blocks until the GPU has finished copying into the slot.
+		void Wait(ReadbackHandle handle)
+		{
+			slots[handle.slot].fence.Wait();
+		}
+
+		// Frees the slot for a new readback. Any outstanding handles to it become stale.
+		void Release(ReadbackHandle handle)
+		{
+			Release(slots[handle.slot]);
+		}
+
+		// Frees every slot which is in use.
+		void ReleaseAll()
+		{
+			for (Slot& slot : slots)
+			{
+				if (slot.isInUse)
+				{
+					Release(slot);
+				}
+			}
+		}
+
+		unsigned GetNumInUse() const
+		{
+			unsigned count = 0;
+			for (const Slot& slot : slots)
+			{
+				count += slot.isInUse ? 1 : 0;
+			}
+
+			return count;
+		}
+
+		const FenceType& GetFence(unsigned slot) const { return slots[slot].fence; }
+
+		static constexpr unsigned SlotCount = Count;
+
+	private:
+		struct Slot
+		{
+			FenceType fence;
+			unsigned generation = 1;
+			bool isInUse = false;
+		};
+
+		void Release(Slot& slot)
+		{
+			slot.fence.Clear();
+			slot.isInUse = false;
+
+			// Zero is reserved for invalid handles.
+			if (++slot.generation == 0)
+			{
+				slot.generation = 1;
+			}
+		}
+
+		std::array<Slot, Count> slots;
+		unsigned next = 0;
+	};
+}
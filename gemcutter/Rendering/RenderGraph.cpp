@@ -0,0 +1,402 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "RenderGraph.h"
+#include "gemcutter/Application/Logging.h"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr unsigned NO_PASS = gem::RenderGraphResource::InvalidIndex;
+}
+
+namespace gem
+{
+	RenderGraphResource RenderGraph::CreateTarget(std::string name, const RenderTargetDesc& desc)
+	{
+		ASSERT(desc.width > 0 && desc.height > 0, "Target ( %s ) must have a size.", name.c_str());
+		ASSERT(!desc.colorFormats.empty() || desc.hasDepth, "Target ( %s ) must have at least one texture.", name.c_str());
+
+		Target& target = targets.emplace_back();
+		target.name = std::move(name);
+		target.desc = desc;
+		target.producers.push_back(NO_PASS);
+		isCompiled = false;
+
+		return { static_cast<unsigned>(targets.size() - 1), 0 };
+	}
+
+	RenderGraphResource RenderGraph::ImportTarget(std::string name, RenderTarget::Ptr renderTarget)
+	{
+		Target& target = targets.emplace_back();
+		target.name = std::move(name);
+		target.imported = std::move(renderTarget);
+		target.isImported = true;
+		target.producers.push_back(NO_PASS);
+		isCompiled = false;
+
+		return { static_cast<unsigned>(targets.size() - 1), 0 };
+	}
+
+	unsigned RenderGraph::AddPass(std::string name, PassFunc func)
+	{
+		ASSERT(func, "Pass ( %s ) must have a function to execute.", name.c_str());
+
+		Pass& pass = passes.emplace_back();
+		pass.name = std::move(name);
+		pass.func = std::move(func);
+		isCompiled = false;
+
+		return static_cast<unsigned>(passes.size() - 1);
+	}
+
+	void RenderGraph::Read(unsigned pass, RenderGraphResource resource)
+	{
+		ASSERT(pass < passes.size(), "'pass' must be a pass of this graph.");
+		ASSERT(resource.index < targets.size(), "'resource' must be a target of this graph.");
+		ASSERT(resource.version < targets[resource.index].producers.size(), "'resource' refers to a version that does not exist.");
+
+		const Target& target = targets[resource.index];
+		if (!target.isImported && resource.version == 0)
+		{
+			Error("RenderGraph: Pass ( %s ) reads from target ( %s ) before it has been written to.",
+				passes[pass].name.c_str(), target.name.c_str());
+		}
+
+		passes[pass].reads.push_back(resource);
+		isCompiled = false;
+	}
+
+	RenderGraphResource RenderGraph::Write(unsigned pass, RenderGraphResource resource)
+	{
+		ASSERT(pass < passes.size(), "'pass' must be a pass of this graph.");
+		ASSERT(resource.index < targets.size(), "'resource' must be a target of this graph.");
+
+		Target& target = targets[resource.index];
+		if (resource.version + 1 != target.producers.size())
+		{
+			Error("RenderGraph: Pass ( %s ) writes to an outdated version of target ( %s ).\nWrites must use the version returned by the previous write.",
+				passes[pass].name.c_str(), target.name.c_str());
+			return {};
+		}
+
+		const RenderGraphResource result = { resource.index, resource.version + 1 };
+		target.producers.push_back(pass);
+		passes[pass].writes.push_back(result);
+		isCompiled = false;
+
+		return result;
+	}
+
+	void RenderGraph::SetSideEffects(unsigned pass)
+	{
+		ASSERT(pass < passes.size(), "'pass' must be a pass of this graph.");
+
+		passes[pass].hasSideEffects = true;
+		isCompiled = false;
+	}
+
+	bool RenderGraph::Compile()
+	{
+		const unsigned numPasses = static_cast<unsigned>(passes.size());
+		std::vector<std::vector<unsigned>> dataDependencies;
+		std::vector<std::vector<unsigned>> orderDependencies;
+		GatherDependencies(dataDependencies, orderDependencies);
+		executionOrder.clear();
+
+		// Only passes contributing to an output of the graph are kept. Ordering constraints
+		// do not contribute anything, so they cannot keep a pass alive.
+		std::vector<unsigned> stack;
+		for (unsigned i = 0; i < numPasses; ++i)
+		{
+			Pass& pass = passes[i];
+			pass.isCulled = !pass.hasSideEffects && std::ranges::none_of(pass.writes, [this](RenderGraphResource write) {
+				return targets[write.index].isImported;
+			});
+
+			if (!pass.isCulled)
+			{
+				stack.push_back(i);
+			}
+		}
+
+		while (!stack.empty())
+		{
+			const unsigned pass = stack.back();
+			stack.pop_back();
+
+			for (unsigned dependency : dataDependencies[pass])
+			{
+				if (passes[dependency].isCulled)
+				{
+					passes[dependency].isCulled = false;
+					stack.push_back(dependency);
+				}
+			}
+		}
+
+		// Order the surviving passes so that each runs after its dependencies.
+		// When several passes are ready, the one declared first is chosen to keep the order predictable.
+		std::vector<unsigned> numBlockers(numPasses, 0);
+		std::vector<std::vector<unsigned>> dependents(numPasses);
+		for (unsigned i = 0; i < numPasses; ++i)
+		{
+			if (passes[i].isCulled)
+			{
+				continue;
+			}
+
+			for (unsigned dependency : dataDependencies[i])
+			{
+				numBlockers[i]++;
+				dependents[dependency].push_back(i);
+			}
+
+			// Culled passes never run, so there is nothing to wait for.
+			for (unsigned dependency : orderDependencies[i])
+			{
+				if (!passes[dependency].isCulled && std::ranges::find(dataDependencies[i], dependency) == dataDependencies[i].end())
+				{
+					numBlockers[i]++;
+					dependents[dependency].push_back(i);
+				}
+			}
+		}
+
+		std::vector<unsigned> ready;
+		for (unsigned i = 0; i < numPasses; ++i)
+		{
+			if (!passes[i].isCulled && numBlockers[i] == 0)
+			{
+				ready.push_back(i);
+			}
+		}
+
+		while (!ready.empty())
+		{
+			const auto next = std::ranges::min_element(ready);
+			const unsigned pass = *next;
+			ready.erase(next);
+			executionOrder.push_back(pass);
+
+			for (unsigned dependent : dependents[pass])
+			{
+				if (--numBlockers[dependent] == 0)
+				{
+					ready.push_back(dependent);
+				}
+			}
+		}
+
+		const size_t numLive = std::ranges::count(passes, false, &Pass::isCulled);
+		if (executionOrder.size() != numLive)
+		{
+			Error("RenderGraph: The dependencies between passes form a cycle.");
+			executionOrder.clear();
+			isCompiled = false;
+			return false;
+		}
+
+		AssignPhysicalTargets();
+
+		isCompiled = true;
+		return true;
+	}
+
+	void RenderGraph::Execute(RenderTargetPool& pool)
+	{
+		ASSERT(isCompiled, "RenderGraph must be compiled before it can be executed.");
+
+		acquiredTargets.resize(physicalTargets.size());
+		for (unsigned i = 0; i < physicalTargets.size(); ++i)
+		{
+			acquiredTargets[i] = pool.Acquire(i, physicalTargets[i]);
+		}
+		pool.Trim(static_cast<unsigned>(physicalTargets.size()));
+
+		for (unsigned pass : executionOrder)
+		{
+			passes[pass].func(*this);
+		}
+
+		// The pool keeps the targets alive until the next frame.
+		acquiredTargets.clear();
+	}
+
+	void RenderGraph::Clear()
+	{
+		targets.clear();
+		passes.clear();
+		executionOrder.clear();
+		physicalTargets.clear();
+		acquiredTargets.clear();
+		isCompiled = false;
+	}
+
+	const RenderTarget::Ptr& RenderGraph::GetTarget(RenderGraphResource resource) const
+	{
+		ASSERT(resource.index < targets.size(), "'resource' must be a target of this graph.");
+
+		const Target& target = targets[resource.index];
+		if (target.isImported)
+		{
+			return target.imported;
+		}
+
+		ASSERT(target.physicalIndex < acquiredTargets.size(), "Target ( %s ) is only available while its passes are executing.", target.name.c_str());
+
+		return acquiredTargets[target.physicalIndex];
+	}
+
+	std::span<const unsigned> RenderGraph::GetExecutionOrder() const
+	{
+		return executionOrder;
+	}
+
+	bool RenderGraph::IsCulled(unsigned pass) const
+	{
+		ASSERT(pass < passes.size(), "'pass' must be a pass of this graph.");
+
+		return passes[pass].isCulled;
+	}
+
+	unsigned RenderGraph::GetPhysicalIndex(RenderGraphResource resource) const
+	{
+		ASSERT(resource.index < targets.size(), "'resource' must be a target of this graph.");
+
+		return targets[resource.index].physicalIndex;
+	}
+
+	unsigned RenderGraph::GetNumPhysicalTargets() const
+	{
+		return static_cast<unsigned>(physicalTargets.size());
+	}
+
+	unsigned RenderGraph::GetNumPasses() const
+	{
+		return static_cast<unsigned>(passes.size());
+	}
+
+	const std::string& RenderGraph::GetPassName(unsigned pass) const
+	{
+		ASSERT(pass < passes.size(), "'pass' must be a pass of this graph.");
+
+		return passes[pass].name;
+	}
+
+	void RenderGraph::GatherDependencies(std::vector<std::vector<unsigned>>& dataDependencies, std::vector<std::vector<unsigned>>& orderDependencies) const
+	{
+		// The passes reading each version of each target.
+		std::vector<std::vector<std::vector<unsigned>>> readers(targets.size());
+		for (unsigned i = 0; i < targets.size(); ++i)
+		{
+			readers[i].resize(targets[i].producers.size());
+		}
+
+		for (unsigned i = 0; i < passes.size(); ++i)
+		{
+			for (RenderGraphResource read : passes[i].reads)
+			{
+				readers[read.index][read.version].push_back(i);
+			}
+		}
+
+		dataDependencies.assign(passes.size(), {});
+		orderDependencies.assign(passes.size(), {});
+		auto AddDependency = [](std::vector<unsigned>& dependencies, unsigned pass, unsigned dependency) {
+			if (dependency != NO_PASS && dependency != pass && std::ranges::find(dependencies, dependency) == dependencies.end())
+			{
+				dependencies.push_back(dependency);
+			}
+		};
+
+		for (unsigned i = 0; i < passes.size(); ++i)
+		{
+			// A read must wait for the version to be produced.
+			for (RenderGraphResource read : passes[i].reads)
+			{
+				AddDependency(dataDependencies[i], i, targets[read.index].producers[read.version]);
+			}
+
+			// A write builds on the previous version, so it must wait for it to be produced.
+			// It must also wait for every pass reading the previous version to finish, but only for the sake of ordering.
+			for (RenderGraphResource write : passes[i].writes)
+			{
+				const unsigned previous = write.version - 1;
+				AddDependency(dataDependencies[i], i, targets[write.index].producers[previous]);
+
+				for (unsigned reader : readers[write.index][previous])
+				{
+					AddDependency(orderDependencies[i], i, reader);
+				}
+			}
+		}
+	}
+
+	void RenderGraph::AssignPhysicalTargets()
+	{
+		physicalTargets.clear();
+
+		// Find the span of the execution order over which each transient target is in use.
+		const unsigned numTargets = static_cast<unsigned>(targets.size());
+		std::vector<unsigned> firstUse(numTargets, NO_PASS);
+		std::vector<unsigned> lastUse(numTargets, 0);
+
+		for (unsigned position = 0; position < executionOrder.size(); ++position)
+		{
+			const Pass& pass = passes[executionOrder[position]];
+			auto Use = [&](RenderGraphResource resource) {
+				firstUse[resource.index] = std::min(firstUse[resource.index], position);
+				lastUse[resource.index] = std::max(lastUse[resource.index], position);
+			};
+
+			std::ranges::for_each(pass.reads, Use);
+			std::ranges::for_each(pass.writes, Use);
+		}
+
+		for (Target& target : targets)
+		{
+			target.physicalIndex = RenderGraphResource::InvalidIndex;
+		}
+
+		// Targets are assigned at their first use and freed after their last, so that a later target with
+		// the same description can take over the RenderTarget. Inputs and outputs of a pass never share one.
+		std::vector<bool> isFree;
+		for (unsigned position = 0; position < executionOrder.size(); ++position)
+		{
+			for (unsigned i = 0; i < numTargets; ++i)
+			{
+				Target& target = targets[i];
+				if (target.isImported || firstUse[i] != position)
+				{
+					continue;
+				}
+
+				for (unsigned slot = 0; slot < physicalTargets.size(); ++slot)
+				{
+					if (isFree[slot] && physicalTargets[slot] == target.desc)
+					{
+						target.physicalIndex = slot;
+						break;
+					}
+				}
+
+				if (target.physicalIndex == RenderGraphResource::InvalidIndex)
+				{
+					target.physicalIndex = static_cast<unsigned>(physicalTargets.size());
+					physicalTargets.push_back(target.desc);
+					isFree.push_back(false);
+				}
+
+				isFree[target.physicalIndex] = false;
+			}
+
+			for (unsigned i = 0; i < numTargets; ++i)
+			{
+				if (!targets[i].isImported && firstUse[i] != NO_PASS && lastUse[i] == position)
+				{
+					isFree[targets[i].physicalIndex] = true;
+				}
+			}
+		}
+	}
+}
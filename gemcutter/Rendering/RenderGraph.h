@@ -0,0 +1,119 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Rendering/RenderTarget.h"
+#include "gemcutter/Rendering/RenderTargetPool.h"
+
+#include <functional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace gem
+{
+	// Refers to a version of a RenderTarget in a RenderGraph. Each write to a target produces a new version.
+	struct RenderGraphResource
+	{
+		bool IsValid() const { return index != InvalidIndex; }
+
+		static constexpr unsigned InvalidIndex = ~0u;
+
+		unsigned index = InvalidIndex;
+		unsigned version = 0;
+	};
+
+	// Schedules a frame's render passes from the RenderTargets they read and write.
+	// Compile() culls the passes which do not contribute to an output, orders the rest by their dependencies,
+	// and assigns each transient target to a pooled RenderTarget. Transient targets whose lifetimes do not
+	// overlap share the same RenderTarget. Compilation has no dependency on OpenGL.
+	// Usage:
+	// {
+	//    auto hdr = graph.CreateTarget("HDR", { width, height, { TextureFormat::RGBA_16F }, TextureFilter::Point, true });
+	//    auto screen = graph.ImportTarget("Screen", nullptr);
+	//
+	//    unsigned scene = graph.AddPass("Scene", [&](const RenderGraph& g) { ... g.GetTarget(hdr) ... });
+	//    hdr = graph.Write(scene, hdr);
+	//
+	//    unsigned tonemap = graph.AddPass("Tonemap", [&](const RenderGraph& g) { ... });
+	//    graph.Read(tonemap, hdr);
+	//    graph.Write(tonemap, screen);
+	//
+	//    if (graph.Compile())
+	//        graph.Execute(pool);
+	// }
+	// Handles captured by a pass should be the versions it reads or writes, since these are what GetTarget() expects.
+	class RenderGraph
+	{
+	public:
+		using PassFunc = std::function<void(const RenderGraph&)>;
+
+		// Adds a target which only exists while the passes using it are executing.
+		RenderGraphResource CreateTarget(std::string name, const RenderTargetDesc& desc);
+		// Adds an externally owned target, such as a persistent history buffer. Its contents are considered initialized.
+		// Passes writing to imported targets are the outputs of the graph. A null target refers to the back-buffer.
+		RenderGraphResource ImportTarget(std::string name, RenderTarget::Ptr target);
+
+		unsigned AddPass(std::string name, PassFunc func);
+		// Declares that the pass samples from the given version of a target.
+		void Read(unsigned pass, RenderGraphResource resource);
+		// Declares that the pass renders to the target. Returns the new version, to be read by later passes.
+		// Only the latest version of a target can be written to.
+		RenderGraphResource Write(unsigned pass, RenderGraphResource resource);
+		// Keeps the pass from being culled, even if nothing reads its results.
+		void SetSideEffects(unsigned pass);
+
+		// Resolves the order and resources of the passes. Returns false if the dependencies contain a cycle.
+		bool Compile();
+		// Acquires the transient targets from the pool, then runs each pass in order.
+		void Execute(RenderTargetPool& pool);
+		// Removes all passes and targets so that the graph can be rebuilt.
+		void Clear();
+
+		// Returns the RenderTarget behind the resource. Only valid while executing.
+		const RenderTarget::Ptr& GetTarget(RenderGraphResource resource) const;
+
+		// The passes which survived culling, in the order they will execute. Only valid after Compile().
+		std::span<const unsigned> GetExecutionOrder() const;
+		bool IsCulled(unsigned pass) const;
+		// Returns the pooled slot assigned to a transient target, or InvalidIndex if none of its users survived culling.
+		unsigned GetPhysicalIndex(RenderGraphResource resource) const;
+		unsigned GetNumPhysicalTargets() const;
+
+		unsigned GetNumPasses() const;
+		const std::string& GetPassName(unsigned pass) const;
+
+	private:
+		struct Target
+		{
+			std::string name;
+			RenderTargetDesc desc;
+			RenderTarget::Ptr imported;
+			bool isImported = false;
+			// The pass which produced each version. The initial version has no producer.
+			std::vector<unsigned> producers;
+			unsigned physicalIndex = RenderGraphResource::InvalidIndex;
+		};
+
+		struct Pass
+		{
+			std::string name;
+			PassFunc func;
+			std::vector<RenderGraphResource> reads;
+			// The versions produced by the pass.
+			std::vector<RenderGraphResource> writes;
+			bool hasSideEffects = false;
+			bool isCulled = true;
+		};
+
+		// Lists the passes which must execute before each pass. Data dependencies produce the contents a pass uses,
+		// while order dependencies only read a version that the pass overwrites.
+		void GatherDependencies(std::vector<std::vector<unsigned>>& dataDependencies, std::vector<std::vector<unsigned>>& orderDependencies) const;
+		void AssignPhysicalTargets();
+
+		std::vector<Target> targets;
+		std::vector<Pass> passes;
+		std::vector<unsigned> executionOrder;
+		std::vector<RenderTargetDesc> physicalTargets;
+		std::vector<RenderTarget::Ptr> acquiredTargets;
+		bool isCompiled = false;
+	};
+}
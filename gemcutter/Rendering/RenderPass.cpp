@@ -4,26 +4,36 @@
 #include "gemcutter/Application/Logging.h"
 #include "gemcutter/Entity/Entity.h"
 #include "gemcutter/Entity/Hierarchy.h"
+#include "gemcutter/Entity/SpatialIndex.h"
+#include "gemcutter/Math/Math.h"
 #include "gemcutter/Math/Transform.h"
 #include "gemcutter/Rendering/Camera.h"
 #include "gemcutter/Rendering/Primitives.h"
 #include "gemcutter/Rendering/Rendering.h"
 #include "gemcutter/Rendering/RenderTarget.h"
+#include "gemcutter/Rendering/StateCache.h"
+#include "gemcutter/Rendering/StaticGeometry.h"
 #include "gemcutter/Rendering/Viewport.h"
 #include "gemcutter/Resource/Font.h"
 #include "gemcutter/Resource/Material.h"
 #include "gemcutter/Resource/Shader.h"
 #include "gemcutter/Resource/Texture.h"
+#include "gemcutter/Resource/TextureStreamer.h"
 #include "gemcutter/Resource/UniformBuffer.h"
 #include "gemcutter/Resource/VertexArray.h"
 #include "gemcutter/Utilities/StdExt.h"
 // Renderables
+#include "gemcutter/Rendering/Mesh.h"
 #include "gemcutter/Rendering/Text.h"
 
+#include <cmath>
 #include <GL/glew.h>
+#include <limits>
 
 namespace
 {
+	const gem::ShaderKeyword GEM_MULTI_DRAW("GEM_MULTI_DRAW");
+
 	void BindRenderable(const gem::Renderable& renderable, gem::Shader* overrideShader)
 	{
 		const gem::Material& material = renderable.GetMaterial();
@@ -51,29 +61,6 @@ namespace
 		gem::SetDepthFunc(material.depthMode);
 		gem::SetCullFunc(material.cullMode);
 	}
-
-	void UnBindRenderable(const gem::Renderable& renderable, gem::Shader* overrideShader)
-	{
-		const gem::Material& material = renderable.GetMaterial();
-
-		if (overrideShader)
-		{
-			overrideShader->UnBind();
-		}
-		else
-		{
-			material.shader->UnBind();
-		}
-
-		if (renderable.array)
-		{
-			renderable.array->UnBind();
-		}
-
-		renderable.textures.UnBind();
-		renderable.buffers.UnBind();
-		material.textures.UnBind();
-	}
 }
 
 namespace gem
@@ -136,18 +123,20 @@ namespace gem
 			target->Bind();
 		}
 
+		Viewport boundViewport;
 		if (viewport)
 		{
-			viewport->bind();
+			boundViewport = *viewport;
 		}
 		else if (target)
 		{
-			target->GetViewport().bind();
+			boundViewport = target->GetViewport();
 		}
 		else
 		{
-			Application.GetScreenViewport().bind();
+			boundViewport = Application.GetScreenViewport();
 		}
+		boundViewport.bind();
 
 		if (Entity::Ptr cameraLock = camera.lock())
 		{
@@ -156,6 +145,18 @@ namespace gem
 
 			viewMatrix = cameraComponent.GetViewMatrix();
 			viewProjMatrix = cameraComponent.GetProjMatrix();
+
+			// Used to estimate the size of textures on screen for the TextureStreamer.
+			cameraPosition = cameraLock->GetWorldTransform().GetTranslation();
+			isPerspective = cameraComponent.IsPerspective();
+			if (isPerspective)
+			{
+				pixelsPerUnit = static_cast<float>(boundViewport.height) / (2.0f * std::tan(ToRadian(cameraComponent.GetFovyDegrees()) * 0.5f));
+			}
+			else
+			{
+				pixelsPerUnit = static_cast<float>(boundViewport.height) / std::abs(cameraComponent.GetTopBound() - cameraComponent.GetBottomBound());
+			}
 		}
 
 		boundPass = this;
@@ -165,7 +166,7 @@ namespace gem
 	{
 		ASSERT(boundPass == this, "RenderPass cannot be unbound if it is not bound.");
 
-		glBindVertexArray(GL_NONE);
+		GLState.BindVertexArray(GL_NONE);
 
 		// UnBind override shader.
 		if (shader)
@@ -226,8 +227,8 @@ namespace gem
 			return;
 		}
 
-		// These must be re-bound for each renderable in case
-		// they had been overridden by a previous entity.
+		// These must be re-bound for each renderable in case they had been overridden
+		// by a previous entity. Bindings which have not changed are skipped by GLState.
 		textures.Bind();
 		buffers.Bind();
 		BindRenderable(*renderable, shader.get());
@@ -235,22 +236,19 @@ namespace gem
 		// Update transform uniforms.
 		const mat4 worldTransform = ent.GetWorldTransform();
 
-		if (!IsPtrNull(camera))
+		if (TextureStreamer.IsEnabled())
 		{
-			const mat4 mv = viewMatrix * worldTransform;
-
-			MVP.Set(viewProjMatrix * mv);
-			modelView.Set(mv);
-		}
-		else
-		{
-			MVP.Set(mat4::Identity);
-			modelView.Set(mat4::Identity);
+			RequestTextureSizes(ent, *renderable, worldTransform);
 		}
 
-		model.Set(worldTransform);
-		invModel.Set(worldTransform.GetFastInverse());
-		normalMatrix.Set(mat3(worldTransform).GetInverse().GetTranspose());
+		const auto* mesh = component_cast<Mesh*>(renderable);
+		const IndirectDrawData transforms = ComputeTransforms(worldTransform, mesh ? mesh->GetModel() : nullptr);
+
+		MVP.Set(transforms.MVP);
+		modelView.Set(transforms.modelView);
+		model.Set(transforms.model);
+		invModel.Set(transforms.invModel);
+		normalMatrix.Set(mat3(transforms.normalToWorld));
 
 		transformBuffer.Bind(static_cast<unsigned>(UniformBufferSlot::Model));
 
@@ -292,9 +290,8 @@ namespace gem
 				text->owner.position -= upDirection * ((font->GetStringHeight() * static_cast<float>(text->GetNumLines())) / 2.0f);
 			}
 
-			glBindVertexArray(Font::GetVAO());
+			GLState.BindVertexArray(Font::GetVAO());
 			glBindBuffer(GL_ARRAY_BUFFER, Font::GetVBO());
-			glActiveTexture(GL_TEXTURE0);
 
 			for (unsigned i = 0; i < text->string.size(); ++i)
 			{
@@ -370,7 +367,7 @@ namespace gem
 				invModel.Set(newTransform.GetFastInverse());
 				transformBuffer.Bind(static_cast<unsigned>(UniformBufferSlot::Model));
 
-				glBindTexture(GL_TEXTURE_2D, font->GetTextures()[charIndex]);
+				GLState.BindTexture(0, GL_TEXTURE_2D, font->GetTextures()[charIndex]);
 				glDrawArrays(GL_TRIANGLES, 0, 6);
 
 				/* Adjust position for the next node. */
@@ -392,7 +389,6 @@ namespace gem
 			vertexArray->Draw();
 		}
 
-		UnBindRenderable(*renderable, shader.get());
 	}
 
 	void RenderPass::Render(std::span<const Entity::Ptr> entities)
@@ -406,6 +402,121 @@ namespace gem
 		}
 	}
 
+	void RenderPass::Render(StaticGeometry& geometry, std::span<const Entity::Ptr> entities)
+	{
+		ASSERT(boundPass == this, "RenderPass must be bound to render.");
+
+		if (!GPUInfo.SupportsMultiDrawIndirect())
+		{
+			Render(entities);
+			return;
+		}
+
+		drawList.Clear();
+		drawGroups.clear();
+
+		for (auto& entity : entities)
+		{
+			ASSERT(entity, "Entity pointer cannot be null.");
+			const Entity& ent = *entity;
+
+			if (!ent.IsEnabled())
+			{
+				continue;
+			}
+
+			auto* renderable = ent.Try<Renderable>();
+			if (!renderable || !renderable->IsEnabled())
+			{
+				continue;
+			}
+
+			// Per-instance overrides, custom geometry, and shaders reading the model uniforms outside of their
+			// Vertex block cannot share a draw, so they are rendered individually.
+			const auto* mesh = component_cast<Mesh*>(renderable);
+			const StaticGeometry::Entry* entry = (mesh && mesh->GetModel()) ? geometry.Find(*mesh->GetModel()) : nullptr;
+			const Shader* program = shader ? shader.get() : renderable->GetMaterial().shader.get();
+			if (!entry ||
+				!program || !program->SupportsMultiDraw() ||
+				renderable->array != entry->model->GetArray() ||
+				renderable->textures.Size() > 0 ||
+				renderable->buffers.Size() > 0)
+			{
+				Render(ent);
+				continue;
+			}
+
+			// Draws can be merged if they share a Material and shader variant.
+			auto group = std::ranges::find_if(drawGroups, [renderable](const Renderable* other) {
+				return &other->GetMaterial() == &renderable->GetMaterial() && other->variants == renderable->variants;
+			});
+
+			if (group == drawGroups.end())
+			{
+				group = drawGroups.insert(drawGroups.end(), renderable);
+			}
+
+			const mat4 worldTransform = ent.GetWorldTransform();
+			if (TextureStreamer.IsEnabled())
+			{
+				RequestTextureSizes(ent, *renderable, worldTransform);
+			}
+
+			const DrawElementsIndirectCommand command {
+				.count      = entry->numIndices,
+				.firstIndex = entry->firstIndex,
+				.baseVertex = static_cast<int>(entry->baseVertex)
+			};
+
+			drawList.Add(
+				static_cast<unsigned>(group - drawGroups.begin()),
+				entry->pool,
+				command,
+				ComputeTransforms(worldTransform, entry->model.get()));
+		}
+
+		if (drawList.GetNumDraws() == 0)
+		{
+			return;
+		}
+
+		drawList.Build();
+		geometry.Upload(drawList);
+
+		ShaderVariantControl overrideVariants;
+		overrideVariants.Define(GEM_MULTI_DRAW);
+
+		std::span<const IndirectDrawList::Batch> batches = drawList.GetBatches();
+		for (unsigned i = 0; i < batches.size(); ++i)
+		{
+			const Renderable& renderable = *drawGroups[batches[i].group];
+			const Material& material = renderable.GetMaterial();
+
+			textures.Bind();
+			buffers.Bind();
+
+			if (shader)
+			{
+				shader->Bind(overrideVariants);
+			}
+			else
+			{
+				ASSERT(material.shader, "Renderable Entity does not have a Shader and the RenderPass does not have an override attached.");
+
+				ShaderVariantControl variants = renderable.variants;
+				variants.Define(GEM_MULTI_DRAW);
+				material.shader->Bind(variants);
+			}
+
+			material.textures.Bind();
+			SetBlendFunc(material.blendMode);
+			SetDepthFunc(material.depthMode);
+			SetCullFunc(material.cullMode);
+
+			geometry.Draw(i);
+		}
+	}
+
 	void RenderPass::RenderRoot(const Entity& root)
 	{
 		ASSERT(boundPass == this, "RenderPass must be bound to render.");
@@ -421,6 +532,75 @@ namespace gem
 		}
 	}
 
+	IndirectDrawData RenderPass::ComputeTransforms(const mat4& worldTransform, const Model* meshModel) const
+	{
+		IndirectDrawData transforms;
+
+		// Quantized positions are decoded by folding the decoding into the model transform.
+		// The normal matrix is unaffected, since the decoding only applies to positions.
+		if (meshModel && meshModel->GetPositionFormat() != PositionFormat::Float)
+		{
+			transforms.model = worldTransform * meshModel->GetPositionDecode();
+			transforms.invModel = transforms.model.GetInverse();
+		}
+		else
+		{
+			transforms.model = worldTransform;
+			transforms.invModel = worldTransform.GetFastInverse();
+		}
+
+		if (!IsPtrNull(camera))
+		{
+			transforms.modelView = viewMatrix * transforms.model;
+			transforms.MVP = viewProjMatrix * transforms.modelView;
+		}
+
+		transforms.normalToWorld = mat4(mat3(worldTransform).GetInverse().GetTranspose());
+
+		return transforms;
+	}
+
+	void RenderPass::RequestTextureSizes(const Entity& ent, const Renderable& renderable, const mat4& worldTransform) const
+	{
+		// Textures are assumed to span their Entity's bounds once. Without bounds or
+		// a camera, there is no way to tell, so the full resolution is requested.
+		float screenSize = std::numeric_limits<float>::max();
+
+		std::optional<AABB> bounds;
+		if (auto* spatialBounds = ent.Try<SpatialBounds>())
+		{
+			bounds = spatialBounds->GetWorldBounds();
+		}
+		else if (auto* mesh = component_cast<Mesh*>(&renderable); mesh && mesh->GetModel())
+		{
+			const Model& meshModel = *mesh->GetModel();
+			bounds = TransformBounds(worldTransform, AABB(meshModel.GetMinBounds(), meshModel.GetMaxBounds()));
+		}
+
+		if (bounds && !IsPtrNull(camera))
+		{
+			const float diameter = Length(bounds->GetExtents()) * 2.0f;
+			if (!isPerspective)
+			{
+				screenSize = diameter * pixelsPerUnit;
+			}
+			else if (const float distance = std::sqrt(bounds->DistanceSquared(cameraPosition)); distance > 0.0f)
+			{
+				screenSize = diameter * pixelsPerUnit / distance;
+			}
+		}
+
+		for (const TextureSlot& slot : renderable.GetMaterial().textures.GetAll())
+		{
+			TextureStreamer.RequestScreenSize(*slot.tex, screenSize);
+		}
+
+		for (const TextureSlot& slot : renderable.textures.GetAll())
+		{
+			TextureStreamer.RequestScreenSize(*slot.tex, screenSize);
+		}
+	}
+
 	void RenderPass::CreateUniformBuffer()
 	{
 		MVP = transformBuffer.AddUniform<mat4>("MVP");
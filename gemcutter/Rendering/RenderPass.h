@@ -1,6 +1,7 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
 #include "gemcutter/Entity/Entity.h"
+#include "gemcutter/Rendering/IndirectDrawList.h"
 #include "gemcutter/Rendering/RenderTarget.h"
 #include "gemcutter/Rendering/Viewport.h"
 #include "gemcutter/Resource/Shader.h"
@@ -8,9 +9,14 @@
 
 #include <optional>
 #include <span>
+#include <vector>
 
 namespace gem
 {
+	class Model;
+	class Renderable;
+	class StaticGeometry;
+
 	// Ties together the three requirements for rendering: geometry, shaders, and a render target.
 	class RenderPass
 	{
@@ -44,6 +50,11 @@ namespace gem
 		void Render(const Entity&);
 		// Renders all Entities in the list in order.
 		void Render(std::span<const Entity::Ptr> entities);
+		// Renders the Entities whose Models were added to the StaticGeometry with one multi-draw per Material and vertex layout.
+		// The rest are rendered individually, along with those whose Shader does not SupportsMultiDraw(),
+		// and all of them if the device does not support multi-draw indirect.
+		// Culled Entities should be left out of the list, as every Entity in it is drawn.
+		void Render(StaticGeometry& geometry, std::span<const Entity::Ptr> entities);
 		// Renders the root Entity along with all renderable descendants (depth first traversal).
 		void RenderRoot(const Entity& root);
 
@@ -53,6 +64,11 @@ namespace gem
 		BufferList buffers;
 
 	private:
+		// Reports the approximate screen size of the renderable's textures to the TextureStreamer.
+		void RequestTextureSizes(const Entity& ent, const Renderable& renderable, const mat4& worldTransform) const;
+		// Returns the transforms of an Entity as seen by the current camera.
+		// Quantized positions of the Model are decoded by the model matrix.
+		IndirectDrawData ComputeTransforms(const mat4& worldTransform, const Model* meshModel) const;
 		void CreateUniformBuffer();
 
 		std::optional<Viewport> viewport;
@@ -65,6 +81,10 @@ namespace gem
 
 		mat4 viewMatrix;
 		mat4 viewProjMatrix;
+		vec3 cameraPosition;
+		// The size of one world unit on screen, at a distance of one unit for perspective cameras.
+		float pixelsPerUnit = 1.0f;
+		bool isPerspective = true;
 
 		UniformHandle<mat4> MVP;
 		UniformHandle<mat4> modelView;
@@ -72,6 +92,11 @@ namespace gem
 		UniformHandle<mat4> invModel;
 		UniformHandle<mat3> normalMatrix;
 
+		// Reused between frames when rendering StaticGeometry.
+		IndirectDrawList drawList;
+		// One Renderable of each Material and variant in the draw list.
+		std::vector<const Renderable*> drawGroups;
+
 		static inline RenderPass* boundPass = nullptr;
 	};
 }
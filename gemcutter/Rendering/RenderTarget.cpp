@@ -113,6 +113,7 @@ namespace gem
 		ASSERT(numColorTextures > 0, "RenderTarget does not have any color textures to initialize.");
 		ASSERT(index < numColorTextures, "'index' must specify a valid color texture.");
 		ASSERT(format != TextureFormat::DEPTH_24, "'format' cannot be DEPTH_24 for a color texture.");
+		ASSERT(!IsCompressed(format), "'format' cannot be a compressed format for a color texture.");
 		ASSERT(!colors[index], "'index' is already initialized.");
 
 		colors[index] = Texture::MakeNew();
@@ -81,7 +81,7 @@ namespace gem
 		void CopyColorToBackBuffer(unsigned index) const;
 
 		// Retrieves a pixel from the specified color buffer.
-		// * This is very expensive and not recommended for real-time use *
+		// * This is very expensive and not recommended for real-time use, see PixelReadback instead *
 		void ReadPixel(unsigned index, int x, int y, std::byte& outR, std::byte& outG, std::byte& outB, std::byte& outA) const;
 		void ReadPixel(unsigned index, int x, int y, unsigned short& outR, unsigned short& outG, unsigned short& outB, unsigned short& outA) const;
 		void ReadPixel(unsigned index, int x, int y, unsigned& outR, unsigned& outG, unsigned& outB, unsigned& outA) const;
@@ -102,6 +102,7 @@ namespace gem
 
 	private:
 		friend class ApplicationSingleton; // For InitDrawFlags().
+		friend class PixelReadback; // For FBO.
 		static void InitDrawFlags();
 
 		unsigned FBO = 0;
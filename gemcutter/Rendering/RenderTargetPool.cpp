@@ -0,0 +1,73 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "RenderTargetPool.h"
+#include "gemcutter/Application/Logging.h"
+
+namespace gem
+{
+	RenderTarget::Ptr RenderTargetPool::Acquire(unsigned slot, const RenderTargetDesc& desc)
+	{
+		ASSERT(desc.width > 0 && desc.height > 0, "A pooled RenderTarget must have a size.");
+
+		if (slot >= entries.size())
+		{
+			entries.resize(slot + 1);
+		}
+
+		Entry& entry = entries[slot];
+		if (entry.target && entry.desc == desc)
+		{
+			return entry.target;
+		}
+
+		// A change of resolution keeps the existing textures, and only reallocates their storage.
+		if (entry.target &&
+			entry.desc.colorFormats == desc.colorFormats &&
+			entry.desc.filter == desc.filter &&
+			entry.desc.hasDepth == desc.hasDepth &&
+			entry.desc.numSamples == desc.numSamples &&
+			entry.target->Resize(desc.width, desc.height))
+		{
+			entry.desc = desc;
+			return entry.target;
+		}
+
+		const unsigned numColorTextures = static_cast<unsigned>(desc.colorFormats.size());
+
+		auto target = RenderTarget::MakeNew();
+		target->Init(desc.width, desc.height, numColorTextures, desc.hasDepth, desc.numSamples);
+		for (unsigned i = 0; i < numColorTextures; ++i)
+		{
+			target->InitTexture(i, desc.colorFormats[i], desc.filter);
+		}
+
+		if (!target->Validate())
+		{
+			Error("RenderTargetPool: Failed to create a RenderTarget for slot ( %u ).", slot);
+			entry = {};
+			return nullptr;
+		}
+
+		entry.desc = desc;
+		entry.target = std::move(target);
+
+		return entry.target;
+	}
+
+	void RenderTargetPool::Trim(unsigned count)
+	{
+		if (count < entries.size())
+		{
+			entries.resize(count);
+		}
+	}
+
+	void RenderTargetPool::Clear()
+	{
+		entries.clear();
+	}
+
+	unsigned RenderTargetPool::GetSize() const
+	{
+		return static_cast<unsigned>(entries.size());
+	}
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Rendering/Rendering.h"
+#include "gemcutter/Rendering/RenderTarget.h"
+
+#include <vector>
+
+namespace gem
+{
+	// Describes a RenderTarget to be allocated on demand, such as by a RenderGraph.
+	struct RenderTargetDesc
+	{
+		bool operator==(const RenderTargetDesc&) const = default;
+
+		unsigned width = 0;
+		unsigned height = 0;
+		// One format per color texture.
+		std::vector<TextureFormat> colorFormats;
+		TextureFilter filter = TextureFilter::Point;
+		bool hasDepth = false;
+		unsigned numSamples = 1;
+	};
+
+	// Keeps RenderTargets alive between frames, so that they are only recreated when their description changes.
+	class RenderTargetPool
+	{
+	public:
+		// Returns the RenderTarget held in the slot, after making sure that it matches the description.
+		// Returns null if the RenderTarget could not be created.
+		RenderTarget::Ptr Acquire(unsigned slot, const RenderTargetDesc& desc);
+
+		// Frees all slots from the given index onwards.
+		void Trim(unsigned count);
+		void Clear();
+
+		unsigned GetSize() const;
+
+	private:
+		struct Entry
+		{
+			RenderTargetDesc desc;
+			RenderTarget::Ptr target;
+		};
+
+		std::vector<Entry> entries;
+	};
+}
@@ -4,6 +4,7 @@
 #include "gemcutter/Application/Logging.h"
 #include "gemcutter/Math/Math.h"
 #include "gemcutter/Math/Vector.h"
+#include "gemcutter/Rendering/StateCache.h"
 #include "gemcutter/Utilities/String.h"
 
 #include <GL/glew.h>
@@ -26,7 +27,12 @@ namespace
 		GL_SHORT,
 		GL_UNSIGNED_SHORT,
 		GL_BYTE,
-		GL_UNSIGNED_BYTE
+		GL_UNSIGNED_BYTE,
+		GL_HALF_FLOAT,
+		GL_HALF_FLOAT,
+		GL_SHORT,
+		GL_SHORT,
+		GL_UNSIGNED_SHORT
 	};
 
 	constexpr int vertexArrayFormat_Resolve[] = {
@@ -57,7 +63,12 @@ namespace
 		2,  // short
 		2,  // unsigned short
 		1,  // char
-		1   // unsigned byte
+		1,  // unsigned byte
+		4,  // half vec2
+		8,  // half vec4
+		4,  // short vec2
+		8,  // short vec4
+		8   // unsigned short vec4
 	};
 
 	constexpr int textureFormatChannelCount_Resolve[] = {
@@ -78,7 +89,44 @@ namespace
 		4, // RGBA_32F
 		1, // DEPTH_24
 		3, // sRGB_8
-		4  // sRGBA_8
+		4, // sRGBA_8
+		3, // BC1
+		3, // BC1_sRGB
+		4, // BC3
+		4, // BC3_sRGB
+		1, // BC4
+		2, // BC5
+		4, // BC7
+		4  // BC7_sRGB
+	};
+
+	constexpr int textureFormatBytes_Resolve[] = {
+		1,  // R_8
+		2,  // R_16
+		2,  // R_16F
+		4,  // R_32
+		4,  // R_32F
+		3,  // RGB_8
+		6,  // RGB_16
+		6,  // RGB_16F
+		12, // RGB_32
+		12, // RGB_32F
+		4,  // RGBA_8
+		8,  // RGBA_16
+		8,  // RGBA_16F
+		16, // RGBA_32
+		16, // RGBA_32F
+		4,  // DEPTH_24
+		3,  // sRGB_8
+		4,  // sRGBA_8
+		8,  // BC1, per block
+		8,  // BC1_sRGB, per block
+		16, // BC3, per block
+		16, // BC3_sRGB, per block
+		8,  // BC4, per block
+		16, // BC5, per block
+		16, // BC7, per block
+		16  // BC7_sRGB, per block
 	};
 
 	constexpr int vertexAccess_Resolve[] = {
@@ -90,7 +138,8 @@ namespace
 	constexpr int bufferUsage_Resolve[] = {
 		GL_STATIC_DRAW,
 		GL_DYNAMIC_DRAW,
-		GL_STREAM_DRAW
+		GL_STREAM_DRAW,
+		GL_STREAM_DRAW // Persistent, when immutable storage is not supported.
 	};
 
 	constexpr int filterMin_Resolve[] = {
@@ -109,24 +158,32 @@ namespace
 	};
 
 	constexpr unsigned format_Resolve[] = {
-		GL_R8,                // R_8
-		GL_R16,               // R_16
-		GL_R16F,              // R_16F
-		GL_R32UI,             // R_32
-		GL_R32F,              // R_32F
-		GL_RGB8,              // RGB_8
-		GL_RGB16,             // RGB_16
-		GL_RGB16F,            // RGB_16F
-		GL_RGB32UI,           // RGB_32
-		GL_RGB32F,            // RGB_32F
-		GL_RGBA8,             // RGBA_8
-		GL_RGBA16,            // RGBA_16
-		GL_RGBA16F,           // RGBA_16F
-		GL_RGBA32UI,          // RGBA_32
-		GL_RGBA32F,           // RGBA_32F
-		GL_DEPTH_COMPONENT24, // DEPTH_24
-		GL_SRGB8,             // sRGB_8
-		GL_SRGB8_ALPHA8       // sRGBA_8
+		GL_R8,                                   // R_8
+		GL_R16,                                  // R_16
+		GL_R16F,                                 // R_16F
+		GL_R32UI,                                // R_32
+		GL_R32F,                                 // R_32F
+		GL_RGB8,                                 // RGB_8
+		GL_RGB16,                                // RGB_16
+		GL_RGB16F,                               // RGB_16F
+		GL_RGB32UI,                              // RGB_32
+		GL_RGB32F,                               // RGB_32F
+		GL_RGBA8,                                // RGBA_8
+		GL_RGBA16,                               // RGBA_16
+		GL_RGBA16F,                              // RGBA_16F
+		GL_RGBA32UI,                             // RGBA_32
+		GL_RGBA32F,                              // RGBA_32F
+		GL_DEPTH_COMPONENT24,                    // DEPTH_24
+		GL_SRGB8,                                // sRGB_8
+		GL_SRGB8_ALPHA8,                         // sRGBA_8
+		GL_COMPRESSED_RGB_S3TC_DXT1_EXT,         // BC1
+		GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,        // BC1_sRGB
+		GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,        // BC3
+		GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,  // BC3_sRGB
+		GL_COMPRESSED_RED_RGTC1,                 // BC4
+		GL_COMPRESSED_RG_RGTC2,                  // BC5
+		GL_COMPRESSED_RGBA_BPTC_UNORM,           // BC7
+		GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM      // BC7_sRGB
 	};
 
 	constexpr int dataFormat_resolve[] = {
@@ -147,12 +204,155 @@ namespace
 		GL_RGBA,              // RGBA_32F
 		GL_DEPTH_COMPONENT,   // DEPTH_24
 		GL_RGB,               // sRGB_8
-		GL_RGBA               // sRGBA_8
+		GL_RGBA,              // sRGBA_8
+		GL_RGB,               // BC1
+		GL_RGB,               // BC1_sRGB
+		GL_RGBA,              // BC3
+		GL_RGBA,              // BC3_sRGB
+		GL_RED,               // BC4
+		GL_RG,                // BC5
+		GL_RGBA,              // BC7
+		GL_RGBA               // BC7_sRGB
+	};
+
+	// Issues the changes which were not filtered out by GLState.
+	class OpenGLBackend final : public gem::StateBackend
+	{
+	public:
+		void UseProgram(unsigned program) override
+		{
+			glUseProgram(program);
+		}
+
+		void BindVertexArray(unsigned vertexArray) override
+		{
+			glBindVertexArray(vertexArray);
+		}
+
+		void BindTexture(unsigned unit, unsigned target, unsigned texture) override
+		{
+			glActiveTexture(GL_TEXTURE0 + unit);
+			glBindTexture(target, texture);
+		}
+
+		void BindUniformBuffer(unsigned slot, unsigned buffer, size_t offset, size_t size) override
+		{
+			if (size == 0)
+			{
+				glBindBufferBase(GL_UNIFORM_BUFFER, slot, buffer);
+			}
+			else
+			{
+				glBindBufferRange(GL_UNIFORM_BUFFER, slot, buffer, static_cast<GLintptr>(offset), static_cast<GLsizeiptr>(size));
+			}
+		}
+
+		void SetCullFunc(gem::CullFunc func) override
+		{
+			switch (func)
+			{
+			case gem::CullFunc::None:
+				glDisable(GL_CULL_FACE);
+				break;
+
+			case gem::CullFunc::Clockwise:
+				glEnable(GL_CULL_FACE);
+				glFrontFace(GL_CCW);
+				break;
+
+			case gem::CullFunc::CounterClockwise:
+				glEnable(GL_CULL_FACE);
+				glFrontFace(GL_CW);
+				break;
+			}
+		}
+
+		void SetBlendFunc(gem::BlendFunc func) override
+		{
+			switch (func)
+			{
+			case gem::BlendFunc::None:
+				glDisable(GL_BLEND);
+				break;
+
+			case gem::BlendFunc::Linear:
+				glEnable(GL_BLEND);
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+				break;
+
+			case gem::BlendFunc::Additive:
+				glEnable(GL_BLEND);
+				glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+				break;
+
+			case gem::BlendFunc::Multiplicative:
+				glEnable(GL_BLEND);
+				glBlendFunc(GL_DST_COLOR, GL_ZERO);
+				break;
+			}
+		}
+
+		void SetDepthFunc(gem::DepthFunc func) override
+		{
+			switch (func)
+			{
+			case gem::DepthFunc::Normal:
+				glEnable(GL_DEPTH_TEST);
+				glDepthMask(GL_TRUE);
+				break;
+
+			case gem::DepthFunc::TestOnly:
+				glEnable(GL_DEPTH_TEST);
+				glDepthMask(GL_FALSE);
+				break;
+
+			case gem::DepthFunc::WriteOnly:
+				glDisable(GL_DEPTH_TEST);
+				glDepthMask(GL_TRUE);
+				break;
+
+			case gem::DepthFunc::None:
+				glDisable(GL_DEPTH_TEST);
+				glDepthMask(GL_FALSE);
+				break;
+			}
+		}
+
+		void SetWireframe(bool enabled) override
+		{
+			glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+		}
+
+		void SetScissor(bool enabled) override
+		{
+			if (enabled)
+			{
+				glEnable(GL_SCISSOR_TEST);
+			}
+			else
+			{
+				glDisable(GL_SCISSOR_TEST);
+			}
+		}
+
+		void SetScissorRect(unsigned x, unsigned y, unsigned width, unsigned height) override
+		{
+			glScissor(x, y, width, height);
+		}
+
+		void SetViewport(unsigned x, unsigned y, unsigned width, unsigned height) override
+		{
+			glViewport(x, y, width, height);
+		}
 	};
+
+	OpenGLBackend openGLBackend;
 }
 
 namespace gem
 {
+	StateCache GLState(openGLBackend);
+
 	TextureWraps::TextureWraps(TextureWrap xy)
 		: x(xy), y(xy)
 	{
@@ -242,6 +442,28 @@ namespace gem
 		return textureFormatChannelCount_Resolve[std::to_underlying(format)];
 	}
 
+	unsigned CountBytes(TextureFormat format)
+	{
+		return textureFormatBytes_Resolve[std::to_underlying(format)];
+	}
+
+	size_t CountBytes(TextureFormat format, unsigned width, unsigned height)
+	{
+		if (IsCompressed(format))
+		{
+			// Partial blocks along the edges are stored as whole blocks.
+			const size_t numBlocks = static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4);
+			return numBlocks * CountBytes(format);
+		}
+
+		return static_cast<size_t>(width) * height * CountBytes(format);
+	}
+
+	bool IsCompressed(TextureFormat format)
+	{
+		return format >= TextureFormat::BC1;
+	}
+
 	void ClearBackBuffer()
 	{
 		SetDepthFunc(DepthFunc::Normal);
@@ -274,100 +496,37 @@ namespace gem
 
 	void SetWireframe(bool enabled)
 	{
-		glPolygonMode(GL_FRONT_AND_BACK, enabled ? GL_LINE : GL_FILL);
+		GLState.SetWireframe(enabled);
 	}
 
 	void SetCullFunc(CullFunc func)
 	{
-		switch (func)
-		{
-		case CullFunc::None:
-			glDisable(GL_CULL_FACE);
-			break;
-
-		case CullFunc::Clockwise:
-			glEnable(GL_CULL_FACE);
-			glFrontFace(GL_CCW);
-			break;
-
-		case CullFunc::CounterClockwise:
-			glEnable(GL_CULL_FACE);
-			glFrontFace(GL_CW);
-			break;
-		}
+		GLState.SetCullFunc(func);
 	}
 
 	void SetBlendFunc(BlendFunc func)
 	{
-		switch (func)
-		{
-		case BlendFunc::None:
-			glDisable(GL_BLEND);
-			break;
-
-		case BlendFunc::Linear:
-			glEnable(GL_BLEND);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-			break;
-
-		case BlendFunc::Additive:
-			glEnable(GL_BLEND);
-			glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-			break;
-
-		case BlendFunc::Multiplicative:
-			glEnable(GL_BLEND);
-			glBlendFunc(GL_DST_COLOR, GL_ZERO);
-			break;
-		}
+		GLState.SetBlendFunc(func);
 	}
 
 	void SetDepthFunc(DepthFunc func)
 	{
-		switch (func)
-		{
-		case DepthFunc::Normal:
-			glEnable(GL_DEPTH_TEST);
-			glDepthMask(GL_TRUE);
-			break;
-
-		case DepthFunc::TestOnly:
-			glEnable(GL_DEPTH_TEST);
-			glDepthMask(GL_FALSE);
-			break;
-
-		case DepthFunc::WriteOnly:
-			glDisable(GL_DEPTH_TEST);
-			glDepthMask(GL_TRUE);
-			break;
-
-		case DepthFunc::None:
-			glDisable(GL_DEPTH_TEST);
-			glDepthMask(GL_FALSE);
-			break;
-		}
+		GLState.SetDepthFunc(func);
 	}
 
 	void SetViewport(unsigned x, unsigned y, unsigned width, unsigned height)
 	{
-		glViewport(x, y, width, height);
+		GLState.SetViewport(x, y, width, height);
 	}
 
 	void SetScissor(unsigned x, unsigned y, unsigned width, unsigned height)
 	{
-		glScissor(x, y, width, height);
+		GLState.SetScissorRect(x, y, width, height);
 	}
 
 	void SetScissor(bool enabled)
 	{
-		if (enabled)
-		{
-			glEnable(GL_SCISSOR_TEST);
-		}
-		else
-		{
-			glDisable(GL_SCISSOR_TEST);
-		}
+		GLState.SetScissor(enabled);
 	}
 
 	bool SaveScreenshot(std::string_view filePath, unsigned x, unsigned y, unsigned width, unsigned height)
@@ -401,6 +560,16 @@ namespace gem
 		glGetIntegerv(GL_MAX_DRAW_BUFFERS, reinterpret_cast<int*>(&maxDrawBuffers));
 		glGetIntegerv(GL_MAX_TEXTURE_SIZE, reinterpret_cast<int*>(&maxTextureSize));
 		glGetIntegerv(GL_MAX_CUBE_MAP_TEXTURE_SIZE, reinterpret_cast<int*>(&maxCubeMapSize));
+
+		supportsMultiDrawIndirect =
+			GLEW_ARB_multi_draw_indirect &&
+			GLEW_ARB_shader_storage_buffer_object &&
+			GLEW_ARB_shader_draw_parameters;
+
+		if (GLEW_ARB_shader_storage_buffer_object)
+		{
+			glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, reinterpret_cast<int*>(&storageBufferAlignment));
+		}
 	}
 
 	unsigned GPUInfoSingleton::GetMaxTextureSlots() const
@@ -432,6 +601,16 @@ namespace gem
 	{
 		return maxCubeMapSize;
 	}
+
+	unsigned GPUInfoSingleton::GetStorageBufferAlignment() const
+	{
+		return storageBufferAlignment;
+	}
+
+	bool GPUInfoSingleton::SupportsMultiDrawIndirect() const
+	{
+		return supportsMultiDrawIndirect;
+	}
 }
 
 REFLECT(gem::UniformBufferSlot)
@@ -441,6 +620,7 @@ REFLECT(gem::UniformBufferSlot)
 		REF_VALUE(Engine)
 		REF_VALUE(Time)
 		REF_VALUE(Particle)
+		REF_VALUE(Lights)
 	}
 REF_END;
 
@@ -460,6 +640,11 @@ REFLECT(gem::VertexFormat)
 		REF_VALUE(uShort)
 		REF_VALUE(Byte)
 		REF_VALUE(uByte)
+		REF_VALUE(HalfVec2)
+		REF_VALUE(HalfVec4)
+		REF_VALUE(ShortVec2)
+		REF_VALUE(ShortVec4)
+		REF_VALUE(uShortVec4)
 	}
 REF_END;
 
@@ -499,6 +684,7 @@ REFLECT(gem::BufferUsage)
 		REF_VALUE(Static)
 		REF_VALUE(Dynamic)
 		REF_VALUE(Stream)
+		REF_VALUE(Persistent)
 	}
 REF_END;
 
@@ -522,6 +708,14 @@ REFLECT(gem::TextureFormat)
 		REF_VALUE(DEPTH_24)
 		REF_VALUE(sRGB_8)
 		REF_VALUE(sRGBA_8)
+		REF_VALUE(BC1)
+		REF_VALUE(BC1_sRGB)
+		REF_VALUE(BC3)
+		REF_VALUE(BC3_sRGB)
+		REF_VALUE(BC4)
+		REF_VALUE(BC5)
+		REF_VALUE(BC7)
+		REF_VALUE(BC7_sRGB)
 	}
 REF_END;
 
@@ -13,7 +13,14 @@ namespace gem
 		Model = 11,
 		Engine = 12,
 		Time = 13,
-		Particle = 14
+		Particle = 14,
+		Lights = 15
+	};
+
+	// Binding locations for built-in shader storage buffers.
+	enum class StorageBufferSlot : uint16_t
+	{
+		Draws = 0
 	};
 
 	enum class VertexFormat : uint16_t
@@ -31,7 +38,14 @@ namespace gem
 		Short,
 		uShort,
 		Byte,
-		uByte
+		uByte,
+		// Compact vector formats for quantized attributes.
+		// Integer components are read as floats, normalized if the VertexStream requests it.
+		HalfVec2,
+		HalfVec4,
+		ShortVec2,
+		ShortVec4,
+		uShortVec4
 	};
 
 	enum class VertexArrayFormat : uint16_t
@@ -71,7 +85,10 @@ namespace gem
 		// The buffer is expected to be occasionally updated. It will be optimized for editing.
 		Dynamic,
 		// The buffer is expected to be updated before each render. It will be optimized for streaming to the GPU.
-		Stream
+		Stream,
+		// The buffer remains mapped for writing for its whole lifetime. The storage cannot be resized.
+		// Writes must be synchronized with the GPU manually, such as by cycling through regions with a FrameRing.
+		Persistent
 	};
 
 	enum class TextureFormat : uint16_t
@@ -93,7 +110,16 @@ namespace gem
 		RGBA_32F,
 		DEPTH_24,
 		sRGB_8,
-		sRGBA_8
+		sRGBA_8,
+		// Block compressed formats, made of 4x4 texel blocks.
+		BC1,
+		BC1_sRGB,
+		BC3,
+		BC3_sRGB,
+		BC4,
+		BC5,
+		BC7,
+		BC7_sRGB
 	};
 
 	enum class TextureWrap : uint16_t
@@ -168,6 +194,11 @@ namespace gem
 	unsigned CountBytes(VertexFormat);
 	unsigned CountMipLevels(unsigned width, unsigned height, TextureFilter);
 	unsigned CountChannels(TextureFormat);
+	// Returns the size of a single texel of the format, or of a single 4x4 block for compressed formats.
+	unsigned CountBytes(TextureFormat);
+	// Returns the size of an image of the format, such as a single mip level.
+	size_t CountBytes(TextureFormat, unsigned width, unsigned height);
+	bool IsCompressed(TextureFormat);
 
 	void ClearBackBuffer();
 	void ClearBackBufferDepth();
@@ -198,6 +229,12 @@ namespace gem
 		unsigned GetMaxDrawBuffers() const;
 		unsigned GetMaxTextureSize() const;
 		unsigned GetMaxCubeMapSize() const;
+		// The required alignment of shader storage buffer ranges, in bytes.
+		unsigned GetStorageBufferAlignment() const;
+
+		// True if the device supports glMultiDrawElementsIndirect(), shader storage buffers, and gl_DrawID.
+		// StaticGeometry falls back to individual draws without these.
+		bool SupportsMultiDrawIndirect() const;
 
 	private:
 		void ScanDevice();
@@ -208,5 +245,7 @@ namespace gem
 		unsigned maxDrawBuffers = 0;
 		unsigned maxTextureSize = 0;
 		unsigned maxCubeMapSize = 0;
+		unsigned storageBufferAlignment = 0;
+		bool supportsMultiDrawIndirect = false;
 	};
 }
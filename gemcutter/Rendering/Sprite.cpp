@@ -2,6 +2,13 @@
 #include "Sprite.h"
 #include "gemcutter/Rendering/Primitives.h"
 
+namespace
+{
+	const gem::ShaderKeyword GEM_SPRITE_CENTERED_X("GEM_SPRITE_CENTERED_X");
+	const gem::ShaderKeyword GEM_SPRITE_CENTERED_Y("GEM_SPRITE_CENTERED_Y");
+	const gem::ShaderKeyword GEM_SPRITE_BILLBOARD("GEM_SPRITE_BILLBOARD");
+}
+
 namespace gem
 {
 	Sprite::Sprite(Entity& _owner)
@@ -32,8 +39,8 @@ namespace gem
 		if (alignment == pivot)
 			return;
 
-		variants.Switch("GEM_SPRITE_CENTERED_X", pivot == Alignment::Center || pivot == Alignment::BottomCenter);
-		variants.Switch("GEM_SPRITE_CENTERED_Y", pivot == Alignment::Center || pivot == Alignment::LeftCenter);
+		variants.Switch(GEM_SPRITE_CENTERED_X, pivot == Alignment::Center || pivot == Alignment::BottomCenter);
+		variants.Switch(GEM_SPRITE_CENTERED_Y, pivot == Alignment::Center || pivot == Alignment::LeftCenter);
 
 		alignment = pivot;
 	}
@@ -48,7 +55,7 @@ namespace gem
 		if (billBoarded == state)
 			return;
 
-		variants.Switch("GEM_SPRITE_BILLBOARD", state);
+		variants.Switch(GEM_SPRITE_BILLBOARD, state);
 
 		billBoarded = state;
 	}
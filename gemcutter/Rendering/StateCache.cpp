@@ -0,0 +1,234 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "StateCache.h"
+#include "gemcutter/Application/Logging.h"
+
+namespace gem
+{
+	StateCache::StateCache(StateBackend& _backend)
+		: backend(_backend)
+	{
+	}
+
+	void StateCache::UseProgram(unsigned _program)
+	{
+		if (Count(program == _program))
+		{
+			backend.UseProgram(_program);
+			program = _program;
+		}
+	}
+
+	void StateCache::BindVertexArray(unsigned _vertexArray)
+	{
+		if (Count(vertexArray == _vertexArray))
+		{
+			backend.BindVertexArray(_vertexArray);
+			vertexArray = _vertexArray;
+		}
+	}
+
+	void StateCache::BindTexture(unsigned unit, unsigned target, unsigned texture)
+	{
+		if (unit >= textures.size())
+		{
+			textures.resize(unit + 1);
+		}
+
+		TextureBinding& binding = textures[unit];
+		if (Count(binding.target == target && binding.texture == texture))
+		{
+			backend.BindTexture(unit, target, texture);
+			binding.target = target;
+			binding.texture = texture;
+			activeTextureUnit = unit;
+		}
+	}
+
+	void StateCache::BindUniformBuffer(unsigned slot, unsigned buffer)
+	{
+		BindUniformBuffer(slot, buffer, 0, 0);
+	}
+
+	void StateCache::BindUniformBuffer(unsigned slot, unsigned buffer, size_t offset, size_t size)
+	{
+		ASSERT(size != 0 || offset == 0, "An offset cannot be used when binding the whole buffer.");
+
+		if (slot >= uniformBuffers.size())
+		{
+			uniformBuffers.resize(slot + 1);
+		}
+
+		BufferBinding& binding = uniformBuffers[slot];
+		if (Count(binding.buffer == buffer && binding.offset == offset && binding.size == size))
+		{
+			backend.BindUniformBuffer(slot, buffer, offset, size);
+			binding.buffer = buffer;
+			binding.offset = offset;
+			binding.size = size;
+		}
+	}
+
+	void StateCache::SetCullFunc(CullFunc func)
+	{
+		if (Count(cullFunc == func))
+		{
+			backend.SetCullFunc(func);
+			cullFunc = func;
+		}
+	}
+
+	void StateCache::SetBlendFunc(BlendFunc func)
+	{
+		if (Count(blendFunc == func))
+		{
+			backend.SetBlendFunc(func);
+			blendFunc = func;
+		}
+	}
+
+	void StateCache::SetDepthFunc(DepthFunc func)
+	{
+		if (Count(depthFunc == func))
+		{
+			backend.SetDepthFunc(func);
+			depthFunc = func;
+		}
+	}
+
+	void StateCache::SetWireframe(bool enabled)
+	{
+		if (Count(wireframe == enabled))
+		{
+			backend.SetWireframe(enabled);
+			wireframe = enabled;
+		}
+	}
+
+	void StateCache::SetScissor(bool enabled)
+	{
+		if (Count(scissor == enabled))
+		{
+			backend.SetScissor(enabled);
+			scissor = enabled;
+		}
+	}
+
+	void StateCache::SetScissorRect(unsigned x, unsigned y, unsigned width, unsigned height)
+	{
+		const std::array rect = { x, y, width, height };
+		if (Count(scissorRect == rect))
+		{
+			backend.SetScissorRect(x, y, width, height);
+			scissorRect = rect;
+		}
+	}
+
+	void StateCache::SetViewport(unsigned x, unsigned y, unsigned width, unsigned height)
+	{
+		const std::array rect = { x, y, width, height };
+		if (Count(viewport == rect))
+		{
+			backend.SetViewport(x, y, width, height);
+			viewport = rect;
+		}
+	}
+
+	unsigned StateCache::GetActiveTextureUnit() const
+	{
+		return activeTextureUnit;
+	}
+
+	void StateCache::Invalidate()
+	{
+		program = Unknown;
+		vertexArray = Unknown;
+		textures.clear();
+		uniformBuffers.clear();
+		cullFunc.reset();
+		blendFunc.reset();
+		depthFunc.reset();
+		wireframe.reset();
+		scissor.reset();
+		scissorRect.reset();
+		viewport.reset();
+	}
+
+	void StateCache::InvalidateActiveTexture()
+	{
+		if (activeTextureUnit < textures.size())
+		{
+			textures[activeTextureUnit] = {};
+		}
+	}
+
+	void StateCache::InvalidateVertexArray()
+	{
+		vertexArray = Unknown;
+	}
+
+	void StateCache::OnProgramDeleted(unsigned _program)
+	{
+		if (program == _program)
+		{
+			program = Unknown;
+		}
+	}
+
+	void StateCache::OnVertexArrayDeleted(unsigned _vertexArray)
+	{
+		if (vertexArray == _vertexArray)
+		{
+			vertexArray = Unknown;
+		}
+	}
+
+	void StateCache::OnTextureDeleted(unsigned texture)
+	{
+		for (TextureBinding& binding : textures)
+		{
+			if (binding.texture == texture)
+			{
+				binding = {};
+			}
+		}
+	}
+
+	void StateCache::OnBufferDeleted(unsigned buffer)
+	{
+		for (BufferBinding& binding : uniformBuffers)
+		{
+			if (binding.buffer == buffer)
+			{
+				binding = {};
+			}
+		}
+	}
+
+	uint64_t StateCache::GetNumIssued() const
+	{
+		return numIssued;
+	}
+
+	uint64_t StateCache::GetNumElided() const
+	{
+		return numElided;
+	}
+
+	void StateCache::ResetCounters()
+	{
+		numIssued = 0;
+		numElided = 0;
+	}
+
+	bool StateCache::Count(bool isRedundant)
+	{
+		if (isRedundant)
+		{
+			++numElided;
+			return false;
+		}
+
+		++numIssued;
+		return true;
+	}
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Rendering/Rendering.h"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace gem
+{
+	// Receives the state changes which were not filtered out by a StateCache.
+	class StateBackend
+	{
+	public:
+		virtual ~StateBackend() = default;
+
+		virtual void UseProgram(unsigned program) = 0;
+		virtual void BindVertexArray(unsigned vertexArray) = 0;
+		virtual void BindTexture(unsigned unit, unsigned target, unsigned texture) = 0;
+		// A size of zero binds the whole buffer.
+		virtual void BindUniformBuffer(unsigned slot, unsigned buffer, size_t offset, size_t size) = 0;
+		virtual void SetCullFunc(CullFunc func) = 0;
+		virtual void SetBlendFunc(BlendFunc func) = 0;
+		virtual void SetDepthFunc(DepthFunc func) = 0;
+		virtual void SetWireframe(bool enabled) = 0;
+		virtual void SetScissor(bool enabled) = 0;
+		virtual void SetScissorRect(unsigned x, unsigned y, unsigned width, unsigned height) = 0;
+		virtual void SetViewport(unsigned x, unsigned y, unsigned width, unsigned height) = 0;
+	};
+
+	// Shadows the bindings and fixed-function state of the backend, so that redundant changes are never issued.
+	// All state is unknown to begin with, so the first change of each is always issued.
+	// Any code which changes the same state directly must call one of the Invalidate functions afterwards.
+	class StateCache
+	{
+	public:
+		StateCache(StateBackend& backend);
+
+		void UseProgram(unsigned program);
+		void BindVertexArray(unsigned vertexArray);
+		void BindTexture(unsigned unit, unsigned target, unsigned texture);
+		void BindUniformBuffer(unsigned slot, unsigned buffer);
+		void BindUniformBuffer(unsigned slot, unsigned buffer, size_t offset, size_t size);
+		void SetCullFunc(CullFunc func);
+		void SetBlendFunc(BlendFunc func);
+		void SetDepthFunc(DepthFunc func);
+		void SetWireframe(bool enabled);
+		void SetScissor(bool enabled);
+		void SetScissorRect(unsigned x, unsigned y, unsigned width, unsigned height);
+		void SetViewport(unsigned x, unsigned y, unsigned width, unsigned height);
+
+		// Returns the texture unit which was bound last, and is therefore active.
+		unsigned GetActiveTextureUnit() const;
+
+		// Forgets all shadowed state, such as after a library has used OpenGL directly.
+		void Invalidate();
+		// Forgets the binding of the active texture unit, such as after a texture was bound to it in order to be edited.
+		void InvalidateActiveTexture();
+		void InvalidateVertexArray();
+
+		// Must be called when an object is deleted, since its name may be reused by a new object.
+		void OnProgramDeleted(unsigned program);
+		void OnVertexArrayDeleted(unsigned vertexArray);
+		void OnTextureDeleted(unsigned texture);
+		void OnBufferDeleted(unsigned buffer);
+
+		// The number of changes passed to the backend, and the number skipped because they were redundant.
+		uint64_t GetNumIssued() const;
+		uint64_t GetNumElided() const;
+		void ResetCounters();
+
+	private:
+		// Returns true if the change must be issued, and counts it either way.
+		bool Count(bool isRedundant);
+
+		static constexpr unsigned Unknown = ~0u;
+
+		struct TextureBinding
+		{
+			unsigned target = Unknown;
+			unsigned texture = Unknown;
+		};
+
+		struct BufferBinding
+		{
+			unsigned buffer = Unknown;
+			size_t offset = 0;
+			size_t size = 0;
+		};
+
+		StateBackend& backend;
+
+		unsigned program = Unknown;
+		unsigned vertexArray = Unknown;
+		unsigned activeTextureUnit = 0;
+		std::vector<TextureBinding> textures;
+		std::vector<BufferBinding> uniformBuffers;
+		std::optional<CullFunc> cullFunc;
+		std::optional<BlendFunc> blendFunc;
+		std::optional<DepthFunc> depthFunc;
+		std::optional<bool> wireframe;
+		std::optional<bool> scissor;
+		std::optional<std::array<unsigned, 4>> scissorRect;
+		std::optional<std::array<unsigned, 4>> viewport;
+
+		uint64_t numIssued = 0;
+		uint64_t numElided = 0;
+	};
+
+	// The StateCache used by the engine for all OpenGL rendering.
+	extern StateCache GLState;
+}
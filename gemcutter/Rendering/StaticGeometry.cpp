@@ -0,0 +1,261 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "StaticGeometry.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Rendering/Rendering.h"
+
+#include <algorithm>
+#include <GL/glew.h>
+#include <limits>
+
+namespace
+{
+	// Pools start large enough for a few hundred typical props, and double when they run out of room.
+	constexpr unsigned INITIAL_POOL_VERTICES = 64 * 1024;
+	constexpr unsigned INITIAL_POOL_INDICES = 192 * 1024;
+	// Room for a few thousand draws over the frames in flight. Grows if a frame needs more.
+	constexpr unsigned INITIAL_STREAM_SIZE = 1024 * 1024;
+
+	bool IsSameAttribute(const gem::VertexStream& a, const gem::VertexStream& b)
+	{
+		return
+			a.bindingUnit == b.bindingUnit &&
+			a.format      == b.format &&
+			a.normalized  == b.normalized &&
+			a.startOffset == b.startOffset &&
+			a.stride      == b.stride &&
+			a.divisor     == b.divisor;
+	}
+}
+
+namespace gem
+{
+	StaticGeometry::StaticGeometry()
+		: stream(INITIAL_STREAM_SIZE)
+	{
+	}
+
+	bool StaticGeometry::Add(Model::Ptr model)
+	{
+		ASSERT(model, "'model' cannot be null.");
+		ASSERT(model->GetArray(), "Model must be uploaded before it can be added to a StaticGeometry.");
+
+		if (entries.contains(model.get()))
+		{
+			return true;
+		}
+
+		const VertexArray& source = *model->GetArray();
+		if (model->GetNumIndices() == 0 || !source.GetIndexBuffer())
+		{
+			Warning("StaticGeometry: Unindexed Models cannot be merged and will be rendered individually.");
+			return false;
+		}
+
+		// Models interleave all of their attributes in a single buffer.
+		const auto& streams = source.GetStreams();
+		ASSERT(!streams.empty(), "Model does not have any vertex attributes.");
+		ASSERT(std::ranges::all_of(streams, [&](const VertexStream& stream) { return stream.buffer == streams.front().buffer; }),
+			"Model attributes must be interleaved in a single buffer.");
+
+		const unsigned poolIndex = FindPool(source);
+		Pool& pool = pools[poolIndex];
+
+		const unsigned indexSize = CountBytes(pool.indexFormat);
+		const unsigned numVertices = model->GetNumVertices();
+		const unsigned numIndices = model->GetNumIndices();
+
+		const unsigned baseVertex = Allocate(pool.vertexRanges, *pool.vertices, pool.stride, numVertices);
+		const unsigned firstIndex = Allocate(pool.indexRanges, *pool.indices, indexSize, numIndices);
+
+		// The indices stay relative to the Model's first vertex. The draw commands offset them with baseVertex.
+		pool.vertices->CopyData(baseVertex * pool.stride, *streams.front().buffer, 0, numVertices * pool.stride);
+		pool.indices->CopyData(firstIndex * indexSize, *source.GetIndexBuffer(), 0, numIndices * indexSize);
+
+		const Model* key = model.get();
+		entries.emplace(key, Entry{ std::move(model), poolIndex, firstIndex, numIndices, baseVertex, numVertices });
+
+		return true;
+	}
+
+	void StaticGeometry::Remove(const Model& model)
+	{
+		auto itr = entries.find(&model);
+		if (itr == entries.end())
+		{
+			return;
+		}
+
+		const Entry& entry = itr->second;
+		Pool& pool = pools[entry.pool];
+		pool.vertexRanges.Free(entry.baseVertex, entry.numVertices);
+		pool.indexRanges.Free(entry.firstIndex, entry.numIndices);
+
+		entries.erase(itr);
+	}
+
+	void StaticGeometry::Clear()
+	{
+		entries.clear();
+		pools.clear();
+		batches.clear();
+		batchDataOffsets.clear();
+	}
+
+	const StaticGeometry::Entry* StaticGeometry::Find(const Model& model) const
+	{
+		auto itr = entries.find(&model);
+		return (itr != entries.end()) ? &itr->second : nullptr;
+	}
+
+	void StaticGeometry::Upload(const IndirectDrawList& list)
+	{
+		ASSERT(GPUInfo.SupportsMultiDrawIndirect(), "StaticGeometry requires multi-draw indirect support.");
+
+		batchDataOffsets.clear();
+		batches.assign(list.GetBatches().begin(), list.GetBatches().end());
+
+		std::span<const DrawElementsIndirectCommand> commands = list.GetCommands();
+		std::span<const IndirectDrawData> data = list.GetDrawData();
+		if (commands.empty())
+		{
+			return;
+		}
+
+		// gl_DrawID restarts with each batch, so each batch's transforms begin their own storage buffer range.
+		const unsigned alignment = std::max(GPUInfo.GetStorageBufferAlignment(), 16u);
+
+		while (true)
+		{
+			commandOffset = stream.Push(commands.data(), static_cast<unsigned>(commands.size_bytes()), sizeof(unsigned));
+
+			bool hasRoom = commandOffset != StreamBuffer::InvalidOffset;
+			for (unsigned i = 0; hasRoom && i < batches.size(); ++i)
+			{
+				const unsigned offset = stream.Push(&data[batches[i].firstCommand], batches[i].numCommands * sizeof(IndirectDrawData), alignment);
+
+				batchDataOffsets.push_back(offset);
+				hasRoom = offset != StreamBuffer::InvalidOffset;
+			}
+
+			if (hasRoom)
+			{
+				break;
+			}
+
+			// The frame does not fit alongside the others in flight. This stalls once, until the larger buffer is in use.
+			batchDataOffsets.clear();
+			stream.Resize(stream.GetCapacity() * 2);
+		}
+	}
+
+	void StaticGeometry::Draw(unsigned batchIndex) const
+	{
+		ASSERT(batchIndex < batches.size(), "'batchIndex' must refer to a batch of the uploaded list.");
+
+		const IndirectDrawList::Batch& batch = batches[batchIndex];
+		const Pool& pool = pools[batch.pool];
+		const unsigned streamBuffer = stream.GetBuffer()->VBO;
+
+		pool.array->Bind();
+		pool.indices->Bind();
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, streamBuffer);
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, static_cast<unsigned>(StorageBufferSlot::Draws), streamBuffer,
+			batchDataOffsets[batchIndex], batch.numCommands * sizeof(IndirectDrawData));
+
+		const std::byte* commands = (std::byte*)nullptr + commandOffset + batch.firstCommand * sizeof(DrawElementsIndirectCommand);
+		if (pool.indexFormat == VertexFormat::uInt)
+		{
+			// Matches VertexArray::Draw(), so that large meshes do not restart their primitives at vertex 65535.
+			glPrimitiveRestartIndex(std::numeric_limits<unsigned>::max());
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, commands, batch.numCommands, 0);
+			glPrimitiveRestartIndex(VertexBuffer::RESTART_INDEX);
+		}
+		else
+		{
+			glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_SHORT, commands, batch.numCommands, 0);
+		}
+
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, GL_NONE);
+	}
+
+	void StaticGeometry::EndFrame()
+	{
+		stream.EndFrame();
+	}
+
+	unsigned StaticGeometry::GetNumModels() const
+	{
+		return static_cast<unsigned>(entries.size());
+	}
+
+	unsigned StaticGeometry::GetNumPools() const
+	{
+		return static_cast<unsigned>(pools.size());
+	}
+
+	MemoryUsage StaticGeometry::GetMemoryUsage() const
+	{
+		MemoryUsage usage;
+		for (const Pool& pool : pools)
+		{
+			usage.gpuBytes += pool.vertices->GetSize();
+			usage.gpuBytes += pool.indices->GetSize();
+		}
+
+		usage.gpuBytes += stream.GetCapacity();
+
+		return usage;
+	}
+
+	unsigned StaticGeometry::FindPool(const VertexArray& array)
+	{
+		const auto& streams = array.GetStreams();
+		const VertexFormat indexFormat = array.GetIndexFormat();
+
+		for (unsigned i = 0; i < pools.size(); ++i)
+		{
+			const Pool& pool = pools[i];
+			if (pool.indexFormat == indexFormat &&
+				std::ranges::equal(pool.streams, streams, IsSameAttribute))
+			{
+				return i;
+			}
+		}
+
+		Pool& pool = pools.emplace_back();
+		pool.indexFormat = indexFormat;
+		pool.stride = streams.front().stride;
+		pool.vertices = VertexBuffer::MakeNew(INITIAL_POOL_VERTICES * pool.stride, BufferUsage::Static, VertexBufferType::Data);
+		pool.indices = VertexBuffer::MakeNew(INITIAL_POOL_INDICES * CountBytes(indexFormat), BufferUsage::Static, VertexBufferType::Index);
+		pool.vertexRanges.Reset(INITIAL_POOL_VERTICES);
+		pool.indexRanges.Reset(INITIAL_POOL_INDICES);
+
+		pool.array = VertexArray::MakeNew();
+		pool.array->SetIndexBuffer(pool.indices, indexFormat);
+		for (VertexStream stream : streams)
+		{
+			stream.buffer = pool.vertices;
+			pool.array->AddStream(stream);
+			pool.streams.push_back(std::move(stream));
+		}
+
+		return static_cast<unsigned>(pools.size() - 1);
+	}
+
+	unsigned StaticGeometry::Allocate(RangeAllocator& ranges, VertexBuffer& buffer, unsigned elementSize, unsigned count)
+	{
+		unsigned offset = ranges.Allocate(count);
+		if (offset == RangeAllocator::InvalidOffset)
+		{
+			// Resizing keeps the same buffer object, so the pool's VertexArray remains valid.
+			const unsigned newCapacity = std::max(ranges.GetCapacity() * 2, ranges.GetCapacity() + count);
+			buffer.Resize(newCapacity * elementSize, true);
+			ranges.Grow(newCapacity);
+
+			offset = ranges.Allocate(count);
+			ASSERT(offset != RangeAllocator::InvalidOffset, "Failed to allocate from the grown buffer.");
+		}
+
+		return offset;
+	}
+}
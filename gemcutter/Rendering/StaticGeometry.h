@@ -0,0 +1,101 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Rendering/IndirectDrawList.h"
+#include "gemcutter/Rendering/RangeAllocator.h"
+#include "gemcutter/Resource/Model.h"
+#include "gemcutter/Resource/StreamBuffer.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace gem
+{
+	// Merges the geometry of static Models into a few large vertex and index buffers, so that many Entities
+	// can be drawn with a single glMultiDrawElementsIndirect() call instead of one draw and VertexArray bind each.
+	// Models are grouped into pools by their vertex layout and index format. Each pool has its own VertexArray.
+	// Usage:
+	// {
+	//    for (auto& model : levelModels)
+	//        geometry.Add(model);
+	//
+	//    pass.Bind();
+	//    pass.Render(geometry, visibleEntities);
+	//    pass.UnBind();
+	//
+	//    geometry.EndFrame();
+	// }
+	// Shaders are compiled with the GEM_MULTI_DRAW definition, which replaces the model uniforms with the
+	// per-draw transforms in their vertex blocks. Requires GPUInfo.SupportsMultiDrawIndirect().
+	class StaticGeometry
+	{
+	public:
+		// The location of a Model in the shared buffers.
+		struct Entry
+		{
+			Model::Ptr model;
+			unsigned pool;
+			unsigned firstIndex;
+			unsigned numIndices;
+			unsigned baseVertex;
+			unsigned numVertices;
+		};
+
+		StaticGeometry();
+
+		StaticGeometry(const StaticGeometry&) = delete;
+		StaticGeometry& operator=(const StaticGeometry&) = delete;
+
+		// Copies the Model's geometry into the shared buffers. The Model must already be uploaded.
+		// Returns false if the Model cannot be merged, such as when it is not indexed. Adding a Model twice has no effect.
+		bool Add(Model::Ptr model);
+		void Remove(const Model& model);
+		void Clear();
+
+		// Returns null if the Model has not been added.
+		const Entry* Find(const Model& model) const;
+
+		// Streams the commands and transforms of a built list to the GPU. Must be called before Draw().
+		void Upload(const IndirectDrawList& list);
+		// Draws a batch of the list passed to Upload(), by its index in IndirectDrawList::GetBatches().
+		// Uses any currently bound shader and render state.
+		void Draw(unsigned batchIndex) const;
+
+		// Fences the commands and transforms uploaded during the current frame.
+		// Must be called once per frame, after the draws which read them have been issued.
+		void EndFrame();
+
+		unsigned GetNumModels() const;
+		unsigned GetNumPools() const;
+		// Returns the size of the shared buffers.
+		MemoryUsage GetMemoryUsage() const;
+
+	private:
+		struct Pool
+		{
+			// The attributes of the Models in the pool, read from the shared vertex buffer.
+			std::vector<VertexStream> streams;
+			VertexFormat indexFormat;
+			unsigned stride;
+
+			VertexArray::Ptr array;
+			VertexBuffer::Ptr vertices;
+			VertexBuffer::Ptr indices;
+			RangeAllocator vertexRanges;
+			RangeAllocator indexRanges;
+		};
+
+		// Returns the pool matching the layout of the array, creating it if needed.
+		unsigned FindPool(const VertexArray& array);
+		// Allocates a range of vertices or indices, growing the buffer if there is no room.
+		static unsigned Allocate(RangeAllocator& ranges, VertexBuffer& buffer, unsigned elementSize, unsigned count);
+
+		std::unordered_map<const Model*, Entry> entries;
+		std::vector<Pool> pools;
+
+		// Holds each frame's commands, followed by the transforms of each batch.
+		StreamBuffer stream;
+		unsigned commandOffset = 0;
+		std::vector<IndirectDrawList::Batch> batches;
+		std::vector<unsigned> batchDataOffsets;
+	};
+}
@@ -0,0 +1,146 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <array>
+#include <limits>
+
+namespace gem
+{
+	// Sub-allocates ranges of a GPU buffer which is rewritten every frame.
+	// Allocations are made one after another, wrapping around to the start of the buffer when they reach the end.
+	// The ranges used by each frame are protected by a fence, so they are only overwritten once the GPU is done with them.
+	//
+	// 'FenceType' must provide Insert(), Wait(), and IsSignalled(). The Fence class is used for GPU resources,
+	// but any type matching the interface can be used to test the allocation in isolation.
+	template<class FenceType, unsigned MaxFrames = 3>
+	class StreamRing
+	{
+		static_assert(MaxFrames > 0, "A StreamRing requires at least one frame in flight.");
+	public:
+		static constexpr unsigned InvalidOffset = std::numeric_limits<unsigned>::max();
+
+		StreamRing() = default;
+		explicit StreamRing(unsigned _capacity) : capacity(_capacity) {}
+
+		// Returns the offset of a new range of 'size' bytes, starting on a multiple of 'alignment'.
+		// Waits for the GPU to release older frames if there is not enough room.
+		// Returns InvalidOffset if the range cannot fit alongside the rest of the current frame's allocations.
+		unsigned Allocate(unsigned size, unsigned alignment = 4)
+		{
+			if (size == 0 || alignment == 0)
+			{
+				return InvalidOffset;
+			}
+
+			RetireFinishedFrames();
+
+			while (true)
+			{
+				// Once everything has been released, starting over avoids skipping the end of the buffer.
+				if (used == 0)
+				{
+					head = 0;
+				}
+
+				// Ranges never straddle the end of the buffer, so the remainder is skipped when they do not fit.
+				unsigned start = (head + alignment - 1) / alignment * alignment;
+				if (start > capacity || capacity - start < size)
+				{
+					start = 0;
+				}
+
+				const unsigned padding = (start >= head) ? start - head : capacity - head;
+				const unsigned required = padding + size;
+				if (required <= capacity - used)
+				{
+					head = start + size;
+					used += required;
+					currentFrameSize += required;
+
+					return start;
+				}
+
+				if (numFrames == 0)
+				{
+					return InvalidOffset;
+				}
+
+				frames[oldest].fence.Wait();
+				RetireOldestFrame();
+			}
+		}
+
+		// Fences the ranges allocated since the last call. Should be called once the GPU commands reading them have been issued.
+		void EndFrame()
+		{
+			if (currentFrameSize == 0)
+			{
+				return;
+			}
+
+			if (numFrames == MaxFrames)
+			{
+				frames[oldest].fence.Wait();
+				RetireOldestFrame();
+			}
+
+			Frame& frame = frames[(oldest + numFrames) % MaxFrames];
+			frame.fence.Insert();
+			frame.size = currentFrameSize;
+
+			numFrames++;
+			currentFrameSize = 0;
+		}
+
+		// Waits for the GPU to finish with every frame, then starts over from an empty buffer of the given size.
+		void Reset(unsigned newCapacity)
+		{
+			while (numFrames > 0)
+			{
+				frames[oldest].fence.Wait();
+				RetireOldestFrame();
+			}
+
+			capacity = newCapacity;
+			head = 0;
+			used = 0;
+			currentFrameSize = 0;
+		}
+
+		unsigned GetCapacity() const { return capacity; }
+		// The number of bytes which cannot be allocated until the GPU is finished with them, including the current frame.
+		unsigned GetUsedSize() const { return used; }
+		unsigned GetNumFramesInFlight() const { return numFrames; }
+
+	private:
+		struct Frame
+		{
+			FenceType fence;
+			unsigned size = 0;
+		};
+
+		// Releases the frames which the GPU has already finished with, without blocking.
+		void RetireFinishedFrames()
+		{
+			while (numFrames > 0 && frames[oldest].fence.IsSignalled())
+			{
+				RetireOldestFrame();
+			}
+		}
+
+		void RetireOldestFrame()
+		{
+			used -= frames[oldest].size;
+			oldest = (oldest + 1) % MaxFrames;
+			numFrames--;
+		}
+
+		std::array<Frame, MaxFrames> frames;
+		unsigned oldest = 0;
+		unsigned numFrames = 0;
+
+		unsigned capacity = 0;
+		unsigned head = 0;
+		unsigned used = 0;
+		unsigned currentFrameSize = 0;
+	};
+}
@@ -0,0 +1,426 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "AssetBuilder.h"
+#include "gemcutter/Application/FileSystem.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Resource/Encoder.h"
+#include "gemcutter/Utilities/ScopeGuard.h"
+#include "gemcutter/Utilities/String.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	enum class JobResult
+	{
+		Built,
+		Skipped,
+		Failed
+	};
+
+	struct Job
+	{
+		// Relative to the workspace, using '/' as a separator.
+		std::string path;
+		// Null if the file is copied as-is.
+		gem::Encoder* encoder = nullptr;
+
+		uint64_t hash = 0;
+		JobResult result = JobResult::Failed;
+	};
+
+	// 64-bit FNV-1a, matching the hashes used by AssetPacks.
+	constexpr uint64_t HASH_OFFSET = 14695981039346656037ull;
+	constexpr uint64_t HASH_PRIME = 1099511628211ull;
+
+	bool HashFile(std::string_view file, uint64_t& hash)
+	{
+		FILE* handle = fopen(file.data(), "rb");
+		if (handle == nullptr)
+		{
+			return false;
+		}
+		defer { fclose(handle); };
+
+		uint8_t buffer[64 * 1024];
+		while (size_t count = fread(buffer, 1, sizeof(buffer), handle))
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				hash ^= buffer[i];
+				hash *= HASH_PRIME;
+			}
+		}
+
+		return ferror(handle) == 0;
+	}
+
+	std::string GetLowercaseExtension(std::string_view file)
+	{
+		std::string extension = gem::ExtractFileExtension(file);
+		gem::ToLowercase(extension);
+
+		return extension;
+	}
+
+	// Lists every file in the workspace's folders, except for .meta files. The order is deterministic.
+	// Files in the root of the workspace, such as its configuration and the BuildCache, are not assets.
+	bool FindWorkspaceFiles(const fs::path& root, std::vector<std::string>& outFiles)
+	{
+		std::error_code error;
+		for (fs::recursive_directory_iterator itr(root, error), end; !error && itr != end; itr.increment(error))
+		{
+			if (!itr->is_regular_file())
+			{
+				continue;
+			}
+
+			std::string path = fs::relative(itr->path(), root).generic_string();
+			if (itr.depth() == 0 || GetLowercaseExtension(path) == ".meta")
+			{
+				continue;
+			}
+
+			outFiles.push_back(std::move(path));
+		}
+
+		if (error)
+		{
+			gem::Error("AssetBuilder: ( %s )\nUnable to read the workspace: %s", root.string().c_str(), error.message().c_str());
+			return false;
+		}
+
+		std::ranges::sort(outFiles);
+		return true;
+	}
+
+	// Runs the function for every job on a pool of threads. Each thread takes the next job in the list as soon as it is free.
+	template<typename Function>
+	void RunJobs(std::span<Job> jobs, unsigned numThreads, Function function)
+	{
+		if (numThreads == 0)
+		{
+			numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+		numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, jobs.size()));
+
+		std::atomic<size_t> nextJob = 0;
+		auto worker = [&]() {
+			for (size_t i = nextJob++; i < jobs.size(); i = nextJob++)
+			{
+				function(jobs[i]);
+			}
+		};
+
+		std::vector<std::jthread> threads;
+		threads.reserve(numThreads);
+		for (unsigned i = 1; i < numThreads; ++i)
+		{
+			threads.emplace_back(worker);
+		}
+
+		// The calling thread also takes part.
+		worker();
+	}
+}
+
+namespace gem
+{
+	bool HashAssetSource(std::string_view file, uint64_t& outHash, unsigned encoderVersion)
+	{
+		uint64_t hash = HASH_OFFSET;
+		if (!HashFile(file, hash))
+		{
+			return false;
+		}
+
+		// Separates the file from its metadata, so that assets with and without a .meta file never match.
+		hash ^= 0xFF;
+		hash *= HASH_PRIME;
+
+		const std::string metaFile = std::string(file) + ".meta";
+		if (FileExists(metaFile) && !HashFile(metaFile, hash))
+		{
+			return false;
+		}
+
+		for (unsigned i = 0; i < sizeof(encoderVersion); ++i)
+		{
+			hash ^= (encoderVersion >> (i * 8)) & 0xFF;
+			hash *= HASH_PRIME;
+		}
+
+		outHash = hash;
+		return true;
+	}
+
+	bool BuildCache::Load(std::string_view file)
+	{
+		entries.clear();
+
+		std::string contents;
+		if (!LoadFileAsString(file, contents))
+		{
+			return false;
+		}
+
+		// Each line is a hash in hexadecimal, followed by the path of the asset.
+		std::string_view text = contents;
+		while (!text.empty())
+		{
+			const size_t end = text.find('\n');
+			const std::string_view line = text.substr(0, end);
+			text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+			uint64_t hash;
+			const auto result = std::from_chars(line.data(), line.data() + line.size(), hash, 16);
+			if (result.ec != std::errc() || result.ptr == line.data() + line.size() || *result.ptr != ' ')
+			{
+				Error("BuildCache: ( %s )\nFile is corrupt.", file.data());
+				entries.clear();
+				return false;
+			}
+
+			entries[std::string(result.ptr + 1, line.data() + line.size())] = hash;
+		}
+
+		return true;
+	}
+
+	bool BuildCache::Save(std::string_view file) const
+	{
+		FILE* cacheFile = fopen(file.data(), "wb");
+		if (cacheFile == nullptr)
+		{
+			Error("BuildCache: ( %s )\nUnable to create file.", file.data());
+			return false;
+		}
+		defer { fclose(cacheFile); };
+
+		for (const auto& [path, hash] : entries)
+		{
+			fprintf(cacheFile, "%016llx %s\n", static_cast<unsigned long long>(hash), path.c_str());
+		}
+
+		return ferror(cacheFile) == 0;
+	}
+
+	void BuildCache::Clear()
+	{
+		entries.clear();
+	}
+
+	bool BuildCache::IsUpToDate(std::string_view path, uint64_t hash) const
+	{
+		auto itr = entries.find(std::string(path));
+		return itr != entries.end() && itr->second == hash;
+	}
+
+	void BuildCache::Set(std::string_view path, uint64_t hash)
+	{
+		entries[std::string(path)] = hash;
+	}
+
+	unsigned BuildCache::GetSize() const
+	{
+		return static_cast<unsigned>(entries.size());
+	}
+
+	void AssetBuilder::AddEncoder(std::string_view extension, Encoder& encoder)
+	{
+		ASSERT(extension.starts_with('.'), "Extensions must start with a '.'");
+
+		std::string key(extension);
+		ToLowercase(key);
+
+		encoders[key] = &encoder;
+	}
+
+	void AssetBuilder::ExcludeExtension(std::string_view extension)
+	{
+		ASSERT(extension.starts_with('.'), "Extensions must start with a '.'");
+
+		std::string key(extension);
+		ToLowercase(key);
+
+		excludedExtensions.push_back(std::move(key));
+	}
+
+	bool AssetBuilder::Update(std::string_view workspace, unsigned numThreads)
+	{
+		const fs::path root(workspace);
+
+		std::vector<std::string> files;
+		if (!FindWorkspaceFiles(root, files))
+		{
+			return false;
+		}
+
+		std::vector<Job> jobs;
+		for (std::string& file : files)
+		{
+			if (Encoder* encoder = FindEncoder(file))
+			{
+				jobs.push_back({ .path = std::move(file), .encoder = encoder });
+			}
+		}
+
+		RunJobs(jobs, numThreads, [&root](Job& job) {
+			if (job.encoder->Update((root / job.path).string()))
+			{
+				job.result = JobResult::Built;
+			}
+			else
+			{
+				Error("Failed to update: %s", job.path.c_str());
+			}
+		});
+
+		return std::ranges::none_of(jobs, [](const Job& job) { return job.result == JobResult::Failed; });
+	}
+
+	bool AssetBuilder::Build(std::string_view workspace, std::string_view output, unsigned numThreads, bool rebuild)
+	{
+		numBuilt = 0;
+		numSkipped = 0;
+		numFailed = 0;
+
+		const fs::path root(workspace);
+		const fs::path outputRoot(output);
+		const std::string cacheFile = (root / CacheFile).string();
+
+		std::vector<std::string> files;
+		if (!FindWorkspaceFiles(root, files))
+		{
+			return false;
+		}
+
+		// Deleting the output folder also forces a full rebuild.
+		BuildCache cache;
+		if (!rebuild && fs::is_directory(outputRoot) && FileExists(cacheFile))
+		{
+			cache.Load(cacheFile);
+		}
+
+		std::vector<Job> jobs;
+		jobs.reserve(files.size());
+		for (std::string& file : files)
+		{
+			Encoder* encoder = FindEncoder(file);
+			if (encoder == nullptr && IsExcluded(file))
+			{
+				continue;
+			}
+
+			jobs.push_back({ .path = std::move(file), .encoder = encoder });
+		}
+
+		// Mirror the folder structure up front, since the Encoders only create files.
+		for (const Job& job : jobs)
+		{
+			std::error_code error;
+			fs::create_directories((outputRoot / job.path).parent_path(), error);
+			if (error)
+			{
+				Error("AssetBuilder: ( %s )\nUnable to create the output folder: %s", output.data(), error.message().c_str());
+				return false;
+			}
+		}
+
+		RunJobs(jobs, numThreads, [&](Job& job) {
+			const fs::path source = root / job.path;
+			const fs::path destination = outputRoot / job.path;
+			const std::string destinationFolder = destination.parent_path().string() + '/';
+
+			if (!HashAssetSource(source.string(), job.hash, job.encoder ? job.encoder->GetVersion() : 0))
+			{
+				Error("Failed to read: %s", job.path.c_str());
+				return;
+			}
+
+			// Outputs which have been deleted since the last build are replaced, if the Encoder reports where they are.
+			const fs::path outputFile = job.encoder ? fs::path(job.encoder->GetOutputFile(source.string(), destinationFolder)) : destination;
+			if (cache.IsUpToDate(job.path, job.hash) && (outputFile.empty() || fs::exists(outputFile)))
+			{
+				job.result = JobResult::Skipped;
+				return;
+			}
+
+			bool success;
+			if (job.encoder)
+			{
+				Log("Encoding: %s", job.path.c_str());
+				success = job.encoder->Pack(source.string(), destinationFolder);
+			}
+			else
+			{
+				Log("Copying:  %s", job.path.c_str());
+
+				std::error_code error;
+				success = fs::copy_file(source, destination, fs::copy_options::overwrite_existing, error);
+			}
+
+			if (success)
+			{
+				job.result = JobResult::Built;
+			}
+			else
+			{
+				Error("Failed to build: %s", job.path.c_str());
+			}
+		});
+
+		// Failed files are left out of the cache so that they are attempted again, and deleted files are forgotten.
+		BuildCache newCache;
+		for (const Job& job : jobs)
+		{
+			switch (job.result)
+			{
+			case JobResult::Built:   numBuilt++;   break;
+			case JobResult::Skipped: numSkipped++; break;
+			case JobResult::Failed:  numFailed++;  continue;
+			}
+
+			newCache.Set(job.path, job.hash);
+		}
+
+		newCache.Save(cacheFile);
+
+		Log("Built %u files, skipped %u unchanged files, %u failed.", numBuilt, numSkipped, numFailed);
+
+		return numFailed == 0;
+	}
+
+	unsigned AssetBuilder::GetNumBuilt() const
+	{
+		return numBuilt;
+	}
+
+	unsigned AssetBuilder::GetNumSkipped() const
+	{
+		return numSkipped;
+	}
+
+	unsigned AssetBuilder::GetNumFailed() const
+	{
+		return numFailed;
+	}
+
+	Encoder* AssetBuilder::FindEncoder(std::string_view file) const
+	{
+		auto itr = encoders.find(GetLowercaseExtension(file));
+		return itr != encoders.end() ? itr->second : nullptr;
+	}
+
+	bool AssetBuilder::IsExcluded(std::string_view file) const
+	{
+		return std::ranges::find(excludedExtensions, GetLowercaseExtension(file)) != excludedExtensions.end();
+	}
+}
@@ -0,0 +1,79 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace gem
+{
+	class Encoder;
+
+	// Hashes the contents of a source asset together with its .meta file, if it has one.
+	// The version of the asset's Encoder is included, so that upgrading an Encoder invalidates its assets.
+	// Returns false if the source file could not be read.
+	bool HashAssetSource(std::string_view file, uint64_t& outHash, unsigned encoderVersion = 0);
+
+	// Remembers the hash of each source asset as of its last successful build.
+	// Paths are stored relative to the workspace, so the cache is not invalidated if the workspace is moved.
+	class BuildCache
+	{
+	public:
+		bool Load(std::string_view file);
+		bool Save(std::string_view file) const;
+		void Clear();
+
+		// Returns true if the asset was last built from the same source and metadata.
+		bool IsUpToDate(std::string_view path, uint64_t hash) const;
+		void Set(std::string_view path, uint64_t hash);
+
+		unsigned GetSize() const;
+
+	private:
+		std::unordered_map<std::string, uint64_t> entries;
+	};
+
+	// Builds a workspace of source assets into an output folder, mirroring its folder structure.
+	// As with the AssetManager, only files inside of the workspace's folders are considered to be assets.
+	// Files with a registered extension are converted by their Encoder, and all other files are copied as-is.
+	// The work is spread across a pool of threads, so Encoders must not modify shared state while converting.
+	//
+	// A BuildCache is kept in the workspace so that assets are only rebuilt when their source, metadata, or Encoder
+	// version changes, or when their output has been removed.
+	class AssetBuilder
+	{
+	public:
+		// The name of the BuildCache file in the root of the workspace.
+		static constexpr std::string_view CacheFile = "Build.cache";
+
+		// Files with the extension, such as ".obj", will be converted with the Encoder. Extensions are not case sensitive.
+		void AddEncoder(std::string_view extension, Encoder& encoder);
+		// Files with the extension will not be copied to the output folder.
+		void ExcludeExtension(std::string_view extension);
+
+		// Ensures that every convertible file in the workspace has an up to date .meta file.
+		bool Update(std::string_view workspace, unsigned numThreads = 0);
+
+		// Converts or copies all files in the workspace into the output folder.
+		// Unless 'rebuild' is set, files which are unchanged since the last build are skipped.
+		// Returns false if any file failed to build. Those files will be attempted again on the next build.
+		bool Build(std::string_view workspace, std::string_view output, unsigned numThreads = 0, bool rebuild = false);
+
+		// Statistics from the most recent build.
+		unsigned GetNumBuilt() const;
+		unsigned GetNumSkipped() const;
+		unsigned GetNumFailed() const;
+
+	private:
+		Encoder* FindEncoder(std::string_view file) const;
+		bool IsExcluded(std::string_view file) const;
+
+		std::unordered_map<std::string, Encoder*> encoders;
+		std::vector<std::string> excludedExtensions;
+
+		unsigned numBuilt = 0;
+		unsigned numSkipped = 0;
+		unsigned numFailed = 0;
+	};
+}
@@ -0,0 +1,482 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "AssetPack.h"
+#include "gemcutter/Application/FileSystem.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Utilities/Compression.h"
+#include "gemcutter/Utilities/ScopeGuard.h"
+#include "gemcutter/Utilities/String.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <mutex>
+#include <shared_mutex>
+#include <Windows.h>
+
+namespace
+{
+	constexpr char PACK_MAGIC[4] = { 'G', 'P', 'A', 'K' };
+	constexpr uint32_t PACK_VERSION = 1;
+
+	struct PackHeader
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t numEntries;
+		uint32_t pathTableSize;
+	};
+
+	static_assert(sizeof(PackHeader) % alignof(gem::AssetPackEntry) == 0, "Entries must be aligned when mapped.");
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	// Protects the list of mounted packs, which is read by all of the loading threads.
+	std::shared_mutex mountMutex;
+	std::vector<std::shared_ptr<const gem::AssetPack>> mountedPacks;
+}
+
+namespace gem
+{
+	std::string NormalizeAssetPath(std::string_view path)
+	{
+		std::string result(path);
+		std::ranges::replace(result, '\\', '/');
+		ToLowercase(result);
+
+		while (result.starts_with("./"))
+		{
+			result.erase(0, 2);
+		}
+
+		return result;
+	}
+
+	uint64_t HashAssetPath(std::string_view normalizedPath)
+	{
+		// 64-bit FNV-1a. This must never change, since the hashes are stored in the packs.
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : normalizedPath)
+		{
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+
+		return hash;
+	}
+
+	AssetPack::~AssetPack()
+	{
+		Close();
+	}
+
+	bool AssetPack::Open(std::string_view file)
+	{
+		ASSERT(!IsOpen(), "AssetPack is already open.");
+
+		HANDLE hFile = CreateFileA(file.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			Error("AssetPack: ( %s )\nUnable to open file.", file.data());
+			return false;
+		}
+		fileHandle = hFile;
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(hFile, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) < sizeof(PackHeader))
+		{
+			Error("AssetPack: ( %s )\nFile is too small to be a pack.", file.data());
+			Close();
+			return false;
+		}
+
+		HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (hMapping == nullptr)
+		{
+			Error("AssetPack: ( %s )\nUnable to map file.", file.data());
+			Close();
+			return false;
+		}
+		mappingHandle = hMapping;
+
+		void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			Error("AssetPack: ( %s )\nUnable to map file.", file.data());
+			Close();
+			return false;
+		}
+		mapping = { static_cast<const std::byte*>(view), static_cast<size_t>(fileSize.QuadPart) };
+
+		// Validate the table of contents so that lookups can trust it from here on.
+		PackHeader header;
+		std::memcpy(&header, mapping.data(), sizeof(header));
+		if (std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header.version != PACK_VERSION)
+		{
+			Error("AssetPack: ( %s )\nFile is not a supported pack.", file.data());
+			Close();
+			return false;
+		}
+
+		const uint64_t entriesSize = static_cast<uint64_t>(header.numEntries) * sizeof(AssetPackEntry);
+		const uint64_t pathTableOffset = sizeof(PackHeader) + entriesSize;
+		if (pathTableOffset + header.pathTableSize > mapping.size())
+		{
+			Error("AssetPack: ( %s )\nFile is truncated.", file.data());
+			Close();
+			return false;
+		}
+
+		entries = { reinterpret_cast<const AssetPackEntry*>(mapping.data() + sizeof(PackHeader)), header.numEntries };
+		pathTable = { reinterpret_cast<const char*>(mapping.data() + pathTableOffset), header.pathTableSize };
+
+		const bool isValid = std::ranges::is_sorted(entries, {}, &AssetPackEntry::hash) &&
+			std::ranges::all_of(entries, [this](const AssetPackEntry& entry) {
+				return entry.offset <= mapping.size() &&
+					entry.size <= mapping.size() - entry.offset &&
+					static_cast<uint64_t>(entry.pathOffset) + entry.pathLength <= pathTable.size() &&
+					(entry.compression == AssetCompression::None ? entry.size == entry.originalSize : entry.compression == AssetCompression::LZ4);
+			});
+
+		if (!isValid)
+		{
+			Error("AssetPack: ( %s )\nTable of contents is corrupt.", file.data());
+			Close();
+			return false;
+		}
+
+		filePath = file;
+
+		return true;
+	}
+
+	void AssetPack::Close()
+	{
+		if (!mapping.empty())
+		{
+			UnmapViewOfFile(mapping.data());
+		}
+
+		if (mappingHandle != nullptr)
+		{
+			CloseHandle(mappingHandle);
+		}
+
+		if (fileHandle != nullptr)
+		{
+			CloseHandle(fileHandle);
+		}
+
+		fileHandle = nullptr;
+		mappingHandle = nullptr;
+		mapping = {};
+		entries = {};
+		pathTable = {};
+		filePath.clear();
+	}
+
+	bool AssetPack::IsOpen() const
+	{
+		return !mapping.empty();
+	}
+
+	const AssetPackEntry* AssetPack::Find(std::string_view path) const
+	{
+		const std::string normalizedPath = NormalizeAssetPath(path);
+
+		auto [begin, end] = std::ranges::equal_range(entries, HashAssetPath(normalizedPath), {}, &AssetPackEntry::hash);
+		for (auto itr = begin; itr != end; ++itr)
+		{
+			if (GetPath(*itr) == normalizedPath)
+			{
+				return &*itr;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool AssetPack::Read(const AssetPackEntry& entry, std::span<const std::byte>& output, std::vector<std::byte>& storage) const
+	{
+		const std::span<const std::byte> payload = GetPayload(entry);
+
+		if (entry.compression == AssetCompression::None)
+		{
+			output = payload;
+			return true;
+		}
+
+		storage.resize(entry.originalSize);
+		if (!DecompressLZ4(payload, storage))
+		{
+			Error("AssetPack: ( %s )\nFailed to decompress \"%.*s\".", filePath.c_str(), entry.pathLength, GetPath(entry).data());
+			storage.clear();
+			return false;
+		}
+
+		output = storage;
+		return true;
+	}
+
+	std::span<const std::byte> AssetPack::GetPayload(const AssetPackEntry& entry) const
+	{
+		return mapping.subspan(entry.offset, entry.size);
+	}
+
+	std::string_view AssetPack::GetPath(const AssetPackEntry& entry) const
+	{
+		return pathTable.substr(entry.pathOffset, entry.pathLength);
+	}
+
+	std::span<const AssetPackEntry> AssetPack::GetEntries() const
+	{
+		return entries;
+	}
+
+	const std::string& AssetPack::GetFilePath() const
+	{
+		return filePath;
+	}
+
+	AssetPackWriter::AssetPackWriter(unsigned _alignment)
+		: alignment(_alignment)
+	{
+		ASSERT(std::has_single_bit(alignment), "'alignment' must be a power of 2.");
+	}
+
+	bool AssetPackWriter::Add(std::string_view path, std::span<const std::byte> data, AssetCompression compression)
+	{
+		std::string normalizedPath = NormalizeAssetPath(path);
+		if (std::ranges::find(pending, normalizedPath, &PendingEntry::path) != pending.end())
+		{
+			Error("AssetPackWriter: \"%s\" has already been added to the pack.", normalizedPath.c_str());
+			return false;
+		}
+
+		PendingEntry& entry = pending.emplace_back();
+		entry.hash = HashAssetPath(normalizedPath);
+		entry.path = std::move(normalizedPath);
+		entry.originalSize = data.size();
+		entry.compression = AssetCompression::None;
+
+		if (compression == AssetCompression::LZ4)
+		{
+			CompressLZ4(data, entry.data);
+			if (entry.data.size() < data.size())
+			{
+				entry.compression = AssetCompression::LZ4;
+				return true;
+			}
+		}
+
+		entry.data.assign(data.begin(), data.end());
+		return true;
+	}
+
+	bool AssetPackWriter::AddFile(std::string_view path, std::string_view sourceFile, AssetCompression compression)
+	{
+		std::vector<std::byte> data;
+		if (!LoadFileAsBinary(sourceFile, data))
+		{
+			Error("AssetPackWriter: ( %s )\nUnable to read file.", sourceFile.data());
+			return false;
+		}
+
+		return Add(path, data, compression);
+	}
+
+	bool AssetPackWriter::Save(std::string_view file) const
+	{
+		// Entries with colliding hashes are kept in a stable order so that packs are reproducible.
+		std::vector<const PendingEntry*> sorted;
+		sorted.reserve(pending.size());
+		for (const PendingEntry& entry : pending)
+		{
+			sorted.push_back(&entry);
+		}
+
+		std::ranges::sort(sorted, [](const PendingEntry* a, const PendingEntry* b) {
+			return a->hash != b->hash ? a->hash < b->hash : a->path < b->path;
+		});
+
+		std::string pathTable;
+		std::vector<AssetPackEntry> entries;
+		entries.reserve(sorted.size());
+		for (const PendingEntry* entry : sorted)
+		{
+			entries.push_back({
+				.hash         = entry->hash,
+				.offset       = 0,
+				.size         = entry->data.size(),
+				.originalSize = entry->originalSize,
+				.pathOffset   = static_cast<uint32_t>(pathTable.size()),
+				.pathLength   = static_cast<uint32_t>(entry->path.size()),
+				.compression  = entry->compression,
+				.padding      = 0
+			});
+
+			pathTable += entry->path;
+		}
+
+		uint64_t offset = sizeof(PackHeader) + entries.size() * sizeof(AssetPackEntry) + pathTable.size();
+		for (AssetPackEntry& entry : entries)
+		{
+			entry.offset = AlignUp(offset, alignment);
+			offset = entry.offset + entry.size;
+		}
+
+		PackHeader header;
+		std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+		header.version = PACK_VERSION;
+		header.numEntries = static_cast<uint32_t>(entries.size());
+		header.pathTableSize = static_cast<uint32_t>(pathTable.size());
+
+		FILE* packFile = fopen(file.data(), "wb");
+		if (packFile == nullptr)
+		{
+			Error("AssetPackWriter: ( %s )\nUnable to open file for writing.", file.data());
+			return false;
+		}
+		defer { fclose(packFile); };
+
+		bool success =
+			fwrite(&header, sizeof(header), 1, packFile) == 1 &&
+			fwrite(entries.data(), sizeof(AssetPackEntry), entries.size(), packFile) == entries.size() &&
+			fwrite(pathTable.data(), 1, pathTable.size(), packFile) == pathTable.size();
+
+		const std::vector<std::byte> padding(alignment);
+		uint64_t position = sizeof(PackHeader) + entries.size() * sizeof(AssetPackEntry) + pathTable.size();
+		for (size_t i = 0; success && i < entries.size(); ++i)
+		{
+			const size_t paddingSize = static_cast<size_t>(entries[i].offset - position);
+			const std::vector<std::byte>& data = sorted[i]->data;
+
+			success =
+				fwrite(padding.data(), 1, paddingSize, packFile) == paddingSize &&
+				(data.empty() || fwrite(data.data(), 1, data.size(), packFile) == data.size());
+
+			position = entries[i].offset + entries[i].size;
+		}
+
+		if (!success)
+		{
+			Error("AssetPackWriter: ( %s )\nFailed to write file.", file.data());
+			return false;
+		}
+
+		return true;
+	}
+
+	unsigned AssetPackWriter::GetNumEntries() const
+	{
+		return static_cast<unsigned>(pending.size());
+	}
+
+	bool MountAssetPack(std::string_view file)
+	{
+		auto pack = std::make_shared<AssetPack>();
+		if (!pack->Open(file))
+		{
+			return false;
+		}
+
+		std::unique_lock lock(mountMutex);
+		mountedPacks.push_back(std::move(pack));
+
+		return true;
+	}
+
+	bool UnmountAssetPack(std::string_view file)
+	{
+		std::unique_lock lock(mountMutex);
+
+		auto itr = std::ranges::find_if(mountedPacks, [file](const std::shared_ptr<const AssetPack>& pack) {
+			return pack->GetFilePath() == file;
+		});
+
+		if (itr == mountedPacks.end())
+		{
+			return false;
+		}
+
+		mountedPacks.erase(itr);
+		return true;
+	}
+
+	void UnmountAllAssetPacks()
+	{
+		std::unique_lock lock(mountMutex);
+		mountedPacks.clear();
+	}
+
+	bool AssetFile::Open(std::string_view path)
+	{
+		Close();
+
+		std::shared_ptr<const AssetPack> sourcePack;
+		const AssetPackEntry* entry = nullptr;
+		{
+			std::shared_lock lock(mountMutex);
+			for (auto itr = mountedPacks.rbegin(); itr != mountedPacks.rend(); ++itr)
+			{
+				entry = (*itr)->Find(path);
+				if (entry)
+				{
+					sourcePack = *itr;
+					break;
+				}
+			}
+		}
+
+		if (entry)
+		{
+			if (!sourcePack->Read(*entry, data, storage))
+			{
+				return false;
+			}
+
+			// Only views into the pack need to keep it alive.
+			if (storage.empty())
+			{
+				pack = std::move(sourcePack);
+			}
+		}
+		else
+		{
+			if (!LoadFileAsBinary(path, storage))
+			{
+				return false;
+			}
+
+			data = storage;
+		}
+
+		isOpen = true;
+		return true;
+	}
+
+	void AssetFile::Close()
+	{
+		pack.reset();
+		storage = {};
+		data = {};
+		isOpen = false;
+	}
+
+	bool AssetFile::IsOpen() const
+	{
+		return isOpen;
+	}
+
+	bool AssetFile::IsMapped() const
+	{
+		return pack != nullptr;
+	}
+
+	std::span<const std::byte> AssetFile::GetData() const
+	{
+		return data;
+	}
+}
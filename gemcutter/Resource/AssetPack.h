@@ -0,0 +1,151 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gem
+{
+	enum class AssetCompression : uint32_t
+	{
+		None,
+		LZ4
+	};
+
+	// Describes a single file stored in an AssetPack.
+	struct AssetPackEntry
+	{
+		// The hash of the normalized path. The table of contents is sorted by this value.
+		uint64_t hash;
+		// The location of the payload from the start of the pack.
+		uint64_t offset;
+		// The size of the payload as it is stored in the pack.
+		uint64_t size;
+		// The size of the file once decompressed.
+		uint64_t originalSize;
+		// The location of the normalized path in the pack's path table.
+		uint32_t pathOffset;
+		uint32_t pathLength;
+		AssetCompression compression;
+		uint32_t padding;
+	};
+
+	// Converts a path to the form used to identify files in an AssetPack.
+	// Paths are lowercase, use '/' as a separator, and do not start with "./".
+	std::string NormalizeAssetPath(std::string_view path);
+
+	// Returns the stable 64-bit hash used to sort and find normalized paths in an AssetPack.
+	uint64_t HashAssetPath(std::string_view normalizedPath);
+
+	// A read-only archive of packed assets, mapped directly into memory.
+	//
+	// The pack is laid out as:
+	//	Header         : magic, version, number of entries, size of the path table.
+	//	Entries        : an AssetPackEntry for each file, sorted by the hash of its path.
+	//	Path Table     : the normalized path of each file, used to resolve hash collisions.
+	//	Payloads       : the contents of each file, starting at an aligned offset.
+	//
+	// Uncompressed files can be parsed directly from the mapped memory without copying them.
+	class AssetPack
+	{
+	public:
+		AssetPack() = default;
+		AssetPack(const AssetPack&) = delete;
+		AssetPack& operator=(const AssetPack&) = delete;
+		~AssetPack();
+
+		// Maps the pack into memory and validates its table of contents.
+		bool Open(std::string_view file);
+		void Close();
+		bool IsOpen() const;
+
+		// Returns the entry for the file, or null if it is not in the pack.
+		const AssetPackEntry* Find(std::string_view path) const;
+
+		// Provides the contents of the file. Uncompressed files are viewed directly from the pack, in which case
+		// 'storage' is left untouched. Compressed files are decompressed into 'storage'.
+		bool Read(const AssetPackEntry& entry, std::span<const std::byte>& output, std::vector<std::byte>& storage) const;
+
+		// Returns the raw payload of the entry, as it is stored in the pack.
+		std::span<const std::byte> GetPayload(const AssetPackEntry& entry) const;
+		std::string_view GetPath(const AssetPackEntry& entry) const;
+
+		std::span<const AssetPackEntry> GetEntries() const;
+		const std::string& GetFilePath() const;
+
+	private:
+		std::string filePath;
+
+		void* fileHandle = nullptr;
+		void* mappingHandle = nullptr;
+		std::span<const std::byte> mapping;
+
+		std::span<const AssetPackEntry> entries;
+		std::string_view pathTable;
+	};
+
+	// Collects files and saves them as an AssetPack.
+	class AssetPackWriter
+	{
+	public:
+		// Every payload will start at a multiple of the alignment. Must be a power of 2.
+		explicit AssetPackWriter(unsigned alignment = 16);
+
+		// Adds the data to the pack under the given path. Returns false if the path is already in use.
+		// If compression does not reduce the size of the data, it is stored uncompressed instead.
+		bool Add(std::string_view path, std::span<const std::byte> data, AssetCompression compression = AssetCompression::None);
+
+		// Adds the contents of a file on the disk to the pack under the given path.
+		bool AddFile(std::string_view path, std::string_view sourceFile, AssetCompression compression = AssetCompression::None);
+
+		bool Save(std::string_view file) const;
+
+		unsigned GetNumEntries() const;
+
+	private:
+		struct PendingEntry
+		{
+			std::string path;
+			uint64_t hash;
+			uint64_t originalSize;
+			AssetCompression compression;
+			std::vector<std::byte> data;
+		};
+
+		std::vector<PendingEntry> pending;
+		unsigned alignment;
+	};
+
+	// Makes the contents of the pack visible to AssetFile, and therefore to all Resource loads.
+	// Packs mounted later take priority over those mounted earlier. Can be called from any thread.
+	bool MountAssetPack(std::string_view file);
+	// The pack is closed once all AssetFiles still using it are closed.
+	bool UnmountAssetPack(std::string_view file);
+	void UnmountAllAssetPacks();
+
+	// The contents of a single asset file, for use by Resource loaders.
+	// Files are first searched for in the mounted AssetPacks, then on the disk. Uncompressed
+	// files found in a pack are viewed directly from the mapped pack without being copied.
+	class AssetFile
+	{
+	public:
+		bool Open(std::string_view path);
+		void Close();
+		bool IsOpen() const;
+
+		// Returns true if the contents are viewed directly from a mounted AssetPack.
+		bool IsMapped() const;
+
+		// Remains valid until the file is closed.
+		std::span<const std::byte> GetData() const;
+
+	private:
+		std::shared_ptr<const AssetPack> pack;
+		std::vector<std::byte> storage;
+		std::span<const std::byte> data;
+		bool isOpen = false;
+	};
+}
@@ -222,7 +222,26 @@ namespace gem
 		// Returns the default settings for the asset.
 		virtual ConfigTable GetDefault() const = 0;
 
+		// Returns the path of the packed asset that Convert() writes for the source file into the destination folder.
+		// Returns an empty string if the Encoder does not report its output extension.
+		std::string GetOutputFile(std::string_view source, std::string_view destination) const
+		{
+			const std::string_view extension = GetOutputExtension();
+			if (extension.empty())
+			{
+				return {};
+			}
+
+			return std::string(destination) + ExtractFilename(source) + std::string(extension);
+		}
+
+		unsigned GetVersion() const { return version; }
+
 	protected:
+		// The extension of the packed asset, such as ".model".
+		// If this is not overridden, the output is unknown and is not checked for when deciding to rebuild an asset.
+		virtual std::string_view GetOutputExtension() const { return {}; }
+
 		// Reads from the source file and output the packed asset to the destination file.
 		// 'metadata' will contain settings of the newest version.
 		virtual bool Convert(std::string_view source, std::string_view destination, const ConfigTable& metadata) const = 0;
@@ -3,10 +3,11 @@
 #include "gemcutter/Application/Logging.h"
 #include "gemcutter/Math/Math.h"
 #include "gemcutter/Rendering/Rendering.h"
+#include "gemcutter/Rendering/StateCache.h"
+#include "gemcutter/Resource/AssetPack.h"
 #include "gemcutter/Resource/Texture.h"
-#include "gemcutter/Utilities/ScopeGuard.h"
+#include "gemcutter/Utilities/BinaryReader.h"
 
-#include <cstdio>
 #include <GL/glew.h>
 
 namespace gem
@@ -61,7 +62,7 @@ namespace gem
 			};
 
 			glGenVertexArrays(1, &VAO);
-			glBindVertexArray(VAO);
+			GLState.BindVertexArray(VAO);
 
 			glEnableVertexAttribArray(0); // Position
 			glEnableVertexAttribArray(1); // UV
@@ -76,43 +77,53 @@ namespace gem
 			glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, 0, (std::byte*)nullptr + verticesSize + texCoordsSize);
 
 			glBindBuffer(GL_ARRAY_BUFFER, GL_NONE);
-			glBindVertexArray(GL_NONE);
+			GLState.BindVertexArray(GL_NONE);
 		}
 
 		/* Load Font from file */
-		FILE* fontFile = fopen(filePath.data(), "rb");
-		if (fontFile == nullptr)
+		AssetFile file;
+		if (!file.Open(filePath))
 		{
 			Error("Font: ( %s )\nUnable to open file.", filePath.data());
 			return false;
 		}
 
-		// Load bitmap data.
 		TextureFilter filter;
 		size_t bitmapSize = 0;
-		std::byte* bitmap = nullptr;
-		defer{ free(bitmap); };
-
-		// Read header.
-		fread(&bitmapSize, sizeof(bitmapSize), 1, fontFile);
-		fread(&width, sizeof(width), 1, fontFile);
-		fread(&height, sizeof(height), 1, fontFile);
-		fread(&filter, sizeof(filter), 1, fontFile);
-
-		// Load Data.
-		bitmap = static_cast<std::byte*>(malloc(sizeof(std::byte) * bitmapSize));
-		fread(bitmap, sizeof(std::byte), bitmapSize, fontFile);
-		fread(dimensions.data(), sizeof(dimensions), 1, fontFile);
-		fread(positions.data(),  sizeof(positions),  1, fontFile);
-		fread(advances.data(),   sizeof(advances),   1, fontFile);
-		fread(masks.data(),      sizeof(masks),      1, fontFile);
+		std::span<const std::byte> bitmap;
+
+		// Read the header, followed by the data. The bitmap is viewed directly from the file.
+		BinaryReader reader(file.GetData());
+		const bool success =
+			reader.Read(bitmapSize) &&
+			reader.Read(width) &&
+			reader.Read(height) &&
+			reader.Read(filter) &&
+			reader.View(bitmapSize, bitmap) &&
+			reader.Read(dimensions) &&
+			reader.Read(positions) &&
+			reader.Read(advances) &&
+			reader.Read(masks);
+
+		size_t requiredSize = 0;
+		for (unsigned i = 0; i < 94; ++i)
+		{
+			if (masks[i])
+			{
+				requiredSize += static_cast<size_t>(dimensions[i].x) * dimensions[i].y;
+			}
+		}
 
-		fclose(fontFile);
+		if (!success || requiredSize > bitmap.size())
+		{
+			Error("Font: ( %s )\nFile is truncated.", filePath.data());
+			return false;
+		}
 
 		// Upload data to OpenGL.
 		glGenTextures(94, textures.data());
 
-		std::byte* bitmapItr = bitmap;
+		const std::byte* bitmapItr = bitmap.data();
 		for (unsigned i = 0; i < 94; ++i)
 		{
 			if (!masks[i])
@@ -145,12 +156,17 @@ namespace gem
 		}
 
 		glBindTexture(GL_TEXTURE_2D, GL_NONE);
+		GLState.InvalidateActiveTexture();
 
 		return true;
 	}
 
 	void Font::Unload()
 	{
+		for (unsigned texture : textures)
+		{
+			GLState.OnTextureDeleted(texture);
+		}
 		glDeleteTextures(94, textures.data());
 
 		textures.fill(GL_NONE);
@@ -240,6 +256,20 @@ namespace gem
 		return height;
 	}
 
+	MemoryUsage Font::GetMemoryUsage() const
+	{
+		MemoryUsage usage;
+		for (unsigned i = 0; i < 94; ++i)
+		{
+			if (textures[i] != GL_NONE && masks[i])
+			{
+				usage.gpuBytes += static_cast<size_t>(dimensions[i].x) * dimensions[i].y;
+			}
+		}
+
+		return usage;
+	}
+
 	unsigned Font::GetVAO()
 	{
 		return VAO;
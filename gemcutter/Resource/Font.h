@@ -43,6 +43,9 @@ namespace gem
 		unsigned GetFontWidth() const;
 		unsigned GetFontHeight() const;
 
+		// Returns the size of the glyph textures on the GPU, not including their mipmaps.
+		MemoryUsage GetMemoryUsage() const;
+
 		static unsigned GetVAO();
 		static unsigned GetVBO();
 
@@ -0,0 +1,443 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "MeshOptimizer.h"
+#include "gemcutter/Application/Logging.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+	constexpr unsigned INVALID_INDEX = std::numeric_limits<unsigned>::max();
+
+	// The size of the LRU cache simulated while reordering triangles.
+	// This is larger than most hardware caches, which keeps the result effective across GPUs.
+	constexpr unsigned FORSYTH_CACHE_SIZE = 32;
+
+	float VertexScore(int cachePosition, unsigned remainingTriangles)
+	{
+		if (remainingTriangles == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = 0.0f;
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				// The most recent triangle is given a fixed score, so that the next
+				// triangle doesn't simply reuse the same edge in a long strip.
+				score = 0.75f;
+			}
+			else
+			{
+				const float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+				score = std::pow(1.0f - (cachePosition - 3) * scale, 1.5f);
+			}
+		}
+
+		// Vertices with few remaining triangles are preferred, so that they can be retired from the cache.
+		score += 2.0f / std::sqrt(static_cast<float>(remainingTriangles));
+
+		return score;
+	}
+
+	// Simulates a FIFO post-transform cache. Returns the number of vertices of the triangle which were not cached.
+	unsigned SimulateTriangle(const unsigned* triangle, std::vector<unsigned>& timestamps, unsigned& time, unsigned cacheSize)
+	{
+		unsigned misses = 0;
+		for (unsigned i = 0; i < 3; ++i)
+		{
+			const unsigned vertex = triangle[i];
+			if (time - timestamps[vertex] > cacheSize)
+			{
+				timestamps[vertex] = time++;
+				++misses;
+			}
+		}
+
+		return misses;
+	}
+
+	void FlushCache(unsigned& time, unsigned cacheSize)
+	{
+		time += cacheSize + 1;
+	}
+}
+
+namespace gem
+{
+	unsigned DeduplicateVertices(std::span<const std::byte> vertices, unsigned vertexSize,
+		std::vector<std::byte>& outVertices, std::vector<unsigned>& outIndices)
+	{
+		ASSERT(vertexSize > 0, "'vertexSize' must be greater than zero.");
+		ASSERT(vertices.size() % vertexSize == 0, "'vertices' must contain a whole number of vertices.");
+
+		const size_t numVertices = vertices.size() / vertexSize;
+		const char* data = reinterpret_cast<const char*>(vertices.data());
+
+		// Vertices are compared by their exact bytes.
+		std::unordered_map<std::string_view, unsigned> uniqueVertices;
+		uniqueVertices.reserve(numVertices);
+
+		outVertices.clear();
+		outIndices.clear();
+		outIndices.reserve(numVertices);
+
+		for (size_t i = 0; i < numVertices; ++i)
+		{
+			const std::string_view key(data + i * vertexSize, vertexSize);
+			const auto nextIndex = static_cast<unsigned>(uniqueVertices.size());
+
+			auto [itr, isNew] = uniqueVertices.emplace(key, nextIndex);
+			if (isNew)
+			{
+				outVertices.insert(outVertices.end(), vertices.begin() + i * vertexSize, vertices.begin() + (i + 1) * vertexSize);
+			}
+
+			outIndices.push_back(itr->second);
+		}
+
+		return static_cast<unsigned>(uniqueVertices.size());
+	}
+
+	void OptimizeVertexCache(std::span<unsigned> indices, unsigned numVertices)
+	{
+		ASSERT(indices.size() % 3 == 0, "'indices' must describe a triangle list.");
+
+		const unsigned numTriangles = static_cast<unsigned>(indices.size() / 3);
+		if (numTriangles == 0)
+		{
+			return;
+		}
+
+		// Build the list of triangles adjacent to each vertex.
+		std::vector<unsigned> remainingTriangles(numVertices, 0);
+		for (unsigned index : indices)
+		{
+			ASSERT(index < numVertices, "Index ( %d ) is out of range.", index);
+			++remainingTriangles[index];
+		}
+
+		std::vector<unsigned> adjacencyOffsets(numVertices, 0);
+		for (unsigned i = 1; i < numVertices; ++i)
+		{
+			adjacencyOffsets[i] = adjacencyOffsets[i - 1] + remainingTriangles[i - 1];
+		}
+
+		std::vector<unsigned> adjacency(indices.size());
+		{
+			std::vector<unsigned> counts(numVertices, 0);
+			for (unsigned i = 0; i < indices.size(); ++i)
+			{
+				const unsigned vertex = indices[i];
+				adjacency[adjacencyOffsets[vertex] + counts[vertex]++] = i / 3;
+			}
+		}
+
+		std::vector<float> vertexScores(numVertices);
+		for (unsigned i = 0; i < numVertices; ++i)
+		{
+			vertexScores[i] = VertexScore(-1, remainingTriangles[i]);
+		}
+
+		std::vector<float> triangleScores(numTriangles);
+		for (unsigned i = 0; i < numTriangles; ++i)
+		{
+			triangleScores[i] =
+				vertexScores[indices[i * 3 + 0]] +
+				vertexScores[indices[i * 3 + 1]] +
+				vertexScores[indices[i * 3 + 2]];
+		}
+
+		std::vector<bool> emitted(numTriangles, false);
+		std::vector<unsigned> output;
+		output.reserve(indices.size());
+
+		// Room for the three vertices pushed by each new triangle before the oldest are evicted.
+		unsigned cache[FORSYTH_CACHE_SIZE + 3];
+		unsigned newCache[FORSYTH_CACHE_SIZE + 3];
+		unsigned cacheCount = 0;
+
+		unsigned bestTriangle = static_cast<unsigned>(std::ranges::max_element(triangleScores) - triangleScores.begin());
+		unsigned searchCursor = 0;
+
+		while (bestTriangle != INVALID_INDEX)
+		{
+			emitted[bestTriangle] = true;
+			const unsigned* triangle = &indices[bestTriangle * 3];
+
+			unsigned newCount = 0;
+			for (unsigned i = 0; i < 3; ++i)
+			{
+				const unsigned vertex = triangle[i];
+				output.push_back(vertex);
+
+				// Retire the triangle from the vertex's adjacency list.
+				unsigned* begin = adjacency.data() + adjacencyOffsets[vertex];
+				unsigned* end = begin + remainingTriangles[vertex];
+				unsigned* itr = std::find(begin, end, bestTriangle);
+				ASSERT(itr != end, "Triangle is missing from the adjacency list.");
+				std::swap(*itr, *(end - 1));
+				--remainingTriangles[vertex];
+
+				if (std::find(newCache, newCache + newCount, vertex) == newCache + newCount)
+				{
+					newCache[newCount++] = vertex;
+				}
+			}
+
+			// The rest of the cache moves back to make room for the new triangle.
+			for (unsigned i = 0; i < cacheCount; ++i)
+			{
+				const unsigned vertex = cache[i];
+				if (std::find(newCache, newCache + newCount, vertex) == newCache + newCount)
+				{
+					newCache[newCount++] = vertex;
+				}
+			}
+
+			// Update the scores of every vertex whose position changed, including those pushed out of the cache.
+			for (unsigned i = 0; i < newCount; ++i)
+			{
+				const unsigned vertex = newCache[i];
+				const int position = (i < FORSYTH_CACHE_SIZE) ? static_cast<int>(i) : -1;
+
+				const float score = VertexScore(position, remainingTriangles[vertex]);
+				const float delta = score - vertexScores[vertex];
+				vertexScores[vertex] = score;
+
+				const unsigned* adjacent = adjacency.data() + adjacencyOffsets[vertex];
+				for (unsigned j = 0; j < remainingTriangles[vertex]; ++j)
+				{
+					triangleScores[adjacent[j]] += delta;
+				}
+			}
+
+			cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+			std::copy_n(newCache, cacheCount, cache);
+
+			// The next triangle is the best one which reuses a cached vertex.
+			bestTriangle = INVALID_INDEX;
+			float bestScore = -1.0f;
+			for (unsigned i = 0; i < cacheCount; ++i)
+			{
+				const unsigned vertex = cache[i];
+				const unsigned* adjacent = adjacency.data() + adjacencyOffsets[vertex];
+				for (unsigned j = 0; j < remainingTriangles[vertex]; ++j)
+				{
+					if (triangleScores[adjacent[j]] > bestScore)
+					{
+						bestScore = triangleScores[adjacent[j]];
+						bestTriangle = adjacent[j];
+					}
+				}
+			}
+
+			// Otherwise, we have reached a dead-end and must jump to a new area of the mesh.
+			if (bestTriangle == INVALID_INDEX)
+			{
+				while (searchCursor < numTriangles && emitted[searchCursor])
+				{
+					++searchCursor;
+				}
+
+				if (searchCursor < numTriangles)
+				{
+					bestTriangle = searchCursor;
+				}
+			}
+		}
+
+		std::ranges::copy(output, indices.begin());
+	}
+
+	void OptimizeOverdraw(std::span<unsigned> indices, std::span<const vec3> positions, float threshold)
+	{
+		ASSERT(indices.size() % 3 == 0, "'indices' must describe a triangle list.");
+		ASSERT(threshold >= 1.0f, "'threshold' must be at least 1.0.");
+
+		const unsigned numTriangles = static_cast<unsigned>(indices.size() / 3);
+		if (numTriangles == 0)
+		{
+			return;
+		}
+
+		std::vector<unsigned> timestamps(positions.size(), 0);
+		unsigned time = DEFAULT_VERTEX_CACHE_SIZE + 1;
+
+		// Hard boundaries are where the vertex cache optimizer jumped to a new area of the mesh.
+		// Clusters can be freely reordered at these points since the cache is already cold.
+		std::vector<unsigned> hardClusters;
+		for (unsigned i = 0; i < numTriangles; ++i)
+		{
+			if (SimulateTriangle(&indices[i * 3], timestamps, time, DEFAULT_VERTEX_CACHE_SIZE) == 3)
+			{
+				hardClusters.push_back(i);
+			}
+		}
+		hardClusters.push_back(numTriangles);
+
+		// Large clusters are further split wherever the cost of flushing the cache is within the threshold.
+		std::vector<unsigned> clusters;
+		for (unsigned c = 0; c + 1 < hardClusters.size(); ++c)
+		{
+			const unsigned start = hardClusters[c];
+			const unsigned end = hardClusters[c + 1];
+
+			FlushCache(time, DEFAULT_VERTEX_CACHE_SIZE);
+			unsigned clusterMisses = 0;
+			for (unsigned i = start; i < end; ++i)
+			{
+				clusterMisses += SimulateTriangle(&indices[i * 3], timestamps, time, DEFAULT_VERTEX_CACHE_SIZE);
+			}
+
+			const float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+			FlushCache(time, DEFAULT_VERTEX_CACHE_SIZE);
+			clusters.push_back(start);
+			unsigned subStart = start;
+			unsigned misses = 0;
+			for (unsigned i = start; i < end; ++i)
+			{
+				misses += SimulateTriangle(&indices[i * 3], timestamps, time, DEFAULT_VERTEX_CACHE_SIZE);
+
+				if (i + 1 < end && static_cast<float>(misses) / static_cast<float>(i + 1 - subStart) <= clusterThreshold)
+				{
+					clusters.push_back(i + 1);
+					subStart = i + 1;
+					misses = 0;
+					FlushCache(time, DEFAULT_VERTEX_CACHE_SIZE);
+				}
+			}
+		}
+		const unsigned numClusters = static_cast<unsigned>(clusters.size());
+		clusters.push_back(numTriangles);
+
+		// Find the area-weighted center and normal of each cluster.
+		std::vector<vec3> clusterCenters(numClusters);
+		std::vector<vec3> clusterNormals(numClusters);
+		vec3 meshCenter;
+		float meshArea = 0.0f;
+
+		for (unsigned c = 0; c < numClusters; ++c)
+		{
+			vec3 center;
+			vec3 normal;
+			float clusterArea = 0.0f;
+
+			for (unsigned i = clusters[c]; i < clusters[c + 1]; ++i)
+			{
+				const vec3& p0 = positions[indices[i * 3 + 0]];
+				const vec3& p1 = positions[indices[i * 3 + 1]];
+				const vec3& p2 = positions[indices[i * 3 + 2]];
+
+				const vec3 cross = Cross(p1 - p0, p2 - p0);
+				const float area = Length(cross);
+
+				center += (p0 + p1 + p2) * (area / 3.0f);
+				normal += cross;
+				clusterArea += area;
+			}
+
+			meshCenter += center;
+			meshArea += clusterArea;
+
+			clusterCenters[c] = (clusterArea > 0.0f) ? center / clusterArea : center;
+			clusterNormals[c] = normal;
+		}
+
+		if (meshArea > 0.0f)
+		{
+			meshCenter /= meshArea;
+		}
+
+		// Clusters facing away from the center are likely to be in front of the rest of the mesh.
+		std::vector<float> sortKeys(numClusters);
+		for (unsigned c = 0; c < numClusters; ++c)
+		{
+			const float length = Length(clusterNormals[c]);
+			sortKeys[c] = (length > 0.0f) ? Dot(clusterCenters[c] - meshCenter, clusterNormals[c] / length) : 0.0f;
+		}
+
+		std::vector<unsigned> order(numClusters);
+		for (unsigned c = 0; c < numClusters; ++c)
+		{
+			order[c] = c;
+		}
+
+		std::ranges::stable_sort(order, [&sortKeys](unsigned lhs, unsigned rhs) {
+			return sortKeys[lhs] > sortKeys[rhs];
+		});
+
+		std::vector<unsigned> output;
+		output.reserve(indices.size());
+		for (unsigned c : order)
+		{
+			output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+		}
+
+		std::ranges::copy(output, indices.begin());
+	}
+
+	unsigned OptimizeVertexFetch(std::span<unsigned> indices, std::vector<std::byte>& vertices, unsigned vertexSize)
+	{
+		ASSERT(vertexSize > 0, "'vertexSize' must be greater than zero.");
+		ASSERT(vertices.size() % vertexSize == 0, "'vertices' must contain a whole number of vertices.");
+
+		const size_t numVertices = vertices.size() / vertexSize;
+
+		std::vector<unsigned> remap(numVertices, INVALID_INDEX);
+		unsigned nextVertex = 0;
+		for (unsigned& index : indices)
+		{
+			ASSERT(index < numVertices, "Index ( %d ) is out of range.", index);
+
+			if (remap[index] == INVALID_INDEX)
+			{
+				remap[index] = nextVertex++;
+			}
+
+			index = remap[index];
+		}
+
+		std::vector<std::byte> output(static_cast<size_t>(nextVertex) * vertexSize);
+		for (size_t i = 0; i < numVertices; ++i)
+		{
+			if (remap[i] != INVALID_INDEX)
+			{
+				std::memcpy(output.data() + static_cast<size_t>(remap[i]) * vertexSize, vertices.data() + i * vertexSize, vertexSize);
+			}
+		}
+
+		vertices = std::move(output);
+
+		return nextVertex;
+	}
+
+	float CalculateACMR(std::span<const unsigned> indices, unsigned numVertices, unsigned cacheSize)
+	{
+		ASSERT(indices.size() % 3 == 0, "'indices' must describe a triangle list.");
+
+		const unsigned numTriangles = static_cast<unsigned>(indices.size() / 3);
+		if (numTriangles == 0)
+		{
+			return 0.0f;
+		}
+
+		std::vector<unsigned> timestamps(numVertices, 0);
+		unsigned time = cacheSize + 1;
+		unsigned misses = 0;
+
+		for (unsigned i = 0; i < numTriangles; ++i)
+		{
+			misses += SimulateTriangle(&indices[i * 3], timestamps, time, cacheSize);
+		}
+
+		return static_cast<float>(misses) / static_cast<float>(numTriangles);
+	}
+}
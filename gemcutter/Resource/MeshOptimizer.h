@@ -0,0 +1,37 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Math/Vector.h"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace gem
+{
+	// The number of vertices assumed to fit in the GPU's post-transform cache.
+	constexpr unsigned DEFAULT_VERTEX_CACHE_SIZE = 16;
+
+	// Merges identical vertices of a non-indexed triangle list.
+	// 'vertices' contains tightly packed vertices of 'vertexSize' bytes each.
+	// The unique vertices are written to 'outVertices', and 'outIndices' receives one index per input vertex.
+	// Returns the number of unique vertices.
+	unsigned DeduplicateVertices(std::span<const std::byte> vertices, unsigned vertexSize,
+		std::vector<std::byte>& outVertices, std::vector<unsigned>& outIndices);
+
+	// Reorders the triangles of an indexed triangle list to reuse recently transformed vertices.
+	// Based on Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+	void OptimizeVertexCache(std::span<unsigned> indices, unsigned numVertices);
+
+	// Reorders clusters of triangles so that those facing away from the center of the mesh are drawn first,
+	// allowing them to occlude the rest of the mesh. The triangles should already be optimized for the vertex cache.
+	// 'threshold' controls how much the cache efficiency may worsen (as a ratio) in order to form smaller clusters.
+	void OptimizeOverdraw(std::span<unsigned> indices, std::span<const vec3> positions, float threshold = 1.05f);
+
+	// Reorders the vertices to match the order in which they are first referenced by the indices, which are remapped.
+	// Unreferenced vertices are removed. Returns the number of vertices remaining.
+	unsigned OptimizeVertexFetch(std::span<unsigned> indices, std::vector<std::byte>& vertices, unsigned vertexSize);
+
+	// Returns the average number of vertices transformed per triangle, using a FIFO cache of the given size.
+	// This ranges from 3.0 (no reuse at all) down to around 0.5 for a regular grid.
+	float CalculateACMR(std::span<const unsigned> indices, unsigned numVertices, unsigned cacheSize = DEFAULT_VERTEX_CACHE_SIZE);
+}
@@ -1,94 +1,199 @@
 // Copyright (c) 2017 Emilian Cioca
 #include "Model.h"
 #include "gemcutter/Application/Logging.h"
-#include "gemcutter/Utilities/ScopeGuard.h"
+#include "gemcutter/Utilities/BinaryReader.h"
+#include "gemcutter/Utilities/StdExt.h"
+
+namespace
+{
+	gem::VertexFormat ResolveStreamFormat(gem::PositionFormat format)
+	{
+		switch (format)
+		{
+		case gem::PositionFormat::Half:    return gem::VertexFormat::HalfVec4;
+		case gem::PositionFormat::UNorm16: return gem::VertexFormat::uShortVec4;
+		default:                           return gem::VertexFormat::Vec3;
+		}
+	}
+
+	gem::VertexFormat ResolveStreamFormat(gem::UVFormat format)
+	{
+		return (format == gem::UVFormat::Half) ? gem::VertexFormat::HalfVec2 : gem::VertexFormat::Vec2;
+	}
+
+	gem::VertexFormat ResolveNormalStreamFormat(gem::NormalFormat format)
+	{
+		return (format == gem::NormalFormat::Octahedral) ? gem::VertexFormat::ShortVec2 : gem::VertexFormat::Vec3;
+	}
+
+	gem::VertexFormat ResolveTangentStreamFormat(gem::NormalFormat format)
+	{
+		return (format == gem::NormalFormat::Octahedral) ? gem::VertexFormat::ShortVec4 : gem::VertexFormat::Vec4;
+	}
+}
 
 namespace gem
 {
 	bool Model::Load(std::string_view filePath)
 	{
-		// Load binary file.
-		FILE* binaryFile = fopen(filePath.data(), "rb");
-		if (binaryFile == nullptr)
+		return LoadData(filePath) && Upload();
+	}
+
+	bool Model::LoadData(std::string_view filePath)
+	{
+		if (!file.Open(filePath))
 		{
 			Error("Model: ( %s )\nUnable to open file.", filePath.data());
 			return false;
 		}
-		defer { fclose(binaryFile); };
 
-		unsigned numVertices;
-		fread(&minBounds,   sizeof(minBounds),   1, binaryFile);
-		fread(&maxBounds,   sizeof(maxBounds),   1, binaryFile);
-		fread(&hasUvs,      sizeof(hasUvs),      1, binaryFile);
-		fread(&hasNormals,  sizeof(hasNormals),  1, binaryFile);
-		fread(&hasTangents, sizeof(hasTangents), 1, binaryFile);
-		fread(&numVertices, sizeof(numVertices), 1, binaryFile);
+		BinaryReader reader(file.GetData());
+		std::array<char, 4> tag = {};
+		uint8_t indexSize = 0;
+		bool success;
 
-		// Determine mesh properties.
-		unsigned bufferSize = numVertices * 3;
-		int stride = sizeof(float) * 3;
-		if (hasUvs)
+		positionFormat = PositionFormat::Float;
+		uvFormat = UVFormat::Float;
+		normalFormat = NormalFormat::Float;
+
+		if (reader.Read(tag) && tag == FileTag)
 		{
-			bufferSize += numVertices * 2;
-			stride += sizeof(float) * 2;
+			uint32_t version = 0;
+			if (!reader.Read(version) || version == 0 || version > FileVersion)
+			{
+				Error("Model: ( %s )\nUnsupported file version ( %d ).", filePath.data(), version);
+				file.Close();
+				return false;
+			}
+
+			success =
+				reader.Read(minBounds) &&
+				reader.Read(maxBounds) &&
+				reader.Read(hasUvs) &&
+				reader.Read(hasNormals) &&
+				reader.Read(hasTangents) &&
+				reader.Read(indexSize);
+
+			// Version 2 added quantized attributes.
+			if (version >= 2)
+			{
+				uint8_t padding = 0;
+				success = success &&
+					reader.Read(positionFormat) &&
+					reader.Read(uvFormat) &&
+					reader.Read(normalFormat) &&
+					reader.Read(padding);
+			}
+
+			success = success &&
+				reader.Read(numVertices) &&
+				reader.Read(numIndices);
+
+			if (success && indexSize != sizeof(uint16_t) && indexSize != sizeof(uint32_t))
+			{
+				Error("Model: ( %s )\nInvalid index size ( %d ).", filePath.data(), indexSize);
+				file.Close();
+				return false;
+			}
+
+			if (success && (positionFormat > PositionFormat::UNorm16 || uvFormat > UVFormat::Half || normalFormat > NormalFormat::Octahedral))
+			{
+				Error("Model: ( %s )\nInvalid vertex format.", filePath.data());
+				file.Close();
+				return false;
+			}
+
+			indexFormat = (indexSize == sizeof(uint32_t)) ? VertexFormat::uInt : VertexFormat::uShort;
 		}
-		if (hasNormals)
+		else
 		{
-			bufferSize += numVertices * 3;
-			stride += sizeof(float) * 3;
+			// Unindexed files from older versions of the MeshEncoder have no header.
+			reader = BinaryReader(file.GetData());
+			numIndices = 0;
+
+			success =
+				reader.Read(minBounds) &&
+				reader.Read(maxBounds) &&
+				reader.Read(hasUvs) &&
+				reader.Read(hasNormals) &&
+				reader.Read(hasTangents) &&
+				reader.Read(numVertices);
 		}
-		if (hasTangents)
+
+		// The vertex data is viewed directly from the file until Upload().
+		const size_t vertexSize = GetVertexSize();
+		success = success &&
+			reader.View(vertexSize * numVertices, vertexData) &&
+			reader.View(static_cast<size_t>(indexSize) * numIndices, indexData);
+
+		if (!success)
 		{
-			bufferSize += numVertices * 4;
-			stride += sizeof(float) * 4;
+			Error("Model: ( %s )\nFile is truncated.", filePath.data());
+			file.Close();
+			return false;
 		}
 
+		positionDecode = ComputePositionDecode(positionFormat, minBounds, maxBounds);
+
+		return true;
+	}
+
+	bool Model::Upload()
+	{
+		ASSERT(!array, "Model has already been uploaded.");
+
 		array = VertexArray::MakeNew();
-		auto buffer = VertexBuffer::MakeNew(static_cast<unsigned>(sizeof(float) * bufferSize), BufferUsage::Static, VertexBufferType::Data);
+		auto buffer = VertexBuffer::MakeNew(static_cast<unsigned>(vertexData.size()), vertexData.data(), BufferUsage::Static, VertexBufferType::Data);
 
-		{ // Read the data buffer from the file.
-			auto mapping = buffer->MapBuffer(VertexAccess::WriteOnly);
-			fread(mapping.GetPtr(), sizeof(float), bufferSize, binaryFile);
+		if (numIndices > 0)
+		{
+			auto indexBuffer = VertexBuffer::MakeNew(static_cast<unsigned>(indexData.size()), indexData.data(), BufferUsage::Static, VertexBufferType::Index);
+			array->SetIndexBuffer(std::move(indexBuffer), indexFormat);
 		}
 
+		vertexData = {};
+		indexData = {};
+		file.Close();
+
 		// Enable vertex attribute streams.
+		// Integer formats are normalized, while floating point formats are unaffected by the flag.
 		VertexStream stream {
 			.buffer       = std::move(buffer),
 			.bindingUnit  = 0,
-			.format       = VertexFormat::Vec3,
-			.normalized   = false,
+			.format       = ResolveStreamFormat(positionFormat),
+			.normalized   = true,
 			.startOffset  = 0,
-			.stride       = static_cast<unsigned>(stride)
+			.stride       = GetVertexSize()
 		};
 
 		array->AddStream(stream);
-		stream.startOffset += sizeof(float) * 3;
+		stream.startOffset += CountBytes(stream.format);
 
 		if (hasUvs)
 		{
 			stream.bindingUnit = 1;
-			stream.format = VertexFormat::Vec2;
+			stream.format = ResolveStreamFormat(uvFormat);
 
 			array->AddStream(stream);
-			stream.startOffset += sizeof(float) * 2;
+			stream.startOffset += CountBytes(stream.format);
 		}
 		if (hasNormals)
 		{
 			stream.bindingUnit = 2;
-			stream.format = VertexFormat::Vec3;
+			stream.format = ResolveNormalStreamFormat(normalFormat);
 
 			array->AddStream(stream);
-			stream.startOffset += sizeof(float) * 3;
+			stream.startOffset += CountBytes(stream.format);
 		}
 		if (hasTangents)
 		{
 			stream.bindingUnit = 3;
-			stream.format = VertexFormat::Vec4;
+			stream.format = ResolveTangentStreamFormat(normalFormat);
 
 			array->AddStream(std::move(stream));
 		}
 
-		array->SetVertexCount(numVertices);
+		array->SetVertexCount(numIndices > 0 ? numIndices : numVertices);
 
 		return true;
 	}
@@ -122,6 +227,130 @@ namespace gem
 	{
 		return hasTangents;
 	}
+
+	PositionFormat Model::GetPositionFormat() const
+	{
+		return positionFormat;
+	}
+
+	UVFormat Model::GetUVFormat() const
+	{
+		return uvFormat;
+	}
+
+	NormalFormat Model::GetNormalFormat() const
+	{
+		return normalFormat;
+	}
+
+	const mat4& Model::GetPositionDecode() const
+	{
+		return positionDecode;
+	}
+
+	mat4 Model::ComputePositionDecode(PositionFormat format, const vec3& minBounds, const vec3& maxBounds)
+	{
+		switch (format)
+		{
+		case PositionFormat::Half:
+			return mat4(mat3::Identity, (minBounds + maxBounds) * 0.5f);
+
+		case PositionFormat::UNorm16:
+		{
+			// Flat axes keep a unit scale so that the transform remains invertible.
+			vec3 extent = maxBounds - minBounds;
+			extent.x = (extent.x > 0.0f) ? extent.x : 1.0f;
+			extent.y = (extent.y > 0.0f) ? extent.y : 1.0f;
+			extent.z = (extent.z > 0.0f) ? extent.z : 1.0f;
+
+			return mat4(mat3::Identity, minBounds, extent);
+		}
+
+		default:
+			return mat4::Identity;
+		}
+	}
+
+	unsigned Model::GetNumVertices() const
+	{
+		return numVertices;
+	}
+
+	unsigned Model::GetNumIndices() const
+	{
+		return numIndices;
+	}
+
+	unsigned Model::GetVertexSize() const
+	{
+		unsigned size = CountBytes(ResolveStreamFormat(positionFormat));
+		if (hasUvs)
+		{
+			size += CountBytes(ResolveStreamFormat(uvFormat));
+		}
+		if (hasNormals)
+		{
+			size += CountBytes(ResolveNormalStreamFormat(normalFormat));
+		}
+		if (hasTangents)
+		{
+			size += CountBytes(ResolveTangentStreamFormat(normalFormat));
+		}
+
+		return size;
+	}
+
+	MemoryUsage Model::GetMemoryUsage() const
+	{
+		MemoryUsage usage;
+		if (!file.IsMapped())
+		{
+			usage.cpuBytes = file.GetData().size();
+		}
+
+		if (array)
+		{
+			// The streams usually share a single interleaved buffer.
+			std::vector<const VertexBuffer*> buffers;
+			for (const VertexStream& stream : array->GetStreams())
+			{
+				if (!Contains(buffers, stream.buffer.get()))
+				{
+					buffers.push_back(stream.buffer.get());
+					usage.gpuBytes += stream.buffer->GetSize();
+				}
+			}
+
+			if (const VertexBuffer* indexBuffer = array->GetIndexBuffer())
+			{
+				usage.gpuBytes += indexBuffer->GetSize();
+			}
+		}
+
+		return usage;
+	}
 }
 
 REFLECT_RESOURCE(gem::Model) REF_END;
+
+REFLECT(gem::PositionFormat)
+	ENUM_VALUES {
+		REF_VALUE(Float)
+		REF_VALUE(Half)
+		REF_VALUE(UNorm16)
+	}
+REF_END;
+
+REFLECT(gem::UVFormat)
+	ENUM_VALUES {
+		REF_VALUE(Float)
+		REF_VALUE(Half)
+	}
+REF_END;
+
+REFLECT(gem::NormalFormat)
+	ENUM_VALUES {
+		REF_VALUE(Float)
+		REF_VALUE(Octahedral)
+	}
+REF_END;
@@ -1,11 +1,43 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
+#include "gemcutter/Math/Matrix.h"
 #include "gemcutter/Math/Vector.h"
+#include "gemcutter/Resource/AssetPack.h"
 #include "gemcutter/Resource/Resource.h"
 #include "gemcutter/Resource/VertexArray.h"
 
+#include <array>
+#include <cstdint>
+#include <span>
+
 namespace gem
 {
+	// How the vertex positions of a *.model are stored.
+	enum class PositionFormat : uint8_t
+	{
+		Float,
+		// Half-floats, relative to the center of the bounds.
+		Half,
+		// Normalized 16-bit integers, spanning the bounds.
+		UNorm16
+	};
+
+	enum class UVFormat : uint8_t
+	{
+		Float,
+		Half
+	};
+
+	// How the normals and tangents of a *.model are stored.
+	enum class NormalFormat : uint8_t
+	{
+		Float,
+		// Normalized 16-bit integers encoding the direction on an octahedron.
+		// Shaders must decode these with decode_octahedral().
+		// Tangents are stored as (octahedral.x, octahedral.y, handedness, 0).
+		Octahedral
+	};
+
 	// A 3D model resource. Can be attached to an Entity's Mesh component.
 	//
 	// Provides the following attributes and bindings:
@@ -13,13 +45,27 @@ namespace gem
 	//	UVs     : 1
 	//	Normal  : 2
 	//	Tangent : 3
+	//
+	// Models are drawn as indexed triangle lists, using 16-bit indices whenever the vertex count allows.
+	// Unindexed models written by older versions of the MeshEncoder are still supported.
+	//
+	// Attributes can be quantized to save memory and bandwidth. Quantized positions are decoded by
+	// the transform uniforms of the RenderPass, so shaders only need to handle octahedral normals.
 	class Model : public Resource<Model>, public Shareable<Model>
 	{
 	public:
 		static constexpr std::string_view Extension = ".model";
 
+		// Begins every indexed *.model file. Older unindexed files begin directly with their bounds.
+		static constexpr std::array<char, 4> FileTag = { 'G', 'M', 'D', 'L' };
+		static constexpr uint32_t FileVersion = 2;
+
 		// Loads pre-packed *.model resources.
 		bool Load(std::string_view filePath);
+		// Reads the file into memory, or views it directly from a mounted AssetPack. Can be called from any thread.
+		bool LoadData(std::string_view filePath);
+		// Creates the VertexArray from the data read by LoadData(). Must be called from the main thread.
+		bool Upload();
 
 		VertexArray::Ptr GetArray() const;
 
@@ -31,8 +77,34 @@ namespace gem
 		bool HasNormals() const;
 		bool HasTangents() const;
 
+		PositionFormat GetPositionFormat() const;
+		UVFormat GetUVFormat() const;
+		NormalFormat GetNormalFormat() const;
+
+		// Returns the transform from the stored vertex positions to local-space.
+		// This is the identity unless the positions are quantized.
+		const mat4& GetPositionDecode() const;
+		static mat4 ComputePositionDecode(PositionFormat format, const vec3& minBounds, const vec3& maxBounds);
+
+		unsigned GetNumVertices() const;
+		// Returns zero if the model is not indexed.
+		unsigned GetNumIndices() const;
+
+		// Returns the size of the vertex buffers, as well as any data waiting to be uploaded.
+		MemoryUsage GetMemoryUsage() const;
+
 	private:
+		// Returns the size of each interleaved vertex, in bytes.
+		unsigned GetVertexSize() const;
+
 		VertexArray::Ptr array;
+		// Only held between LoadData() and Upload().
+		AssetFile file;
+		std::span<const std::byte> vertexData;
+		std::span<const std::byte> indexData;
+		unsigned numVertices = 0;
+		unsigned numIndices = 0;
+		VertexFormat indexFormat = VertexFormat::uShort;
 
 		vec3 minBounds;
 		vec3 maxBounds;
@@ -40,5 +112,10 @@ namespace gem
 		bool hasUvs = false;
 		bool hasNormals = false;
 		bool hasTangents = false;
+
+		PositionFormat positionFormat = PositionFormat::Float;
+		UVFormat uvFormat = UVFormat::Float;
+		NormalFormat normalFormat = NormalFormat::Float;
+		mat4 positionDecode;
 	};
 }
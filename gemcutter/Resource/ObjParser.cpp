@@ -0,0 +1,446 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "ObjParser.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Utilities/ScopeGuard.h"
+
+#include <algorithm>
+#include <charconv>
+#include <functional>
+#include <thread>
+#include <Windows.h>
+
+namespace
+{
+	// Smaller chunks are not worth the cost of starting a thread.
+	constexpr size_t MIN_CHUNK_SIZE = 1024 * 1024;
+
+	enum class Statement
+	{
+		Other,
+		Position,
+		Uv,
+		Normal,
+		Face
+	};
+
+	// The number of elements in a chunk of the file, or in all chunks before it.
+	struct Counts
+	{
+		size_t positions = 0;
+		size_t uvs = 0;
+		size_t normals = 0;
+		size_t corners = 0;
+		unsigned lines = 0;
+	};
+
+	struct Chunk
+	{
+		std::string_view text;
+		Counts counts;
+		// Where the chunk's elements begin in the output.
+		Counts offsets;
+
+		const char* error = nullptr;
+		unsigned errorLine = 0;
+	};
+
+	bool IsSpace(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	std::string_view TrimLeft(std::string_view text)
+	{
+		const auto start = std::ranges::find_if_not(text, IsSpace);
+		return text.substr(start - text.begin());
+	}
+
+	// Removes and returns the next whitespace separated token.
+	// The result is empty at the end of the line, or at the start of a comment.
+	std::string_view NextToken(std::string_view& line)
+	{
+		line = TrimLeft(line);
+		const size_t end = std::ranges::find_if(line, [](char c) { return IsSpace(c) || c == '#'; }) - line.begin();
+
+		const std::string_view token = line.substr(0, end);
+		line.remove_prefix(end);
+
+		if (token.empty())
+		{
+			line = {};
+		}
+
+		return token;
+	}
+
+	// Returns true if nothing but whitespace or a comment remains on the line.
+	bool IsEndOfLine(std::string_view line)
+	{
+		line = TrimLeft(line);
+		return line.empty() || line.starts_with('#');
+	}
+
+	// Identifies the statement and removes its keyword from the line.
+	Statement ReadStatement(std::string_view& line)
+	{
+		line = TrimLeft(line);
+
+		auto match = [&line](std::string_view keyword) {
+			if (line.size() > keyword.size() && line.starts_with(keyword) && IsSpace(line[keyword.size()]))
+			{
+				line.remove_prefix(keyword.size());
+				return true;
+			}
+
+			return false;
+		};
+
+		if (match("v"))  return Statement::Position;
+		if (match("vt")) return Statement::Uv;
+		if (match("vn")) return Statement::Normal;
+		if (match("f"))  return Statement::Face;
+
+		return Statement::Other;
+	}
+
+	// Calls the function with each line of the text, until it returns false.
+	template<typename Function>
+	void ForEachLine(std::string_view text, Function&& function)
+	{
+		while (!text.empty())
+		{
+			const size_t end = text.find('\n');
+			if (!function(text.substr(0, end)) || end == std::string_view::npos)
+			{
+				return;
+			}
+
+			text.remove_prefix(end + 1);
+		}
+	}
+
+	bool ReadFloat(std::string_view& line, float& value)
+	{
+		std::string_view token = NextToken(line);
+		if (token.starts_with('+'))
+		{
+			token.remove_prefix(1);
+		}
+
+		const char* end = token.data() + token.size();
+		const auto result = std::from_chars(token.data(), end, value);
+
+		return result.ec == std::errc() && result.ptr == end;
+	}
+
+	// Converts a one-based index, or a negative index relative to the elements defined so far, to a zero-based index.
+	bool ReadIndex(std::string_view text, size_t numDefined, size_t numTotal, unsigned& index)
+	{
+		const char* end = text.data() + text.size();
+		long long value;
+		const auto result = std::from_chars(text.data(), end, value);
+		if (result.ec != std::errc() || result.ptr != end || value == 0)
+		{
+			return false;
+		}
+
+		value += (value > 0) ? -1 : static_cast<long long>(numDefined);
+		if (value < 0 || static_cast<size_t>(value) >= numTotal)
+		{
+			return false;
+		}
+
+		index = static_cast<unsigned>(value);
+		return true;
+	}
+
+	// Reads a corner in any of the forms "v", "v/vt", "v//vn", or "v/vt/vn".
+	bool ReadCorner(std::string_view token, const Counts& defined, const Counts& totals, gem::ObjCorner& corner)
+	{
+		corner = { gem::ObjCorner::None, gem::ObjCorner::None, gem::ObjCorner::None };
+
+		const size_t firstSlash = token.find('/');
+		if (!ReadIndex(token.substr(0, firstSlash), defined.positions, totals.positions, corner.position))
+		{
+			return false;
+		}
+
+		if (firstSlash == std::string_view::npos)
+		{
+			return true;
+		}
+		token.remove_prefix(firstSlash + 1);
+
+		const size_t secondSlash = token.find('/');
+		const std::string_view uv = token.substr(0, secondSlash);
+		if (!uv.empty() && !ReadIndex(uv, defined.uvs, totals.uvs, corner.uv))
+		{
+			return false;
+		}
+
+		if (secondSlash == std::string_view::npos)
+		{
+			return !uv.empty();
+		}
+
+		return ReadIndex(token.substr(secondSlash + 1), defined.normals, totals.normals, corner.normal);
+	}
+
+	// The first pass only counts the elements in the chunk, so that the output can be allocated up front.
+	void CountChunk(Chunk& chunk)
+	{
+		ForEachLine(chunk.text, [&chunk](std::string_view line) {
+			++chunk.counts.lines;
+
+			switch (ReadStatement(line))
+			{
+			case Statement::Position: ++chunk.counts.positions; break;
+			case Statement::Uv:       ++chunk.counts.uvs;       break;
+			case Statement::Normal:   ++chunk.counts.normals;   break;
+			case Statement::Face:
+			{
+				unsigned numCorners = 0;
+				while (!NextToken(line).empty())
+				{
+					++numCorners;
+				}
+
+				// Polygons are split into a fan of triangles.
+				if (numCorners >= 3)
+				{
+					chunk.counts.corners += (numCorners - 2) * 3;
+				}
+				break;
+			}
+			case Statement::Other:
+				break;
+			}
+
+			return true;
+		});
+	}
+
+	// The second pass parses the chunk directly into its reserved ranges of the output.
+	void ParseChunk(Chunk& chunk, const Counts& totals, gem::ObjMesh& output)
+	{
+		// Since the cursors start from the chunk's offsets, they also count the elements defined so far in the file.
+		Counts cursor = chunk.offsets;
+
+		auto fail = [&](const char* error) {
+			chunk.error = error;
+			chunk.errorLine = cursor.lines;
+			return false;
+		};
+
+		ForEachLine(chunk.text, [&](std::string_view line) {
+			++cursor.lines;
+
+			switch (ReadStatement(line))
+			{
+			case Statement::Position:
+			{
+				gem::vec3& position = output.positions[cursor.positions++];
+				if (!ReadFloat(line, position.x) || !ReadFloat(line, position.y) || !ReadFloat(line, position.z))
+				{
+					return fail("Invalid vertex position.");
+				}
+				break;
+			}
+			case Statement::Uv:
+			{
+				// The second coordinate is optional.
+				gem::vec2& uv = output.uvs[cursor.uvs++];
+				if (!ReadFloat(line, uv.x) || (!IsEndOfLine(line) && !ReadFloat(line, uv.y)))
+				{
+					return fail("Invalid texture coordinate.");
+				}
+				break;
+			}
+			case Statement::Normal:
+			{
+				gem::vec3& normal = output.normals[cursor.normals++];
+				if (!ReadFloat(line, normal.x) || !ReadFloat(line, normal.y) || !ReadFloat(line, normal.z))
+				{
+					return fail("Invalid vertex normal.");
+				}
+				break;
+			}
+			case Statement::Face:
+			{
+				gem::ObjCorner first {};
+				gem::ObjCorner previous {};
+				unsigned numCorners = 0;
+
+				for (std::string_view token = NextToken(line); !token.empty(); token = NextToken(line))
+				{
+					gem::ObjCorner corner;
+					if (!ReadCorner(token, cursor, totals, corner))
+					{
+						return fail("Invalid face index.");
+					}
+
+					if (numCorners == 0)
+					{
+						first = corner;
+					}
+					else if (numCorners >= 2)
+					{
+						output.corners[cursor.corners++] = first;
+						output.corners[cursor.corners++] = previous;
+						output.corners[cursor.corners++] = corner;
+					}
+
+					previous = corner;
+					++numCorners;
+				}
+
+				if (numCorners < 3)
+				{
+					return fail("Faces must have at least three corners.");
+				}
+				break;
+			}
+			case Statement::Other:
+				break;
+			}
+
+			return true;
+		});
+	}
+
+	// Splits the text into roughly equal chunks, each ending on a line boundary.
+	std::vector<Chunk> SplitChunks(std::string_view text, unsigned numChunks)
+	{
+		std::vector<Chunk> chunks;
+		chunks.reserve(numChunks);
+
+		size_t start = 0;
+		for (unsigned i = 1; i <= numChunks && start < text.size(); ++i)
+		{
+			size_t end = text.size();
+			if (i < numChunks)
+			{
+				end = text.find('\n', std::max(text.size() / numChunks * i, start));
+				end = (end == std::string_view::npos) ? text.size() : end + 1;
+			}
+
+			chunks.emplace_back().text = text.substr(start, end - start);
+			start = end;
+		}
+
+		return chunks;
+	}
+
+	// Runs the function for each chunk, in parallel. The calling thread processes the first chunk.
+	template<typename Function>
+	void ForEachChunk(std::vector<Chunk>& chunks, Function function)
+	{
+		if (chunks.empty())
+		{
+			return;
+		}
+
+		std::vector<std::jthread> threads;
+		threads.reserve(chunks.size() - 1);
+		for (size_t i = 1; i < chunks.size(); ++i)
+		{
+			threads.emplace_back(function, std::ref(chunks[i]));
+		}
+
+		function(chunks[0]);
+	}
+}
+
+namespace gem
+{
+	bool ParseObj(std::string_view text, ObjMesh& output, unsigned numThreads)
+	{
+		if (numThreads == 0)
+		{
+			numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+		}
+
+		const size_t maxChunks = std::max<size_t>(text.size() / MIN_CHUNK_SIZE, 1);
+		std::vector<Chunk> chunks = SplitChunks(text, static_cast<unsigned>(std::min<size_t>(numThreads, maxChunks)));
+
+		ForEachChunk(chunks, CountChunk);
+
+		// A prefix sum of the counts gives each chunk its own range of the output,
+		// and resolves relative indices which refer to elements in previous chunks.
+		Counts totals;
+		for (Chunk& chunk : chunks)
+		{
+			chunk.offsets = totals;
+
+			totals.positions += chunk.counts.positions;
+			totals.uvs       += chunk.counts.uvs;
+			totals.normals   += chunk.counts.normals;
+			totals.corners   += chunk.counts.corners;
+			totals.lines     += chunk.counts.lines;
+		}
+
+		output.positions.resize(totals.positions);
+		output.uvs.resize(totals.uvs);
+		output.normals.resize(totals.normals);
+		output.corners.resize(totals.corners);
+
+		ForEachChunk(chunks, [&totals, &output](Chunk& chunk) {
+			ParseChunk(chunk, totals, output);
+		});
+
+		// Report the first error in the file.
+		for (const Chunk& chunk : chunks)
+		{
+			if (chunk.error)
+			{
+				Error("OBJ: Line %u\n%s", chunk.errorLine, chunk.error);
+				output = {};
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool LoadObj(std::string_view file, ObjMesh& output, unsigned numThreads)
+	{
+		HANDLE hFile = CreateFileA(file.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+		{
+			Error("OBJ: ( %s )\nUnable to open file.", file.data());
+			return false;
+		}
+		defer { CloseHandle(hFile); };
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(hFile, &fileSize))
+		{
+			Error("OBJ: ( %s )\nUnable to read file.", file.data());
+			return false;
+		}
+
+		// Empty files cannot be mapped.
+		if (fileSize.QuadPart == 0)
+		{
+			return ParseObj({}, output, numThreads);
+		}
+
+		HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (hMapping == nullptr)
+		{
+			Error("OBJ: ( %s )\nUnable to map file.", file.data());
+			return false;
+		}
+		defer { CloseHandle(hMapping); };
+
+		const void* view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			Error("OBJ: ( %s )\nUnable to map file.", file.data());
+			return false;
+		}
+		defer { UnmapViewOfFile(view); };
+
+		return ParseObj({ static_cast<const char*>(view), static_cast<size_t>(fileSize.QuadPart) }, output, numThreads);
+	}
+}
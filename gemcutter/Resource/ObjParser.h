@@ -0,0 +1,38 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Math/Vector.h"
+
+#include <string_view>
+#include <vector>
+
+namespace gem
+{
+	// References the attributes of one corner of a triangle. Indices are zero-based.
+	struct ObjCorner
+	{
+		// Marks an attribute which was not specified by the face.
+		static constexpr unsigned None = ~0u;
+
+		unsigned position;
+		unsigned uv;
+		unsigned normal;
+	};
+
+	// The geometry of a Wavefront OBJ file. Polygons are triangulated as fans.
+	struct ObjMesh
+	{
+		std::vector<vec3> positions;
+		std::vector<vec2> uvs;
+		std::vector<vec3> normals;
+		// Three corners for each triangle.
+		std::vector<ObjCorner> corners;
+	};
+
+	// Parses the text of an OBJ file. Only vertex attributes and faces are read, other statements and comments are ignored.
+	// The text is split into chunks on line boundaries and parsed on up to 'numThreads' threads.
+	// A value of 0 uses all of the available hardware threads, which should be avoided if the caller is already parallel.
+	bool ParseObj(std::string_view text, ObjMesh& output, unsigned numThreads = 0);
+
+	// Maps the file into memory and parses it.
+	bool LoadObj(std::string_view file, ObjMesh& output, unsigned numThreads = 0);
+}
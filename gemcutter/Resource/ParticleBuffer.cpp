@@ -52,29 +52,22 @@ namespace gem
 		attributes = _attributes;
 
 		array->RemoveStreams();
-		buffer = VertexBuffer::MakeNew(TotalBufferSize(), BufferUsage::Dynamic, VertexBufferType::Data);
 
-		// Position attribute is always used.
-		VertexStream stream {
-			.buffer      = buffer,
-			.bindingUnit = 0,
-			.format      = VertexFormat::Vec3,
-			.normalized  = false,
-			.startOffset = 0,
-			.stride      = 0
-		};
+		// The storage is only ever grown. Toggling attributes on and off
+		// afterwards only needs to redirect the streams to the existing buffer.
+		const unsigned requiredSize = TotalBufferSize();
+		if (!buffer || buffer->GetSize() < requiredSize)
+		{
+			buffer = VertexBuffer::MakeNew(requiredSize, BufferUsage::Persistent, VertexBufferType::Data);
+		}
 
-		array->AddStream(stream);
+		// Position attribute is always used.
+		unsigned startOffset = 0;
+		AddStream(VertexFormat::Vec3, 0, startOffset);
 
-		unsigned startOffset = sizeof(vec3);
 		if (attributes.Has(ParticleAttributes::Size))
 		{
-			stream.bindingUnit = 1;
-			stream.format = VertexFormat::Vec2;
-			stream.startOffset = startOffset * maxParticles;
-
-			array->AddStream(stream);
-			startOffset += sizeof(vec2);
+			AddStream(VertexFormat::Vec2, 1, startOffset);
 
 			if (!sizes)
 			{
@@ -84,12 +77,7 @@ namespace gem
 
 		if (attributes.Has(ParticleAttributes::Color))
 		{
-			stream.bindingUnit = 2;
-			stream.format = VertexFormat::Vec3;
-			stream.startOffset = startOffset * maxParticles;
-
-			array->AddStream(stream);
-			startOffset += sizeof(vec3);
+			AddStream(VertexFormat::Vec3, 2, startOffset);
 
 			if (!colors)
 			{
@@ -99,12 +87,7 @@ namespace gem
 
 		if (attributes.Has(ParticleAttributes::Alpha))
 		{
-			stream.bindingUnit = 3;
-			stream.format = VertexFormat::Float;
-			stream.startOffset = startOffset * maxParticles;
-
-			array->AddStream(stream);
-			startOffset += sizeof(float);
+			AddStream(VertexFormat::Float, 3, startOffset);
 
 			if (!alphas)
 			{
@@ -114,12 +97,7 @@ namespace gem
 
 		if (attributes.Has(ParticleAttributes::Rotation))
 		{
-			stream.bindingUnit = 4;
-			stream.format = VertexFormat::Float;
-			stream.startOffset = startOffset * maxParticles;
-
-			array->AddStream(stream);
-			startOffset += sizeof(float);
+			AddStream(VertexFormat::Float, 4, startOffset);
 
 			if (!rotations)
 			{
@@ -129,11 +107,7 @@ namespace gem
 
 		if (attributes.Has(ParticleAttributes::AgeRatio))
 		{
-			stream.bindingUnit = 5;
-			stream.format = VertexFormat::Float;
-			stream.startOffset = startOffset * maxParticles;
-
-			array->AddStream(std::move(stream));
+			AddStream(VertexFormat::Float, 5, startOffset);
 
 			if (!ageRatios)
 			{
@@ -144,46 +118,46 @@ namespace gem
 
 	void ParticleBuffer::Update(unsigned activeParticles)
 	{
-		array->SetVertexCount(activeParticles);
-
 		if (activeParticles == 0)
 		{
+			array->SetVertexCount(0);
 			return;
 		}
 
-		BufferMapping mapping = buffer->MapBuffer(VertexAccess::WriteOnly);
-		std::byte* data = mapping.GetPtr();
+		// Wait for the GPU to finish reading the oldest region before we overwrite it.
+		ring.Advance();
+
+		// Every attribute stores its regions back-to-back, so selecting
+		// a region only requires offsetting the first vertex of the draw.
+		array->SetFirstIndex(ring.GetCurrentRegion() * maxParticles);
+		array->SetVertexCount(activeParticles);
 
-		memcpy(data, positions, sizeof(vec3) * activeParticles);
-		data += sizeof(vec3) * maxParticles;
+		unsigned startOffset = 0;
+		Upload(positions, sizeof(vec3), activeParticles, startOffset);
 
 		if (attributes.Has(ParticleAttributes::Size))
 		{
-			memcpy(data, sizes, sizeof(vec2) * activeParticles);
-			data += sizeof(vec2) * maxParticles;
+			Upload(sizes, sizeof(vec2), activeParticles, startOffset);
 		}
 
 		if (attributes.Has(ParticleAttributes::Color))
 		{
-			memcpy(data, colors, sizeof(vec3) * activeParticles);
-			data += sizeof(vec3) * maxParticles;
+			Upload(colors, sizeof(vec3), activeParticles, startOffset);
 		}
 
 		if (attributes.Has(ParticleAttributes::Alpha))
 		{
-			memcpy(data, alphas, sizeof(float) * activeParticles);
-			data += sizeof(float) * maxParticles;
+			Upload(alphas, sizeof(float), activeParticles, startOffset);
 		}
 
 		if (attributes.Has(ParticleAttributes::Rotation))
 		{
-			memcpy(data, rotations, sizeof(float) * activeParticles);
-			data += sizeof(float) * maxParticles;
+			Upload(rotations, sizeof(float), activeParticles, startOffset);
 		}
 
 		if (attributes.Has(ParticleAttributes::AgeRatio))
 		{
-			memcpy(data, ageRatios, sizeof(float) * activeParticles);
+			Upload(ageRatios, sizeof(float), activeParticles, startOffset);
 		}
 	}
 
@@ -251,6 +225,37 @@ namespace gem
 		if (attributes.Has(ParticleAttributes::Rotation)) bufferSize += sizeof(float);
 		if (attributes.Has(ParticleAttributes::AgeRatio)) bufferSize += sizeof(float);
 
-		return bufferSize * maxParticles;
+		return bufferSize * maxParticles * ring.RegionCount;
+	}
+
+	void ParticleBuffer::AddStream(VertexFormat format, unsigned bindingUnit, unsigned& startOffset)
+	{
+		array->AddStream({
+			.buffer      = buffer,
+			.bindingUnit = bindingUnit,
+			.format      = format,
+			.normalized  = false,
+			.startOffset = startOffset,
+			.stride      = 0
+		});
+
+		startOffset += CountBytes(format) * maxParticles * ring.RegionCount;
+	}
+
+	void ParticleBuffer::Upload(const void* source, unsigned elementSize, unsigned activeParticles, unsigned& startOffset)
+	{
+		const unsigned offset = startOffset + elementSize * maxParticles * ring.GetCurrentRegion();
+		const unsigned size = elementSize * activeParticles;
+
+		if (std::byte* data = buffer->GetPersistentPtr())
+		{
+			memcpy(data + offset, source, size);
+		}
+		else
+		{
+			buffer->SetData(offset, size, source);
+		}
+
+		startOffset += elementSize * maxParticles * ring.RegionCount;
 	}
 }
@@ -1,5 +1,7 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
+#include "gemcutter/Rendering/Fence.h"
+#include "gemcutter/Rendering/FrameRing.h"
 #include "gemcutter/Resource/VertexArray.h"
 #include "gemcutter/Utilities/EnumFlags.h"
 
@@ -28,6 +30,8 @@ namespace gem
 
 		void SetAttributes(EnumFlags<ParticleAttributes> attributes);
 		// Uploads data to the GPU buffers.
+		// Each call writes to the next region of a persistently mapped buffer,
+		// so the GPU can continue to render the previous frames without stalling.
 		void Update(unsigned activeParticles);
 
 		void Kill(unsigned index, unsigned last);
@@ -49,11 +53,16 @@ namespace gem
 
 	private:
 		unsigned TotalBufferSize() const;
+		void AddStream(VertexFormat format, unsigned bindingUnit, unsigned& startOffset);
+		void Upload(const void* source, unsigned elementSize, unsigned activeParticles, unsigned& startOffset);
 
 		EnumFlags<ParticleAttributes> attributes = ParticleAttributes::None;
 		unsigned maxParticles = 0;
 
 		VertexArray::Ptr array;
 		VertexBuffer::Ptr buffer;
+		// Unlike a StreamBuffer, each frame has a fixed region sized for maxParticles. The streams never
+		// move between frames, so only the first index of the array changes.
+		FrameRing<Fence> ring;
 	};
 }
@@ -40,14 +40,11 @@ namespace gem
 	{
 	}
 
-	void RotationFunc::Init(ParticleBuffer& particles, ParticleEmitter&, unsigned startIndex, unsigned count)
+	void RotationFunc::Init(ParticleBuffer& particles, ParticleEmitter& emitter, unsigned startIndex, unsigned count)
 	{
 		ASSERT(startIndex + count <= particles.GetMaxParticles(), "Indices out of range.");
 
-		for (unsigned i = startIndex, end = startIndex + count; i < end; ++i)
-		{
-			particles.rotations[i] = initialRotation.Random();
-		}
+		emitter.GetRandomStream().FillRange({ particles.rotations + startIndex, count }, initialRotation.min, initialRotation.max);
 	}
 
 	void RotationFunc::Update(ParticleBuffer& particles, ParticleEmitter& emitter, float deltaTime)
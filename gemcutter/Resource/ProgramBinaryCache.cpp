@@ -0,0 +1,226 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "ProgramBinaryCache.h"
+#include "gemcutter/Application/FileSystem.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Utilities/BinaryReader.h"
+#include "gemcutter/Utilities/ScopeGuard.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+	// 64-bit FNV-1a.
+	constexpr uint64_t HASH_OFFSET = 14695981039346656037ull;
+	constexpr uint64_t HASH_PRIME = 1099511628211ull;
+
+	void HashBytes(uint64_t& hash, const void* data, size_t size)
+	{
+		const auto* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; ++i)
+		{
+			hash ^= bytes[i];
+			hash *= HASH_PRIME;
+		}
+	}
+
+	// Includes the length of the string, so that moving text from one string to the next changes the hash.
+	void HashString(uint64_t& hash, std::string_view str)
+	{
+		const uint64_t length = str.size();
+		HashBytes(hash, &length, sizeof(length));
+		HashBytes(hash, str.data(), str.size());
+	}
+}
+
+namespace gem
+{
+	void ProgramBinaryCache::SetDriver(std::string_view vendor, std::string_view renderer, std::string_view version)
+	{
+		driverHash = HASH_OFFSET;
+		HashString(driverHash, vendor);
+		HashString(driverHash, renderer);
+		HashString(driverHash, version);
+	}
+
+	uint64_t ProgramBinaryCache::GetDriverHash() const
+	{
+		return driverHash;
+	}
+
+	void ProgramBinaryCache::SetDirectory(std::string_view _directory)
+	{
+		directory = _directory;
+		if (!directory.empty() && directory.back() != '/' && directory.back() != '\\')
+		{
+			directory.push_back('/');
+		}
+	}
+
+	const std::string& ProgramBinaryCache::GetDirectory() const
+	{
+		return directory;
+	}
+
+	bool ProgramBinaryCache::IsEnabled() const
+	{
+		return !directory.empty();
+	}
+
+	uint64_t ProgramBinaryCache::ComputeKey(std::span<const std::string_view> sources) const
+	{
+		uint64_t key = HASH_OFFSET;
+		HashBytes(key, &driverHash, sizeof(driverHash));
+
+		for (std::string_view source : sources)
+		{
+			HashString(key, source);
+		}
+
+		return key;
+	}
+
+	std::string ProgramBinaryCache::GetFilePath(uint64_t key) const
+	{
+		char name[17];
+		snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+
+		return directory + name + std::string(Extension);
+	}
+
+	bool ProgramBinaryCache::Load(uint64_t key, ProgramBinary& outBinary) const
+	{
+		if (!IsEnabled())
+		{
+			return false;
+		}
+
+		const std::string file = GetFilePath(key);
+		std::vector<std::byte> contents;
+		if (!FileExists(file) || !LoadFileAsBinary(file, contents))
+		{
+			return false;
+		}
+
+		BinaryReader reader(contents);
+		std::array<char, 4> tag = {};
+		uint32_t version = 0;
+		uint64_t storedDriver = 0;
+		uint64_t storedKey = 0;
+		uint64_t checksum = 0;
+		uint32_t format = 0;
+		uint64_t size = 0;
+		std::span<const std::byte> data;
+		const bool success =
+			reader.Read(tag) &&
+			reader.Read(version) &&
+			reader.Read(storedDriver) &&
+			reader.Read(storedKey) &&
+			reader.Read(checksum) &&
+			reader.Read(format) &&
+			reader.Read(size) &&
+			reader.View(static_cast<size_t>(size), data);
+
+		if (!success || tag != FileTag || version != FileVersion || storedDriver != driverHash || storedKey != key)
+		{
+			return false;
+		}
+
+		uint64_t dataHash = HASH_OFFSET;
+		HashBytes(dataHash, data.data(), data.size());
+		if (dataHash != checksum)
+		{
+			Warning("ProgramBinaryCache: ( %s )\nFile is corrupted and will be ignored.", file.c_str());
+			return false;
+		}
+
+		outBinary.format = format;
+		outBinary.data.assign(data.begin(), data.end());
+
+		return true;
+	}
+
+	bool ProgramBinaryCache::Save(uint64_t key, const ProgramBinary& binary) const
+	{
+		if (!IsEnabled() || binary.data.empty())
+		{
+			return false;
+		}
+
+		std::error_code error;
+		fs::create_directories(directory, error);
+
+		// Written under a temporary name first, so that a crash cannot leave a partial file behind.
+		const std::string file = GetFilePath(key);
+		const std::string tempFile = file + ".tmp";
+		{
+			FILE* programFile = fopen(tempFile.c_str(), "wb");
+			if (programFile == nullptr)
+			{
+				Warning("ProgramBinaryCache: ( %s )\nUnable to create file.", tempFile.c_str());
+				return false;
+			}
+			defer { fclose(programFile); };
+
+			uint64_t checksum = HASH_OFFSET;
+			HashBytes(checksum, binary.data.data(), binary.data.size());
+			const uint64_t size = binary.data.size();
+
+			fwrite(FileTag.data(), sizeof(char), FileTag.size(), programFile);
+			fwrite(&FileVersion, sizeof(FileVersion), 1, programFile);
+			fwrite(&driverHash, sizeof(driverHash), 1, programFile);
+			fwrite(&key, sizeof(key), 1, programFile);
+			fwrite(&checksum, sizeof(checksum), 1, programFile);
+			fwrite(&binary.format, sizeof(binary.format), 1, programFile);
+			fwrite(&size, sizeof(size), 1, programFile);
+			fwrite(binary.data.data(), 1, binary.data.size(), programFile);
+
+			if (ferror(programFile) != 0)
+			{
+				Warning("ProgramBinaryCache: ( %s )\nFailed to write file.", tempFile.c_str());
+				return false;
+			}
+		}
+
+		fs::rename(tempFile, file, error);
+		if (error)
+		{
+			fs::remove(tempFile, error);
+			return false;
+		}
+
+		return true;
+	}
+
+	void ProgramBinaryCache::Remove(uint64_t key) const
+	{
+		if (IsEnabled())
+		{
+			std::error_code error;
+			fs::remove(GetFilePath(key), error);
+		}
+	}
+
+	unsigned ProgramBinaryCache::Clear() const
+	{
+		if (!IsEnabled())
+		{
+			return 0;
+		}
+
+		unsigned count = 0;
+		std::error_code error;
+		for (const fs::directory_entry& entry : fs::directory_iterator(directory, error))
+		{
+			if (entry.is_regular_file(error) && entry.path().extension() == Extension && fs::remove(entry.path(), error))
+			{
+				++count;
+			}
+		}
+
+		return count;
+	}
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gem
+{
+	// A linked shader program in the driver's own format, as returned by glGetProgramBinary().
+	struct ProgramBinary
+	{
+		uint32_t format = 0;
+		std::vector<std::byte> data;
+	};
+
+	// Stores linked shader programs on disk, so that they do not need to be compiled again on later runs.
+	// Each program is stored in its own file, named after its key. Keys are computed from the complete source
+	// of the program as well as the driver, so a modified shader or an updated driver never finds a stale binary.
+	// Files which are truncated, corrupted, or were written by another driver are ignored.
+	class ProgramBinaryCache
+	{
+	public:
+		static constexpr std::string_view Extension = ".program";
+		static constexpr std::array<char, 4> FileTag = { 'G', 'P', 'R', 'G' };
+		static constexpr uint32_t FileVersion = 1;
+
+		// Identifies the driver which is compiling the programs.
+		void SetDriver(std::string_view vendor, std::string_view renderer, std::string_view version);
+		uint64_t GetDriverHash() const;
+
+		// Sets the folder to store the programs in. It is created when the first program is saved.
+		// An empty directory disables the cache.
+		void SetDirectory(std::string_view directory);
+		const std::string& GetDirectory() const;
+		bool IsEnabled() const;
+
+		// Returns the key for a program compiled from the source strings, in order.
+		uint64_t ComputeKey(std::span<const std::string_view> sources) const;
+		std::string GetFilePath(uint64_t key) const;
+
+		// Reads the program stored with the key. Returns false if there is none, or if it is invalid.
+		bool Load(uint64_t key, ProgramBinary& outBinary) const;
+		bool Save(uint64_t key, const ProgramBinary& binary) const;
+
+		// Deletes the stored program, such as when the driver no longer accepts it.
+		void Remove(uint64_t key) const;
+		// Deletes every stored program. Returns the number of programs deleted.
+		unsigned Clear() const;
+
+	private:
+		std::string directory;
+		uint64_t driverHash = 0;
+	};
+}
@@ -1,10 +1,15 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
 #include "gemcutter/Application/FileSystem.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Resource/ResourceCache.h"
+#include "gemcutter/Resource/ResourceLoader.h"
 #include "gemcutter/Utilities/StdExt.h"
 #include "gemcutter/Utilities/String.h"
 
+#include <concepts>
 #include <loupe/loupe.h>
+#include <memory>
 #include <string_view>
 #include <string>
 #include <type_traits>
@@ -27,10 +32,123 @@ namespace gem
 		PRIVATE_MEMBER(ResourceBase, path);
 	};
 
+	template<class Asset> class Resource;
+
+	namespace detail
+	{
+		template<class Asset>
+		class ResourceLoadJob final : public LoadJob
+		{
+			friend Resource<Asset>;
+		public:
+			ResourceLoadJob(std::shared_ptr<Asset> _asset, std::string _path)
+				: asset(std::move(_asset)), path(std::move(_path))
+			{
+			}
+
+			// Null until the load has succeeded.
+			std::shared_ptr<Asset> GetAsset() const { return GetStatus() == LoadStatus::Loaded ? asset : nullptr; }
+
+		private:
+			static constexpr bool HasLoadData = requires(Asset& a, std::string_view p) { { a.LoadData(p) } -> std::same_as<bool>; };
+			static constexpr bool HasUpload   = requires(Asset& a) { { a.Upload() } -> std::same_as<bool>; };
+
+			bool Read() override
+			{
+				if constexpr (HasLoadData)
+				{
+					return asset->LoadData(path);
+				}
+				else
+				{
+					return true;
+				}
+			}
+
+			bool Upload() override
+			{
+				if constexpr (!HasLoadData)
+				{
+					// Assets which don't separate their file reads from their GPU work are loaded entirely here.
+					return asset->Load(path);
+				}
+				else if constexpr (HasUpload)
+				{
+					return asset->Upload();
+				}
+				else
+				{
+					return true;
+				}
+			}
+
+			void Complete(bool success) override
+			{
+				Resource<Asset>::CompleteAsync(path, asset, success);
+			}
+
+			std::shared_ptr<Asset> asset;
+			std::string path;
+		};
+	}
+
+	// A handle to an asset being loaded asynchronously. Similar to a std::shared_future.
+	template<class Asset>
+	class ResourceFuture
+	{
+		friend Resource<Asset>;
+	public:
+		ResourceFuture() = default;
+
+		// Returns false if the handle was default constructed.
+		bool IsValid() const { return asset || job; }
+		// Returns true once the load has either succeeded or failed.
+		bool IsReady() const { return !job || job->IsDone(); }
+		LoadStatus GetStatus() const { return job ? job->GetStatus() : (asset ? LoadStatus::Loaded : LoadStatus::Failed); }
+
+		// Blocks until the load is complete. Must be called from the main thread.
+		void Wait() const
+		{
+			if (job)
+			{
+				ResourceLoader.Wait(*job);
+			}
+		}
+
+		// Returns the asset, blocking until it is ready. Returns null if the load failed.
+		std::shared_ptr<Asset> Get() const
+		{
+			Wait();
+			return TryGet();
+		}
+
+		// Returns the asset if it has finished loading, without blocking.
+		std::shared_ptr<Asset> TryGet() const
+		{
+			return job ? job->GetAsset() : asset;
+		}
+
+	private:
+		ResourceFuture(std::shared_ptr<Asset> _asset) : asset(std::move(_asset)) {}
+		ResourceFuture(std::shared_ptr<detail::ResourceLoadJob<Asset>> _job) : job(std::move(_job)) {}
+
+		std::shared_ptr<Asset> asset;
+		std::shared_ptr<detail::ResourceLoadJob<Asset>> job;
+	};
+
 	// Provides an interface for cached loading of the specified asset.
+	//
+	// Assets can be loaded asynchronously if they split their loading into two steps:
+	//	bool LoadData(std::string_view filePath) : Reads and decodes the file. Runs on a loading thread.
+	//	bool Upload()                            : Creates any GPU objects. Runs on the main thread.
+	// Assets which only provide Load() are still loaded asynchronously, but entirely on the main thread.
+	//
+	// Cached assets are tracked by the ResourceCache, which can evict them once they are no longer in use.
+	// The cache and the table of pending loads are not synchronized, so they must only be used from the main thread.
 	template<class Asset>
 	class Resource : public ResourceBase
 	{
+		friend detail::ResourceLoadJob<Asset>;
 	protected:
 		Resource() = default;
 
@@ -42,6 +160,7 @@ namespace gem
 		// Calls the derived class's Load() with the normalized file path.
 		static std::shared_ptr<Asset> Load(std::string filePath)
 		{
+			ASSERT(ResourceLoader.IsMainThread(), "Resources can only be loaded from the main thread.");
 			NormalizeFilePath(filePath);
 
 			// Search for the cached asset.
@@ -50,6 +169,12 @@ namespace gem
 				return ptr;
 			}
 
+			// The asset might already be on its way.
+			if (auto itr = pendingLoads.find(filePath); itr != pendingLoads.end())
+			{
+				return ResourceFuture<Asset>(itr->second).Get();
+			}
+
 			// Create the new asset.
 			auto resourcePtr = std::make_shared<Asset>();
 			resourcePtr->path = filePath;
@@ -59,11 +184,38 @@ namespace gem
 			}
 
 			// Add new asset to cache.
-			resourceCache.insert(std::make_pair(std::move(filePath), resourcePtr));
+			AddToCache(std::move(filePath), resourcePtr);
 
 			return resourcePtr;
 		}
 
+		// Begins loading an asset from the specified file, or retrieves it from the cache.
+		// Requests for a file which is already being loaded share the same result.
+		static ResourceFuture<Asset> LoadAsync(std::string filePath)
+		{
+			ASSERT(ResourceLoader.IsMainThread(), "Resources can only be loaded from the main thread.");
+			NormalizeFilePath(filePath);
+
+			if (std::shared_ptr<Asset> ptr = FindNormalized(filePath))
+			{
+				return ResourceFuture<Asset>(std::move(ptr));
+			}
+
+			if (auto itr = pendingLoads.find(filePath); itr != pendingLoads.end())
+			{
+				return ResourceFuture<Asset>(itr->second);
+			}
+
+			auto resourcePtr = std::make_shared<Asset>();
+			resourcePtr->path = filePath;
+
+			auto job = std::make_shared<detail::ResourceLoadJob<Asset>>(std::move(resourcePtr), filePath);
+			pendingLoads.emplace(std::move(filePath), job);
+			ResourceLoader.Submit(job);
+
+			return ResourceFuture<Asset>(std::move(job));
+		}
+
 		// Searches for a loaded asset previously loaded from the specified file path.
 		static std::shared_ptr<Asset> Find(std::string filePath)
 		{
@@ -74,9 +226,42 @@ namespace gem
 		// Clears the asset cache. An asset will need to load from file again after this call.
 		static void UnloadAll()
 		{
+			for (auto& [path, entry] : resourceCache)
+			{
+				typeCache.OnRemoved(entry.usage);
+			}
+
 			resourceCache.clear();
 		}
 
+		// Sets the maximum memory, in bytes, for cached assets of this type. Zero disables the budget.
+		static void SetCacheBudget(size_t bytes)
+		{
+			typeCache.budget = bytes;
+		}
+
+		static size_t GetCacheBudget()
+		{
+			return typeCache.budget;
+		}
+
+		// Returns the memory currently held by cached assets of this type.
+		static MemoryUsage GetCacheUsage()
+		{
+			return typeCache.usage;
+		}
+
+		// Returns the highest memory held by cached assets of this type.
+		static MemoryUsage GetPeakCacheUsage()
+		{
+			return typeCache.peakUsage;
+		}
+
+		static unsigned GetNumCached()
+		{
+			return typeCache.numAssets;
+		}
+
 	private:
 		// Converts the path to a standard format for cache lookups.
 		static void NormalizeFilePath(std::string& filePath)
@@ -89,6 +274,18 @@ namespace gem
 			}
 		}
 
+		// Called on the main thread once an asynchronous load has finished.
+		static void CompleteAsync(const std::string& filePath, const std::shared_ptr<Asset>& asset, bool success)
+		{
+			ASSERT(ResourceLoader.IsMainThread(), "Asynchronous loads must be completed on the main thread.");
+			pendingLoads.erase(filePath);
+
+			if (success)
+			{
+				AddToCache(filePath, asset);
+			}
+		}
+
 		static std::shared_ptr<Asset> FindNormalized(std::string_view filePath)
 		{
 			auto itr = resourceCache.find(filePath);
@@ -98,11 +295,79 @@ namespace gem
 			}
 			else
 			{
-				return itr->second;
+				itr->second.lastUsed = detail::ResourceCacheBase::Touch();
+				return itr->second.asset;
+			}
+		}
+
+		static MemoryUsage MeasureMemory(const Asset& asset)
+		{
+			if constexpr (requires { { asset.GetMemoryUsage() } -> std::same_as<MemoryUsage>; })
+			{
+				return asset.GetMemoryUsage();
+			}
+			else
+			{
+				return {};
 			}
 		}
 
-		static inline std::unordered_map<std::string, std::shared_ptr<Asset>, string_hash, std::equal_to<>> resourceCache;
+		static void AddToCache(std::string filePath, std::shared_ptr<Asset> asset)
+		{
+			const MemoryUsage usage = MeasureMemory(*asset);
+			resourceCache.insert(std::make_pair(std::move(filePath), CacheEntry{ std::move(asset), usage, detail::ResourceCacheBase::Touch() }));
+
+			typeCache.OnAdded(usage);
+		}
+
+		struct CacheEntry
+		{
+			std::shared_ptr<Asset> asset;
+			MemoryUsage usage;
+			uint64_t lastUsed = 0;
+		};
+
+		// Exposes this type's cache to the ResourceCache.
+		class TypeCache final : public detail::ResourceCacheBase
+		{
+		public:
+			TypeCache() : ResourceCacheBase(Asset::Extension) {}
+
+		private:
+			void Refresh() override
+			{
+				usage = {};
+				for (auto& [path, entry] : resourceCache)
+				{
+					entry.usage = MeasureMemory(*entry.asset);
+					usage += entry.usage;
+				}
+			}
+
+			void GatherCandidates(std::vector<Candidate>& output) override
+			{
+				for (auto& [path, entry] : resourceCache)
+				{
+					if (entry.asset.use_count() == 1)
+					{
+						output.push_back({ this, &path, entry.lastUsed, entry.usage.Total() });
+					}
+				}
+			}
+
+			void Evict(const std::string& path) override
+			{
+				auto itr = resourceCache.find(path);
+				ASSERT(itr != resourceCache.end(), "Evicted asset must be in the cache.");
+
+				OnRemoved(itr->second.usage);
+				resourceCache.erase(itr);
+			}
+		};
+
+		static inline std::unordered_map<std::string, CacheEntry, string_hash, std::equal_to<>> resourceCache;
+		static inline TypeCache typeCache;
+		static inline std::unordered_map<std::string, std::shared_ptr<detail::ResourceLoadJob<Asset>>, string_hash, std::equal_to<>> pendingLoads;
 	};
 
 	// Helper function to load an asset.
@@ -113,6 +378,14 @@ namespace gem
 		return Resource<Asset>::Load(std::move(filePath));
 	}
 
+	// Helper function to begin loading an asset asynchronously.
+	template<class Asset>
+	ResourceFuture<Asset> LoadAsync(std::string filePath)
+	{
+		static_assert(std::is_base_of_v<Resource<Asset>, Asset>);
+		return Resource<Asset>::LoadAsync(std::move(filePath));
+	}
+
 	// Helper function to unload all managed instances of an asset.
 	template<class Asset>
 	void UnloadAll()
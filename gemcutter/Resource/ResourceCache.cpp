@@ -0,0 +1,224 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "ResourceCache.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Utilities/StdExt.h"
+
+#include <algorithm>
+
+namespace
+{
+	void UpdatePeak(gem::MemoryUsage& peak, const gem::MemoryUsage& usage)
+	{
+		peak.cpuBytes = std::max(peak.cpuBytes, usage.cpuBytes);
+		peak.gpuBytes = std::max(peak.gpuBytes, usage.gpuBytes);
+	}
+}
+
+namespace gem
+{
+	ResourceCacheSingleton ResourceCache;
+
+	void detail::ResourceCacheBase::OnAdded(const MemoryUsage& assetUsage)
+	{
+		if (!isRegistered)
+		{
+			ResourceCache.Register(*this);
+			isRegistered = true;
+		}
+
+		++numAssets;
+		usage += assetUsage;
+		UpdatePeak(peakUsage, usage);
+
+		ResourceCache.usage += assetUsage;
+		UpdatePeak(ResourceCache.peakUsage, ResourceCache.usage);
+
+		if (ResourceCache.IsOverBudget())
+		{
+			ResourceCache.Trim();
+		}
+	}
+
+	void detail::ResourceCacheBase::OnRemoved(const MemoryUsage& assetUsage)
+	{
+		ASSERT(numAssets > 0, "Cache is already empty.");
+
+		--numAssets;
+		usage -= assetUsage;
+		ResourceCache.usage -= assetUsage;
+	}
+
+	void ResourceCacheSingleton::SetBudget(size_t bytes)
+	{
+		budget = bytes;
+	}
+
+	size_t ResourceCacheSingleton::GetBudget() const
+	{
+		return budget;
+	}
+
+	MemoryUsage ResourceCacheSingleton::GetUsage() const
+	{
+		return usage;
+	}
+
+	MemoryUsage ResourceCacheSingleton::GetPeakUsage() const
+	{
+		return peakUsage;
+	}
+
+	void ResourceCacheSingleton::ResetPeakUsage()
+	{
+		peakUsage = usage;
+		for (detail::ResourceCacheBase* cache : caches)
+		{
+			cache->peakUsage = cache->usage;
+		}
+	}
+
+	std::vector<ResourceCacheStats> ResourceCacheSingleton::GetStats() const
+	{
+		std::vector<ResourceCacheStats> stats;
+		stats.reserve(caches.size());
+
+		for (const detail::ResourceCacheBase* cache : caches)
+		{
+			stats.push_back({
+				.extension = cache->extension,
+				.numAssets = cache->numAssets,
+				.usage     = cache->usage,
+				.peakUsage = cache->peakUsage,
+				.budget    = cache->budget
+			});
+		}
+
+		return stats;
+	}
+
+	unsigned ResourceCacheSingleton::Trim()
+	{
+		usage = {};
+		for (detail::ResourceCacheBase* cache : caches)
+		{
+			cache->Refresh();
+			UpdatePeak(cache->peakUsage, cache->usage);
+
+			usage += cache->usage;
+		}
+		UpdatePeak(peakUsage, usage);
+
+		// Evicting an asset can release the last references to others, such as the Textures of a Material,
+		// so candidates are gathered again until nothing more can be evicted.
+		unsigned numEvicted = 0;
+		std::vector<detail::ResourceCacheBase::Candidate> candidates;
+
+		for (detail::ResourceCacheBase* cache : caches)
+		{
+			while (cache->budget != 0 && cache->usage.Total() > cache->budget)
+			{
+				candidates.clear();
+				cache->GatherCandidates(candidates);
+
+				const unsigned count = EvictCandidates(candidates, cache->usage.Total(), cache->budget);
+				if (count == 0)
+				{
+					break;
+				}
+
+				numEvicted += count;
+			}
+		}
+
+		while (budget != 0 && usage.Total() > budget)
+		{
+			candidates.clear();
+			for (detail::ResourceCacheBase* cache : caches)
+			{
+				cache->GatherCandidates(candidates);
+			}
+
+			const unsigned count = EvictCandidates(candidates, usage.Total(), budget);
+			if (count == 0)
+			{
+				break;
+			}
+
+			numEvicted += count;
+		}
+
+		return numEvicted;
+	}
+
+	unsigned ResourceCacheSingleton::EvictUnused()
+	{
+		unsigned numEvicted = 0;
+		std::vector<detail::ResourceCacheBase::Candidate> candidates;
+
+		do
+		{
+			candidates.clear();
+			for (detail::ResourceCacheBase* cache : caches)
+			{
+				cache->GatherCandidates(candidates);
+			}
+
+			for (const auto& candidate : candidates)
+			{
+				candidate.cache->Evict(*candidate.path);
+			}
+
+			numEvicted += static_cast<unsigned>(candidates.size());
+		}
+		while (!candidates.empty());
+
+		return numEvicted;
+	}
+
+	void ResourceCacheSingleton::Update()
+	{
+		if (IsOverBudget())
+		{
+			Trim();
+		}
+	}
+
+	void ResourceCacheSingleton::Register(detail::ResourceCacheBase& cache)
+	{
+		ASSERT(!Contains(caches, &cache), "Cache is already registered.");
+
+		caches.push_back(&cache);
+	}
+
+	bool ResourceCacheSingleton::IsOverBudget() const
+	{
+		if (budget != 0 && usage.Total() > budget)
+		{
+			return true;
+		}
+
+		return std::ranges::any_of(caches, [](const detail::ResourceCacheBase* cache) {
+			return cache->budget != 0 && cache->usage.Total() > cache->budget;
+		});
+	}
+
+	unsigned ResourceCacheSingleton::EvictCandidates(std::vector<detail::ResourceCacheBase::Candidate>& candidates, size_t currentUsage, size_t targetUsage)
+	{
+		std::ranges::sort(candidates, {}, &detail::ResourceCacheBase::Candidate::lastUsed);
+
+		unsigned numEvicted = 0;
+		for (const auto& candidate : candidates)
+		{
+			if (currentUsage <= targetUsage)
+			{
+				break;
+			}
+
+			currentUsage -= std::min(candidate.bytes, currentUsage);
+			candidate.cache->Evict(*candidate.path);
+			++numEvicted;
+		}
+
+		return numEvicted;
+	}
+}
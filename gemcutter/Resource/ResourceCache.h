@@ -0,0 +1,131 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gem
+{
+	class ResourceCacheSingleton;
+
+	// The memory held by an asset, or by a group of assets.
+	struct MemoryUsage
+	{
+		size_t Total() const { return cpuBytes + gpuBytes; }
+
+		MemoryUsage& operator+=(const MemoryUsage& other) { cpuBytes += other.cpuBytes; gpuBytes += other.gpuBytes; return *this; }
+		MemoryUsage& operator-=(const MemoryUsage& other) { cpuBytes -= other.cpuBytes; gpuBytes -= other.gpuBytes; return *this; }
+
+		size_t cpuBytes = 0;
+		size_t gpuBytes = 0;
+	};
+
+	// A summary of the cached assets of a single type.
+	struct ResourceCacheStats
+	{
+		std::string_view extension;
+		unsigned numAssets = 0;
+		MemoryUsage usage;
+		MemoryUsage peakUsage;
+		// Zero if the type does not have a budget.
+		size_t budget = 0;
+	};
+
+	namespace detail
+	{
+		// The type-erased view of the cache of a single Resource type.
+		class ResourceCacheBase
+		{
+			friend ResourceCacheSingleton;
+		public:
+			// An unreferenced asset which can be evicted from the cache.
+			struct Candidate
+			{
+				ResourceCacheBase* cache;
+				const std::string* path;
+				uint64_t lastUsed;
+				size_t bytes;
+			};
+
+			ResourceCacheBase(std::string_view _extension) : extension(_extension) {}
+
+			// Must be called whenever an asset is added to the cache.
+			void OnAdded(const MemoryUsage& assetUsage);
+			// Must be called whenever an asset is removed from the cache.
+			void OnRemoved(const MemoryUsage& assetUsage);
+
+			// Returns a new value to mark an asset as being the most recently used.
+			static uint64_t Touch() { return ++accessCounter; }
+
+			std::string_view extension;
+			unsigned numAssets = 0;
+			MemoryUsage usage;
+			MemoryUsage peakUsage;
+			size_t budget = 0;
+
+		protected:
+			virtual ~ResourceCacheBase() = default;
+
+			// Measures each cached asset again, in case its memory has changed since it was loaded.
+			virtual void Refresh() = 0;
+			// Appends the assets which are referenced only by the cache.
+			virtual void GatherCandidates(std::vector<Candidate>& output) = 0;
+			virtual void Evict(const std::string& path) = 0;
+
+		private:
+			bool isRegistered = false;
+			static inline uint64_t accessCounter = 0;
+		};
+	}
+
+	// Tracks the memory held by all of the cached resources, and enforces memory budgets.
+	// When a budget is exceeded, the least recently used assets referenced only by their cache are
+	// unloaded until the usage falls back within the budget. Assets still in use are never evicted.
+	//
+	// Assets report their memory by implementing:
+	//	MemoryUsage GetMemoryUsage() const
+	// Assets without this function are cached as normal, but are counted as using no memory.
+	extern class ResourceCacheSingleton ResourceCache;
+	class ResourceCacheSingleton
+	{
+		friend class ApplicationSingleton; // For Update().
+		friend detail::ResourceCacheBase;
+	public:
+		// Sets the budget shared by all resource types, in bytes. Zero disables the budget.
+		void SetBudget(size_t bytes);
+		size_t GetBudget() const;
+
+		// Returns the memory currently held by all cached assets.
+		MemoryUsage GetUsage() const;
+		// Returns the highest memory usage since the start of the program, or since the last ResetPeakUsage().
+		MemoryUsage GetPeakUsage() const;
+		void ResetPeakUsage();
+
+		// Returns a summary of each resource type that has been cached.
+		std::vector<ResourceCacheStats> GetStats() const;
+
+		// Measures all cached assets, then evicts the least recently used unreferenced assets until every
+		// budget is met, or until there is nothing left to evict. Returns the number of assets evicted.
+		unsigned Trim();
+
+		// Unloads all assets referenced only by their cache, regardless of the budgets.
+		unsigned EvictUnused();
+
+	private:
+		// Called every frame to enforce the budgets.
+		void Update();
+
+		void Register(detail::ResourceCacheBase& cache);
+		bool IsOverBudget() const;
+		// Evicts candidates, from least to most recently used, until the usage is no more than the budget.
+		static unsigned EvictCandidates(std::vector<detail::ResourceCacheBase::Candidate>& candidates, size_t currentUsage, size_t targetUsage);
+
+		std::vector<detail::ResourceCacheBase*> caches;
+
+		MemoryUsage usage;
+		MemoryUsage peakUsage;
+		size_t budget = 0;
+	};
+}
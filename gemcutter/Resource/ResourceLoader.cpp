@@ -0,0 +1,259 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "ResourceLoader.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Application/Timer.h"
+
+#include <algorithm>
+
+namespace
+{
+	// Loading is mostly bound by the disk, so only a few threads are needed to keep it busy.
+	constexpr unsigned MAX_LOADING_THREADS = 4;
+}
+
+namespace gem
+{
+	ResourceLoaderSingleton ResourceLoader;
+
+	ResourceLoaderSingleton::~ResourceLoaderSingleton()
+	{
+		StopThreads();
+	}
+
+	void ResourceLoaderSingleton::Submit(std::shared_ptr<detail::LoadJob> job)
+	{
+		ASSERT(job, "'job' cannot be null.");
+		ASSERT(job->GetStatus() == LoadStatus::Reading, "'job' has already been submitted.");
+
+		if (threads.empty())
+		{
+			StartThreads();
+		}
+
+		numPending.fetch_add(1, std::memory_order_relaxed);
+
+		{
+			std::scoped_lock lock(readMutex);
+			readQueue.push_back(std::move(job));
+		}
+
+		readCondition.notify_one();
+	}
+
+	void ResourceLoaderSingleton::Wait(detail::LoadJob& job)
+	{
+		ASSERT(IsMainThread(), "Loads can only be waited on from the main thread.");
+
+		if (job.IsDone())
+		{
+			return;
+		}
+
+		// Rather than waiting behind every other queued job, take this one off the queue and read it now.
+		std::shared_ptr<detail::LoadJob> stolen;
+		{
+			std::scoped_lock lock(readMutex);
+			auto itr = std::ranges::find(readQueue, &job, &std::shared_ptr<detail::LoadJob>::get);
+			if (itr != readQueue.end())
+			{
+				stolen = std::move(*itr);
+				readQueue.erase(itr);
+			}
+		}
+
+		if (stolen)
+		{
+			Read(std::move(stolen));
+		}
+		else
+		{
+			job.status.wait(LoadStatus::Reading, std::memory_order_acquire);
+		}
+
+		if (job.GetStatus() == LoadStatus::Uploading)
+		{
+			std::shared_ptr<detail::LoadJob> pending;
+			{
+				std::scoped_lock lock(uploadMutex);
+				auto itr = std::ranges::find(uploadQueue, &job, &std::shared_ptr<detail::LoadJob>::get);
+				ASSERT(itr != uploadQueue.end(), "A job ready to upload must be in the upload queue.");
+
+				pending = std::move(*itr);
+				uploadQueue.erase(itr);
+			}
+
+			Finish(*pending);
+		}
+	}
+
+	void ResourceLoaderSingleton::WaitAll()
+	{
+		while (numPending.load(std::memory_order_acquire) > 0)
+		{
+			std::shared_ptr<detail::LoadJob> job;
+			{
+				std::scoped_lock lock(uploadMutex);
+				if (!uploadQueue.empty())
+				{
+					job = uploadQueue.front();
+				}
+			}
+
+			if (!job)
+			{
+				std::scoped_lock lock(readMutex);
+				if (!readQueue.empty())
+				{
+					job = readQueue.front();
+				}
+			}
+
+			if (job)
+			{
+				Wait(*job);
+			}
+			else
+			{
+				// Everything left is being read by the loading threads.
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void ResourceLoaderSingleton::Shutdown()
+	{
+		if (threads.empty())
+		{
+			return;
+		}
+
+		StopThreads();
+
+		// Anything left over is abandoned so that the callers waiting on it are released.
+		auto abandon = [this](std::deque<std::shared_ptr<detail::LoadJob>>& queue) {
+			for (auto& job : queue)
+			{
+				job->readSucceeded = false;
+				Finish(*job);
+			}
+			queue.clear();
+		};
+
+		abandon(readQueue);
+		abandon(uploadQueue);
+	}
+
+	void ResourceLoaderSingleton::SetUploadBudget(float milliseconds)
+	{
+		ASSERT(milliseconds >= 0.0f, "'milliseconds' cannot be negative.");
+
+		uploadBudget = milliseconds;
+	}
+
+	float ResourceLoaderSingleton::GetUploadBudget() const
+	{
+		return uploadBudget;
+	}
+
+	unsigned ResourceLoaderSingleton::GetNumPending() const
+	{
+		return numPending.load(std::memory_order_relaxed);
+	}
+
+	bool ResourceLoaderSingleton::IsMainThread() const
+	{
+		return std::this_thread::get_id() == mainThread;
+	}
+
+	void ResourceLoaderSingleton::Update()
+	{
+		const int64_t start = Timer::GetCurrentTick();
+		const int64_t budget = static_cast<int64_t>(uploadBudget * static_cast<float>(Timer::GetTicksPerMS()));
+
+		do
+		{
+			std::shared_ptr<detail::LoadJob> job;
+			{
+				std::scoped_lock lock(uploadMutex);
+				if (uploadQueue.empty())
+				{
+					return;
+				}
+
+				job = std::move(uploadQueue.front());
+				uploadQueue.pop_front();
+			}
+
+			Finish(*job);
+		}
+		while (Timer::GetCurrentTick() - start < budget);
+	}
+
+	void ResourceLoaderSingleton::StartThreads()
+	{
+		const unsigned numThreads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, MAX_LOADING_THREADS);
+
+		threads.reserve(numThreads);
+		for (unsigned i = 0; i < numThreads; ++i)
+		{
+			threads.emplace_back([this](std::stop_token stopToken) { ThreadLoop(stopToken); });
+		}
+	}
+
+	void ResourceLoaderSingleton::StopThreads()
+	{
+		for (std::jthread& thread : threads)
+		{
+			thread.request_stop();
+		}
+
+		readCondition.notify_all();
+		threads.clear();
+	}
+
+	void ResourceLoaderSingleton::ThreadLoop(std::stop_token stopToken)
+	{
+		while (true)
+		{
+			std::shared_ptr<detail::LoadJob> job;
+			{
+				std::unique_lock lock(readMutex);
+				readCondition.wait(lock, stopToken, [this] { return !readQueue.empty(); });
+				if (stopToken.stop_requested())
+				{
+					return;
+				}
+
+				job = std::move(readQueue.front());
+				readQueue.pop_front();
+			}
+
+			Read(std::move(job));
+		}
+	}
+
+	void ResourceLoaderSingleton::Read(std::shared_ptr<detail::LoadJob> job)
+	{
+		job->readSucceeded = job->Read();
+
+		{
+			// Changing the status under the lock ensures that an uploading job can always be found in the queue.
+			std::scoped_lock lock(uploadMutex);
+			job->status.store(LoadStatus::Uploading, std::memory_order_release);
+			uploadQueue.push_back(job);
+		}
+
+		job->status.notify_all();
+	}
+
+	void ResourceLoaderSingleton::Finish(detail::LoadJob& job)
+	{
+		const bool success = job.readSucceeded && job.Upload();
+		job.Complete(success);
+
+		job.status.store(success ? LoadStatus::Loaded : LoadStatus::Failed, std::memory_order_release);
+		job.status.notify_all();
+
+		numPending.fetch_sub(1, std::memory_order_release);
+	}
+}
@@ -0,0 +1,113 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gem
+{
+	class ResourceLoaderSingleton;
+
+	enum class LoadStatus : unsigned
+	{
+		// Waiting for, or running on, a loading thread.
+		Reading,
+		// Waiting to be finished on the main thread.
+		Uploading,
+		Loaded,
+		Failed
+	};
+
+	namespace detail
+	{
+		// A single asynchronous load, split between a loading thread and the main thread.
+		class LoadJob
+		{
+			friend ResourceLoaderSingleton;
+		public:
+			virtual ~LoadJob() = default;
+
+			LoadStatus GetStatus() const { return status.load(std::memory_order_acquire); }
+			bool IsDone() const { return GetStatus() >= LoadStatus::Loaded; }
+
+		protected:
+			// Runs on a loading thread. Must not touch the GPU or any shared engine state.
+			virtual bool Read() = 0;
+			// Runs on the main thread once Read() has completed successfully.
+			virtual bool Upload() = 0;
+			// Runs on the main thread once the load has either succeeded or failed.
+			virtual void Complete(bool success) = 0;
+
+		private:
+			std::atomic<LoadStatus> status = LoadStatus::Reading;
+			bool readSucceeded = false;
+		};
+	}
+
+	// Schedules asynchronous resource loads.
+	// File reads and decoding are distributed across a small pool of loading threads, while any work
+	// requiring the GPU is finished on the main thread, a few jobs per frame, within a time budget.
+	extern class ResourceLoaderSingleton ResourceLoader;
+	class ResourceLoaderSingleton
+	{
+		friend class ApplicationSingleton; // For Update().
+	public:
+		~ResourceLoaderSingleton();
+
+		// Queues the job to be read by a loading thread. The threads are started on first use.
+		void Submit(std::shared_ptr<detail::LoadJob> job);
+
+		// Blocks until the job is complete. If it has not started yet, or is waiting to be uploaded,
+		// it is finished immediately on the calling thread. Must be called from the main thread.
+		void Wait(detail::LoadJob& job);
+
+		// Finishes all queued jobs. Must be called from the main thread.
+		void WaitAll();
+
+		// Stops the loading threads. Jobs still in progress are abandoned.
+		void Shutdown();
+
+		// Sets the maximum time spent finishing loads each frame. At least one is always finished per frame.
+		void SetUploadBudget(float milliseconds);
+		float GetUploadBudget() const;
+
+		// Returns the number of jobs which have been submitted but not yet completed.
+		unsigned GetNumPending() const;
+
+		// Returns true if called from the main thread, which the program started on.
+		// Loads are finished there, and the resource caches are only accessed from it.
+		bool IsMainThread() const;
+
+	private:
+		// Called every frame in order to finish the loads that are ready for the GPU.
+		void Update();
+
+		void StartThreads();
+		void StopThreads();
+		void ThreadLoop(std::stop_token stopToken);
+
+		// Reads the job, and marks it as ready to upload.
+		void Read(std::shared_ptr<detail::LoadJob> job);
+		// Uploads and completes the job.
+		void Finish(detail::LoadJob& job);
+
+		std::vector<std::jthread> threads;
+
+		std::mutex readMutex;
+		std::condition_variable_any readCondition;
+		std::deque<std::shared_ptr<detail::LoadJob>> readQueue;
+
+		std::mutex uploadMutex;
+		std::deque<std::shared_ptr<detail::LoadJob>> uploadQueue;
+
+		std::atomic<unsigned> numPending = 0;
+		float uploadBudget = 2.0f;
+
+		// The singleton is constructed during static initialization, which runs on the main thread.
+		const std::thread::id mainThread = std::this_thread::get_id();
+	};
+}
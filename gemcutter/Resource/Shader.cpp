@@ -2,10 +2,15 @@
 #include "Shader.h"
 #include "gemcutter/Application/FileSystem.h"
 #include "gemcutter/Application/Logging.h"
+#include "gemcutter/Application/Timer.h"
 #include "gemcutter/Math/Vector.h"
+#include "gemcutter/Rendering/ClusteredLighting.h"
+#include "gemcutter/Rendering/Rendering.h"
+#include "gemcutter/Rendering/StateCache.h"
 #include "gemcutter/Utilities/ScopeGuard.h"
 #include "gemcutter/Utilities/String.h"
 
+#include <algorithm>
 #include <cctype>
 #include <functional>
 #include <GL/glew.h>
@@ -113,13 +118,27 @@ namespace
 		};
 
 		// Normal mapping helper.
-		mat3 make_TBN(vec3 normal, vec3 tangent, float handedness){
-			vec3 N = Gem_NormalToWorld * normal;
-			vec3 T = Gem_NormalToWorld * tangent;
+		mat3 Gem_make_TBN(mat3 normalToWorld, vec3 normal, vec3 tangent, float handedness){
+			vec3 N = normalToWorld * normal;
+			vec3 T = normalToWorld * tangent;
 			vec3 B = cross(T, N) * handedness;
 			return mat3(T, B, N);
 		}
 
+		// Expanded where it is used, so that it reads the multi-draw transforms in GEM_MULTI_DRAW variants.
+		#define make_TBN(normal, tangent, handedness) Gem_make_TBN(Gem_NormalToWorld, normal, tangent, handedness)
+
+		// Decodes normals and tangents from models using the octahedral NormalFormat.
+		vec3 decode_octahedral(vec2 e)
+		{
+			vec3 v = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+			if (v.z < 0.0)
+			{
+				v.xy = (1.0 - abs(e.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+			}
+			return normalize(v);
+		}
+
 		float linear_to_sRGB(float x)
 		{
 			if (x <= 0.00031308) return 12.92 * x;
@@ -184,19 +203,118 @@ namespace
 		#define is_directional_light(light) GEM_IS_DIRECTIONAL_LIGHT(light.Type)
 		#define is_spot_light(light) GEM_IS_SPOT_LIGHT(light.Type)
 		#define compute_light(light, normal, pos) GEM_COMPUTE_LIGHT(normal, pos, light.Color, light.Position, light.Direction, light.AttenuationLinear, light.AttenuationQuadratic, light.Angle, light.Type)
+
+		// Written by gem::ClusteredLighting.
+		struct Gem_Light {
+			vec4 Position;
+			vec4 Color;
+			vec4 Direction;
+			uvec4 Type;
+		};
+
+		layout(std140) uniform Gem_Light_Uniforms{
+			uvec4 Gem_ClusterSize;
+			vec4 Gem_ClusterScale;
+			vec4 Gem_ClusterOffset;
+			Gem_Light Gem_Lights[255];
+		};
+
+		// Each cluster's entry is packed as (offset << 8) | count. The light indices follow all of the entries.
+		uniform usamplerBuffer Gem_LightGrid;
+
+		vec3 GEM_COMPUTE_PACKED_LIGHT(Gem_Light light, vec3 normal, vec3 surfacePos)
+		{
+			return GEM_COMPUTE_LIGHT(normal, surfacePos, light.Color.rgb, light.Position.xyz, light.Direction.xyz, light.Position.w, light.Color.w, light.Direction.w, light.Type.x);
+		}
+
+		vec3 GEM_COMPUTE_CLUSTERED_LIGHTING(vec3 normal, vec3 surfacePos, vec2 fragCoord)
+		{
+			vec3 lighting = vec3(0.0);
+
+			// Directional lights are first, and reach every surface.
+			for (uint i = 0u; i < Gem_ClusterSize.w; ++i)
+			{
+				lighting += GEM_COMPUTE_PACKED_LIGHT(Gem_Lights[i], normal, surfacePos);
+			}
+
+			float depth = -(Gem_View * vec4(surfacePos, 1.0)).z;
+			uvec2 tile = min(uvec2(max((fragCoord - Gem_ClusterOffset.xy) * Gem_ClusterScale.xy, vec2(0.0))), Gem_ClusterSize.xy - 1u);
+			uint slice = uint(clamp(floor(log(max(depth, 1e-4)) * Gem_ClusterScale.z - Gem_ClusterScale.w), 0.0, float(Gem_ClusterSize.z - 1u)));
+			uint cluster = tile.x + Gem_ClusterSize.x * (tile.y + Gem_ClusterSize.y * slice);
+
+			uint entry = texelFetch(Gem_LightGrid, int(cluster)).r;
+			uint first = Gem_ClusterSize.x * Gem_ClusterSize.y * Gem_ClusterSize.z + (entry >> 8u);
+			uint count = entry & 0xFFu;
+			for (uint i = 0u; i < count; ++i)
+			{
+				uint index = texelFetch(Gem_LightGrid, int(first + i)).r;
+				lighting += GEM_COMPUTE_PACKED_LIGHT(Gem_Lights[index], normal, surfacePos);
+			}
+
+			return lighting;
+		}
+
+		// Only available in Fragment blocks.
+		#define compute_clustered_lighting(normal, pos) GEM_COMPUTE_CLUSTERED_LIGHTING(normal, pos, gl_FragCoord.xy)
 	)";
 
+	// Precedes the Vertex block, so that GEM_MULTI_DRAW can replace the model uniforms with the per-draw
+	// transforms written by StaticGeometry. gl_DrawID is only available in Vertex blocks, so the later
+	// stages keep the regular model uniforms.
+	constexpr std::string_view multiDrawHeader = R"(
+		#ifdef GEM_MULTI_DRAW
+		struct Gem_DrawData{
+			mat4 MVP;
+			mat4 ModelView;
+			mat4 Model;
+			mat4 InvModel;
+			mat4 NormalToWorld;
+		};
+
+		layout(std430) readonly buffer Gem_Draw_Buffer{
+			Gem_DrawData Gem_Draws[];
+		};
+
+		#define Gem_MVP Gem_Draws[Gem_DrawID].MVP
+		#define Gem_ModelView Gem_Draws[Gem_DrawID].ModelView
+		#define Gem_Model Gem_Draws[Gem_DrawID].Model
+		#define Gem_InvModel Gem_Draws[Gem_DrawID].InvModel
+		#define Gem_NormalToWorld mat3(Gem_Draws[Gem_DrawID].NormalToWorld)
+		#endif
+	)";
+
+	// Returns true if the source reads the model uniforms. The multi-draw variant only replaces them in Vertex blocks.
+	bool UsesModelUniforms(std::string_view source)
+	{
+		// "Gem_Model" also covers Gem_ModelView.
+		for (std::string_view name : { "Gem_MVP", "Gem_Model", "Gem_InvModel", "Gem_NormalToWorld", "make_TBN" })
+		{
+			if (source.find(name) != std::string_view::npos)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	// Starts compiling the shader. With parallel compilation, the driver may finish in the background.
 	unsigned CompileShader(unsigned program, unsigned type, std::string_view _header, std::string_view body)
 	{
 		unsigned shader = glCreateShader(type);
-		defer { glDeleteShader(shader); };
 
 		const char* sources[] = { _header.data(), body.data() };
 		const int lengths[] = { static_cast<int>(_header.size()), static_cast<int>(body.size()) };
 
 		glShaderSource(shader, 2, sources, lengths);
 		glCompileShader(shader);
+		glAttachShader(program, shader);
+
+		return shader;
+	}
 
+	bool CheckShader(unsigned shader)
+	{
 		GLint success = GL_FALSE;
 		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
 		if (success == GL_FALSE)
@@ -218,17 +336,15 @@ namespace
 
 			gem::Error(infoLog);
 
-			return GL_NONE;
+			return false;
 		}
 
-		glAttachShader(program, shader);
-		return shader;
+		return true;
 	}
 
-	bool LinkProgram(unsigned program)
+	bool CheckProgram(unsigned program)
 	{
 		GLint success = GL_FALSE;
-		glLinkProgram(program);
 		glGetProgramiv(program, GL_LINK_STATUS, &success);
 
 		// Output GL error to log on failure.
@@ -260,138 +376,8 @@ namespace
 
 namespace gem
 {
-	void ShaderVariantControl::Define(std::string_view name, std::string_view value)
-	{
-		ASSERT(!name.empty(), "Name cannot be empty.");
-
-		defer{ UpdateHash(); };
-
-		// Search for and update the define if it already exists.
-		for (auto& define : defines)
-		{
-			if (define.name == name)
-			{
-				define.value = value;
-				return;
-			}
-		}
-
-		// Add as a new define.
-		defines.emplace_back(std::string(name), std::string(value));
-	}
-
-	void ShaderVariantControl::Switch(std::string_view name, bool state)
-	{
-		if (state)
-		{
-			Define(name);
-		}
-		else
-		{
-			Undefine(name);
-		}
-	}
-
-	void ShaderVariantControl::Toggle(std::string_view name)
-	{
-		ASSERT(!name.empty(), "Name cannot be empty.");
-
-		defer { UpdateHash(); };
-
-		for (unsigned i = 0; i < defines.size(); ++i)
-		{
-			if (defines[i].name == name)
-			{
-				defines.erase(defines.begin() + i);
-				return;
-			}
-		}
-
-		defines.emplace_back(std::string(name), "");
-	}
-
-	bool ShaderVariantControl::IsDefined(std::string_view name) const
-	{
-		for (auto& define : defines)
-		{
-			if (define.name == name)
-			{
-				return true;
-			}
-		}
-
-		return false;
-	}
-
-	bool ShaderVariantControl::IsEmpty() const
-	{
-		return defines.empty();
-	}
-
-	void ShaderVariantControl::Undefine(std::string_view name)
-	{
-		for (unsigned i = 0; i < defines.size(); ++i)
-		{
-			if (defines[i].name == name)
-			{
-				defines.erase(defines.begin() + i);
-				UpdateHash();
-
-				return;
-			}
-		}
-	}
-
-	void ShaderVariantControl::Reset()
-	{
-		defines.clear();
-		hash = 0;
-	}
-
-	std::string ShaderVariantControl::GetString() const
-	{
-		std::string result;
-
-		// Rough estimate of total length.
-		result.reserve(defines.size() * 12);
-
-		for (auto& define : defines)
-		{
-			result += "#define " + define.name + ' ' + define.value + '\n';
-		}
-
-		return result;
-	}
-
-	std::size_t ShaderVariantControl::GetHash() const
-	{
-		return hash;
-	}
-
-	bool ShaderVariantControl::operator==(const ShaderVariantControl& other) const
-	{
-		return hash == other.hash;
-	}
-
-	bool ShaderVariantControl::operator!=(const ShaderVariantControl& other) const
-	{
-		return hash != other.hash;
-	}
-
-	void ShaderVariantControl::UpdateHash()
-	{
-		std::hash<std::string> str_hash;
-		hash = 0x0;
-
-		for (auto& define : defines)
-		{
-			hash += str_hash(define.name) + str_hash(define.value);
-		}
-	}
-
-	//-----------------------------------------------------------------------------------------------------
-
 	std::string Shader::commonHeader;
+	std::string Shader::multiDrawVertexHeader;
 
 	Shader::~Shader()
 	{
@@ -617,6 +603,8 @@ namespace gem
 			fragmentSource = passThroughFragment;
 		}
 
+		supportsMultiDraw = !UsesModelUniforms(geometrySource) && !UsesModelUniforms(fragmentSource);
+
 		loaded = true;
 		return true;
 	}
@@ -765,7 +753,8 @@ namespace gem
 				if (Id == static_cast<unsigned>(UniformBufferSlot::Camera) ||
 					Id == static_cast<unsigned>(UniformBufferSlot::Engine) ||
 					Id == static_cast<unsigned>(UniformBufferSlot::Model) ||
-					Id == static_cast<unsigned>(UniformBufferSlot::Time))
+					Id == static_cast<unsigned>(UniformBufferSlot::Time) ||
+					Id == static_cast<unsigned>(UniformBufferSlot::Lights))
 				{
 					Error("Buffer \"%s\" uses a reserved slot binding.", name);
 					return false;
@@ -1079,6 +1068,12 @@ namespace gem
 					return false;
 				}
 
+				if (Id == ClusteredLightingSingleton::TextureUnit)
+				{
+					Error("Sampler \"%s\" uses the texture unit reserved for clustered lighting.", name);
+					return false;
+				}
+
 				textureBindings.emplace_back(name, Id);
 
 				// Add OpenGL correct entry into _Samplers string.
@@ -1103,7 +1098,69 @@ namespace gem
 
 		// Our minimum supported version is 3.3, where the format of the GLSL
 		// version identifier begins to be symmetrical with the GL version.
-		commonHeader = "#version " + std::to_string(major) + std::to_string(minor) + "0\n" + std::string(header);
+		const int version = major * 10 + minor;
+		commonHeader = "#version " + std::to_string(major) + std::to_string(minor) + "0\n";
+
+		// Extensions must be enabled before any other code.
+		multiDrawVertexHeader.clear();
+		if (GPUInfo.SupportsMultiDrawIndirect())
+		{
+			if (version < 43)
+			{
+				commonHeader += "#extension GL_ARB_shader_storage_buffer_object : enable\n";
+			}
+
+			if (version < 46)
+			{
+				commonHeader += "#extension GL_ARB_shader_draw_parameters : enable\n";
+				multiDrawVertexHeader = "#define Gem_DrawID gl_DrawIDARB\n";
+			}
+			else
+			{
+				multiDrawVertexHeader = "#define Gem_DrawID gl_DrawID\n";
+			}
+
+			multiDrawVertexHeader += multiDrawHeader;
+		}
+
+		commonHeader += header;
+
+		// Program binaries can only be reused by the same driver that created them.
+		int numBinaryFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+		supportsProgramBinaries = numBinaryFormats > 0;
+
+		binaryCache.SetDriver(
+			reinterpret_cast<const char*>(glGetString(GL_VENDOR)),
+			reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+			reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+		// Let the driver compile with as many threads as it sees fit.
+		if (GLEW_KHR_parallel_shader_compile)
+		{
+			glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+			supportsParallelCompile = true;
+		}
+		else if (GLEW_ARB_parallel_shader_compile)
+		{
+			glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+			supportsParallelCompile = true;
+		}
+	}
+
+	void Shader::SetBinaryCacheDirectory(std::string_view directory)
+	{
+		binaryCache.SetDirectory(directory);
+	}
+
+	const std::string& Shader::GetBinaryCacheDirectory()
+	{
+		return binaryCache.GetDirectory();
+	}
+
+	unsigned Shader::ClearBinaryCache()
+	{
+		return binaryCache.Clear();
 	}
 
 	bool Shader::IsLoaded() const
@@ -1111,9 +1168,15 @@ namespace gem
 		return loaded;
 	}
 
+	bool Shader::SupportsMultiDraw() const
+	{
+		return supportsMultiDraw;
+	}
+
 	void Shader::Unload()
 	{
 		loaded = false;
+		supportsMultiDraw = false;
 
 		textures.Clear();
 		buffers.Clear();
@@ -1144,67 +1207,142 @@ namespace gem
 		if (itr == variants.end()) [[unlikely]]
 		{
 			// This shader variant is new and needs to be created.
-			auto& variant = variants.emplace(definitions, ShaderVariant()).first->second;
+			itr = variants.emplace(definitions, ShaderVariant()).first;
+			StartVariant(itr->first, itr->second);
+		}
+
+		if (itr->second.isCompiling) [[unlikely]]
+		{
+			FinishVariant(itr->first, itr->second);
+		}
 
-			const std::string defines = definitions.GetString();
+		itr->second.Bind();
 
-			if (!variant.Load(
-				commonHeader + uniformBuffers + samplers + defines,
-				attributes + vertexSource,
-				geometrySource,
-				fragmentSource))
+		/* Bind global shader resources */
+		textures.Bind();
+		buffers.Bind();
+	}
+
+	unsigned Shader::Precompile(std::span<const ShaderVariantControl> definitions)
+	{
+		ASSERT(IsLoaded(), "Must have a shader loaded to call this function.");
+
+		unsigned count = 0;
+		for (const ShaderVariantControl& variantDefinitions : definitions)
+		{
+			auto [itr, isNew] = variants.try_emplace(variantDefinitions);
+			if (isNew)
 			{
-				if (!defines.empty())
-				{
-					Error("With variant definitions:\n%s", defines.c_str());
-				}
+				StartVariant(itr->first, itr->second);
+				++count;
+			}
+		}
 
-				// Instead of doing nothing, we load a hard-coded pink shader on failure.
-				if (!variant.Load(commonHeader, fallbackVertex, "", fallbackFragment))
-				{
-					ASSERT(false, "Fallback pink-shader failed to compile.");
-				}
+		return count;
+	}
+
+	unsigned Shader::UpdateCompilation()
+	{
+		unsigned count = 0;
+		for (auto& [definitions, variant] : variants)
+		{
+			if (!variant.isCompiling)
+			{
+				continue;
+			}
+
+			if (variant.IsReady())
+			{
+				FinishVariant(definitions, variant);
 			}
 			else
 			{
-				// Make sure the samplers are all set to the correct bindings.
-				for (const auto& binding : textureBindings)
-				{
-					unsigned location = glGetUniformLocation(variant.program, binding.name.c_str());
-					// Not finding a location is not an error.
-					// It is most likely because a uniform has been optimized away.
-					if (location != GL_INVALID_INDEX)
-					{
-						glProgramUniform1i(variant.program, location, binding.unit);
-					}
-				}
+				++count;
+			}
+		}
 
-				// Make sure the UniformBuffers are all set to the correct bindings.
-				for (const auto& binding : bufferBindings)
-				{
-					unsigned block = glGetUniformBlockIndex(variant.program, ("Gem_User_" + binding.name).c_str());
-					if (block != GL_INVALID_INDEX)
-					{
-						glUniformBlockBinding(variant.program, block, binding.unit);
-					}
-				}
+		return count;
+	}
+
+	void Shader::FinishCompilation()
+	{
+		for (auto& [definitions, variant] : variants)
+		{
+			if (variant.isCompiling)
+			{
+				FinishVariant(definitions, variant);
 			}
+		}
+	}
+
+	bool Shader::IsCompiled(const ShaderVariantControl& definitions) const
+	{
+		auto itr = variants.find(definitions);
+		return itr != variants.end() && !itr->second.isCompiling;
+	}
 
-			variant.Bind();
+	bool Shader::SupportsParallelCompilation()
+	{
+		return supportsParallelCompile;
+	}
+
+	void Shader::StartVariant(const ShaderVariantControl& definitions, ShaderVariant& variant)
+	{
+		variant.Start(
+			commonHeader + uniformBuffers + samplers + definitions.GetString(),
+			multiDrawVertexHeader + attributes + vertexSource,
+			geometrySource,
+			fragmentSource);
+	}
+
+	void Shader::FinishVariant(const ShaderVariantControl& definitions, ShaderVariant& variant)
+	{
+		if (!variant.Finish())
+		{
+			LoadFallback(definitions, variant);
+			return;
 		}
-		else
+
+		// Make sure the samplers are all set to the correct bindings.
+		for (const auto& binding : textureBindings)
 		{
-			itr->second.Bind();
+			unsigned location = glGetUniformLocation(variant.program, binding.name.c_str());
+			// Not finding a location is not an error.
+			// It is most likely because a uniform has been optimized away.
+			if (location != GL_INVALID_INDEX)
+			{
+				glProgramUniform1i(variant.program, location, binding.unit);
+			}
 		}
 
-		/* Bind global shader resources */
-		textures.Bind();
-		buffers.Bind();
+		// Make sure the UniformBuffers are all set to the correct bindings.
+		for (const auto& binding : bufferBindings)
+		{
+			unsigned block = glGetUniformBlockIndex(variant.program, ("Gem_User_" + binding.name).c_str());
+			if (block != GL_INVALID_INDEX)
+			{
+				glUniformBlockBinding(variant.program, block, binding.unit);
+			}
+		}
+	}
+
+	void Shader::LoadFallback(const ShaderVariantControl& definitions, ShaderVariant& variant)
+	{
+		if (!definitions.IsEmpty())
+		{
+			Error("With variant definitions:\n%s", definitions.GetString().c_str());
+		}
+
+		// Instead of doing nothing, we load a hard-coded pink shader on failure.
+		if (!variant.Load(commonHeader, fallbackVertex, "", fallbackFragment))
+		{
+			ASSERT(false, "Fallback pink-shader failed to compile.");
+		}
 	}
 
 	void Shader::UnBind()
 	{
-		glUseProgram(GL_NONE);
+		GLState.UseProgram(GL_NONE);
 
 		textures.UnBind();
 		buffers.UnBind();
@@ -1229,73 +1367,208 @@ namespace gem
 
 	bool Shader::ShaderVariant::Load(std::string_view _header, std::string_view vertSource, std::string_view geomSource, std::string_view fragSource)
 	{
+		Start(_header, vertSource, geomSource, fragSource);
+		return Finish();
+	}
+
+	void Shader::ShaderVariant::Start(std::string_view _header, std::string_view vertSource, std::string_view geomSource, std::string_view fragSource)
+	{
+		ASSERT(program == GL_NONE, "ShaderVariant is already loaded.");
+
+		useCache = supportsProgramBinaries && binaryCache.IsEnabled();
+		if (useCache)
+		{
+			const std::string_view sources[] = { _header, vertSource, geomSource, fragSource };
+			key = binaryCache.ComputeKey(sources);
+
+			if (LoadBinary(key))
+			{
+				isCompiling = true;
+				return;
+			}
+		}
+
 		program = glCreateProgram();
-		unsigned vertShader = GL_NONE;
-		unsigned geomShader = GL_NONE;
-		unsigned fragShader = GL_NONE;
+		if (useCache)
+		{
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
 
+		// Errors are not checked until Finish(), so that the driver is free to compile in the background.
 		if (!vertSource.empty())
 		{
 			vertShader = CompileShader(program, GL_VERTEX_SHADER, _header, vertSource);
-			if (vertShader == GL_NONE)
-			{
-				Error("Shader variant's vertex stage failed to compile.");
-				Unload();
-				return false;
-			}
 		}
 
 		if (!geomSource.empty())
 		{
 			geomShader = CompileShader(program, GL_GEOMETRY_SHADER, _header, geomSource);
-			if (geomShader == GL_NONE)
-			{
-				Error("Shader variant's geometry stage failed to compile.");
-				Unload();
-				return false;
-			}
 		}
 
 		if (!fragSource.empty())
 		{
 			fragShader = CompileShader(program, GL_FRAGMENT_SHADER, _header, fragSource);
-			if (fragShader == GL_NONE)
+		}
+
+		glLinkProgram(program);
+		isCompiling = true;
+	}
+
+	bool Shader::ShaderVariant::IsReady() const
+	{
+		ASSERT(isCompiling, "ShaderVariant is not compiling.");
+
+		if (!supportsParallelCompile || (vertShader == GL_NONE && geomShader == GL_NONE && fragShader == GL_NONE))
+		{
+			return true;
+		}
+
+		GLint isComplete = GL_FALSE;
+		glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &isComplete);
+
+		return isComplete == GL_TRUE;
+	}
+
+	bool Shader::ShaderVariant::Finish()
+	{
+		ASSERT(isCompiling, "ShaderVariant is not compiling.");
+
+		isCompiling = false;
+		defer { DeleteShaders(); };
+
+		if (vertShader != GL_NONE && !CheckShader(vertShader))
+		{
+			Error("Shader variant's vertex stage failed to compile.");
+			Unload();
+			return false;
+		}
+
+		if (geomShader != GL_NONE && !CheckShader(geomShader))
+		{
+			Error("Shader variant's geometry stage failed to compile.");
+			Unload();
+			return false;
+		}
+
+		if (fragShader != GL_NONE && !CheckShader(fragShader))
+		{
+			Error("Shader variant's fragment stage failed to compile.");
+			Unload();
+			return false;
+		}
+
+		if (!CheckProgram(program))
+		{
+			Error("Shader variant failed to link.");
+			Unload();
+			return false;
+		}
+
+		// Programs restored from the binary cache have no shaders and do not need to be saved again.
+		const bool wasCompiled = vertShader != GL_NONE || geomShader != GL_NONE || fragShader != GL_NONE;
+		if (useCache && wasCompiled)
+		{
+			SaveBinary(key);
+		}
+
+		BindEngineBlocks();
+
+		return true;
+	}
+
+	void Shader::ShaderVariant::DeleteShaders()
+	{
+		for (unsigned* shader : { &vertShader, &geomShader, &fragShader })
+		{
+			if (*shader != GL_NONE)
 			{
-				Error("Shader variant's fragment stage failed to compile.");
-				Unload();
-				return false;
+				if (program != GL_NONE)
+				{
+					glDetachShader(program, *shader);
+				}
+
+				glDeleteShader(*shader);
+				*shader = GL_NONE;
 			}
 		}
+	}
 
-		if (!LinkProgram(program))
+	bool Shader::ShaderVariant::LoadBinary(uint64_t key)
+	{
+		ProgramBinary binary;
+		if (!binaryCache.Load(key, binary))
 		{
-			Error("Shader variant failed to link.");
+			return false;
+		}
+
+		program = glCreateProgram();
+		glProgramBinary(program, binary.format, binary.data.data(), static_cast<GLsizei>(binary.data.size()));
+
+		// Drivers may reject a binary at any time, in which case it is compiled from source again.
+		int status = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &status);
+		if (status != GL_TRUE)
+		{
+			binaryCache.Remove(key);
 			Unload();
 			return false;
 		}
 
-		if (vertShader != GL_NONE) glDetachShader(program, vertShader);
-		if (geomShader != GL_NONE) glDetachShader(program, geomShader);
-		if (fragShader != GL_NONE) glDetachShader(program, fragShader);
+		return true;
+	}
+
+	void Shader::ShaderVariant::SaveBinary(uint64_t key) const
+	{
+		int length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+		{
+			return;
+		}
+
+		ProgramBinary binary;
+		binary.data.resize(static_cast<size_t>(length));
+
+		GLenum format = GL_NONE;
+		glGetProgramBinary(program, length, nullptr, &format, binary.data.data());
+		binary.format = format;
+
+		binaryCache.Save(key, binary);
+	}
 
+	void Shader::ShaderVariant::BindEngineBlocks() const
+	{
 		/* Initialize built-in uniform blocks */
 		unsigned cameraBlock = glGetUniformBlockIndex(program, "Gem_Camera_Uniforms");
 		unsigned modelBlock  = glGetUniformBlockIndex(program, "Gem_Model_Uniforms");
 		unsigned engineBlock = glGetUniformBlockIndex(program, "Gem_Engine_Uniforms");
 		unsigned timeBlock   = glGetUniformBlockIndex(program, "Gem_Time_Uniforms");
+		unsigned lightBlock  = glGetUniformBlockIndex(program, "Gem_Light_Uniforms");
 
 		if (cameraBlock != GL_INVALID_INDEX) glUniformBlockBinding(program, cameraBlock, (GLuint)UniformBufferSlot::Camera);
 		if (modelBlock  != GL_INVALID_INDEX) glUniformBlockBinding(program, modelBlock,  (GLuint)UniformBufferSlot::Model);
 		if (engineBlock != GL_INVALID_INDEX) glUniformBlockBinding(program, engineBlock, (GLuint)UniformBufferSlot::Engine);
 		if (timeBlock   != GL_INVALID_INDEX) glUniformBlockBinding(program, timeBlock,   (GLuint)UniformBufferSlot::Time);
+		if (lightBlock  != GL_INVALID_INDEX) glUniformBlockBinding(program, lightBlock,  (GLuint)UniformBufferSlot::Lights);
 
-		return true;
+		if (GPUInfo.SupportsMultiDrawIndirect())
+		{
+			unsigned drawBlock = glGetProgramResourceIndex(program, GL_SHADER_STORAGE_BLOCK, "Gem_Draw_Buffer");
+			if (drawBlock != GL_INVALID_INDEX) glShaderStorageBlockBinding(program, drawBlock, (GLuint)StorageBufferSlot::Draws);
+		}
+
+		int lightGrid = glGetUniformLocation(program, "Gem_LightGrid");
+		if (lightGrid != -1) glProgramUniform1i(program, lightGrid, ClusteredLightingSingleton::TextureUnit);
 	}
 
 	void Shader::ShaderVariant::Unload()
 	{
+		DeleteShaders();
+		isCompiling = false;
+
 		if (program != GL_NONE)
 		{
+			GLState.OnProgramDeleted(program);
 			glDeleteProgram(program);
 			program = GL_NONE;
 		}
@@ -1305,7 +1578,144 @@ namespace gem
 	{
 		ASSERT(program != GL_NONE, "ShaderVariant cannot be bound because it is not loaded.");
 
-		glUseProgram(program);
+		GLState.UseProgram(program);
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
+	void ShaderPrecompiler::Add(Shader::Ptr shader, const ShaderVariantControl& definitions)
+	{
+		ASSERT(shader, "'shader' cannot be null.");
+
+		queue.emplace_back(std::move(shader), definitions);
+	}
+
+	void ShaderPrecompiler::AddPermutations(Shader::Ptr shader, std::span<const ShaderKeyword> switches, const ShaderVariantControl& base)
+	{
+		ASSERT(shader, "'shader' cannot be null.");
+		ASSERT(switches.size() < 16, "Too many switches. Expected at most 15 (32768 variants).");
+
+		const unsigned numPermutations = 1u << switches.size();
+		queue.reserve(queue.size() + numPermutations);
+
+		for (unsigned mask = 0; mask < numPermutations; ++mask)
+		{
+			ShaderVariantControl definitions = base;
+			for (unsigned i = 0; i < switches.size(); ++i)
+			{
+				definitions.Switch(switches[i], (mask & (1u << i)) != 0);
+			}
+
+			queue.emplace_back(shader, std::move(definitions));
+		}
+	}
+
+	bool ShaderPrecompiler::Update()
+	{
+		const int64_t start = Timer::GetCurrentTick();
+		const int64_t budget = static_cast<int64_t>(timeBudget * static_cast<float>(Timer::GetTicksPerMS()));
+
+		while (nextRequest < queue.size())
+		{
+			pending.push_back(nextRequest);
+			Request& request = queue[nextRequest++];
+			request.shader->Precompile({ &request.definitions, 1 });
+
+			if (!Shader::SupportsParallelCompilation())
+			{
+				// The driver would compile on this thread anyway, so we finish now to measure the time.
+				request.shader->FinishCompilation();
+				if (Timer::GetCurrentTick() - start >= budget)
+				{
+					break;
+				}
+			}
+			else if (std::ranges::find(compiling, request.shader) == compiling.end())
+			{
+				compiling.push_back(request.shader);
+			}
+		}
+
+		std::erase_if(compiling, [](const Shader::Ptr& shader) {
+			return shader->UpdateCompilation() == 0;
+		});
+
+		// Each request is counted once, even if its variant was already queued or compiled by someone else.
+		numCompiled += static_cast<unsigned>(std::erase_if(pending, [this](size_t index) {
+			const Request& request = queue[index];
+			return request.shader->IsCompiled(request.definitions);
+		}));
+
+		return IsDone();
+	}
+
+	void ShaderPrecompiler::Finish()
+	{
+		for (; nextRequest < queue.size(); ++nextRequest)
+		{
+			Request& request = queue[nextRequest];
+			request.shader->Precompile({ &request.definitions, 1 });
+
+			if (std::ranges::find(compiling, request.shader) == compiling.end())
+			{
+				compiling.push_back(request.shader);
+			}
+		}
+
+		for (const Shader::Ptr& shader : compiling)
+		{
+			shader->FinishCompilation();
+		}
+
+		compiling.clear();
+		pending.clear();
+		numCompiled = static_cast<unsigned>(queue.size());
+	}
+
+	void ShaderPrecompiler::Clear()
+	{
+		queue.clear();
+		nextRequest = 0;
+		compiling.clear();
+		pending.clear();
+		numCompiled = 0;
+	}
+
+	void ShaderPrecompiler::SetTimeBudget(float milliseconds)
+	{
+		ASSERT(milliseconds >= 0.0f, "'milliseconds' cannot be negative.");
+
+		timeBudget = milliseconds;
+	}
+
+	float ShaderPrecompiler::GetTimeBudget() const
+	{
+		return timeBudget;
+	}
+
+	unsigned ShaderPrecompiler::GetNumVariants() const
+	{
+		return static_cast<unsigned>(queue.size());
+	}
+
+	unsigned ShaderPrecompiler::GetNumCompiled() const
+	{
+		return numCompiled;
+	}
+
+	float ShaderPrecompiler::GetProgress() const
+	{
+		if (queue.empty())
+		{
+			return 1.0f;
+		}
+
+		return static_cast<float>(GetNumCompiled()) / static_cast<float>(queue.size());
+	}
+
+	bool ShaderPrecompiler::IsDone() const
+	{
+		return numCompiled == queue.size();
 	}
 }
 
@@ -1,6 +1,8 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
+#include "gemcutter/Resource/ProgramBinaryCache.h"
 #include "gemcutter/Resource/Resource.h"
+#include "gemcutter/Resource/ShaderVariantControl.h"
 #include "gemcutter/Resource/Shareable.h"
 #include "gemcutter/Resource/Texture.h"
 #include "gemcutter/Resource/UniformBuffer.h"
@@ -10,69 +12,6 @@
 #include <unordered_map>
 #include <vector>
 
-namespace gem
-{
-	// Manages a set of defines used to control shaders.
-	class ShaderVariantControl
-	{
-	public:
-		// Adds a new define, or updates its value.
-		void Define(std::string_view name, std::string_view value = "");
-
-		// Either Define()'s or Undefine()'s the property, based on state.
-		void Switch(std::string_view name, bool state);
-
-		// Defines the property if it does not already exist. If it does, it is undefined.
-		void Toggle(std::string_view name);
-
-		// Returns true if 'name' is defined.
-		bool IsDefined(std::string_view name) const;
-
-		// Returns true if this object contains no defines.
-		bool IsEmpty() const;
-
-		// Removes a define.
-		void Undefine(std::string_view name);
-
-		// Clears all defined values.
-		void Reset();
-
-		// Returns the complete list of Defines.
-		std::string GetString() const;
-
-		// Returns a hash value generated from all internal defines.
-		std::size_t GetHash() const;
-
-		bool operator==(const ShaderVariantControl&) const;
-		bool operator!=(const ShaderVariantControl&) const;
-
-	private:
-		void UpdateHash();
-
-		struct Entry
-		{
-			std::string name;
-			std::string value;
-		};
-
-		std::vector<Entry> defines;
-		std::size_t hash = 0;
-	};
-}
-
-namespace std
-{
-	// Custom hash functor for the variant control.
-	template<>
-	struct hash<gem::ShaderVariantControl>
-	{
-		size_t operator()(const gem::ShaderVariantControl& svc) const noexcept
-		{
-			return svc.GetHash();
-		}
-	};
-}
-
 namespace gem
 {
 	// Used internally to expose Uniform buffers from the shader to BufferSlots.
@@ -120,6 +59,29 @@ namespace gem
 		void UnBind();
 
 		bool IsLoaded() const;
+		// Returns false if the Geometry or Fragment blocks read the model uniforms. The GEM_MULTI_DRAW variant
+		// only provides them to the Vertex block, so the shader must be drawn one Entity at a time instead.
+		bool SupportsMultiDraw() const;
+
+		// Starts compiling the variants ahead of time, so that binding them later does not stall rendering.
+		// If the driver supports parallel compilation, the variants are compiled in the background.
+		// Returns the number of variants which were not already compiled or compiling.
+		unsigned Precompile(std::span<const ShaderVariantControl> definitions);
+		// Completes any variants which have finished compiling in the background. Returns the number still compiling.
+		unsigned UpdateCompilation();
+		// Blocks until all variants have finished compiling.
+		void FinishCompilation();
+		// Returns true if the variant has been compiled and is ready to bind without stalling.
+		bool IsCompiled(const ShaderVariantControl& definitions) const;
+		// Returns true if the driver is able to compile shaders in the background.
+		static bool SupportsParallelCompilation();
+
+		// Sets the folder used to keep compiled shader variants between runs. An empty directory disables the cache.
+		// Variants are only cached if the driver supports program binaries.
+		static void SetBinaryCacheDirectory(std::string_view directory);
+		static const std::string& GetBinaryCacheDirectory();
+		// Deletes all of the cached shader variants. Returns the number deleted.
+		static unsigned ClearBinaryCache();
 
 		// These textures will be bound whenever the shader is used in rendering.
 		TextureList textures;
@@ -135,11 +97,30 @@ namespace gem
 		{
 			~ShaderVariant();
 
+			// Loads the program from the binary cache if possible, otherwise it is compiled and added to the cache.
 			bool Load(std::string_view header, std::string_view vertSource, std::string_view geomSource, std::string_view fragSource);
 			void Unload();
 			void Bind() const;
 
+			// Load() split in two. Start() issues the compilation without waiting on the result, and Finish()
+			// checks the result, blocking if the driver is still compiling. IsReady() polls without blocking.
+			void Start(std::string_view header, std::string_view vertSource, std::string_view geomSource, std::string_view fragSource);
+			bool IsReady() const;
+			bool Finish();
+			void DeleteShaders();
+
+			bool LoadBinary(uint64_t key);
+			void SaveBinary(uint64_t key) const;
+			// Connects the engine's uniform blocks to their binding slots.
+			void BindEngineBlocks() const;
+
 			unsigned program = 0;
+			unsigned vertShader = 0;
+			unsigned geomShader = 0;
+			unsigned fragShader = 0;
+			uint64_t key = 0;
+			bool useCache = false;
+			bool isCompiling = false;
 		};
 
 		// Used to identify the content of a Program block.
@@ -173,10 +154,19 @@ namespace gem
 		bool ParseUniformBlock(const Block& block, std::string_view name, unsigned Id, bool isInstance, bool isStatic);
 		bool ParseSamplers(const Block& block);
 
+		void StartVariant(const ShaderVariantControl& definitions, ShaderVariant& variant);
+		void FinishVariant(const ShaderVariantControl& definitions, ShaderVariant& variant);
+		void LoadFallback(const ShaderVariantControl& definitions, ShaderVariant& variant);
+
 		friend class ApplicationSingleton; // For BuildCommonHeader().
 		static void BuildCommonHeader();
 
+		static inline ProgramBinaryCache binaryCache;
+		static inline bool supportsProgramBinaries = false;
+		static inline bool supportsParallelCompile = false;
+
 		bool loaded = false;
+		bool supportsMultiDraw = false;
 
 		std::unordered_map<ShaderVariantControl, ShaderVariant> variants;
 
@@ -185,6 +175,8 @@ namespace gem
 
 		// Various shader source code snippets.
 		static std::string commonHeader;
+		// Prepended to the Vertex block. Holds the multi-draw replacements of the model uniforms.
+		static std::string multiDrawVertexHeader;
 		std::string attributes;
 		std::string samplers;
 		std::string uniformBuffers;
@@ -192,4 +184,52 @@ namespace gem
 		std::string geometrySource;
 		std::string fragmentSource;
 	};
+
+	// Compiles shader variants ahead of time, such as behind a loading screen, and tracks the progress.
+	class ShaderPrecompiler
+	{
+	public:
+		// Queues a single variant of the shader.
+		void Add(Shader::Ptr shader, const ShaderVariantControl& definitions = {});
+		// Queues every combination of the switches on top of the base definitions, 2^N variants in total.
+		void AddPermutations(Shader::Ptr shader, std::span<const ShaderKeyword> switches, const ShaderVariantControl& base = {});
+
+		// Should be called once per frame. If the driver supports parallel compilation, all queued variants
+		// are handed to it at once. Otherwise, they are compiled one at a time within the time budget.
+		// Returns true once every queued variant has been compiled.
+		bool Update();
+		// Blocks until every queued variant has been compiled.
+		void Finish();
+		// Removes all queued variants. Variants which are already compiling are unaffected.
+		void Clear();
+
+		// Sets the maximum time spent compiling each frame when the driver cannot compile in the background.
+		// At least one variant is always compiled per frame.
+		void SetTimeBudget(float milliseconds);
+		float GetTimeBudget() const;
+
+		unsigned GetNumVariants() const;
+		unsigned GetNumCompiled() const;
+		// Returns the fraction of queued variants which have been compiled, from 0 to 1.
+		float GetProgress() const;
+		bool IsDone() const;
+
+	private:
+		struct Request
+		{
+			Shader::Ptr shader;
+			ShaderVariantControl definitions;
+		};
+
+		std::vector<Request> queue;
+		size_t nextRequest = 0;
+
+		// Shaders which may still have variants compiling in the background.
+		std::vector<Shader::Ptr> compiling;
+		// The indices of started requests which have not yet been seen to finish.
+		std::vector<size_t> pending;
+		unsigned numCompiled = 0;
+
+		float timeBudget = 8.0f;
+	};
 }
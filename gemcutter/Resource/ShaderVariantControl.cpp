@@ -0,0 +1,279 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "ShaderVariantControl.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Utilities/StdExt.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <deque>
+#include <unordered_map>
+
+namespace
+{
+	struct KeywordRegistry
+	{
+		// A deque never moves its elements as it grows, so the names can be safely viewed.
+		std::deque<std::string> names;
+		std::unordered_map<std::string, uint16_t, gem::string_hash, std::equal_to<>> indices;
+	};
+
+	// Keywords are often created during static initialization, so the registry is created on first use.
+	KeywordRegistry& GetRegistry()
+	{
+		static KeywordRegistry registry;
+		return registry;
+	}
+}
+
+namespace gem
+{
+	ShaderKeyword::ShaderKeyword(std::string_view name)
+	{
+		ASSERT(!name.empty(), "Name cannot be empty.");
+
+		KeywordRegistry& registry = GetRegistry();
+		auto itr = registry.indices.find(name);
+		if (itr != registry.indices.end())
+		{
+			index = itr->second;
+			return;
+		}
+
+		// Silently dropping the define would compile the wrong variant, so this cannot be recovered from.
+		if (registry.names.size() >= MaxKeywords) [[unlikely]]
+		{
+			ErrorBox("ShaderKeyword: The maximum of (%u) unique keywords has been exceeded by \"%.*s\".",
+				MaxKeywords, static_cast<int>(name.size()), name.data());
+			std::abort();
+		}
+
+		index = static_cast<uint16_t>(registry.names.size());
+		registry.names.emplace_back(name);
+		registry.indices.emplace(name, index);
+	}
+
+	ShaderKeyword::ShaderKeyword(const char* name)
+		: ShaderKeyword(std::string_view(name))
+	{
+	}
+
+	std::string_view ShaderKeyword::GetName() const
+	{
+		return GetRegistry().names[index];
+	}
+
+	unsigned ShaderKeyword::GetNumKeywords()
+	{
+		return static_cast<unsigned>(GetRegistry().names.size());
+	}
+
+	void ShaderKeyword::ResetKeywords(unsigned count)
+	{
+		KeywordRegistry& registry = GetRegistry();
+		while (registry.names.size() > count)
+		{
+			registry.indices.erase(registry.names.back());
+			registry.names.pop_back();
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
+	void ShaderVariantControl::Define(ShaderKeyword keyword)
+	{
+		SetBit(keyword.GetIndex());
+
+		if (!values.empty()) [[unlikely]]
+		{
+			std::erase_if(values, [&](const Value& entry) { return entry.keyword == keyword.GetIndex(); });
+		}
+	}
+
+	void ShaderVariantControl::Define(ShaderKeyword keyword, int value)
+	{
+		SetBit(keyword.GetIndex());
+
+		auto itr = std::ranges::lower_bound(values, keyword.GetIndex(), {}, &Value::keyword);
+		if (itr != values.end() && itr->keyword == keyword.GetIndex())
+		{
+			itr->value = value;
+		}
+		else
+		{
+			values.insert(itr, { static_cast<uint16_t>(keyword.GetIndex()), value });
+		}
+	}
+
+	void ShaderVariantControl::Switch(ShaderKeyword keyword, bool state)
+	{
+		if (state)
+		{
+			Define(keyword);
+		}
+		else
+		{
+			Undefine(keyword);
+		}
+	}
+
+	void ShaderVariantControl::Toggle(ShaderKeyword keyword)
+	{
+		Switch(keyword, !IsDefined(keyword));
+	}
+
+	bool ShaderVariantControl::IsDefined(ShaderKeyword keyword) const
+	{
+		return TestBit(keyword.GetIndex());
+	}
+
+	int ShaderVariantControl::GetValue(ShaderKeyword keyword) const
+	{
+		auto itr = std::ranges::lower_bound(values, keyword.GetIndex(), {}, &Value::keyword);
+		if (itr != values.end() && itr->keyword == keyword.GetIndex())
+		{
+			return itr->value;
+		}
+
+		return 0;
+	}
+
+	bool ShaderVariantControl::IsEmpty() const
+	{
+		return mask == 0 && extendedMask.empty();
+	}
+
+	void ShaderVariantControl::Undefine(ShaderKeyword keyword)
+	{
+		ClearBit(keyword.GetIndex());
+
+		if (!values.empty()) [[unlikely]]
+		{
+			std::erase_if(values, [&](const Value& entry) { return entry.keyword == keyword.GetIndex(); });
+		}
+	}
+
+	void ShaderVariantControl::Reset()
+	{
+		mask = 0;
+		extendedMask.clear();
+		values.clear();
+	}
+
+	std::string ShaderVariantControl::GetString() const
+	{
+		const KeywordRegistry& registry = GetRegistry();
+		std::string result;
+
+		// Rough estimate of total length.
+		unsigned numDefines = std::popcount(mask);
+		for (uint64_t word : extendedMask)
+		{
+			numDefines += std::popcount(word);
+		}
+		result.reserve(numDefines * 32);
+
+		// Both the bits and the values are in the order of the keywords' indices.
+		auto value = values.begin();
+		auto appendWord = [&](uint64_t bits, unsigned firstIndex) {
+			for (; bits != 0; bits &= bits - 1)
+			{
+				const unsigned index = firstIndex + static_cast<unsigned>(std::countr_zero(bits));
+
+				result += "#define ";
+				result += registry.names[index];
+				result += ' ';
+				if (value != values.end() && value->keyword == index)
+				{
+					result += std::to_string(value->value);
+					++value;
+				}
+				result += '\n';
+			}
+		};
+
+		appendWord(mask, 0);
+		for (unsigned i = 0; i < extendedMask.size(); ++i)
+		{
+			appendWord(extendedMask[i], (i + 1) * 64);
+		}
+
+		return result;
+	}
+
+	std::size_t ShaderVariantControl::GetHash() const
+	{
+		uint64_t hash = mask;
+		for (uint64_t word : extendedMask)
+		{
+			hash = (hash ^ word) * 0x100000001b3ull;
+		}
+
+		for (const Value& entry : values)
+		{
+			// Mixes in the values without any branches. Collisions only affect performance, since equality is exact.
+			hash ^= (static_cast<uint64_t>(static_cast<uint32_t>(entry.value)) + entry.keyword + 0x9e3779b97f4a7c15ull) * 0xbf58476d1ce4e5b9ull;
+		}
+
+		return static_cast<std::size_t>(hash);
+	}
+
+	bool ShaderVariantControl::operator==(const ShaderVariantControl& other) const
+	{
+		return mask == other.mask && extendedMask == other.extendedMask && values == other.values;
+	}
+
+	bool ShaderVariantControl::operator!=(const ShaderVariantControl& other) const
+	{
+		return !(*this == other);
+	}
+
+	void ShaderVariantControl::SetBit(unsigned index)
+	{
+		if (index < 64) [[likely]]
+		{
+			mask |= 1ull << index;
+			return;
+		}
+
+		const unsigned word = index / 64 - 1;
+		if (word >= extendedMask.size())
+		{
+			extendedMask.resize(word + 1);
+		}
+
+		extendedMask[word] |= 1ull << (index % 64);
+	}
+
+	void ShaderVariantControl::ClearBit(unsigned index)
+	{
+		if (index < 64) [[likely]]
+		{
+			mask &= ~(1ull << index);
+			return;
+		}
+
+		const unsigned word = index / 64 - 1;
+		if (word >= extendedMask.size())
+		{
+			return;
+		}
+
+		extendedMask[word] &= ~(1ull << (index % 64));
+		while (!extendedMask.empty() && extendedMask.back() == 0)
+		{
+			extendedMask.pop_back();
+		}
+	}
+
+	bool ShaderVariantControl::TestBit(unsigned index) const
+	{
+		if (index < 64) [[likely]]
+		{
+			return (mask & (1ull << index)) != 0;
+		}
+
+		const unsigned word = index / 64 - 1;
+		return word < extendedMask.size() && (extendedMask[word] & (1ull << (index % 64))) != 0;
+	}
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace gem
+{
+	// A define used to control shader variants. Each unique name is assigned an index the first time
+	// it is used, so that variants can be compared and hashed without any string work.
+	// Keywords which are switched often should be created once and reused.
+	// Names are registered permanently, including those converted implicitly from a string literal.
+	// The registry is not synchronized, so keywords must only be created on the main thread.
+	class ShaderKeyword
+	{
+	public:
+		// Creating more unique keywords than this is a fatal error.
+		static constexpr unsigned MaxKeywords = 1u << 16;
+
+		ShaderKeyword(std::string_view name);
+		ShaderKeyword(const char* name);
+
+		unsigned GetIndex() const { return index; }
+		std::string_view GetName() const;
+
+		// Returns the number of unique keywords created so far.
+		static unsigned GetNumKeywords();
+
+		// Unregisters every keyword created after the first 'count', such as those created by a unit test.
+		// Any keywords or variants still referring to the removed names must not be used again.
+		static void ResetKeywords(unsigned count);
+
+	private:
+		uint16_t index;
+	};
+
+	// Manages a set of defines used to control shaders.
+	class ShaderVariantControl
+	{
+	public:
+		// Adds a new define, or removes its value.
+		void Define(ShaderKeyword keyword);
+		// Adds a new define with a value, or updates its value.
+		void Define(ShaderKeyword keyword, int value);
+
+		// Either Define()'s or Undefine()'s the property, based on state.
+		void Switch(ShaderKeyword keyword, bool state);
+
+		// Defines the property if it does not already exist. If it does, it is undefined.
+		void Toggle(ShaderKeyword keyword);
+
+		// Returns true if the keyword is defined.
+		bool IsDefined(ShaderKeyword keyword) const;
+
+		// Returns the value of the define, or 0 if it has no value.
+		int GetValue(ShaderKeyword keyword) const;
+
+		// Returns true if this object contains no defines.
+		bool IsEmpty() const;
+
+		// Removes a define.
+		void Undefine(ShaderKeyword keyword);
+
+		// Clears all defined values.
+		void Reset();
+
+		// Returns the complete list of Defines, in the order of the keywords' indices.
+		std::string GetString() const;
+
+		// Returns a hash value generated from all internal defines.
+		std::size_t GetHash() const;
+
+		bool operator==(const ShaderVariantControl&) const;
+		bool operator!=(const ShaderVariantControl&) const;
+
+	private:
+		struct Value
+		{
+			bool operator==(const Value&) const = default;
+
+			uint16_t keyword;
+			int value;
+		};
+
+		void SetBit(unsigned index);
+		void ClearBit(unsigned index);
+		bool TestBit(unsigned index) const;
+
+		// A bit for each of the first 64 keywords, by index.
+		uint64_t mask = 0;
+		// The bits of any further keywords, 64 per word. Trailing empty words are removed, so that
+		// equal sets of defines are always stored the same way. Only allocated by large projects.
+		std::vector<uint64_t> extendedMask;
+		// Only the defines with a value, sorted by keyword.
+		std::vector<Value> values;
+	};
+}
+
+namespace std
+{
+	// Custom hash functor for the variant control.
+	template<>
+	struct hash<gem::ShaderVariantControl>
+	{
+		size_t operator()(const gem::ShaderVariantControl& svc) const noexcept
+		{
+			return svc.GetHash();
+		}
+	};
+}
@@ -1,10 +1,13 @@
 // Copyright (c) 2017 Emilian Cioca
 #include "Sound.h"
 #include "gemcutter/Application/Logging.h"
-#include "gemcutter/Utilities/ScopeGuard.h"
+#include "gemcutter/Resource/AssetPack.h"
+#include "gemcutter/Utilities/BinaryReader.h"
 
+#include <memory>
 #include <soloud.h>
 #include <soloud_wav.h>
+#include <soloud_wavstream.h>
 
 namespace gem
 {
@@ -17,39 +20,87 @@ namespace gem
 
 	bool Sound::Load(std::string_view filePath)
 	{
-		FILE* soundFile = fopen(filePath.data(), "rb");
-		if (soundFile == nullptr)
+		return LoadData(filePath);
+	}
+
+	bool Sound::LoadData(std::string_view filePath)
+	{
+		ASSERT(source == nullptr, "Sound already has a clip loaded.");
+
+		if (!file.Open(filePath))
 		{
 			Error("Sound: ( %s )\nUnable to open file.", filePath.data());
 			return false;
 		}
-		defer { fclose(soundFile); };
 
-		fread(&is3D,        sizeof(is3D),        1, soundFile);
-		fread(&loop,        sizeof(loop),        1, soundFile);
-		fread(&unique,      sizeof(unique),      1, soundFile);
-		fread(&attenuation, sizeof(attenuation), 1, soundFile);
-		fread(&rolloff,     sizeof(rolloff),     1, soundFile);
-		fread(&volume,      sizeof(volume),      1, soundFile);
-		fread(&minDistance, sizeof(minDistance), 1, soundFile);
-		fread(&maxDistance, sizeof(maxDistance), 1, soundFile);
+		BinaryReader reader(file.GetData());
+		std::array<char, 4> tag = {};
+		const bool hasTag = reader.Read(tag) && tag == FileTag;
+		if (hasTag)
+		{
+			uint32_t version = 0;
+			if (!reader.Read(version) || version == 0 || version > FileVersion)
+			{
+				Error("Sound: ( %s )\nUnsupported file version ( %d ).", filePath.data(), version);
+				file.Close();
+				return false;
+			}
+		}
+		else
+		{
+			// Older files have no tag, and are never streamed.
+			reader = BinaryReader(file.GetData());
+		}
 
 		size_t size = 0;
-		fread(&size, sizeof(size), 1, soundFile);
-		buffer.resize(size);
-		fread(buffer.data(), size, 1, soundFile);
+		std::span<const std::byte> data;
+		stream = false;
+		const bool success =
+			reader.Read(is3D) &&
+			reader.Read(loop) &&
+			reader.Read(unique) &&
+			reader.Read(attenuation) &&
+			reader.Read(rolloff) &&
+			reader.Read(volume) &&
+			reader.Read(minDistance) &&
+			reader.Read(maxDistance) &&
+			(!hasTag || reader.Read(stream)) &&
+			reader.Read(size) &&
+			reader.View(size, data);
+
+		if (!success)
+		{
+			Error("Sound: ( %s )\nFile is truncated.", filePath.data());
+			file.Close();
+			return false;
+		}
 
-		auto sound = std::make_unique<SoLoud::Wav>();
+		// The clip is decoded directly from the file's data, which must outlive a streamed clip.
+		// SoLoud only reads from the data, since it is not asked to take ownership of it.
+		auto* clipData = reinterpret_cast<unsigned char*>(const_cast<std::byte*>(data.data()));
+		SoLoud::result result;
+		if (stream)
+		{
+			auto sound = std::make_unique<SoLoud::WavStream>();
+			result = sound->loadMem(clipData, static_cast<unsigned>(size), false, false);
+			source = sound.release();
+		}
+		else
+		{
+			auto sound = std::make_unique<SoLoud::Wav>();
+			result = sound->loadMem(clipData, static_cast<unsigned>(size), false, false);
+			source = sound.release();
+
+			file.Close();
+		}
 
-		SoLoud::result result = sound->loadMem(reinterpret_cast<unsigned char*>(buffer.data()), static_cast<unsigned>(size), false, false);
 		if (result != SoLoud::SOLOUD_ERRORS::SO_NO_ERROR)
 		{
-			Error("Sound: %s", audioEngine.getErrorString(result));
+			Error("Sound: ( %s )\n%s", filePath.data(), audioEngine.getErrorString(result));
+			Unload();
 			return false;
 		}
 
-		source = sound.release();
-
 		if (is3D)
 		{
 			source->mFlags |= SoLoud::AudioSource::PROCESS_3D;
@@ -65,10 +116,11 @@ namespace gem
 
 	void Sound::Unload()
 	{
+		// Any playing instances are stopped before the data they are streaming from is released.
 		delete source;
 		source = nullptr;
 
-		buffer.clear();
+		file.Close();
 	}
 
 	void Sound::SetIs3D(bool _is3D)
@@ -169,6 +221,33 @@ namespace gem
 	{
 		return volume;
 	}
+
+	bool Sound::IsStreamed() const
+	{
+		return stream;
+	}
+
+	MemoryUsage Sound::GetMemoryUsage() const
+	{
+		MemoryUsage usage;
+
+		if (stream)
+		{
+			// Streamed clips only hold their encoded data, unless they are viewed from a mounted AssetPack.
+			if (!file.IsMapped())
+			{
+				usage.cpuBytes = file.GetData().size();
+			}
+		}
+		else if (source)
+		{
+			// Clips are fully decoded into floating point samples when loaded.
+			const auto* wav = static_cast<const SoLoud::Wav*>(source);
+			usage.cpuBytes = sizeof(float) * wav->mSampleCount * wav->mChannels;
+		}
+
+		return usage;
+	}
 }
 
 REFLECT(gem::AttenuationFunc)
@@ -182,6 +261,7 @@ REF_END;
 
 REFLECT(gem::Sound) BASES { REF_BASE(gem::ResourceBase) }
 	MEMBERS {
+		REF_MEMBER(stream,      readonly())
 		REF_MEMBER_EX(is3D,     nullptr, &gem::Sound::SetIs3D)
 		REF_MEMBER_EX(loop,     nullptr, &gem::Sound::SetLooping)
 		REF_MEMBER_EX(unique,   nullptr, &gem::Sound::SetIsUnique)
@@ -1,8 +1,12 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
+#include "gemcutter/Resource/AssetPack.h"
 #include "gemcutter/Resource/Resource.h"
 #include "gemcutter/Resource/Shareable.h"
 
+#include <array>
+#include <cstdint>
+
 namespace SoLoud
 {
 	class AudioSource;
@@ -20,16 +24,27 @@ namespace gem
 
 	// An audio clip which can be attached to an Entity's SoundSource component.
 	// A SoundListener must also be present in the scene for 3d audio effects.
+	//
+	// Clips are either decoded entirely when loaded, or streamed. Streamed clips keep only their encoded
+	// data, and each playing instance decodes a small window of samples at a time. This is slower to play,
+	// but is much smaller in memory for long clips such as music. Streamed clips in an AssetPack are decoded
+	// directly from the mapped pack.
 	class Sound : public Resource<Sound>, public Shareable<Sound>
 	{
 		friend class SoundSource; // For source.
 	public:
 		static constexpr std::string_view Extension = ".sound";
 
+		// Begins every *.sound file with a streaming setting. Older files begin directly with their settings.
+		static constexpr std::array<char, 4> FileTag = { 'G', 'S', 'N', 'D' };
+		static constexpr uint32_t FileVersion = 1;
+
 		~Sound();
 
 		// Loads pre-packed *.sound resources.
 		bool Load(std::string_view filePath);
+		// Sounds don't use the GPU, so they can be loaded entirely from any thread.
+		bool LoadData(std::string_view filePath);
 		void Unload();
 
 		void SetIs3D(bool is3D);
@@ -58,10 +73,18 @@ namespace gem
 		void SetVolume(float volume);
 		float GetVolume() const;
 
+		// Returns true if the clip is decoded while it plays, rather than when it is loaded.
+		bool IsStreamed() const;
+
+		// Returns the size of the decoded samples, or of the encoded clip if it is streamed.
+		MemoryUsage GetMemoryUsage() const;
+
 	private:
 		SoLoud::AudioSource* source = nullptr;
-		std::vector<std::byte> buffer;
+		// Only held while loading, or until Unload() if the clip is streamed.
+		AssetFile file;
 
+		bool stream = false;
 		bool is3D = false;
 		bool loop = false;
 		bool unique = false;
@@ -72,6 +95,7 @@ namespace gem
 		float maxDistance = 1.0f;
 
 	public:
+		PRIVATE_MEMBER(Sound, stream);
 		PRIVATE_MEMBER(Sound, is3D);
 		PRIVATE_MEMBER(Sound, loop);
 		PRIVATE_MEMBER(Sound, unique);
@@ -0,0 +1,80 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "StreamBuffer.h"
+#include "gemcutter/Application/Logging.h"
+
+#include <cstring>
+
+namespace gem
+{
+	StreamBuffer::StreamBuffer(unsigned capacity, VertexBufferType _type)
+		: ring(capacity)
+		, buffer(VertexBuffer::MakeNew(capacity, BufferUsage::Persistent, _type))
+		, type(_type)
+	{
+	}
+
+	unsigned StreamBuffer::Allocate(unsigned size, unsigned alignment)
+	{
+		ASSERT(size > 0, "Cannot allocate an empty range.");
+		ASSERT(alignment > 0, "'alignment' must be greater than zero.");
+
+		return ring.Allocate(size, alignment);
+	}
+
+	void StreamBuffer::SetData(unsigned offset, unsigned size, const void* source)
+	{
+		ASSERT(offset + size <= buffer->GetSize(), "Out of bounds.");
+
+		if (std::byte* data = buffer->GetPersistentPtr())
+		{
+			std::memcpy(data + offset, source, size);
+		}
+		else
+		{
+			buffer->SetData(offset, size, source);
+		}
+	}
+
+	unsigned StreamBuffer::Push(const void* source, unsigned size, unsigned alignment)
+	{
+		const unsigned offset = Allocate(size, alignment);
+		if (offset != InvalidOffset)
+		{
+			SetData(offset, size, source);
+		}
+
+		return offset;
+	}
+
+	std::byte* StreamBuffer::GetPtr(unsigned offset) const
+	{
+		ASSERT(offset < buffer->GetSize(), "Out of bounds.");
+
+		std::byte* data = buffer->GetPersistentPtr();
+		return data ? data + offset : nullptr;
+	}
+
+	void StreamBuffer::EndFrame()
+	{
+		ring.EndFrame();
+	}
+
+	void StreamBuffer::Resize(unsigned newCapacity)
+	{
+		ASSERT(newCapacity > 0, "A StreamBuffer must have a non-zero capacity.");
+
+		// Persistent buffers have immutable storage, so growing requires a new buffer.
+		ring.Reset(newCapacity);
+		buffer = VertexBuffer::MakeNew(newCapacity, BufferUsage::Persistent, type);
+	}
+
+	unsigned StreamBuffer::GetCapacity() const
+	{
+		return ring.GetCapacity();
+	}
+
+	const VertexBuffer::Ptr& StreamBuffer::GetBuffer() const
+	{
+		return buffer;
+	}
+}
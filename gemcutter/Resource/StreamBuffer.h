@@ -0,0 +1,59 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Rendering/Fence.h"
+#include "gemcutter/Rendering/StreamRing.h"
+#include "gemcutter/Resource/VertexArray.h"
+
+namespace gem
+{
+	// A persistently mapped VertexBuffer for data which is rewritten every frame, such as dynamic geometry.
+	// Each frame's data is written to a new range of the buffer, so the GPU can continue to read the previous
+	// frames without the implicit synchronization of VertexBuffer::SetData() or MapBuffer().
+	// Usage:
+	// {
+	//    unsigned offset = stream.Push(vertices.data(), size, sizeof(Vertex));
+	//    array->SetFirstIndex(offset / sizeof(Vertex));
+	//    array->Draw();
+	//
+	//    stream.EndFrame();
+	// }
+	// Alternatively, VertexArray::SetStreamOffset() can point individual streams at their own ranges.
+	class StreamBuffer
+	{
+	public:
+		static constexpr unsigned InvalidOffset = StreamRing<Fence>::InvalidOffset;
+
+		StreamBuffer(unsigned capacity, VertexBufferType type = VertexBufferType::Data);
+
+		StreamBuffer(const StreamBuffer&) = delete;
+		StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+		// Reserves a range for the current frame. 'alignment' should usually be the size of a vertex, so that the
+		// offset can be converted to a first index. Returns InvalidOffset if the frame has run out of room.
+		unsigned Allocate(unsigned size, unsigned alignment = 4);
+		// Copies data into a range returned by Allocate().
+		void SetData(unsigned offset, unsigned size, const void* source);
+		// Allocates a range and copies the data into it. Returns InvalidOffset if the frame has run out of room.
+		unsigned Push(const void* source, unsigned size, unsigned alignment = 4);
+
+		// Returns a pointer to write directly to a range returned by Allocate().
+		// Returns nullptr if persistent mapping is not supported by the device, in which case SetData() must be used.
+		std::byte* GetPtr(unsigned offset) const;
+
+		// Fences the data written during the current frame.
+		// Must be called once per frame, after the draws which read the data have been issued.
+		void EndFrame();
+
+		// Waits for the GPU to finish with all previous frames, then replaces the buffer with a new one of the given capacity.
+		// Any VertexStreams referring to the old buffer must be added again.
+		void Resize(unsigned newCapacity);
+
+		unsigned GetCapacity() const;
+		const VertexBuffer::Ptr& GetBuffer() const;
+
+	private:
+		StreamRing<Fence> ring;
+		VertexBuffer::Ptr buffer;
+		VertexBufferType type;
+	};
+}
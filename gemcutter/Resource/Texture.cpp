@@ -1,8 +1,11 @@
 // Copyright (c) 2017 Emilian Cioca
 #include "Texture.h"
 #include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
 #include "gemcutter/Rendering/Rendering.h"
-#include "gemcutter/Utilities/ScopeGuard.h"
+#include "gemcutter/Rendering/StateCache.h"
+#include "gemcutter/Resource/TextureStreamer.h"
+#include "gemcutter/Utilities/BinaryReader.h"
 
 #include <algorithm>
 #include <GL/glew.h>
@@ -69,6 +72,7 @@ namespace gem
 		}
 
 		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
 		return true;
 	}
 
@@ -76,6 +80,8 @@ namespace gem
 	{
 		ASSERT(hTex != 0, "Texture object is not yet initialized.");
 		ASSERT(data, "'data' cannot be null.");
+		ASSERT(!IsCompressed(format), "Compressed textures cannot be modified.");
+		ASSERT(streamId == MipResidency::InvalidId, "Streamed textures cannot be modified.");
 
 		glBindTexture(target, hTex);
 		glTexSubImage2D(target, 0, 0, 0, width, height, ResolveDataFormat(sourceFormat), GL_UNSIGNED_BYTE, data);
@@ -86,97 +92,113 @@ namespace gem
 		}
 
 		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
 	}
 
 	bool Texture::Load(std::string_view filePath)
+	{
+		return LoadData(filePath) && Upload();
+	}
+
+	bool Texture::LoadData(std::string_view filePath)
 	{
 		ASSERT(hTex == 0, "Texture already has a texture loaded.");
 
-		unsigned numLevels = 0;
 		if (filePath.ends_with(Texture::Extension))
 		{
-			FILE* textureFile = fopen(filePath.data(), "rb");
-			if (textureFile == nullptr)
+			if (!file.Open(filePath))
 			{
 				Error("Texture: ( %s )\nUnable to open file.", filePath.data());
 				return false;
 			}
-			defer { fclose(textureFile); };
+
+			BinaryReader reader(file.GetData());
+			std::array<char, 4> tag = {};
+			const bool hasTag = reader.Read(tag) && tag == FileTag;
+			if (hasTag)
+			{
+				uint32_t version = 0;
+				if (!reader.Read(version) || version == 0 || version > FileVersion)
+				{
+					Error("Texture: ( %s )\nUnsupported file version ( %d ).", filePath.data(), version);
+					file.Close();
+					return false;
+				}
+			}
+			else
+			{
+				// Older files have no tag, and only contain the first mip level.
+				reader = BinaryReader(file.GetData());
+			}
 
 			// Read header.
-			bool isCubeMap = false;
 			int _width = 0;
 			int _height = 0;
-			fread(&isCubeMap, sizeof(isCubeMap), 1, textureFile);
-			fread(&_width,    sizeof(_width),    1, textureFile);
-			fread(&_height,   sizeof(_height),   1, textureFile);
+			if (!reader.Read(loadingCubeMap) ||
+				!reader.Read(_width) ||
+				!reader.Read(_height))
+			{
+				Error("Texture: ( %s )\nFile is truncated.", filePath.data());
+				file.Close();
+				return false;
+			}
 
-			const int maxSize = isCubeMap ? GPUInfo.GetMaxCubeMapSize() : GPUInfo.GetMaxTextureSize();
+			const int maxSize = loadingCubeMap ? GPUInfo.GetMaxCubeMapSize() : GPUInfo.GetMaxTextureSize();
 			if (_width > maxSize || _height > maxSize)
 			{
 				Error("Texture: The requested texture size (%dx%d) is not supported. The maximum is (%dx%d).",
 					_width, _height, maxSize, maxSize);
 
+				file.Close();
 				return false;
 			}
 
 			width = _width;
 			height = _height;
-			fread(&format,           sizeof(format),           1, textureFile);
-			fread(&filter,           sizeof(filter),           1, textureFile);
-			fread(&wraps.x,          sizeof(wraps.x),          1, textureFile);
-			fread(&wraps.y,          sizeof(wraps.y),          1, textureFile);
-			fread(&anisotropicLevel, sizeof(anisotropicLevel), 1, textureFile);
-
-			numLevels = CountMipLevels(width, height, filter);
-			const unsigned numChannels = CountChannels(format);
-			const unsigned textureSize = width * height * numChannels;
-			const unsigned dataFormat  = ResolveDataFormat(format);
-			if (isCubeMap)
+			uint32_t numLevels = 1;
+			bool success =
+				reader.Read(format) &&
+				reader.Read(filter) &&
+				reader.Read(wraps.x) &&
+				reader.Read(wraps.y) &&
+				reader.Read(anisotropicLevel) &&
+				(!hasTag || reader.Read(numLevels));
+
+			if (success && (format > TextureFormat::BC7_sRGB || numLevels == 0 || numLevels > CountMipLevels(width, height, TextureFilter::Trilinear)))
 			{
-				auto* image = static_cast<std::byte*>(malloc(sizeof(std::byte) * textureSize * 6));
-				defer{ free(image); };
-
-				fread(image, sizeof(std::byte), textureSize * 6, textureFile);
-
-				glGenTextures(1, &hTex);
-				glBindTexture(GL_TEXTURE_CUBE_MAP, hTex);
-				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, ResolveFilterMag(filter));
-				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, ResolveFilterMin(filter));
-				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-				glTexParameterf(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropicLevel);
-
-				glTexStorage2D(GL_TEXTURE_CUBE_MAP, numLevels, ResolveFormat(format), width, height);
-
-				for (unsigned i = 0; i < 6; ++i)
-				{
-					glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, 0, 0, width, height, dataFormat, GL_UNSIGNED_BYTE, image + (textureSize * i));
-				}
-
-				target = GL_TEXTURE_CUBE_MAP;
+				Error("Texture: ( %s )\nInvalid format or mip levels.", filePath.data());
+				file.Close();
+				return false;
 			}
-			else
-			{
-				auto* image = static_cast<std::byte*>(malloc(sizeof(std::byte) * textureSize));
-				defer{ free(image); };
 
-				fread(image, sizeof(std::byte), textureSize, textureFile);
+			// The driver cannot generate mip levels for compressed formats.
+			if (success && IsCompressed(format) && numLevels < CountMipLevels(width, height, filter))
+			{
+				Error("Texture: ( %s )\nCompressed textures must contain all of their mip levels.", filePath.data());
+				file.Close();
+				return false;
+			}
 
-				glGenTextures(1, &hTex);
-				glBindTexture(GL_TEXTURE_2D, hTex);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, ResolveFilterMag(filter));
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, ResolveFilterMin(filter));
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, ResolveWrap(wraps.x));
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, ResolveWrap(wraps.y));
-				glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropicLevel);
+			// The pixels are viewed directly from the file until Upload(). Each level contains every face.
+			const unsigned numFaces = loadingCubeMap ? 6 : 1;
+			size_t dataSize = 0;
+			for (unsigned i = 0; i < numLevels; ++i)
+			{
+				const auto levelWidth  = static_cast<unsigned>(Max(width >> i, 1));
+				const auto levelHeight = static_cast<unsigned>(Max(height >> i, 1));
 
-				glTexStorage2D(GL_TEXTURE_2D, numLevels, ResolveFormat(format), width, height);
-				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, dataFormat, GL_UNSIGNED_BYTE, image);
+				dataSize += CountBytes(format, levelWidth, levelHeight) * numFaces;
+			}
+			success = success && reader.View(dataSize, pixelData);
 
-				target = GL_TEXTURE_2D;
+			if (!success)
+			{
+				Error("Texture: ( %s )\nFile is truncated.", filePath.data());
+				file.Close();
+				return false;
 			}
+
+			loadingLevels = numLevels;
 		}
 		else
 		{
@@ -196,31 +218,162 @@ namespace gem
 			width = image.width;
 			height = image.height;
 			format = image.format;
-			numLevels = CountMipLevels(width, height, filter);
+			loadingCubeMap = false;
 
-			glGenTextures(1, &hTex);
-			glBindTexture(GL_TEXTURE_2D, hTex);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, ResolveFilterMag(filter));
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, ResolveFilterMin(filter));
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, ResolveWrap(wraps.x));
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, ResolveWrap(wraps.y));
-			glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropicLevel);
+			decodedPixels.assign(image.data, image.data + width * height * CountChannels(format));
+			pixelData = decodedPixels;
+			loadingLevels = 1;
+		}
 
-			glTexStorage2D(GL_TEXTURE_2D, numLevels, ResolveFormat(format), width, height);
-			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, ResolveDataFormat(format), GL_UNSIGNED_BYTE, image.data);
+		return true;
+	}
 
-			target = GL_TEXTURE_2D;
+	bool Texture::Upload()
+	{
+		ASSERT(hTex == 0, "Texture already has a texture loaded.");
+		ASSERT(!pixelData.empty(), "LoadData() must succeed before calling Upload().");
+
+		const unsigned numLevels = CountMipLevels(width, height, filter);
+		const unsigned numFaces  = loadingCubeMap ? 6 : 1;
+		target = loadingCubeMap ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+
+		// Streamed textures begin with only their smallest levels. The rest stay in the file until they are needed.
+		residentLevel = 0;
+		if (TextureStreamer.IsEnabled() && file.IsOpen() && numLevels > 1 && loadingLevels == numLevels)
+		{
+			streamId = TextureStreamer.Register(*this, width, height, numFaces, numLevels, format);
+			residentLevel = TextureStreamer.GetResidency().GetResidentLevel(streamId);
 		}
 
-		if (numLevels > 1)
+		hTex = CreateStorage(residentLevel);
+
+		const unsigned numLoadedLevels = Min(loadingLevels, numLevels);
+		UploadLevels(residentLevel, numLoadedLevels, residentLevel);
+
+		if (numLoadedLevels < numLevels)
 		{
 			glGenerateMipmap(target);
 		}
 
 		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
+
+		if (streamId == MipResidency::InvalidId)
+		{
+			pixelData = {};
+			decodedPixels = {};
+			file.Close();
+		}
+
 		return true;
 	}
 
+	unsigned Texture::CreateStorage(unsigned firstLevel)
+	{
+		const unsigned numLevels = streamId == MipResidency::InvalidId ? CountMipLevels(width, height, filter) : loadingLevels;
+
+		unsigned handle = 0;
+		glGenTextures(1, &handle);
+
+		glBindTexture(target, handle);
+		glTexParameteri(target, GL_TEXTURE_MAG_FILTER, ResolveFilterMag(filter));
+		glTexParameteri(target, GL_TEXTURE_MIN_FILTER, ResolveFilterMin(filter));
+		if (target == GL_TEXTURE_CUBE_MAP)
+		{
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		}
+		else
+		{
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, ResolveWrap(wraps.x));
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, ResolveWrap(wraps.y));
+		}
+		glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropicLevel);
+
+		glTexStorage2D(target, numLevels - firstLevel, ResolveFormat(format), Max(width >> firstLevel, 1), Max(height >> firstLevel, 1));
+
+		return handle;
+	}
+
+	void Texture::UploadLevels(unsigned first, unsigned last, unsigned baseLevel)
+	{
+		const unsigned numFaces   = target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+		const unsigned dataFormat = ResolveDataFormat(format);
+
+		// Levels are stored from largest to smallest, each with all of its faces.
+		const std::byte* data = pixelData.data();
+		for (unsigned level = 0; level < last; ++level)
+		{
+			const auto levelWidth  = static_cast<unsigned>(Max(width >> level, 1));
+			const auto levelHeight = static_cast<unsigned>(Max(height >> level, 1));
+			const size_t levelSize = CountBytes(format, levelWidth, levelHeight);
+
+			if (level < first)
+			{
+				data += levelSize * numFaces;
+				continue;
+			}
+
+			for (unsigned face = 0; face < numFaces; ++face)
+			{
+				const unsigned faceTarget = numFaces == 6 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+				if (IsCompressed(format))
+				{
+					glCompressedTexSubImage2D(faceTarget, level - baseLevel, 0, 0, levelWidth, levelHeight, ResolveFormat(format), static_cast<GLsizei>(levelSize), data);
+				}
+				else
+				{
+					glTexSubImage2D(faceTarget, level - baseLevel, 0, 0, levelWidth, levelHeight, dataFormat, GL_UNSIGNED_BYTE, data);
+				}
+
+				data += levelSize;
+			}
+		}
+	}
+
+	void Texture::SetResidentLevel(unsigned level)
+	{
+		ASSERT(streamId != MipResidency::InvalidId, "Only streamed textures can change their resident levels.");
+
+		const unsigned numFaces = target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+
+		// Immutable storage cannot be resized, so the levels are moved to a new texture object.
+		const unsigned oldTex = hTex;
+		hTex = CreateStorage(level);
+
+		if (GLEW_ARB_copy_image)
+		{
+			// Levels which are already resident are copied on the GPU, and only the new levels are read from the file.
+			for (unsigned i = Max(level, residentLevel); i < loadingLevels; ++i)
+			{
+				const int levelWidth  = Max(width >> i, 1);
+				const int levelHeight = Max(height >> i, 1);
+
+				glCopyImageSubData(
+					oldTex, target, i - residentLevel, 0, 0, 0,
+					hTex, target, i - level, 0, 0, 0,
+					levelWidth, levelHeight, numFaces);
+			}
+
+			if (level < residentLevel)
+			{
+				UploadLevels(level, residentLevel, level);
+			}
+		}
+		else
+		{
+			UploadLevels(level, loadingLevels, level);
+		}
+
+		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
+		GLState.OnTextureDeleted(oldTex);
+		glDeleteTextures(1, &oldTex);
+
+		residentLevel = level;
+	}
+
 	void Texture::SetFilter(TextureFilter _filter)
 	{
 		ASSERT(hTex != 0, "A texture must be loaded to call this function.");
@@ -230,6 +383,7 @@ namespace gem
 		glTexParameteri(target, GL_TEXTURE_MAG_FILTER, ResolveFilterMag(_filter));
 		glTexParameteri(target, GL_TEXTURE_MIN_FILTER, ResolveFilterMin(_filter));
 		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
 
 		filter = _filter;
 	}
@@ -243,6 +397,7 @@ namespace gem
 		glTexParameteri(target, GL_TEXTURE_WRAP_S, ResolveWrap(_wraps.x));
 		glTexParameteri(target, GL_TEXTURE_WRAP_T, ResolveWrap(_wraps.y));
 		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
 
 		wraps = _wraps;
 	}
@@ -256,6 +411,7 @@ namespace gem
 		glBindTexture(target, hTex);
 		glTexParameterf(target, GL_TEXTURE_MAX_ANISOTROPY_EXT, level);
 		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
 
 		anisotropicLevel = level;
 	}
@@ -280,12 +436,24 @@ namespace gem
 			glTexParameteri(target, GL_TEXTURE_COMPARE_MODE, GL_NONE);
 		}
 		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
 	}
 
 	void Texture::Unload()
 	{
+		if (streamId != MipResidency::InvalidId)
+		{
+			TextureStreamer.Unregister(streamId);
+			streamId = MipResidency::InvalidId;
+			residentLevel = 0;
+
+			pixelData = {};
+			file.Close();
+		}
+
 		if (hTex != GL_NONE)
 		{
+			GLState.OnTextureDeleted(hTex);
 			glDeleteTextures(1, &hTex);
 			hTex = GL_NONE;
 			target = GL_NONE;
@@ -296,14 +464,12 @@ namespace gem
 	{
 		ASSERT(hTex != 0, "A texture must be loaded to call this function.");
 
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(target, hTex);
+		GLState.BindTexture(slot, target, hTex);
 	}
 
 	void Texture::UnBind(unsigned slot)
 	{
-		glActiveTexture(GL_TEXTURE0 + slot);
-		glBindTexture(target, GL_NONE);
+		GLState.BindTexture(slot, target, GL_NONE);
 	}
 
 	unsigned Texture::GetHandle() const
@@ -375,14 +541,65 @@ namespace gem
 		return target == GL_TEXTURE_CUBE_MAP;
 	}
 
+	bool Texture::IsStreamed() const
+	{
+		return streamId != MipResidency::InvalidId;
+	}
+
+	unsigned Texture::GetResidentLevel() const
+	{
+		return residentLevel;
+	}
+
+	MemoryUsage Texture::GetMemoryUsage() const
+	{
+		MemoryUsage usage;
+		usage.cpuBytes = decodedPixels.size();
+
+		// Streamed textures keep their file open. Files outside of an AssetPack are held in memory.
+		if (streamId != MipResidency::InvalidId && !file.IsMapped())
+		{
+			usage.cpuBytes += file.GetData().size();
+		}
+
+		if (hTex == 0)
+		{
+			return usage;
+		}
+
+		if (streamId != MipResidency::InvalidId)
+		{
+			usage.gpuBytes = TextureStreamer.GetResidency().GetResidentBytes(streamId);
+			return usage;
+		}
+
+		const unsigned numLevels = target == GL_TEXTURE_2D_MULTISAMPLE ? 1 : CountMipLevels(width, height, filter);
+		const unsigned numFaces  = target == GL_TEXTURE_CUBE_MAP ? 6 : 1;
+
+		for (unsigned i = 0; i < numLevels; ++i)
+		{
+			const size_t levelWidth  = std::max(width >> i, 1);
+			const size_t levelHeight = std::max(height >> i, 1);
+
+			usage.gpuBytes += CountBytes(format, static_cast<unsigned>(levelWidth), static_cast<unsigned>(levelHeight));
+		}
+
+		usage.gpuBytes *= numFaces * numSamples;
+
+		return usage;
+	}
+
 	void Texture::RegenerateMipmaps()
 	{
 		ASSERT(hTex != 0, "A texture must be loaded to call this function.");
 		ASSERT(numSamples == 1, "It is illegal to generate mipmaps on a multisampled texture.");
+		ASSERT(!IsCompressed(format), "Mipmaps cannot be generated for compressed textures.");
+		ASSERT(streamId == MipResidency::InvalidId, "Mipmaps cannot be generated for streamed textures.");
 
 		glBindTexture(target, hTex);
 		glGenerateMipmap(target);
 		glBindTexture(target, GL_NONE);
+		GLState.InvalidateActiveTexture();
 	}
 
 	//-----------------------------------------------------------------------------------------------------
@@ -1,9 +1,13 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
 #include "gemcutter/Rendering/Rendering.h"
+#include "gemcutter/Resource/AssetPack.h"
 #include "gemcutter/Resource/Resource.h"
 #include "gemcutter/Resource/Shareable.h"
+#include "gemcutter/Resource/TextureStreamer.h"
 
+#include <array>
+#include <cstdint>
 #include <span>
 #include <string_view>
 #include <vector>
@@ -13,9 +17,14 @@ namespace gem
 	// A 2D texture, renderTarget, or cubemap.
 	class Texture : public Resource<Texture>, public Shareable<Texture>
 	{
+		friend TextureStreamerSingleton; // For SetResidentLevel().
 	public:
 		static constexpr std::string_view Extension = ".texture";
 
+		// Begins every *.texture file with precomputed mip levels. Older files begin directly with their header.
+		static constexpr std::array<char, 4> FileTag = { 'G', 'T', 'E', 'X' };
+		static constexpr uint32_t FileVersion = 1;
+
 		~Texture();
 
 		// Creates an empty 2D texture for render targets or custom data.
@@ -31,7 +40,14 @@ namespace gem
 		void SetData(const std::byte* data, TextureFormat sourceFormat);
 
 		// Loads packed *.texture resources, as well as *.png, *.jpg, *.tga, *.bmp.
+		// Mip levels stored in the file are uploaded directly. Any other levels are generated by the driver.
+		// If the TextureStreamer is enabled, files containing all of their mip levels are streamed instead.
 		bool Load(std::string_view filePath);
+		// Reads and decodes the file into memory. Packed *.texture files are viewed directly from a
+		// mounted AssetPack instead. Can be called from any thread.
+		bool LoadData(std::string_view filePath);
+		// Creates the texture from the data read by LoadData(). Must be called from the main thread.
+		bool Upload();
 		void Unload();
 
 		void Bind(unsigned slot);
@@ -56,10 +72,24 @@ namespace gem
 		float GetAspectRatio() const;
 
 		bool IsCubeMap() const;
+		// Returns true if the texture's mip levels are managed by the TextureStreamer.
+		bool IsStreamed() const;
+		// Returns the largest mip level currently on the GPU. Always 0 unless the texture is streamed.
+		unsigned GetResidentLevel() const;
+
+		// Returns the size of the texture on the GPU, as well as any data waiting to be uploaded.
+		MemoryUsage GetMemoryUsage() const;
 
 		void RegenerateMipmaps();
 
 	private:
+		// Creates and binds a new texture object, with storage for the level and every level smaller than it.
+		unsigned CreateStorage(unsigned firstLevel);
+		// Uploads the levels in the range [first, last) from the loaded data to the bound texture, whose largest level is 'baseLevel'.
+		void UploadLevels(unsigned first, unsigned last, unsigned baseLevel);
+		// Replaces the texture object with one holding the level and every level smaller than it.
+		void SetResidentLevel(unsigned level);
+
 		unsigned hTex       = 0;
 		unsigned numSamples = 1;
 		unsigned target     = 0;
@@ -70,6 +100,16 @@ namespace gem
 		TextureWraps wraps = TextureWrap::Clamp;
 		float anisotropicLevel = 1.0f;
 
+		// Only held between LoadData() and Upload(), or until Unload() if the texture is streamed.
+		AssetFile file;
+		std::vector<std::byte> decodedPixels;
+		std::span<const std::byte> pixelData;
+		unsigned loadingLevels = 1;
+		bool loadingCubeMap = false;
+
+		unsigned streamId = MipResidency::InvalidId;
+		unsigned residentLevel = 0;
+
 	public:
 		PRIVATE_MEMBER(Texture, numSamples);
 		PRIVATE_MEMBER(Texture, width);
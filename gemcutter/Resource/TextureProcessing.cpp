@@ -0,0 +1,1075 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "TextureProcessing.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Application/Reflection.h"
+#include "gemcutter/Math/Math.h"
+#include "gemcutter/Math/Vector.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+	// A full precision image, with color channels in linear space.
+	struct FloatImage
+	{
+		unsigned width = 0;
+		unsigned height = 0;
+		std::vector<gem::vec4> texels;
+	};
+
+	struct Tap
+	{
+		unsigned index;
+		float weight;
+	};
+
+	// The Kaiser filter extends this many destination texels to either side, with a window shaped by KAISER_ALPHA.
+	constexpr float KAISER_WIDTH = 3.0f;
+	constexpr float KAISER_ALPHA = 4.0f;
+
+	float SRGBToLinear(float value)
+	{
+		return (value <= 0.04045f) ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float LinearToSRGB(float value)
+	{
+		return (value <= 0.0031308f) ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	uint8_t ToByte(float value)
+	{
+		return static_cast<uint8_t>(gem::Clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+
+	FloatImage ToFloatImage(const gem::ImageRGBA8& image, bool sRGB)
+	{
+		static const auto sRGBTable = [] {
+			std::array<float, 256> table;
+			for (unsigned i = 0; i < 256; ++i)
+			{
+				table[i] = SRGBToLinear(i / 255.0f);
+			}
+
+			return table;
+		}();
+
+		FloatImage result;
+		result.width = image.width;
+		result.height = image.height;
+		result.texels.resize(static_cast<size_t>(image.width) * image.height);
+
+		for (size_t i = 0; i < result.texels.size(); ++i)
+		{
+			const uint8_t* texel = &image.pixels[i * 4];
+			for (unsigned c = 0; c < 3; ++c)
+			{
+				result.texels[i][c] = sRGB ? sRGBTable[texel[c]] : texel[c] / 255.0f;
+			}
+			result.texels[i].w = texel[3] / 255.0f;
+		}
+
+		return result;
+	}
+
+	gem::ImageRGBA8 ToImage(const FloatImage& image, bool sRGB)
+	{
+		gem::ImageRGBA8 result;
+		result.width = image.width;
+		result.height = image.height;
+		result.pixels.resize(image.texels.size() * 4);
+
+		for (size_t i = 0; i < image.texels.size(); ++i)
+		{
+			uint8_t* texel = &result.pixels[i * 4];
+			for (unsigned c = 0; c < 3; ++c)
+			{
+				const float value = image.texels[i][c];
+				texel[c] = ToByte(sRGB ? LinearToSRGB(gem::Clamp(value, 0.0f, 1.0f)) : value);
+			}
+			texel[3] = ToByte(image.texels[i].w);
+		}
+
+		return result;
+	}
+
+	float Sinc(float x)
+	{
+		if (std::abs(x) < 1e-4f)
+		{
+			return 1.0f;
+		}
+
+		x *= gem::M_PI;
+		return std::sin(x) / x;
+	}
+
+	// The zeroth order modified Bessel function of the first kind.
+	float BesselI0(float x)
+	{
+		const float halfSquared = x * x * 0.25f;
+		float sum = 1.0f;
+		float term = 1.0f;
+
+		for (unsigned k = 1; term > sum * 1e-8f; ++k)
+		{
+			term *= halfSquared / static_cast<float>(k * k);
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	float Kaiser(float x)
+	{
+		const float t = x / KAISER_WIDTH;
+		if (std::abs(t) >= 1.0f)
+		{
+			return 0.0f;
+		}
+
+		return BesselI0(KAISER_ALPHA * std::sqrt(1.0f - t * t)) / BesselI0(KAISER_ALPHA);
+	}
+
+	// For each texel of the destination, lists the source texels it is filtered from. The weights of each list sum to 1.
+	// Taps past the edges of the source are clamped to the edge texels.
+	std::vector<std::vector<Tap>> ComputeTaps(unsigned sourceSize, unsigned size, gem::MipFilter filter)
+	{
+		const float scale = static_cast<float>(sourceSize) / static_cast<float>(size);
+		const float radius = (filter == gem::MipFilter::Box) ? scale * 0.5f : scale * KAISER_WIDTH;
+
+		std::vector<std::vector<Tap>> taps(size);
+		for (unsigned i = 0; i < size; ++i)
+		{
+			const float center = (i + 0.5f) * scale;
+			const int first = static_cast<int>(std::floor(center - radius));
+			const int last  = static_cast<int>(std::ceil(center + radius));
+
+			float total = 0.0f;
+			for (int s = first; s < last; ++s)
+			{
+				float weight;
+				if (filter == gem::MipFilter::Box)
+				{
+					// The portion of the source texel covered by the destination texel.
+					weight = gem::Min(s + 1.0f, center + radius) - gem::Max(static_cast<float>(s), center - radius);
+					if (weight <= 0.0f)
+					{
+						continue;
+					}
+				}
+				else
+				{
+					// Distance is measured in destination texels, so the sinc cuts off at the destination's frequency.
+					const float distance = (s + 0.5f - center) / scale;
+					weight = Sinc(distance) * Kaiser(distance);
+					if (weight == 0.0f)
+					{
+						continue;
+					}
+				}
+
+				taps[i].push_back({ static_cast<unsigned>(std::clamp(s, 0, static_cast<int>(sourceSize) - 1)), weight });
+				total += weight;
+			}
+
+			for (Tap& tap : taps[i])
+			{
+				tap.weight /= total;
+			}
+		}
+
+		return taps;
+	}
+
+	// A separable filter. The rows are resized first, followed by the columns.
+	FloatImage Resample(const FloatImage& source, unsigned width, unsigned height, gem::MipFilter filter)
+	{
+		FloatImage rows;
+		rows.width = width;
+		rows.height = source.height;
+		rows.texels.resize(static_cast<size_t>(width) * source.height);
+
+		const auto rowTaps = ComputeTaps(source.width, width, filter);
+		for (unsigned y = 0; y < source.height; ++y)
+		{
+			const gem::vec4* sourceRow = &source.texels[static_cast<size_t>(y) * source.width];
+			for (unsigned x = 0; x < width; ++x)
+			{
+				gem::vec4 sum;
+				for (const Tap& tap : rowTaps[x])
+				{
+					sum += sourceRow[tap.index] * tap.weight;
+				}
+
+				rows.texels[static_cast<size_t>(y) * width + x] = sum;
+			}
+		}
+
+		FloatImage result;
+		result.width = width;
+		result.height = height;
+		result.texels.resize(static_cast<size_t>(width) * height);
+
+		const auto columnTaps = ComputeTaps(source.height, height, filter);
+		for (unsigned y = 0; y < height; ++y)
+		{
+			gem::vec4* row = &result.texels[static_cast<size_t>(y) * width];
+			for (const Tap& tap : columnTaps[y])
+			{
+				const gem::vec4* sourceRow = &rows.texels[static_cast<size_t>(tap.index) * width];
+				for (unsigned x = 0; x < width; ++x)
+				{
+					row[x] += sourceRow[x] * tap.weight;
+				}
+			}
+		}
+
+		// The negative lobes of the Kaiser filter can overshoot around hard edges.
+		for (gem::vec4& texel : result.texels)
+		{
+			texel = gem::Clamp(texel, gem::vec4(0.0f), gem::vec4(1.0f));
+		}
+
+		return result;
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
+	template<size_t N>
+	using Color = std::array<float, N>;
+
+	// The RGBA texels of a 4x4 block, row by row.
+	using BlockTexels = std::array<std::array<uint8_t, 4>, 16>;
+
+	// BC7 mode 6 interpolation weights for each 4-bit index, out of 64.
+	constexpr unsigned BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	unsigned CountBlockBytes(gem::TextureCompression compression)
+	{
+		return (compression == gem::TextureCompression::BC1 || compression == gem::TextureCompression::BC4) ? 8 : 16;
+	}
+
+	BlockTexels LoadBlock(const gem::ImageRGBA8& image, unsigned blockX, unsigned blockY)
+	{
+		BlockTexels block;
+		for (unsigned y = 0; y < 4; ++y)
+		{
+			const unsigned sourceY = gem::Min(blockY * 4 + y, image.height - 1);
+			for (unsigned x = 0; x < 4; ++x)
+			{
+				const unsigned sourceX = gem::Min(blockX * 4 + x, image.width - 1);
+				memcpy(block[y * 4 + x].data(), &image.pixels[(static_cast<size_t>(sourceY) * image.width + sourceX) * 4], 4);
+			}
+		}
+
+		return block;
+	}
+
+	void StoreBlock(gem::ImageRGBA8& image, unsigned blockX, unsigned blockY, const BlockTexels& block)
+	{
+		for (unsigned y = 0; y < 4 && blockY * 4 + y < image.height; ++y)
+		{
+			for (unsigned x = 0; x < 4 && blockX * 4 + x < image.width; ++x)
+			{
+				const size_t index = static_cast<size_t>(blockY * 4 + y) * image.width + (blockX * 4 + x);
+				memcpy(&image.pixels[index * 4], block[y * 4 + x].data(), 4);
+			}
+		}
+	}
+
+	template<size_t N>
+	std::array<Color<N>, 16> GetChannels(const BlockTexels& block)
+	{
+		std::array<Color<N>, 16> texels;
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			for (unsigned c = 0; c < N; ++c)
+			{
+				texels[i][c] = block[i][c];
+			}
+		}
+
+		return texels;
+	}
+
+	template<size_t N>
+	float SquaredDistance(const Color<N>& texel, const std::array<uint8_t, 4>& paletteColor)
+	{
+		float distance = 0.0f;
+		for (unsigned c = 0; c < N; ++c)
+		{
+			const float delta = texel[c] - paletteColor[c];
+			distance += delta * delta;
+		}
+
+		return distance;
+	}
+
+	// Finds the extremes of the texels along their axis of greatest variance, as a starting point for a block's endpoints.
+	template<size_t N>
+	void FindEndpoints(const std::array<Color<N>, 16>& texels, Color<N>& e0, Color<N>& e1)
+	{
+		Color<N> mean = {};
+		Color<N> min = texels[0];
+		Color<N> max = texels[0];
+		for (const Color<N>& texel : texels)
+		{
+			for (unsigned c = 0; c < N; ++c)
+			{
+				mean[c] += texel[c] / 16.0f;
+				min[c] = gem::Min(min[c], texel[c]);
+				max[c] = gem::Max(max[c], texel[c]);
+			}
+		}
+
+		float covariance[N][N] = {};
+		for (const Color<N>& texel : texels)
+		{
+			for (unsigned i = 0; i < N; ++i)
+			{
+				for (unsigned j = 0; j < N; ++j)
+				{
+					covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+				}
+			}
+		}
+
+		// Power iteration converges on the principal axis, starting from the diagonal of the bounds.
+		Color<N> axis;
+		for (unsigned c = 0; c < N; ++c)
+		{
+			axis[c] = max[c] - min[c];
+		}
+
+		for (unsigned iteration = 0; iteration < 8; ++iteration)
+		{
+			Color<N> next = {};
+			float largest = 0.0f;
+			for (unsigned i = 0; i < N; ++i)
+			{
+				for (unsigned j = 0; j < N; ++j)
+				{
+					next[i] += covariance[i][j] * axis[j];
+				}
+				largest = gem::Max(largest, std::abs(next[i]));
+			}
+
+			if (largest == 0.0f)
+			{
+				break;
+			}
+
+			for (unsigned c = 0; c < N; ++c)
+			{
+				axis[c] = next[c] / largest;
+			}
+		}
+
+		float lengthSquared = 0.0f;
+		for (unsigned c = 0; c < N; ++c)
+		{
+			lengthSquared += axis[c] * axis[c];
+		}
+
+		if (lengthSquared == 0.0f)
+		{
+			// All texels are the same.
+			e0 = mean;
+			e1 = mean;
+			return;
+		}
+
+		float lowest = std::numeric_limits<float>::max();
+		float highest = -std::numeric_limits<float>::max();
+		for (const Color<N>& texel : texels)
+		{
+			float projection = 0.0f;
+			for (unsigned c = 0; c < N; ++c)
+			{
+				projection += (texel[c] - mean[c]) * axis[c];
+			}
+
+			lowest = gem::Min(lowest, projection);
+			highest = gem::Max(highest, projection);
+		}
+
+		for (unsigned c = 0; c < N; ++c)
+		{
+			e0[c] = gem::Clamp(mean[c] + axis[c] * highest / lengthSquared, 0.0f, 255.0f);
+			e1[c] = gem::Clamp(mean[c] + axis[c] * lowest / lengthSquared, 0.0f, 255.0f);
+		}
+	}
+
+	// Solves for the endpoints which best reproduce the texels in the least squares sense,
+	// given how far along the line from e0 to e1 each texel has been placed.
+	template<size_t N>
+	bool FitEndpoints(const std::array<Color<N>, 16>& texels, const std::array<float, 16>& weights, Color<N>& e0, Color<N>& e1)
+	{
+		float a = 0.0f;
+		float b = 0.0f;
+		float c = 0.0f;
+		Color<N> x0 = {};
+		Color<N> x1 = {};
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			const float w = weights[i];
+			a += (1.0f - w) * (1.0f - w);
+			b += (1.0f - w) * w;
+			c += w * w;
+
+			for (unsigned ch = 0; ch < N; ++ch)
+			{
+				x0[ch] += (1.0f - w) * texels[i][ch];
+				x1[ch] += w * texels[i][ch];
+			}
+		}
+
+		const float determinant = a * c - b * b;
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return false;
+		}
+
+		for (unsigned ch = 0; ch < N; ++ch)
+		{
+			e0[ch] = gem::Clamp((c * x0[ch] - b * x1[ch]) / determinant, 0.0f, 255.0f);
+			e1[ch] = gem::Clamp((a * x1[ch] - b * x0[ch]) / determinant, 0.0f, 255.0f);
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
+	uint16_t PackRGB565(const Color<3>& color)
+	{
+		const auto r = static_cast<unsigned>(color[0] * (31.0f / 255.0f) + 0.5f);
+		const auto g = static_cast<unsigned>(color[1] * (63.0f / 255.0f) + 0.5f);
+		const auto b = static_cast<unsigned>(color[2] * (31.0f / 255.0f) + 0.5f);
+
+		return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+	}
+
+	std::array<uint8_t, 4> UnpackRGB565(uint16_t color)
+	{
+		const unsigned r = (color >> 11) & 31;
+		const unsigned g = (color >> 5) & 63;
+		const unsigned b = color & 31;
+
+		return {
+			static_cast<uint8_t>((r << 3) | (r >> 2)),
+			static_cast<uint8_t>((g << 2) | (g >> 4)),
+			static_cast<uint8_t>((b << 3) | (b >> 2)),
+			255
+		};
+	}
+
+	// BC1 blocks are in 3 color mode, with a transparent 4th color, if the first endpoint is not the greater one.
+	// The color blocks of BC3 are always in 4 color mode.
+	std::array<std::array<uint8_t, 4>, 4> DecodeColorPalette(uint16_t c0, uint16_t c1, bool alwaysFourColors)
+	{
+		std::array<std::array<uint8_t, 4>, 4> palette;
+		palette[0] = UnpackRGB565(c0);
+		palette[1] = UnpackRGB565(c1);
+
+		if (c0 > c1 || alwaysFourColors)
+		{
+			for (unsigned c = 0; c < 3; ++c)
+			{
+				palette[2][c] = static_cast<uint8_t>((2 * palette[0][c] + palette[1][c]) / 3);
+				palette[3][c] = static_cast<uint8_t>((palette[0][c] + 2 * palette[1][c]) / 3);
+			}
+			palette[2][3] = 255;
+			palette[3][3] = 255;
+		}
+		else
+		{
+			for (unsigned c = 0; c < 3; ++c)
+			{
+				palette[2][c] = static_cast<uint8_t>((palette[0][c] + palette[1][c]) / 2);
+			}
+			palette[2][3] = 255;
+			palette[3] = { 0, 0, 0, 0 };
+		}
+
+		return palette;
+	}
+
+	void EncodeColorBlock(const BlockTexels& block, uint8_t* output)
+	{
+		// How far towards the second endpoint each index is, in 4 color mode.
+		constexpr std::array<float, 4> indexWeights = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+		const auto texels = GetChannels<3>(block);
+		Color<3> e0, e1;
+		FindEndpoints(texels, e0, e1);
+
+		uint16_t bestC0 = 0;
+		uint16_t bestC1 = 0;
+		uint32_t bestIndices = 0;
+		float bestError = std::numeric_limits<float>::max();
+
+		for (unsigned iteration = 0; iteration < 3; ++iteration)
+		{
+			uint16_t c0 = PackRGB565(e0);
+			uint16_t c1 = PackRGB565(e1);
+			if (c0 < c1)
+			{
+				std::swap(c0, c1);
+				std::swap(e0, e1);
+			}
+
+			const auto palette = DecodeColorPalette(c0, c1, true);
+			std::array<float, 16> weights;
+			uint32_t indices = 0;
+			float error = 0.0f;
+
+			for (unsigned i = 0; i < 16; ++i)
+			{
+				unsigned bestIndex = 0;
+				float bestDistance = SquaredDistance<3>(texels[i], palette[0]);
+				for (unsigned k = 1; k < 4; ++k)
+				{
+					const float distance = SquaredDistance<3>(texels[i], palette[k]);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						bestIndex = k;
+					}
+				}
+
+				indices |= bestIndex << (i * 2);
+				weights[i] = indexWeights[bestIndex];
+				error += bestDistance;
+			}
+
+			// Equal endpoints would decode in 3 color mode, where only the first two indices are the same color.
+			if (c0 == c1)
+			{
+				indices = 0;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				bestC0 = c0;
+				bestC1 = c1;
+				bestIndices = indices;
+			}
+
+			if (error == 0.0f || !FitEndpoints(texels, weights, e0, e1))
+			{
+				break;
+			}
+		}
+
+		memcpy(output, &bestC0, 2);
+		memcpy(output + 2, &bestC1, 2);
+		memcpy(output + 4, &bestIndices, 4);
+	}
+
+	void DecodeColorBlock(const uint8_t* input, bool alwaysFourColors, BlockTexels& block)
+	{
+		uint16_t c0, c1;
+		uint32_t indices;
+		memcpy(&c0, input, 2);
+		memcpy(&c1, input + 2, 2);
+		memcpy(&indices, input + 4, 4);
+
+		const auto palette = DecodeColorPalette(c0, c1, alwaysFourColors);
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			const auto& color = palette[(indices >> (i * 2)) & 3];
+			for (unsigned c = 0; c < 3; ++c)
+			{
+				block[i][c] = color[c];
+			}
+
+			// The alpha of BC3 blocks is decoded separately.
+			if (!alwaysFourColors)
+			{
+				block[i][3] = color[3];
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
+	// Blocks are in 8 value mode if the first endpoint is greater, otherwise they are in 6 value mode with 0 and 255 added.
+	std::array<uint8_t, 8> DecodeChannelPalette(uint8_t a0, uint8_t a1)
+	{
+		std::array<uint8_t, 8> palette;
+		palette[0] = a0;
+		palette[1] = a1;
+
+		if (a0 > a1)
+		{
+			for (unsigned k = 2; k < 8; ++k)
+			{
+				palette[k] = static_cast<uint8_t>(((8 - k) * a0 + (k - 1) * a1 + 3) / 7);
+			}
+		}
+		else
+		{
+			for (unsigned k = 2; k < 6; ++k)
+			{
+				palette[k] = static_cast<uint8_t>(((6 - k) * a0 + (k - 1) * a1 + 2) / 5);
+			}
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+
+		return palette;
+	}
+
+	// Encodes a single channel of the block, as used by BC4, BC5, and the alpha of BC3.
+	void EncodeChannelBlock(const BlockTexels& block, unsigned channel, uint8_t* output)
+	{
+		uint8_t min = 255;
+		uint8_t max = 0;
+		for (const auto& texel : block)
+		{
+			min = gem::Min(min, texel[channel]);
+			max = gem::Max(max, texel[channel]);
+		}
+
+		const auto palette = DecodeChannelPalette(max, min);
+		uint64_t indices = 0;
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			unsigned bestIndex = 0;
+			int bestDistance = 256;
+			for (unsigned k = 0; k < 8; ++k)
+			{
+				const int distance = std::abs(static_cast<int>(block[i][channel]) - palette[k]);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = k;
+				}
+			}
+
+			indices |= static_cast<uint64_t>(bestIndex) << (i * 3);
+		}
+
+		output[0] = max;
+		output[1] = min;
+		for (unsigned i = 0; i < 6; ++i)
+		{
+			output[2 + i] = static_cast<uint8_t>(indices >> (i * 8));
+		}
+	}
+
+	void DecodeChannelBlock(const uint8_t* input, unsigned channel, BlockTexels& block)
+	{
+		uint64_t indices = 0;
+		for (unsigned i = 0; i < 6; ++i)
+		{
+			indices |= static_cast<uint64_t>(input[2 + i]) << (i * 8);
+		}
+
+		const auto palette = DecodeChannelPalette(input[0], input[1]);
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			block[i][channel] = palette[(indices >> (i * 3)) & 7];
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
+	// Reads and writes the fields of a 128-bit BC7 block, starting from the lowest bit.
+	class BitStream
+	{
+	public:
+		BitStream(uint8_t* _bytes) : bytes(_bytes) {}
+
+		void Write(unsigned value, unsigned numBits)
+		{
+			for (unsigned i = 0; i < numBits; ++i, ++offset)
+			{
+				bytes[offset / 8] |= static_cast<uint8_t>(((value >> i) & 1) << (offset % 8));
+			}
+		}
+
+		unsigned Read(unsigned numBits)
+		{
+			unsigned value = 0;
+			for (unsigned i = 0; i < numBits; ++i, ++offset)
+			{
+				value |= ((bytes[offset / 8] >> (offset % 8)) & 1u) << i;
+			}
+
+			return value;
+		}
+
+	private:
+		uint8_t* bytes;
+		unsigned offset = 0;
+	};
+
+	std::array<uint8_t, 4> InterpolateBC7(const std::array<uint8_t, 4>& e0, const std::array<uint8_t, 4>& e1, unsigned index)
+	{
+		const unsigned weight = BC7_WEIGHTS[index];
+
+		std::array<uint8_t, 4> color;
+		for (unsigned c = 0; c < 4; ++c)
+		{
+			color[c] = static_cast<uint8_t>(((64 - weight) * e0[c] + weight * e1[c] + 32) >> 6);
+		}
+
+		return color;
+	}
+
+	// Mode 6 endpoints have 7 bits per channel and a shared lowest bit. Both choices of the lowest bit are tried.
+	std::array<uint8_t, 4> QuantizeBC7Endpoint(const Color<4>& color, unsigned& outLowBit)
+	{
+		std::array<uint8_t, 4> best = {};
+		float bestError = std::numeric_limits<float>::max();
+
+		for (unsigned lowBit = 0; lowBit < 2; ++lowBit)
+		{
+			std::array<uint8_t, 4> quantized;
+			float error = 0.0f;
+			for (unsigned c = 0; c < 4; ++c)
+			{
+				const int value = gem::Clamp(static_cast<int>(std::round((color[c] - lowBit) * 0.5f)), 0, 127);
+				quantized[c] = static_cast<uint8_t>((value << 1) | lowBit);
+
+				const float delta = quantized[c] - color[c];
+				error += delta * delta;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				best = quantized;
+				outLowBit = lowBit;
+			}
+		}
+
+		return best;
+	}
+
+	void EncodeBC7Block(const BlockTexels& block, uint8_t* output)
+	{
+		const auto texels = GetChannels<4>(block);
+		Color<4> e0, e1;
+		FindEndpoints(texels, e0, e1);
+
+		std::array<uint8_t, 4> best0 = {};
+		std::array<uint8_t, 4> best1 = {};
+		unsigned bestLowBit0 = 0;
+		unsigned bestLowBit1 = 0;
+		std::array<unsigned, 16> bestIndices = {};
+		float bestError = std::numeric_limits<float>::max();
+
+		for (unsigned iteration = 0; iteration < 3; ++iteration)
+		{
+			unsigned lowBit0, lowBit1;
+			const auto q0 = QuantizeBC7Endpoint(e0, lowBit0);
+			const auto q1 = QuantizeBC7Endpoint(e1, lowBit1);
+
+			std::array<std::array<uint8_t, 4>, 16> palette;
+			for (unsigned k = 0; k < 16; ++k)
+			{
+				palette[k] = InterpolateBC7(q0, q1, k);
+			}
+
+			std::array<unsigned, 16> indices;
+			std::array<float, 16> weights;
+			float error = 0.0f;
+			for (unsigned i = 0; i < 16; ++i)
+			{
+				unsigned bestIndex = 0;
+				float bestDistance = SquaredDistance<4>(texels[i], palette[0]);
+				for (unsigned k = 1; k < 16; ++k)
+				{
+					const float distance = SquaredDistance<4>(texels[i], palette[k]);
+					if (distance < bestDistance)
+					{
+						bestDistance = distance;
+						bestIndex = k;
+					}
+				}
+
+				indices[i] = bestIndex;
+				weights[i] = BC7_WEIGHTS[bestIndex] / 64.0f;
+				error += bestDistance;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				best0 = q0;
+				best1 = q1;
+				bestLowBit0 = lowBit0;
+				bestLowBit1 = lowBit1;
+				bestIndices = indices;
+			}
+
+			if (error == 0.0f || !FitEndpoints(texels, weights, e0, e1))
+			{
+				break;
+			}
+		}
+
+		// The index of the first texel is stored without its highest bit, which must be 0.
+		if (bestIndices[0] >= 8)
+		{
+			std::swap(best0, best1);
+			std::swap(bestLowBit0, bestLowBit1);
+			for (unsigned& index : bestIndices)
+			{
+				index = 15 - index;
+			}
+		}
+
+		memset(output, 0, 16);
+		BitStream bits(output);
+		bits.Write(1 << 6, 7);
+		for (unsigned c = 0; c < 4; ++c)
+		{
+			bits.Write(best0[c] >> 1, 7);
+			bits.Write(best1[c] >> 1, 7);
+		}
+		bits.Write(bestLowBit0, 1);
+		bits.Write(bestLowBit1, 1);
+
+		bits.Write(bestIndices[0], 3);
+		for (unsigned i = 1; i < 16; ++i)
+		{
+			bits.Write(bestIndices[i], 4);
+		}
+	}
+
+	void DecodeBC7Block(const uint8_t* input, BlockTexels& block)
+	{
+		uint8_t bytes[16];
+		memcpy(bytes, input, 16);
+
+		BitStream bits(bytes);
+		if (bits.Read(7) != (1 << 6))
+		{
+			block = {};
+			return;
+		}
+
+		std::array<uint8_t, 4> e0, e1;
+		for (unsigned c = 0; c < 4; ++c)
+		{
+			e0[c] = static_cast<uint8_t>(bits.Read(7) << 1);
+			e1[c] = static_cast<uint8_t>(bits.Read(7) << 1);
+		}
+
+		const unsigned lowBit0 = bits.Read(1);
+		const unsigned lowBit1 = bits.Read(1);
+		for (unsigned c = 0; c < 4; ++c)
+		{
+			e0[c] |= lowBit0;
+			e1[c] |= lowBit1;
+		}
+
+		for (unsigned i = 0; i < 16; ++i)
+		{
+			block[i] = InterpolateBC7(e0, e1, bits.Read(i == 0 ? 3 : 4));
+		}
+	}
+}
+
+namespace gem
+{
+	ImageRGBA8 ConvertToRGBA8(const std::byte* data, unsigned width, unsigned height, unsigned numChannels)
+	{
+		ASSERT(data, "'data' cannot be null.");
+		ASSERT(numChannels == 3 || numChannels == 4, "'numChannels' must be 3 or 4.");
+
+		ImageRGBA8 image;
+		image.width = width;
+		image.height = height;
+		image.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+		const auto* source = reinterpret_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < static_cast<size_t>(width) * height; ++i)
+		{
+			uint8_t* texel = &image.pixels[i * 4];
+			memcpy(texel, source + i * numChannels, numChannels);
+
+			if (numChannels == 3)
+			{
+				texel[3] = 255;
+			}
+		}
+
+		return image;
+	}
+
+	std::vector<ImageRGBA8> GenerateMipChain(const ImageRGBA8& image, unsigned numLevels, MipFilter filter, bool sRGB)
+	{
+		ASSERT(numLevels > 0, "'numLevels' must be at least 1.");
+		ASSERT(image.pixels.size() == static_cast<size_t>(image.width) * image.height * 4, "'image' does not match its dimensions.");
+
+		std::vector<ImageRGBA8> levels;
+		levels.reserve(numLevels);
+		levels.push_back(image);
+
+		FloatImage level = ToFloatImage(image, sRGB);
+		for (unsigned i = 1; i < numLevels; ++i)
+		{
+			level = Resample(level, Max(level.width / 2, 1u), Max(level.height / 2, 1u), filter);
+			levels.push_back(ToImage(level, sRGB));
+		}
+
+		return levels;
+	}
+
+	TextureFormat ResolveCompressedFormat(TextureCompression compression, bool sRGB)
+	{
+		switch (compression)
+		{
+		case TextureCompression::BC1: return sRGB ? TextureFormat::BC1_sRGB : TextureFormat::BC1;
+		case TextureCompression::BC3: return sRGB ? TextureFormat::BC3_sRGB : TextureFormat::BC3;
+		case TextureCompression::BC7: return sRGB ? TextureFormat::BC7_sRGB : TextureFormat::BC7;
+		// There are no sRGB variants of the data formats.
+		case TextureCompression::BC4: return TextureFormat::BC4;
+		case TextureCompression::BC5: return TextureFormat::BC5;
+		default:
+			ASSERT(false, "'compression' must be a block compression scheme.");
+			return TextureFormat::RGBA_8;
+		}
+	}
+
+	std::vector<std::byte> CompressImage(const ImageRGBA8& image, TextureCompression compression)
+	{
+		ASSERT(compression != TextureCompression::None, "'compression' must be a block compression scheme.");
+		ASSERT(image.width > 0 && image.height > 0, "'image' cannot be empty.");
+		ASSERT(image.pixels.size() == static_cast<size_t>(image.width) * image.height * 4, "'image' does not match its dimensions.");
+
+		const unsigned blockBytes = CountBlockBytes(compression);
+		const unsigned numBlocksX = (image.width + 3) / 4;
+		const unsigned numBlocksY = (image.height + 3) / 4;
+
+		std::vector<std::byte> data(static_cast<size_t>(numBlocksX) * numBlocksY * blockBytes);
+		auto* output = reinterpret_cast<uint8_t*>(data.data());
+
+		for (unsigned y = 0; y < numBlocksY; ++y)
+		{
+			for (unsigned x = 0; x < numBlocksX; ++x)
+			{
+				const BlockTexels block = LoadBlock(image, x, y);
+
+				switch (compression)
+				{
+				case TextureCompression::BC1:
+					EncodeColorBlock(block, output);
+					break;
+
+				case TextureCompression::BC3:
+					EncodeChannelBlock(block, 3, output);
+					EncodeColorBlock(block, output + 8);
+					break;
+
+				case TextureCompression::BC4:
+					EncodeChannelBlock(block, 0, output);
+					break;
+
+				case TextureCompression::BC5:
+					EncodeChannelBlock(block, 0, output);
+					EncodeChannelBlock(block, 1, output + 8);
+					break;
+
+				case TextureCompression::BC7:
+					EncodeBC7Block(block, output);
+					break;
+
+				case TextureCompression::None:
+					break;
+				}
+
+				output += blockBytes;
+			}
+		}
+
+		return data;
+	}
+
+	ImageRGBA8 DecompressImage(std::span<const std::byte> data, unsigned width, unsigned height, TextureCompression compression)
+	{
+		ASSERT(compression != TextureCompression::None, "'compression' must be a block compression scheme.");
+
+		const unsigned blockBytes = CountBlockBytes(compression);
+		const unsigned numBlocksX = (width + 3) / 4;
+		const unsigned numBlocksY = (height + 3) / 4;
+		ASSERT(data.size() == static_cast<size_t>(numBlocksX) * numBlocksY * blockBytes, "'data' does not match the dimensions of the image.");
+
+		ImageRGBA8 image;
+		image.width = width;
+		image.height = height;
+		image.pixels.resize(static_cast<size_t>(width) * height * 4);
+
+		const auto* input = reinterpret_cast<const uint8_t*>(data.data());
+		for (unsigned y = 0; y < numBlocksY; ++y)
+		{
+			for (unsigned x = 0; x < numBlocksX; ++x)
+			{
+				BlockTexels block;
+				block.fill({ 0, 0, 0, 255 });
+
+				switch (compression)
+				{
+				case TextureCompression::BC1:
+					DecodeColorBlock(input, false, block);
+					break;
+
+				case TextureCompression::BC3:
+					DecodeChannelBlock(input, 3, block);
+					DecodeColorBlock(input + 8, true, block);
+					break;
+
+				case TextureCompression::BC4:
+					DecodeChannelBlock(input, 0, block);
+					break;
+
+				case TextureCompression::BC5:
+					DecodeChannelBlock(input, 0, block);
+					DecodeChannelBlock(input + 8, 1, block);
+					break;
+
+				case TextureCompression::BC7:
+					DecodeBC7Block(input, block);
+					break;
+
+				case TextureCompression::None:
+					break;
+				}
+
+				StoreBlock(image, x, y, block);
+				input += blockBytes;
+			}
+		}
+
+		return image;
+	}
+}
+
+REFLECT(gem::MipFilter)
+	ENUM_VALUES {
+		REF_VALUE(Box)
+		REF_VALUE(Kaiser)
+	}
+REF_END;
+
+REFLECT(gem::TextureCompression)
+	ENUM_VALUES {
+		REF_VALUE(None)
+		REF_VALUE(BC1)
+		REF_VALUE(BC3)
+		REF_VALUE(BC4)
+		REF_VALUE(BC5)
+		REF_VALUE(BC7)
+	}
+REF_END;
@@ -0,0 +1,61 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Rendering/Rendering.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gem
+{
+	// The filter used to produce each mip level from the level above it.
+	enum class MipFilter : uint16_t
+	{
+		// Averages each 2x2 group of texels.
+		Box,
+		// A Kaiser windowed sinc. Smaller mip levels stay sharper, at the cost of slight ringing around hard edges.
+		Kaiser
+	};
+
+	// The block compression scheme used to store a texture.
+	enum class TextureCompression : uint16_t
+	{
+		None,
+		// RGB at 4 bits per texel. Alpha is discarded.
+		BC1,
+		// RGBA at 8 bits per texel.
+		BC3,
+		// The red channel at 4 bits per texel, for data such as roughness or height maps.
+		BC4,
+		// The red and green channels at 8 bits per texel, for data such as the X and Y of normal maps.
+		BC5,
+		// RGBA at 8 bits per texel, with higher quality than BC1 and BC3.
+		BC7
+	};
+
+	// An image with four 8-bit channels per texel, stored row by row.
+	struct ImageRGBA8
+	{
+		unsigned width = 0;
+		unsigned height = 0;
+		std::vector<uint8_t> pixels;
+	};
+
+	// Expands 3 or 4 channel image data, such as from a RawImage, to RGBA.
+	[[nodiscard]] ImageRGBA8 ConvertToRGBA8(const std::byte* data, unsigned width, unsigned height, unsigned numChannels);
+
+	// Returns 'numLevels' images, starting with a copy of the source followed by each successively halved mip level.
+	// Each level is filtered from a full precision copy of the level above it, so rounding errors do not build up.
+	// If 'sRGB' is set, the color channels are filtered in linear space so that the mip levels are not darkened.
+	[[nodiscard]] std::vector<ImageRGBA8> GenerateMipChain(const ImageRGBA8& image, unsigned numLevels, MipFilter filter, bool sRGB);
+
+	// Returns the format of a texture stored with the compression scheme.
+	[[nodiscard]] TextureFormat ResolveCompressedFormat(TextureCompression compression, bool sRGB);
+
+	// Encodes the image into blocks of 4x4 texels, in the layout expected by the format from ResolveCompressedFormat().
+	// Partial blocks along the edges of the image are padded by repeating the edge texels.
+	[[nodiscard]] std::vector<std::byte> CompressImage(const ImageRGBA8& image, TextureCompression compression);
+	// Decodes blocks produced by CompressImage(). Channels which are not stored by the format are decoded as 0, or 255 for alpha.
+	// BC7 blocks must be in mode 6, which is the only mode used by CompressImage(). Other blocks are decoded as 0.
+	[[nodiscard]] ImageRGBA8 DecompressImage(std::span<const std::byte> data, unsigned width, unsigned height, TextureCompression compression);
+}
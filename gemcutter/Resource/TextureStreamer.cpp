@@ -0,0 +1,409 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "TextureStreamer.h"
+#include "gemcutter/Application/Logging.h"
+#include "gemcutter/Math/Math.h"
+#include "gemcutter/Resource/Texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+namespace
+{
+	// A texture whose largest resident level could be released to meet the memory budget.
+	struct ReleaseCandidate
+	{
+		// Levels which are not needed are released before those which are,
+		// then in order of the lowest priority.
+		bool operator>(const ReleaseCandidate& other) const
+		{
+			return std::tie(isNeeded, priority) > std::tie(other.isNeeded, other.priority);
+		}
+
+		bool isNeeded;
+		double priority;
+		unsigned id;
+	};
+}
+
+namespace gem
+{
+	TextureStreamerSingleton TextureStreamer;
+
+	unsigned MipResidency::Entry::LevelSize(unsigned level) const
+	{
+		return Max(Max(width, height) >> level, 1u);
+	}
+
+	unsigned MipResidency::Add(unsigned width, unsigned height, unsigned numFaces, unsigned numLevels, TextureFormat format)
+	{
+		ASSERT(width > 0 && height > 0, "Texture must not be empty.");
+		ASSERT(numLevels > 0 && numLevels <= CountMipLevels(width, height, TextureFilter::Trilinear), "'numLevels' is invalid.");
+
+		unsigned id;
+		if (freeIds.empty())
+		{
+			id = static_cast<unsigned>(entries.size());
+			entries.emplace_back();
+		}
+		else
+		{
+			id = freeIds.back();
+			freeIds.pop_back();
+		}
+
+		Entry& entry = entries[id];
+		entry.width = width;
+		entry.height = height;
+		entry.isUsed = true;
+
+		entry.chainBytes.assign(numLevels + 1, 0);
+		for (unsigned level = numLevels; level-- > 0;)
+		{
+			const unsigned levelWidth  = Max(width >> level, 1u);
+			const unsigned levelHeight = Max(height >> level, 1u);
+
+			entry.chainBytes[level] = entry.chainBytes[level + 1] + CountBytes(format, levelWidth, levelHeight) * numFaces;
+		}
+
+		entry.tailLevel = numLevels - 1;
+		while (entry.tailLevel > 0 && entry.LevelSize(entry.tailLevel - 1) <= TailSize)
+		{
+			--entry.tailLevel;
+		}
+
+		entry.residentLevel = entry.tailLevel;
+		entry.targetLevel = entry.tailLevel;
+		entry.wantedLevel = entry.tailLevel;
+
+		totalResidentBytes += entry.chainBytes[entry.residentLevel];
+		++numTextures;
+
+		return id;
+	}
+
+	void MipResidency::Remove(unsigned id)
+	{
+		ASSERT(id < entries.size() && entries[id].isUsed, "'id' is invalid.");
+
+		totalResidentBytes -= entries[id].chainBytes[entries[id].residentLevel];
+		entries[id] = {};
+		freeIds.push_back(id);
+		--numTextures;
+	}
+
+	void MipResidency::RequestScreenSize(unsigned id, float pixels)
+	{
+		ASSERT(id < entries.size() && entries[id].isUsed, "'id' is invalid.");
+
+		Entry& entry = entries[id];
+		if (entry.lastRequested != frame)
+		{
+			entry.lastRequested = frame;
+			entry.requestedSize = pixels;
+		}
+		else
+		{
+			entry.requestedSize = Max(entry.requestedSize, pixels);
+		}
+	}
+
+	void MipResidency::SetMemoryBudget(size_t bytes)
+	{
+		memoryBudget = bytes;
+	}
+
+	size_t MipResidency::GetMemoryBudget() const
+	{
+		return memoryBudget;
+	}
+
+	void MipResidency::SetUploadBudget(size_t bytes)
+	{
+		uploadBudget = bytes;
+	}
+
+	size_t MipResidency::GetUploadBudget() const
+	{
+		return uploadBudget;
+	}
+
+	void MipResidency::SetRetainFrames(unsigned frames)
+	{
+		retainFrames = frames;
+	}
+
+	unsigned MipResidency::GetRetainFrames() const
+	{
+		return retainFrames;
+	}
+
+	std::span<const MipResidency::Change> MipResidency::Update()
+	{
+		changes.clear();
+		uploadedBytes = 0;
+
+		PlanTargets();
+
+		// Release levels first, so the memory is available to the levels being streamed in.
+		std::vector<unsigned> pending;
+		for (unsigned id = 0; id < entries.size(); ++id)
+		{
+			Entry& entry = entries[id];
+			if (!entry.isUsed)
+			{
+				continue;
+			}
+
+			if (entry.targetLevel > entry.residentLevel)
+			{
+				totalResidentBytes -= entry.chainBytes[entry.residentLevel] - entry.chainBytes[entry.targetLevel];
+				entry.residentLevel = entry.targetLevel;
+				changes.emplace_back(id, entry.residentLevel);
+			}
+			else if (entry.targetLevel < entry.residentLevel)
+			{
+				pending.push_back(id);
+			}
+		}
+
+		// The textures which are the most magnified on screen are streamed first.
+		std::ranges::sort(pending, std::greater{}, [this](unsigned id) {
+			const Entry& entry = entries[id];
+			return entry.screenSize / static_cast<float>(entry.LevelSize(entry.residentLevel));
+		});
+
+		for (unsigned id : pending)
+		{
+			Entry& entry = entries[id];
+			const size_t levelBytes = entry.chainBytes[entry.residentLevel - 1] - entry.chainBytes[entry.residentLevel];
+			if (uploadedBytes > 0 && uploadedBytes + levelBytes > uploadBudget)
+			{
+				break;
+			}
+
+			--entry.residentLevel;
+			uploadedBytes += levelBytes;
+			totalResidentBytes += levelBytes;
+			changes.emplace_back(id, entry.residentLevel);
+		}
+
+		++frame;
+		return changes;
+	}
+
+	unsigned MipResidency::GetResidentLevel(unsigned id) const
+	{
+		ASSERT(id < entries.size() && entries[id].isUsed, "'id' is invalid.");
+
+		return entries[id].residentLevel;
+	}
+
+	unsigned MipResidency::GetTargetLevel(unsigned id) const
+	{
+		ASSERT(id < entries.size() && entries[id].isUsed, "'id' is invalid.");
+
+		return entries[id].targetLevel;
+	}
+
+	size_t MipResidency::GetResidentBytes(unsigned id) const
+	{
+		ASSERT(id < entries.size() && entries[id].isUsed, "'id' is invalid.");
+
+		return entries[id].chainBytes[entries[id].residentLevel];
+	}
+
+	size_t MipResidency::GetTotalResidentBytes() const
+	{
+		return totalResidentBytes;
+	}
+
+	size_t MipResidency::GetUploadedBytes() const
+	{
+		return uploadedBytes;
+	}
+
+	unsigned MipResidency::GetNumTextures() const
+	{
+		return numTextures;
+	}
+
+	unsigned MipResidency::ComputeLevel(unsigned width, unsigned height, unsigned numLevels, float pixels)
+	{
+		ASSERT(numLevels > 0, "'numLevels' must be at least 1.");
+
+		if (!(pixels > 0.0f))
+		{
+			return numLevels - 1;
+		}
+
+		const float ratio = static_cast<float>(Max(width, height)) / pixels;
+		if (ratio <= 1.0f)
+		{
+			return 0;
+		}
+
+		return Min(static_cast<unsigned>(std::floor(std::log2(ratio))), numLevels - 1);
+	}
+
+	void MipResidency::PlanTargets()
+	{
+		size_t plannedBytes = 0;
+		for (Entry& entry : entries)
+		{
+			if (!entry.isUsed)
+			{
+				continue;
+			}
+
+			if (entry.lastRequested == frame)
+			{
+				entry.screenSize = entry.requestedSize;
+			}
+
+			// Textures which have not been drawn recently only need their smallest levels.
+			if (entry.lastRequested > 0 && frame - entry.lastRequested <= retainFrames)
+			{
+				const auto numLevels = static_cast<unsigned>(entry.chainBytes.size() - 1);
+				entry.wantedLevel = Min(ComputeLevel(entry.width, entry.height, numLevels, entry.screenSize), entry.tailLevel);
+			}
+			else
+			{
+				entry.wantedLevel = entry.tailLevel;
+			}
+
+			// Levels which are already resident are kept for as long as the budget allows.
+			entry.targetLevel = Min(entry.wantedLevel, entry.residentLevel);
+			plannedBytes += entry.chainBytes[entry.targetLevel];
+		}
+
+		if (memoryBudget == 0 || plannedBytes <= memoryBudget)
+		{
+			return;
+		}
+
+		// Unneeded levels are released from the least recently drawn textures first. Once only needed levels
+		// remain, they are released from the textures that will be the least magnified on screen as a result.
+		auto makeCandidate = [this](unsigned id) {
+			const Entry& entry = entries[id];
+			if (entry.targetLevel < entry.wantedLevel)
+			{
+				return ReleaseCandidate{ false, static_cast<double>(entry.lastRequested), id };
+			}
+
+			return ReleaseCandidate{ true, static_cast<double>(entry.screenSize / static_cast<float>(entry.LevelSize(entry.targetLevel))), id };
+		};
+
+		std::priority_queue<ReleaseCandidate, std::vector<ReleaseCandidate>, std::greater<>> candidates;
+		for (unsigned id = 0; id < entries.size(); ++id)
+		{
+			if (entries[id].isUsed && entries[id].targetLevel < entries[id].tailLevel)
+			{
+				candidates.push(makeCandidate(id));
+			}
+		}
+
+		while (plannedBytes > memoryBudget && !candidates.empty())
+		{
+			const unsigned id = candidates.top().id;
+			candidates.pop();
+
+			Entry& entry = entries[id];
+			plannedBytes -= entry.chainBytes[entry.targetLevel] - entry.chainBytes[entry.targetLevel + 1];
+			++entry.targetLevel;
+
+			if (entry.targetLevel < entry.tailLevel)
+			{
+				candidates.push(makeCandidate(id));
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------------------------------------
+
+	void TextureStreamerSingleton::SetEnabled(bool enabled)
+	{
+		isEnabled = enabled;
+	}
+
+	bool TextureStreamerSingleton::IsEnabled() const
+	{
+		return isEnabled;
+	}
+
+	void TextureStreamerSingleton::RequestScreenSize(const Texture& texture, float pixels)
+	{
+		if (texture.streamId != MipResidency::InvalidId)
+		{
+			residency.RequestScreenSize(texture.streamId, pixels);
+		}
+	}
+
+	void TextureStreamerSingleton::SetMemoryBudget(size_t bytes)
+	{
+		residency.SetMemoryBudget(bytes);
+	}
+
+	size_t TextureStreamerSingleton::GetMemoryBudget() const
+	{
+		return residency.GetMemoryBudget();
+	}
+
+	void TextureStreamerSingleton::SetUploadBudget(size_t bytes)
+	{
+		residency.SetUploadBudget(bytes);
+	}
+
+	size_t TextureStreamerSingleton::GetUploadBudget() const
+	{
+		return residency.GetUploadBudget();
+	}
+
+	void TextureStreamerSingleton::SetRetainFrames(unsigned frames)
+	{
+		residency.SetRetainFrames(frames);
+	}
+
+	unsigned TextureStreamerSingleton::GetRetainFrames() const
+	{
+		return residency.GetRetainFrames();
+	}
+
+	const MipResidency& TextureStreamerSingleton::GetResidency() const
+	{
+		return residency;
+	}
+
+	void TextureStreamerSingleton::Update()
+	{
+		if (residency.GetNumTextures() == 0)
+		{
+			return;
+		}
+
+		for (const MipResidency::Change& change : residency.Update())
+		{
+			textures[change.id]->SetResidentLevel(change.residentLevel);
+		}
+	}
+
+	unsigned TextureStreamerSingleton::Register(Texture& texture, unsigned width, unsigned height, unsigned numFaces, unsigned numLevels, TextureFormat format)
+	{
+		const unsigned id = residency.Add(width, height, numFaces, numLevels, format);
+		if (id >= textures.size())
+		{
+			textures.resize(id + 1, nullptr);
+		}
+
+		textures[id] = &texture;
+		return id;
+	}
+
+	void TextureStreamerSingleton::Unregister(unsigned id)
+	{
+		residency.Remove(id);
+		textures[id] = nullptr;
+	}
+}
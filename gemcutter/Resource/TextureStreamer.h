@@ -0,0 +1,153 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include "gemcutter/Rendering/Rendering.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace gem
+{
+	class Texture;
+
+	// Decides which mip levels of each streamed texture should be resident on the GPU.
+	// Only the bookkeeping is done here, so it can be used without a GPU. The TextureStreamer applies its decisions.
+	//
+	// A texture's resident level is the largest mip level held on the GPU, along with every smaller level.
+	// Level 0 is the full resolution image. Textures start with only their smallest levels resident, and
+	// gain larger levels as they are drawn at larger sizes on screen.
+	class MipResidency
+	{
+	public:
+		static constexpr unsigned InvalidId = ~0u;
+		// Levels no larger than this along either side are always resident, so a texture can be drawn as soon as it is loaded.
+		static constexpr unsigned TailSize = 64;
+
+		// A change to the resident level of a texture.
+		struct Change
+		{
+			unsigned id;
+			unsigned residentLevel;
+		};
+
+		// Registers a texture with all of its mip levels available to stream. Returns an id for the texture.
+		unsigned Add(unsigned width, unsigned height, unsigned numFaces, unsigned numLevels, TextureFormat format);
+		void Remove(unsigned id);
+
+		// Reports that the texture was drawn this frame, covering roughly 'pixels' along its largest side.
+		// The largest size reported during a frame is used.
+		void RequestScreenSize(unsigned id, float pixels);
+
+		// Sets the limit for the memory of all resident levels, in bytes. Zero disables the budget.
+		// The smallest levels of each texture are always resident, even if they alone exceed the budget.
+		void SetMemoryBudget(size_t bytes);
+		size_t GetMemoryBudget() const;
+
+		// Sets the maximum size of the levels streamed in each frame, in bytes. At least one level is always streamed per frame.
+		void SetUploadBudget(size_t bytes);
+		size_t GetUploadBudget() const;
+
+		// Sets how many frames a texture keeps its requested levels after it was last drawn.
+		// Afterwards, its larger levels are the first to be released when the memory budget is exceeded.
+		void SetRetainFrames(unsigned frames);
+		unsigned GetRetainFrames() const;
+
+		// Ends the frame, and decides on the new resident level of each texture.
+		// Levels are released immediately when they are no longer needed to stay within the memory budget.
+		// Textures drawn larger than their resident levels gain one level each, most visible first, within the upload budget.
+		// Returns the changes in residency, which remain valid until the next call.
+		std::span<const Change> Update();
+
+		unsigned GetResidentLevel(unsigned id) const;
+		// Returns the level that the texture is streaming towards.
+		unsigned GetTargetLevel(unsigned id) const;
+		// Returns the size of the texture's resident levels, in bytes.
+		size_t GetResidentBytes(unsigned id) const;
+
+		// Returns the size of the resident levels of all textures, in bytes.
+		size_t GetTotalResidentBytes() const;
+		// Returns the size of the levels streamed in during the last Update(), in bytes.
+		size_t GetUploadedBytes() const;
+		unsigned GetNumTextures() const;
+
+		// Returns the largest level which still has at least as many texels as 'pixels' along its largest side.
+		[[nodiscard]] static unsigned ComputeLevel(unsigned width, unsigned height, unsigned numLevels, float pixels);
+
+	private:
+		struct Entry
+		{
+			// The size of each level along its largest side.
+			unsigned LevelSize(unsigned level) const;
+
+			// The total size of each level and every level smaller than it.
+			std::vector<size_t> chainBytes;
+			unsigned width = 0;
+			unsigned height = 0;
+			unsigned tailLevel = 0;
+			unsigned residentLevel = 0;
+			unsigned targetLevel = 0;
+			unsigned wantedLevel = 0;
+			float screenSize = 0.0f;
+			float requestedSize = 0.0f;
+			uint64_t lastRequested = 0;
+			bool isUsed = false;
+		};
+
+		// Decides the target level of each texture, releasing the least needed levels until the memory budget is met.
+		void PlanTargets();
+
+		std::vector<Entry> entries;
+		std::vector<unsigned> freeIds;
+		std::vector<Change> changes;
+
+		size_t memoryBudget = 0;
+		size_t uploadBudget = 4 * 1024 * 1024;
+		size_t totalResidentBytes = 0;
+		size_t uploadedBytes = 0;
+		unsigned numTextures = 0;
+		unsigned retainFrames = 120;
+		uint64_t frame = 1;
+	};
+
+	// Streams the mip levels of textures based on how large they appear on screen.
+	// When enabled, packed *.texture files containing all of their mip levels are streamed as they are loaded.
+	// RenderPasses report the screen size of the textures they draw, and any other use of a streamed texture
+	// should call RequestScreenSize() each frame, otherwise only its smallest levels are guaranteed to be resident.
+	extern class TextureStreamerSingleton TextureStreamer;
+	class TextureStreamerSingleton
+	{
+		friend class ApplicationSingleton; // For Update().
+		friend Texture; // For Register() and Unregister().
+	public:
+		// Only textures loaded while streaming is enabled are streamed. Disabled by default.
+		void SetEnabled(bool enabled);
+		bool IsEnabled() const;
+
+		// Reports that the texture was drawn this frame, covering roughly 'pixels' along its largest side.
+		// Has no effect if the texture is not streamed.
+		void RequestScreenSize(const Texture& texture, float pixels);
+
+		// See MipResidency for details.
+		void SetMemoryBudget(size_t bytes);
+		size_t GetMemoryBudget() const;
+		void SetUploadBudget(size_t bytes);
+		size_t GetUploadBudget() const;
+		void SetRetainFrames(unsigned frames);
+		unsigned GetRetainFrames() const;
+
+		const MipResidency& GetResidency() const;
+
+	private:
+		// Called every frame to stream levels in and out.
+		void Update();
+
+		// Returns the id of the texture in the MipResidency.
+		unsigned Register(Texture& texture, unsigned width, unsigned height, unsigned numFaces, unsigned numLevels, TextureFormat format);
+		void Unregister(unsigned id);
+
+		MipResidency residency;
+		std::vector<Texture*> textures;
+		bool isEnabled = false;
+	};
+}
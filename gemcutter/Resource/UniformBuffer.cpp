@@ -4,6 +4,7 @@
 #include "gemcutter/Math/Matrix.h"
 #include "gemcutter/Math/Quaternion.h"
 #include "gemcutter/Math/Vector.h"
+#include "gemcutter/Rendering/StateCache.h"
 
 #include <algorithm>
 #include <GL/glew.h>
@@ -77,6 +78,7 @@ namespace gem
 
 	void UniformBuffer::UnLoad()
 	{
+		GLState.OnBufferDeleted(UBO);
 		glDeleteBuffers(1, &UBO);
 		UBO = GL_NONE;
 
@@ -90,10 +92,12 @@ namespace gem
 
 	void UniformBuffer::Bind(unsigned slot) const
 	{
-		glBindBufferBase(GL_UNIFORM_BUFFER, slot, UBO);
+		GLState.BindUniformBuffer(slot, UBO);
 
 		if (dirty)
 		{
+			// The binding above may have been skipped, so the buffer is bound explicitly for the upload.
+			glBindBuffer(GL_UNIFORM_BUFFER, UBO);
 			glBufferSubData(GL_UNIFORM_BUFFER, 0, bufferSize, buffer);
 			dirty = false;
 		}
@@ -101,7 +105,7 @@ namespace gem
 
 	void UniformBuffer::UnBind(unsigned slot)
 	{
-		glBindBufferBase(GL_UNIFORM_BUFFER, slot, GL_NONE);
+		GLState.BindUniformBuffer(slot, GL_NONE);
 	}
 
 	int UniformBuffer::GetByteSize() const
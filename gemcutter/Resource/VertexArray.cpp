@@ -2,6 +2,7 @@
 #include "VertexArray.h"
 #include "gemcutter/Application/Logging.h"
 #include "gemcutter/Math/Math.h"
+#include "gemcutter/Rendering/StateCache.h"
 #include "gemcutter/Utilities/ScopeGuard.h"
 
 #include <GL/glew.h>
@@ -13,6 +14,8 @@ namespace gem
 	BufferMapping::BufferMapping(VertexBuffer& _buffer, VertexAccess accessMode)
 		: buffer(&_buffer)
 	{
+		ASSERT(!buffer->persistentData, "Persistent VertexBuffers are already mapped. Use GetPersistentPtr() instead.");
+
 		buffer->Bind();
 		data = static_cast<std::byte*>(glMapBuffer(buffer->target, ResolveVertexAccess(accessMode)));
 		buffer->UnBind();
@@ -84,7 +87,19 @@ namespace gem
 
 		glGenBuffers(1, &VBO);
 		glBindBuffer(target, VBO);
-		glBufferData(target, size, source, ResolveBufferUsage(usage));
+		if (usage == BufferUsage::Persistent && GLEW_ARB_buffer_storage)
+		{
+			constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+			glBufferStorage(target, size, source, flags);
+			persistentData = static_cast<std::byte*>(glMapBufferRange(target, 0, size, flags));
+
+			ASSERT(persistentData, "Failed to persistently map VertexBuffer.");
+		}
+		else
+		{
+			glBufferData(target, size, source, ResolveBufferUsage(usage));
+		}
 		glBindBuffer(target, GL_NONE);
 	}
 
@@ -118,8 +133,23 @@ namespace gem
 		UnBind();
 	}
 
+	void VertexBuffer::CopyData(unsigned start, const VertexBuffer& source, unsigned sourceStart, unsigned _size)
+	{
+		ASSERT(start + _size <= size, "Out of bounds.");
+		ASSERT(sourceStart + _size <= source.size, "Out of bounds of 'source'.");
+		ASSERT(&source != this, "Cannot copy a VertexBuffer onto itself.");
+
+		glBindBuffer(GL_COPY_READ_BUFFER, source.VBO);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, sourceStart, start, _size);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, GL_NONE);
+		glBindBuffer(GL_COPY_READ_BUFFER, GL_NONE);
+	}
+
 	void VertexBuffer::Resize(unsigned newSize, bool transferData)
 	{
+		ASSERT(!persistentData, "Persistent VertexBuffers have immutable storage and cannot be resized.");
+
 		if (newSize == size)
 			return;
 
@@ -152,6 +182,11 @@ namespace gem
 		return { *this, accessMode };
 	}
 
+	std::byte* VertexBuffer::GetPersistentPtr() const
+	{
+		return persistentData;
+	}
+
 	unsigned VertexBuffer::GetSize() const
 	{
 		return size;
@@ -190,12 +225,16 @@ namespace gem
 
 	VertexArray::~VertexArray()
 	{
+		GLState.OnVertexArrayDeleted(VAO);
 		glDeleteVertexArrays(1, &VAO);
 	}
 
-	void VertexArray::SetIndexBuffer(VertexBuffer::Ptr buffer)
+	void VertexArray::SetIndexBuffer(VertexBuffer::Ptr buffer, VertexFormat _indexFormat)
 	{
+		ASSERT(_indexFormat == VertexFormat::uShort || _indexFormat == VertexFormat::uInt, "'indexFormat' must be uShort or uInt.");
+
 		indexBuffer = std::move(buffer);
+		indexFormat = _indexFormat;
 		if (indexBuffer)
 		{
 			ASSERT(indexBuffer->GetBufferType() == VertexBufferType::Index, "'buffer' must contain indices.");
@@ -212,6 +251,11 @@ namespace gem
 		return indexBuffer.get();
 	}
 
+	VertexFormat VertexArray::GetIndexFormat() const
+	{
+		return indexFormat;
+	}
+
 	void VertexArray::AddStream(VertexStream ptr)
 	{
 		ASSERT(ptr.buffer, "'ptr.buffer' cannot be nullptr.");
@@ -230,86 +274,31 @@ namespace gem
 			ptr.stride = CountBytes(ptr.format);
 		}
 
-		glBindVertexArray(VAO);
-		ptr.buffer->Bind();
-		glEnableVertexAttribArray(ptr.bindingUnit);
-		glVertexAttribDivisor(ptr.bindingUnit, ptr.divisor);
+		ASSERT(ptr.format != VertexFormat::Mat3 || (!HasStream(ptr.bindingUnit + 1) && !HasStream(ptr.bindingUnit + 2)),
+			"mat3 vertex attribute requires streams [ %d, %d, %d ] to be available.", ptr.bindingUnit, ptr.bindingUnit + 1, ptr.bindingUnit + 2);
+		ASSERT(ptr.format != VertexFormat::Mat4 || (!HasStream(ptr.bindingUnit + 1) && !HasStream(ptr.bindingUnit + 2) && !HasStream(ptr.bindingUnit + 3)),
+			"mat4 vertex attribute requires streams [ %d, %d, %d, %d ] to be available.", ptr.bindingUnit, ptr.bindingUnit + 1, ptr.bindingUnit + 2, ptr.bindingUnit + 3);
 
-		switch (ptr.format)
-		{
-		case VertexFormat::Float:
-			glVertexAttribPointer(ptr.bindingUnit, 1, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			break;
-		case VertexFormat::Double:
-			glVertexAttribLPointer(ptr.bindingUnit, 1, GL_DOUBLE, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			break;
+		ApplyStream(ptr);
 
-		case VertexFormat::Vec2:
-			glVertexAttribPointer(ptr.bindingUnit, 2, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			break;
-		case VertexFormat::Vec3:
-			glVertexAttribPointer(ptr.bindingUnit, 3, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			break;
-		case VertexFormat::Vec4:
-			glVertexAttribPointer(ptr.bindingUnit, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			break;
-
-		case VertexFormat::Mat2:
-			glVertexAttribPointer(ptr.bindingUnit, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			break;
-		case VertexFormat::Mat3:
-		{
-			const unsigned unit0 = ptr.bindingUnit;
-			const unsigned unit1 = ptr.bindingUnit + 1;
-			const unsigned unit2 = ptr.bindingUnit + 2;
-			ASSERT(!HasStream(unit1) && !HasStream(unit2),
-				"mat3 vertex attribute requires streams [ %d, %d, %d ] to be available.", unit0, unit1, unit2);
+		streams.push_back(std::move(ptr));
+	}
 
-			glEnableVertexAttribArray(unit1);
-			glEnableVertexAttribArray(unit2);
-			glVertexAttribDivisor(unit1, ptr.divisor);
-			glVertexAttribDivisor(unit2, ptr.divisor);
-			glVertexAttribPointer(unit0, 3, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			glVertexAttribPointer(unit1, 3, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 12);
-			glVertexAttribPointer(unit2, 3, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 24);
-			break;
-		}
-		case VertexFormat::Mat4:
+	void VertexArray::SetStreamOffset(unsigned bindingUnit, unsigned startOffset)
+	{
+		for (auto& stream : streams)
 		{
-			const unsigned unit0 = ptr.bindingUnit;
-			const unsigned unit1 = ptr.bindingUnit + 1;
-			const unsigned unit2 = ptr.bindingUnit + 2;
-			const unsigned unit3 = ptr.bindingUnit + 3;
-			ASSERT(!HasStream(unit1) && !HasStream(unit2) && !HasStream(unit3),
-				"mat4 vertex attribute requires streams [ %d, %d, %d, %d ] to be available.", unit0, unit1, unit2, unit3);
-
-			glEnableVertexAttribArray(unit1);
-			glEnableVertexAttribArray(unit2);
-			glEnableVertexAttribArray(unit3);
-			glVertexAttribDivisor(unit1, ptr.divisor);
-			glVertexAttribDivisor(unit2, ptr.divisor);
-			glVertexAttribDivisor(unit3, ptr.divisor);
-			glVertexAttribPointer(unit0, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			glVertexAttribPointer(unit1, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 16);
-			glVertexAttribPointer(unit2, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 32);
-			glVertexAttribPointer(unit3, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 48);
-			break;
-		}
+			if (stream.bindingUnit == bindingUnit)
+			{
+				ASSERT(startOffset < stream.buffer->GetSize(), "'startOffset' cannot be greater than the size of the VertexBuffer.");
 
-		case VertexFormat::Int:    [[fallthrough]];
-		case VertexFormat::uInt:   [[fallthrough]];
-		case VertexFormat::Short:  [[fallthrough]];
-		case VertexFormat::uShort: [[fallthrough]];
-		case VertexFormat::Byte:   [[fallthrough]];
-		case VertexFormat::uByte:
-			glVertexAttribIPointer(ptr.bindingUnit, 1, ResolveVertexFormat(ptr.format), ptr.stride, (std::byte*)nullptr + ptr.startOffset);
-			break;
+				stream.startOffset = startOffset;
+				ApplyStream(stream);
+				return;
+			}
 		}
 
-		ptr.buffer->UnBind();
-		glBindVertexArray(GL_NONE);
-
-		streams.push_back(std::move(ptr));
+		ASSERT(false, "'bindingUnit' ( %d ) is not a stream.", bindingUnit);
 	}
 
 	bool VertexArray::HasStream(unsigned bindingUnit) const
@@ -355,7 +344,7 @@ namespace gem
 
 			if (found)
 			{
-				glBindVertexArray(VAO);
+				GLState.BindVertexArray(VAO);
 				switch (stream.format)
 				{
 				case VertexFormat::Mat4:
@@ -368,7 +357,7 @@ namespace gem
 				default:
 					glDisableVertexAttribArray(stream.bindingUnit);
 				}
-				glBindVertexArray(GL_NONE);
+				GLState.BindVertexArray(GL_NONE);
 
 				streams.erase(streams.begin() + i);
 				return;
@@ -378,7 +367,7 @@ namespace gem
 
 	void VertexArray::RemoveStreams()
 	{
-		glBindVertexArray(VAO);
+		GLState.BindVertexArray(VAO);
 		for (const VertexStream& stream : streams)
 		{
 			switch (stream.format)
@@ -395,7 +384,7 @@ namespace gem
 			}
 		}
 
-		glBindVertexArray(GL_NONE);
+		GLState.BindVertexArray(GL_NONE);
 		streams.clear();
 	}
 
@@ -433,41 +422,58 @@ namespace gem
 
 	void VertexArray::Bind() const
 	{
-		glBindVertexArray(VAO);
+		GLState.BindVertexArray(VAO);
 	}
 
 	void VertexArray::UnBind() const
 	{
-		glBindVertexArray(GL_NONE);
+		GLState.BindVertexArray(GL_NONE);
 	}
 
 	void VertexArray::Draw() const
 	{
-		Draw(0, format);
+		Draw(firstIndex, format);
 	}
 
-	void VertexArray::Draw(unsigned firstIndex) const
+	void VertexArray::Draw(unsigned first) const
 	{
-		Draw(firstIndex, format);
+		Draw(first, format);
 	}
 
-	void VertexArray::Draw(unsigned firstIndex, VertexArrayFormat formatOverride) const
+	void VertexArray::Draw(unsigned first, VertexArrayFormat formatOverride) const
 	{
 		if (indexBuffer)
 		{
 			indexBuffer->Bind();
-			glDrawElementsInstanced(ResolveVertexArrayFormat(formatOverride), vertexCount, GL_UNSIGNED_SHORT, (std::byte*)nullptr + firstIndex * sizeof(unsigned short), instanceCount);
+			if (indexFormat == VertexFormat::uInt)
+			{
+				// The restart index is shared by all index types, so it must match the maximum value of 32-bit
+				// indices while drawing. Otherwise, vertex 65535 of a large mesh would restart the primitive.
+				glPrimitiveRestartIndex(std::numeric_limits<unsigned>::max());
+				glDrawElementsInstanced(ResolveVertexArrayFormat(formatOverride), vertexCount, GL_UNSIGNED_INT, (std::byte*)nullptr + first * sizeof(unsigned), instanceCount);
+				glPrimitiveRestartIndex(VertexBuffer::RESTART_INDEX);
+			}
+			else
+			{
+				glDrawElementsInstanced(ResolveVertexArrayFormat(formatOverride), vertexCount, GL_UNSIGNED_SHORT, (std::byte*)nullptr + first * sizeof(unsigned short), instanceCount);
+			}
 		}
 		else
 		{
-			glDrawArraysInstanced(ResolveVertexArrayFormat(formatOverride), firstIndex, vertexCount, instanceCount);
+			glDrawArraysInstanced(ResolveVertexArrayFormat(formatOverride), first, vertexCount, instanceCount);
 		}
 	}
 
 	void VertexArray::SetVertexCount(unsigned count)
 	{
 #ifdef GEM_DEBUG
-		if (count > 0)
+		if (count > 0 && indexBuffer)
+		{
+			// The count refers to indices, which can reference any vertex.
+			const unsigned last = (firstIndex + count) * CountBytes(indexFormat);
+			ASSERT(last <= indexBuffer->GetSize(), "Rendering %d indices would cause a buffer overrun in the index buffer.", count);
+		}
+		else if (count > 0)
 		{
 			// Check to ensure that the specified count would not cause us to read past any of the buffers.
 			for (unsigned i = 0; i < streams.size(); ++i)
@@ -475,7 +481,7 @@ namespace gem
 				const auto& stream = streams[i];
 				const unsigned bufferSize = stream.buffer->GetSize();
 				const unsigned last = (stream.divisor == 0)
-					? stream.startOffset + CountBytes(stream.format) + (count - 1) * stream.stride
+					? stream.startOffset + CountBytes(stream.format) + (firstIndex + count - 1) * stream.stride
 					: stream.startOffset + CountBytes(stream.format);
 
 				ASSERT(last <= bufferSize, "Rendering %d vertices would cause a buffer overrun in Stream( %d ).", count, i);
@@ -490,6 +496,16 @@ namespace gem
 		return vertexCount;
 	}
 
+	void VertexArray::SetFirstIndex(unsigned index)
+	{
+		firstIndex = index;
+	}
+
+	unsigned VertexArray::GetFirstIndex() const
+	{
+		return firstIndex;
+	}
+
 	void VertexArray::SetInstanceCount(unsigned count)
 	{
 #ifdef GEM_DEBUG
@@ -517,6 +533,94 @@ namespace gem
 	{
 		return instanceCount;
 	}
+
+	void VertexArray::ApplyStream(const VertexStream& ptr) const
+	{
+		GLState.BindVertexArray(VAO);
+		ptr.buffer->Bind();
+		glEnableVertexAttribArray(ptr.bindingUnit);
+		glVertexAttribDivisor(ptr.bindingUnit, ptr.divisor);
+
+		switch (ptr.format)
+		{
+		case VertexFormat::Float:
+			glVertexAttribPointer(ptr.bindingUnit, 1, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+		case VertexFormat::Double:
+			glVertexAttribLPointer(ptr.bindingUnit, 1, GL_DOUBLE, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+
+		case VertexFormat::Vec2:
+			glVertexAttribPointer(ptr.bindingUnit, 2, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+		case VertexFormat::Vec3:
+			glVertexAttribPointer(ptr.bindingUnit, 3, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+		case VertexFormat::Vec4:
+			glVertexAttribPointer(ptr.bindingUnit, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+
+		case VertexFormat::Mat2:
+			glVertexAttribPointer(ptr.bindingUnit, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+		case VertexFormat::Mat3:
+		{
+			const unsigned unit0 = ptr.bindingUnit;
+			const unsigned unit1 = ptr.bindingUnit + 1;
+			const unsigned unit2 = ptr.bindingUnit + 2;
+
+			glEnableVertexAttribArray(unit1);
+			glEnableVertexAttribArray(unit2);
+			glVertexAttribDivisor(unit1, ptr.divisor);
+			glVertexAttribDivisor(unit2, ptr.divisor);
+			glVertexAttribPointer(unit0, 3, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			glVertexAttribPointer(unit1, 3, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 12);
+			glVertexAttribPointer(unit2, 3, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 24);
+			break;
+		}
+		case VertexFormat::Mat4:
+		{
+			const unsigned unit0 = ptr.bindingUnit;
+			const unsigned unit1 = ptr.bindingUnit + 1;
+			const unsigned unit2 = ptr.bindingUnit + 2;
+			const unsigned unit3 = ptr.bindingUnit + 3;
+
+			glEnableVertexAttribArray(unit1);
+			glEnableVertexAttribArray(unit2);
+			glEnableVertexAttribArray(unit3);
+			glVertexAttribDivisor(unit1, ptr.divisor);
+			glVertexAttribDivisor(unit2, ptr.divisor);
+			glVertexAttribDivisor(unit3, ptr.divisor);
+			glVertexAttribPointer(unit0, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			glVertexAttribPointer(unit1, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 16);
+			glVertexAttribPointer(unit2, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 32);
+			glVertexAttribPointer(unit3, 4, GL_FLOAT, ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset + 48);
+			break;
+		}
+
+		case VertexFormat::Int:    [[fallthrough]];
+		case VertexFormat::uInt:   [[fallthrough]];
+		case VertexFormat::Short:  [[fallthrough]];
+		case VertexFormat::uShort: [[fallthrough]];
+		case VertexFormat::Byte:   [[fallthrough]];
+		case VertexFormat::uByte:
+			glVertexAttribIPointer(ptr.bindingUnit, 1, ResolveVertexFormat(ptr.format), ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+
+		case VertexFormat::HalfVec2: [[fallthrough]];
+		case VertexFormat::ShortVec2:
+			glVertexAttribPointer(ptr.bindingUnit, 2, ResolveVertexFormat(ptr.format), ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+		case VertexFormat::HalfVec4:  [[fallthrough]];
+		case VertexFormat::ShortVec4: [[fallthrough]];
+		case VertexFormat::uShortVec4:
+			glVertexAttribPointer(ptr.bindingUnit, 4, ResolveVertexFormat(ptr.format), ptr.normalized, ptr.stride, (std::byte*)nullptr + ptr.startOffset);
+			break;
+		}
+
+		ptr.buffer->UnBind();
+		GLState.BindVertexArray(GL_NONE);
+	}
 }
 
 REFLECT_SIMPLE(gem::VertexBuffer);
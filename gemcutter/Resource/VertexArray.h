@@ -50,6 +50,7 @@ namespace gem
 	{
 		friend BufferMapping;
 		friend VertexArray;
+		friend class StaticGeometry; // For VBO.
 	public:
 		VertexBuffer(unsigned size, BufferUsage usage, VertexBufferType type);
 		VertexBuffer(unsigned size, const void* source, BufferUsage usage, VertexBufferType type);
@@ -58,15 +59,22 @@ namespace gem
 		void ClearData();
 		void ClearData(unsigned start, unsigned size);
 		void SetData(unsigned start, unsigned size, const void* source);
+		// Copies a range of another buffer on the GPU, without reading it back.
+		void CopyData(unsigned start, const VertexBuffer& source, unsigned sourceStart, unsigned size);
 		void Resize(unsigned newSize, bool transferData);
 
 		BufferMapping MapBuffer(VertexAccess accessMode);
 
+		// Returns the permanent write-only mapping of a BufferUsage::Persistent buffer.
+		// Returns nullptr if the buffer is not persistent, or if persistent mapping is not supported by the device.
+		std::byte* GetPersistentPtr() const;
+
 		unsigned GetSize() const;
 		BufferUsage GetBufferUsage() const;
 		VertexBufferType GetBufferType() const;
 
 		// Special index value used to restart Triangle/line fans/strips/loops.
+		// 32-bit index buffers use the maximum 'unsigned' value instead.
 		static constexpr unsigned short RESTART_INDEX = std::numeric_limits<unsigned short>::max();
 
 	private:
@@ -77,6 +85,7 @@ namespace gem
 		unsigned size = 0;
 		BufferUsage usage;
 		int target;
+		std::byte* persistentData = nullptr;
 	};
 
 	// A single vertex attribute to be streamed to a vertex shader.
@@ -107,11 +116,15 @@ namespace gem
 		VertexArray(VertexArrayFormat format);
 		~VertexArray();
 
-		void SetIndexBuffer(VertexBuffer::Ptr buffer);
+		// 'indexFormat' must be either VertexFormat::uShort or VertexFormat::uInt.
+		void SetIndexBuffer(VertexBuffer::Ptr buffer, VertexFormat indexFormat = VertexFormat::uShort);
 		const VertexBuffer* GetIndexBuffer() const;
 		VertexBuffer* GetIndexBuffer();
+		VertexFormat GetIndexFormat() const;
 
 		void AddStream(VertexStream ptr);
+		// Points an existing stream at a new location in its buffer, such as a range allocated from a StreamBuffer.
+		void SetStreamOffset(unsigned bindingUnit, unsigned startOffset);
 		bool HasStream(unsigned bindingUnit) const;
 		void RemoveStream(unsigned bindingUnit);
 		void RemoveStreams();
@@ -130,6 +143,7 @@ namespace gem
 		void UnBind() const;
 
 		// Renders the array using any currently bound state.
+		// The default first index can be set with SetFirstIndex().
 		void Draw() const;
 		void Draw(unsigned firstIndex) const;
 		void Draw(unsigned firstIndex, VertexArrayFormat formatOverride) const;
@@ -137,6 +151,10 @@ namespace gem
 		void SetVertexCount(unsigned count);
 		unsigned GetVertexCount() const;
 
+		// Sets the first vertex, or index if an index buffer is present, used by Draw().
+		void SetFirstIndex(unsigned index);
+		unsigned GetFirstIndex() const;
+
 		void SetInstanceCount(unsigned count);
 		unsigned GetInstanceCount() const;
 
@@ -145,11 +163,16 @@ namespace gem
 		VertexArrayFormat format = VertexArrayFormat::Triangle;
 
 	private:
+		// Describes the layout of the stream to the vertex array object.
+		void ApplyStream(const VertexStream& ptr) const;
+
 		unsigned VAO = 0;
+		unsigned firstIndex = 0;
 		unsigned vertexCount = 0;
 		unsigned instanceCount = 1;
 
 		VertexBuffer::Ptr indexBuffer;
+		VertexFormat indexFormat = VertexFormat::uShort;
 		std::vector<VertexStream> streams;
 	};
 }
@@ -0,0 +1,68 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace gem
+{
+	// Reads a sequence of trivially copyable values from a block of memory, such as a packed asset file.
+	// Every read is bounds checked. A failed read does not advance the reader.
+	class BinaryReader
+	{
+	public:
+		BinaryReader(std::span<const std::byte> _data)
+			: data(_data)
+		{}
+
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		bool Read(T& value)
+		{
+			if (sizeof(T) > GetRemaining())
+			{
+				return false;
+			}
+
+			std::memcpy(&value, data.data() + position, sizeof(T));
+			position += sizeof(T);
+
+			return true;
+		}
+
+		// Provides a view of the next bytes without copying them.
+		bool View(size_t size, std::span<const std::byte>& output)
+		{
+			if (size > GetRemaining())
+			{
+				return false;
+			}
+
+			output = data.subspan(position, size);
+			position += size;
+
+			return true;
+		}
+
+		// Advances past the next bytes, such as a section which is not understood.
+		bool Skip(size_t size)
+		{
+			if (size > GetRemaining())
+			{
+				return false;
+			}
+
+			position += size;
+
+			return true;
+		}
+
+		size_t GetPosition() const { return position; }
+		size_t GetRemaining() const { return data.size() - position; }
+		bool IsAtEnd() const { return position == data.size(); }
+
+	private:
+		std::span<const std::byte> data;
+		size_t position = 0;
+	};
+}
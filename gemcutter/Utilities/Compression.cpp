@@ -0,0 +1,212 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "Compression.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+	// Constants defined by the LZ4 block format.
+	constexpr size_t MIN_MATCH = 4;
+	constexpr size_t LAST_LITERALS = 5;
+	constexpr size_t MATCH_FIND_LIMIT = 12;
+	constexpr size_t MAX_OFFSET = 65535;
+
+	constexpr unsigned HASH_BITS = 12;
+
+	uint32_t Read32(const uint8_t* data)
+	{
+		uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+
+		return value;
+	}
+
+	uint32_t Hash(uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	void WriteLength(std::vector<std::byte>& output, size_t length)
+	{
+		while (length >= 255)
+		{
+			output.push_back(std::byte{ 255 });
+			length -= 255;
+		}
+
+		output.push_back(static_cast<std::byte>(length));
+	}
+
+	// Appends a run of literals followed by a match. A match length of 0 marks the final sequence.
+	void WriteSequence(std::vector<std::byte>& output, const uint8_t* literals, size_t numLiterals, size_t offset, size_t matchLength)
+	{
+		const size_t matchCode = matchLength == 0 ? 0 : matchLength - MIN_MATCH;
+
+		const uint8_t token = static_cast<uint8_t>((std::min<size_t>(numLiterals, 15) << 4) | std::min<size_t>(matchCode, 15));
+		output.push_back(static_cast<std::byte>(token));
+
+		if (numLiterals >= 15)
+		{
+			WriteLength(output, numLiterals - 15);
+		}
+
+		const auto* literalBytes = reinterpret_cast<const std::byte*>(literals);
+		output.insert(output.end(), literalBytes, literalBytes + numLiterals);
+
+		if (matchLength == 0)
+		{
+			return;
+		}
+
+		output.push_back(static_cast<std::byte>(offset & 0xFF));
+		output.push_back(static_cast<std::byte>(offset >> 8));
+
+		if (matchCode >= 15)
+		{
+			WriteLength(output, matchCode - 15);
+		}
+	}
+
+	bool ReadLength(const uint8_t*& itr, const uint8_t* end, size_t& length)
+	{
+		uint8_t value;
+		do
+		{
+			if (itr == end)
+			{
+				return false;
+			}
+
+			value = *itr++;
+			length += value;
+		}
+		while (value == 255);
+
+		return true;
+	}
+}
+
+namespace gem
+{
+	void CompressLZ4(std::span<const std::byte> source, std::vector<std::byte>& output)
+	{
+		output.clear();
+		output.reserve(source.size() + source.size() / 255 + 16);
+
+		const auto* src = reinterpret_cast<const uint8_t*>(source.data());
+		const size_t size = source.size();
+
+		size_t anchor = 0;
+		if (size > MATCH_FIND_LIMIT)
+		{
+			// Holds the last position + 1 at which each hashed sequence was seen.
+			std::vector<uint32_t> table(1u << HASH_BITS, 0);
+
+			const size_t matchEndLimit = size - LAST_LITERALS;
+			size_t pos = 0;
+			while (pos + MATCH_FIND_LIMIT <= size)
+			{
+				const uint32_t sequence = Read32(src + pos);
+				uint32_t& entry = table[Hash(sequence)];
+				const size_t candidate = entry;
+				entry = static_cast<uint32_t>(pos + 1);
+
+				if (candidate == 0 ||
+					pos - (candidate - 1) > MAX_OFFSET ||
+					Read32(src + candidate - 1) != sequence)
+				{
+					++pos;
+					continue;
+				}
+
+				const size_t matchStart = candidate - 1;
+				size_t matchLength = MIN_MATCH;
+				while (pos + matchLength < matchEndLimit && src[matchStart + matchLength] == src[pos + matchLength])
+				{
+					++matchLength;
+				}
+
+				WriteSequence(output, src + anchor, pos - anchor, pos - matchStart, matchLength);
+
+				pos += matchLength;
+				anchor = pos;
+			}
+		}
+
+		WriteSequence(output, src + anchor, size - anchor, 0, 0);
+	}
+
+	bool DecompressLZ4(std::span<const std::byte> source, std::span<std::byte> destination)
+	{
+		const auto* itr = reinterpret_cast<const uint8_t*>(source.data());
+		const auto* end = itr + source.size();
+
+		auto* dest = reinterpret_cast<uint8_t*>(destination.data());
+		auto* destItr = dest;
+		auto* destEnd = dest + destination.size();
+
+		while (itr != end)
+		{
+			const uint8_t token = *itr++;
+
+			size_t numLiterals = token >> 4;
+			if (numLiterals == 15 && !ReadLength(itr, end, numLiterals))
+			{
+				return false;
+			}
+
+			if (numLiterals > static_cast<size_t>(end - itr) ||
+				numLiterals > static_cast<size_t>(destEnd - destItr))
+			{
+				return false;
+			}
+
+			std::copy_n(itr, numLiterals, destItr);
+			itr += numLiterals;
+			destItr += numLiterals;
+
+			// The final sequence has no match.
+			if (itr == end)
+			{
+				break;
+			}
+
+			if (end - itr < 2)
+			{
+				return false;
+			}
+
+			const size_t offset = itr[0] | (itr[1] << 8);
+			itr += 2;
+
+			if (offset == 0 || offset > static_cast<size_t>(destItr - dest))
+			{
+				return false;
+			}
+
+			size_t matchLength = token & 0xF;
+			if (matchLength == 15 && !ReadLength(itr, end, matchLength))
+			{
+				return false;
+			}
+			matchLength += MIN_MATCH;
+
+			if (matchLength > static_cast<size_t>(destEnd - destItr))
+			{
+				return false;
+			}
+
+			// Matches may overlap with the bytes they produce, so they must be copied forwards one at a time.
+			const uint8_t* match = destItr - offset;
+			for (size_t i = 0; i < matchLength; ++i)
+			{
+				destItr[i] = match[i];
+			}
+			destItr += matchLength;
+		}
+
+		return destItr == destEnd;
+	}
+}
@@ -0,0 +1,16 @@
+// Copyright (c) 2026 Emilian Cioca
+#pragma once
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace gem
+{
+	// Compresses the data into the LZ4 block format. Favors decompression speed over compression ratio.
+	// The output does not record the original size, so it must be stored alongside the compressed data.
+	void CompressLZ4(std::span<const std::byte> source, std::vector<std::byte>& output);
+
+	// Decompresses an LZ4 block. The destination must be exactly the size of the original data.
+	// Returns false if the block is malformed or does not decompress to the destination's size.
+	bool DecompressLZ4(std::span<const std::byte> source, std::span<std::byte> destination);
+}
@@ -4,65 +4,271 @@
 #include "gemcutter/Math/Math.h"
 #include "gemcutter/Math/Vector.h"
 
+#include <atomic>
+#include <bit>
 #include <cstdlib>
+#include <ctime>
 #include <loupe/loupe.h>
 #include <random>
 
 namespace
 {
-	std::mt19937 engine;
+	// Seed used to derive the stream of each new thread.
+	std::atomic<uint64_t> globalSeed = 0;
+	// Ensures that every thread derives a unique stream from the global seed.
+	std::atomic<uint64_t> threadCounter = 0;
+
+	// Expands a 64-bit seed into well distributed state words.
+	uint64_t SplitMix64(uint64_t& x)
+	{
+		uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// Converts the top 24 bits of a random value to a float in the range [0, 1].
+	float ToUnitInclusive(uint32_t value)
+	{
+		return static_cast<float>(value >> 8) * (1.0f / 16777215.0f);
+	}
+
+	// Converts the top 24 bits of a random value to a float in the range [0, 1).
+	float ToUnitExclusive(uint32_t value)
+	{
+		return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+	}
+
+	// Converts a random value to a float in the range [-1, 1].
+	float ToSignedUnit(uint32_t value)
+	{
+		return static_cast<float>(static_cast<int32_t>(value)) * (1.0f / 2147483648.0f);
+	}
+
+	gem::RandomStream CreateThreadStream()
+	{
+		uint64_t seed = globalSeed.load(std::memory_order_relaxed);
+		seed ^= threadCounter.fetch_add(1, std::memory_order_relaxed) * 0xD1B54A32D192ED03ull;
+
+		return gem::RandomStream(seed);
+	}
+
+	thread_local gem::RandomStream threadStream = CreateThreadStream();
 }
 
 namespace gem
 {
+	RandomStream::RandomStream()
+		: RandomStream(GetThreadRandomStream().Split())
+	{
+	}
+
+	RandomStream::RandomStream(uint64_t seed)
+	{
+		Seed(seed);
+	}
+
+	void RandomStream::Seed(uint64_t seed)
+	{
+		const uint64_t low  = SplitMix64(seed);
+		const uint64_t high = SplitMix64(seed);
+
+		state[0] = static_cast<uint32_t>(low);
+		state[1] = static_cast<uint32_t>(low >> 32);
+		state[2] = static_cast<uint32_t>(high);
+		state[3] = static_cast<uint32_t>(high >> 32);
+	}
+
+	RandomStream RandomStream::Split()
+	{
+		RandomStream result = *this;
+		Jump();
+
+		return result;
+	}
+
+	uint32_t RandomStream::Next()
+	{
+		const uint32_t result = std::rotl(state[1] * 5, 7) * 9;
+		const uint32_t t = state[1] << 9;
+
+		state[2] ^= state[0];
+		state[3] ^= state[1];
+		state[1] ^= state[2];
+		state[0] ^= state[3];
+		state[2] ^= t;
+		state[3] = std::rotl(state[3], 11);
+
+		return result;
+	}
+
+	float RandomStream::Range(float min, float max)
+	{
+		ASSERT(min <= max, "Invalid range.");
+
+		// Rounding can push the result just past 'max', so it is clamped.
+		return Min(min + (max - min) * ToUnitInclusive(Next()), max);
+	}
+
+	int RandomStream::Range(int min, int max)
+	{
+		ASSERT(min <= max, "Invalid range.");
+
+		const uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min) + 1;
+		if (range == 0)
+		{
+			// The range covers every possible int.
+			return static_cast<int>(Next());
+		}
+
+		// Lemire's nearly divisionless method. Values which would bias the result are rejected.
+		uint64_t product = static_cast<uint64_t>(Next()) * range;
+		uint32_t low = static_cast<uint32_t>(product);
+		if (low < range)
+		{
+			const uint32_t threshold = (0u - range) % range;
+			while (low < threshold)
+			{
+				product = static_cast<uint64_t>(Next()) * range;
+				low = static_cast<uint32_t>(product);
+			}
+		}
+
+		return static_cast<int>(static_cast<uint32_t>(min) + static_cast<uint32_t>(product >> 32));
+	}
+
+	vec3 RandomStream::Direction()
+	{
+		// Marsaglia's method provides a uniform distribution over the sphere without trigonometry.
+		float u, v, s;
+		do
+		{
+			u = ToSignedUnit(Next());
+			v = ToSignedUnit(Next());
+			s = u * u + v * v;
+		} while (s >= 1.0f);
+
+		const float scale = 2.0f * std::sqrt(1.0f - s);
+		return vec3(u * scale, v * scale, 1.0f - 2.0f * s);
+	}
+
+	vec3 RandomStream::Color()
+	{
+		return vec3(
+			ToUnitInclusive(Next()),
+			ToUnitInclusive(Next()),
+			ToUnitInclusive(Next()));
+	}
+
+	bool RandomStream::Bool(float probability)
+	{
+		ASSERT(probability >= 0.0f && probability <= 1.0f, "Probability must be within [0, 1].");
+
+		return ToUnitExclusive(Next()) < probability;
+	}
+
+	void RandomStream::FillRange(std::span<float> values, float min, float max)
+	{
+		ASSERT(min <= max, "Invalid range.");
+
+		const float range = max - min;
+		for (float& value : values)
+		{
+			value = Min(min + range * ToUnitInclusive(Next()), max);
+		}
+	}
+
+	void RandomStream::FillDirections(std::span<vec3> values)
+	{
+		for (vec3& value : values)
+		{
+			value = Direction();
+		}
+	}
+
+	void RandomStream::Jump()
+	{
+		constexpr uint32_t JUMP[] = { 0x8764000B, 0xF542D2D3, 0x6FA035C3, 0x77F2DB5B };
+
+		uint32_t s0 = 0;
+		uint32_t s1 = 0;
+		uint32_t s2 = 0;
+		uint32_t s3 = 0;
+		for (uint32_t word : JUMP)
+		{
+			for (unsigned b = 0; b < 32; ++b)
+			{
+				if (word & (1u << b))
+				{
+					s0 ^= state[0];
+					s1 ^= state[1];
+					s2 ^= state[2];
+					s3 ^= state[3];
+				}
+
+				Next();
+			}
+		}
+
+		state[0] = s0;
+		state[1] = s1;
+		state[2] = s2;
+		state[3] = s3;
+	}
+
+	RandomStream& GetThreadRandomStream()
+	{
+		return threadStream;
+	}
+
 	void SeedRandomNumberGenerator()
 	{
 		std::random_device rd;
 
-		engine.seed(rd());
+		SeedRandomNumberGenerator(rd());
 		srand(static_cast<unsigned>(time(nullptr)));
 	}
 
 	void SeedRandomNumberGenerator(unsigned seed)
 	{
-		engine.seed(seed);
+		globalSeed.store(seed, std::memory_order_relaxed);
+		threadStream.Seed(seed);
 		srand(seed);
 	}
 
 	float RandomRange(float min, float max)
 	{
-		std::uniform_real_distribution<float> dist(min, std::nextafter(max, FLT_MAX));
-		return dist(engine);
+		return threadStream.Range(min, max);
 	}
 
 	int RandomRange(int min, int max)
 	{
-		std::uniform_int_distribution<int> dist(min, max);
-		return dist(engine);
+		return threadStream.Range(min, max);
 	}
 
 	vec3 RandomDirection()
 	{
-		return Normalize(vec3(
-			RandomRange(-1.0f, 1.0f),
-			RandomRange(-1.0f, 1.0f),
-			RandomRange(-1.0f, 1.0f)));
+		return threadStream.Direction();
 	}
 
 	vec3 RandomColor()
 	{
-		return vec3(
-			RandomRange(0.0f, 1.0f),
-			RandomRange(0.0f, 1.0f),
-			RandomRange(0.0f, 1.0f));
+		return threadStream.Color();
 	}
 
 	bool RandomBool(float probability)
 	{
-		ASSERT(probability >= 0.0f && probability <= 1.0f, "Probability must be within [0, 1].");
+		return threadStream.Bool(probability);
+	}
+
+	void FillRange(std::span<float> values, float min, float max)
+	{
+		threadStream.FillRange(values, min, max);
+	}
 
-		std::bernoulli_distribution dist(probability);
-		return dist(engine);
+	void FillDirections(std::span<vec3> values)
+	{
+		threadStream.FillDirections(values);
 	}
 
 	Range::Range(float _min, float _max)
@@ -78,7 +284,12 @@ namespace gem
 
 	float Range::Random() const
 	{
-		return RandomRange(min, max);
+		return threadStream.Range(min, max);
+	}
+
+	float Range::Random(RandomStream& stream) const
+	{
+		return stream.Range(min, max);
 	}
 
 	void Range::Set(float _min, float _max)
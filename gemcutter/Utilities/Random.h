@@ -1,10 +1,63 @@
 // Copyright (c) 2017 Emilian Cioca
 #pragma once
+#include <cstdint>
+#include <span>
 
 namespace gem
 {
 	struct vec3;
 
+	// A fast pseudo-random number generator (xoshiro128**) with a 16 byte state.
+	// A single stream is not thread-safe. Instead, independent streams can be split off from
+	// one another to be owned by each thread or system, such as one per ParticleEmitter.
+	class RandomStream
+	{
+	public:
+		// Creates a new stream split from the calling thread's stream.
+		RandomStream();
+		explicit RandomStream(uint64_t seed);
+
+		// Restarts the stream. The same seed will always produce the same sequence.
+		void Seed(uint64_t seed);
+
+		// Returns a new stream starting at the current position of this one,
+		// then advances this stream so that the two sequences will not overlap.
+		[[nodiscard]] RandomStream Split();
+
+		// Returns the next raw 32-bit value from the sequence.
+		uint32_t Next();
+
+		// Returns a random float in the range [min, max].
+		float Range(float min, float max);
+		// Returns a random int in the range [min, max].
+		int Range(int min, int max);
+
+		// Returns a random unit-length vector.
+		vec3 Direction();
+		// Returns a random color with [0, 1] RGB values.
+		vec3 Color();
+
+		// Returns true randomly given the [0, 1] probability.
+		bool Bool(float probability);
+
+		// Fills the values with random floats in the range [min, max].
+		void FillRange(std::span<float> values, float min, float max);
+		// Fills the values with random unit-length vectors.
+		void FillDirections(std::span<vec3> values);
+
+	private:
+		// Advances the stream by 2^64 values.
+		void Jump();
+
+		uint32_t state[4];
+	};
+
+	// Returns the stream used by the global random functions on the calling thread.
+	// Each thread's stream is created on first use and derived from the last global seed.
+	RandomStream& GetThreadRandomStream();
+
+	// Reseeds the calling thread's stream. Threads which first
+	// generate numbers afterwards will derive their streams from this seed.
 	void SeedRandomNumberGenerator();
 	void SeedRandomNumberGenerator(unsigned seed);
 
@@ -21,6 +74,11 @@ namespace gem
 	// Returns true randomly given the [0, 1] probability.
 	bool RandomBool(float probability);
 
+	// Fills the values with random floats in the range [min, max].
+	void FillRange(std::span<float> values, float min, float max);
+	// Fills the values with random unit-length vectors.
+	void FillDirections(std::span<vec3> values);
+
 	struct Range
 	{
 		Range() = default;
@@ -30,6 +88,7 @@ namespace gem
 		[[nodiscard]] static Range Deviation(float value, float deviation);
 
 		float Random() const;
+		float Random(RandomStream& stream) const;
 		void Set(float min, float max);
 
 		bool Contains(float value) const;
@@ -0,0 +1,258 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Application/FileSystem.h>
+#include <gemcutter/Resource/AssetBuilder.h>
+#include <gemcutter/Resource/Encoder.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace gem;
+
+namespace
+{
+	// Writes the source text to the output folder, followed by the "suffix" setting.
+	class TextEncoder : public Encoder
+	{
+	public:
+		TextEncoder(unsigned version = 2) : Encoder(version) {}
+
+		ConfigTable GetDefault() const override
+		{
+			ConfigTable defaultConfig;
+			defaultConfig.SetInt("version", static_cast<int>(version));
+			defaultConfig.SetString("suffix", "!");
+
+			return defaultConfig;
+		}
+
+		mutable std::atomic<unsigned> numConverted = 0;
+
+	protected:
+		std::string_view GetOutputExtension() const override
+		{
+			return ".out";
+		}
+
+		bool Convert(std::string_view source, std::string_view destination, const ConfigTable& metadata) const override
+		{
+			++numConverted;
+
+			std::string contents;
+			if (!LoadFileAsString(source, contents) || contents == "invalid")
+			{
+				return false;
+			}
+
+			std::ofstream(std::string(destination) + ExtractFilename(source) + ".out") << contents << metadata.GetString("suffix");
+			return true;
+		}
+
+		bool Validate(const ConfigTable& metadata, unsigned loadedVersion) const override
+		{
+			return loadedVersion == 1 || metadata.HasSetting("suffix");
+		}
+
+		bool Upgrade(ConfigTable& metadata, unsigned) const override
+		{
+			metadata.SetString("suffix", "?");
+			return true;
+		}
+	};
+
+	// An Encoder written before output extensions were reported.
+	class UnknownOutputEncoder : public TextEncoder
+	{
+	protected:
+		std::string_view GetOutputExtension() const override
+		{
+			return Encoder::GetOutputExtension();
+		}
+	};
+
+	std::string ReadFile(const std::filesystem::path& file)
+	{
+		std::string contents;
+		LoadFileAsString(file.string(), contents);
+
+		return contents;
+	}
+}
+
+TEST_CASE("AssetBuilder")
+{
+	namespace fs = std::filesystem;
+
+	const fs::path workspace = "AssetBuilderTest/workspace";
+	const fs::path output = "AssetBuilderTest/output";
+	fs::remove_all("AssetBuilderTest");
+	fs::create_directories(workspace / "top");
+	fs::create_directories(workspace / "sub" / "deep");
+
+	// Files in the root of the workspace are not assets.
+	std::ofstream(workspace / "config.workspace") << "settings";
+
+	std::ofstream(workspace / "top" / "a.txt") << "a";
+	std::ofstream(workspace / "sub" / "B.TXT") << "b";
+	std::ofstream(workspace / "sub" / "deep" / "c.txt") << "c";
+	std::ofstream(workspace / "sub" / "copied.dat") << "data";
+	std::ofstream(workspace / "top" / "excluded.tmp") << "temporary";
+
+	// An older version of the metadata will be upgraded.
+	std::ofstream(workspace / "top" / "a.txt.meta") << "version=1\n";
+
+	TextEncoder encoder;
+	AssetBuilder builder;
+	builder.AddEncoder(".txt", encoder);
+	builder.ExcludeExtension(".TMP");
+
+	SECTION("BuildCache")
+	{
+		uint64_t hash1 = 0;
+		uint64_t hash2 = 0;
+		REQUIRE(HashAssetSource((workspace / "top" / "a.txt").string(), hash1));
+		REQUIRE(HashAssetSource((workspace / "sub" / "B.TXT").string(), hash2));
+		CHECK(hash1 != hash2);
+		CHECK_FALSE(HashAssetSource((workspace / "missing.txt").string(), hash1));
+
+		BuildCache cache;
+		cache.Set("top/a.txt", hash1);
+		cache.Set("sub/folder with spaces/B.TXT", hash2);
+		REQUIRE(cache.Save("AssetBuilderTest/test.cache"));
+
+		BuildCache loaded;
+		REQUIRE(loaded.Load("AssetBuilderTest/test.cache"));
+		CHECK(loaded.GetSize() == 2);
+		CHECK(loaded.IsUpToDate("top/a.txt", hash1));
+		CHECK(loaded.IsUpToDate("sub/folder with spaces/B.TXT", hash2));
+		CHECK_FALSE(loaded.IsUpToDate("top/a.txt", hash2));
+		CHECK_FALSE(loaded.IsUpToDate("c.txt", hash1));
+
+		// The metadata is part of the hash.
+		uint64_t hashWithMeta = 0;
+		std::ofstream(workspace / "sub" / "B.TXT.meta") << "version=2\nsuffix=.\n";
+		REQUIRE(HashAssetSource((workspace / "sub" / "B.TXT").string(), hashWithMeta));
+		CHECK(hashWithMeta != hash2);
+	}
+
+	SECTION("Build")
+	{
+		REQUIRE(builder.Update(workspace.string(), 4));
+		CHECK(fs::exists(workspace / "sub" / "B.TXT.meta"));
+		CHECK(fs::exists(workspace / "sub" / "deep" / "c.txt.meta"));
+
+		REQUIRE(builder.Build(workspace.string(), output.string(), 4));
+		CHECK(builder.GetNumBuilt() == 4);
+		CHECK(builder.GetNumSkipped() == 0);
+		CHECK(encoder.numConverted == 3);
+
+		CHECK(ReadFile(output / "top" / "a.out") == "a?");
+		CHECK(ReadFile(output / "sub" / "B.out") == "b!");
+		CHECK(ReadFile(output / "sub" / "deep" / "c.out") == "c!");
+		CHECK(ReadFile(output / "sub" / "copied.dat") == "data");
+		CHECK_FALSE(fs::exists(output / "top" / "excluded.tmp"));
+		CHECK_FALSE(fs::exists(output / "top" / "a.txt.meta"));
+		CHECK_FALSE(fs::exists(output / "config.workspace"));
+
+		// Nothing has changed.
+		REQUIRE(builder.Build(workspace.string(), output.string(), 4));
+		CHECK(builder.GetNumBuilt() == 0);
+		CHECK(builder.GetNumSkipped() == 4);
+		CHECK(encoder.numConverted == 3);
+
+		// Changes to either the source or the metadata are detected.
+		std::ofstream(workspace / "sub" / "deep" / "c.txt") << "C";
+		std::ofstream(workspace / "top" / "a.txt.meta") << "version=2\nsuffix=#\n";
+		REQUIRE(builder.Build(workspace.string(), output.string(), 1));
+		CHECK(builder.GetNumBuilt() == 2);
+		CHECK(builder.GetNumSkipped() == 2);
+		CHECK(encoder.numConverted == 5);
+		CHECK(ReadFile(output / "top" / "a.out") == "a#");
+		CHECK(ReadFile(output / "sub" / "deep" / "c.out") == "C!");
+
+		// Failures are retried on the next build.
+		std::ofstream(workspace / "top" / "a.txt") << "invalid";
+		CHECK_FALSE(builder.Build(workspace.string(), output.string(), 4));
+		CHECK(builder.GetNumFailed() == 1);
+		CHECK_FALSE(builder.Build(workspace.string(), output.string(), 4));
+		CHECK(builder.GetNumFailed() == 1);
+		CHECK(encoder.numConverted == 7);
+
+		std::ofstream(workspace / "top" / "a.txt") << "fixed";
+		REQUIRE(builder.Build(workspace.string(), output.string(), 4));
+		CHECK(builder.GetNumBuilt() == 1);
+		CHECK(ReadFile(output / "top" / "a.out") == "fixed#");
+
+		// Missing outputs are rebuilt.
+		fs::remove(output / "sub" / "B.out");
+		fs::remove(output / "sub" / "copied.dat");
+		REQUIRE(builder.Build(workspace.string(), output.string(), 4));
+		CHECK(builder.GetNumBuilt() == 2);
+		CHECK(builder.GetNumSkipped() == 2);
+		CHECK(ReadFile(output / "sub" / "B.out") == "b!");
+		CHECK(ReadFile(output / "sub" / "copied.dat") == "data");
+
+		// A full rebuild ignores the cache.
+		REQUIRE(builder.Build(workspace.string(), output.string(), 4, true));
+		CHECK(builder.GetNumBuilt() == 4);
+
+		// So does removing the output folder.
+		fs::remove_all(output);
+		REQUIRE(builder.Build(workspace.string(), output.string(), 4));
+		CHECK(builder.GetNumBuilt() == 4);
+		CHECK(ReadFile(output / "sub" / "copied.dat") == "data");
+	}
+
+	SECTION("Encoder Upgrade")
+	{
+		REQUIRE(builder.Update(workspace.string(), 4));
+		REQUIRE(builder.Build(workspace.string(), output.string(), 4));
+		CHECK(builder.GetNumBuilt() == 4);
+
+		TextEncoder upgradedEncoder(3);
+		AssetBuilder upgradedBuilder;
+		upgradedBuilder.AddEncoder(".txt", upgradedEncoder);
+		upgradedBuilder.ExcludeExtension(".tmp");
+
+		// The old outputs are not reused, and the metadata must be updated before they can be rebuilt.
+		CHECK_FALSE(upgradedBuilder.Build(workspace.string(), output.string(), 4));
+		CHECK(upgradedBuilder.GetNumSkipped() == 1);
+		CHECK(upgradedBuilder.GetNumFailed() == 3);
+
+		REQUIRE(upgradedBuilder.Update(workspace.string(), 4));
+		REQUIRE(upgradedBuilder.Build(workspace.string(), output.string(), 4));
+		CHECK(upgradedBuilder.GetNumBuilt() == 3);
+		CHECK(upgradedBuilder.GetNumSkipped() == 1);
+		CHECK(upgradedEncoder.numConverted == 3);
+	}
+
+	SECTION("Unknown Outputs")
+	{
+		UnknownOutputEncoder unknownEncoder;
+		AssetBuilder unknownBuilder;
+		unknownBuilder.AddEncoder(".txt", unknownEncoder);
+		unknownBuilder.ExcludeExtension(".tmp");
+
+		REQUIRE(unknownBuilder.Update(workspace.string(), 4));
+		REQUIRE(unknownBuilder.Build(workspace.string(), output.string(), 4));
+		CHECK(unknownBuilder.GetNumBuilt() == 4);
+
+		// Without an extension, the outputs cannot be checked, so only the cache decides.
+		fs::remove(output / "sub" / "B.out");
+		REQUIRE(unknownBuilder.Build(workspace.string(), output.string(), 4));
+		CHECK(unknownBuilder.GetNumBuilt() == 0);
+		CHECK(unknownBuilder.GetNumSkipped() == 4);
+	}
+
+	SECTION("Missing Metadata")
+	{
+		// Encoded files cannot be built until their metadata is created and up to date.
+		CHECK_FALSE(builder.Build(workspace.string(), output.string()));
+		CHECK(builder.GetNumBuilt() == 1);
+		CHECK(builder.GetNumFailed() == 3);
+		CHECK(encoder.numConverted == 0);
+	}
+
+	fs::remove_all("AssetBuilderTest");
+}
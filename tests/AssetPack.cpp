@@ -0,0 +1,271 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Resource/AssetPack.h>
+#include <gemcutter/Utilities/BinaryReader.h>
+#include <gemcutter/Utilities/Compression.h>
+#include <gemcutter/Utilities/Random.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace gem;
+
+namespace
+{
+	std::vector<std::byte> ToBytes(std::string_view text)
+	{
+		auto* begin = reinterpret_cast<const std::byte*>(text.data());
+		return { begin, begin + text.size() };
+	}
+
+	std::vector<std::byte> RoundTrip(const std::vector<std::byte>& data)
+	{
+		std::vector<std::byte> compressed;
+		CompressLZ4(data, compressed);
+
+		std::vector<std::byte> result(data.size());
+		if (!DecompressLZ4(compressed, result))
+		{
+			result.clear();
+		}
+
+		return result;
+	}
+
+	bool Equals(std::span<const std::byte> data, std::string_view text)
+	{
+		return std::ranges::equal(data, ToBytes(text));
+	}
+}
+
+TEST_CASE("Compression")
+{
+	SECTION("Round Trip")
+	{
+		RandomStream random(7);
+
+		std::vector<std::byte> noise(5000);
+		for (auto& value : noise)
+		{
+			value = static_cast<std::byte>(random.Next());
+		}
+
+		std::vector<std::byte> repeating;
+		for (unsigned i = 0; i < 10000; ++i)
+		{
+			repeating.push_back(static_cast<std::byte>(i % 7));
+		}
+
+		std::vector<std::byte> runs(70000, std::byte{ 3 });
+		std::copy(noise.begin(), noise.end(), runs.begin() + 30000);
+
+		CHECK(RoundTrip({}).empty());
+		CHECK(RoundTrip(ToBytes("abc")) == ToBytes("abc"));
+		CHECK(RoundTrip(ToBytes("aaaaaaaaaaaaaaaaaaaaaaaa")) == ToBytes("aaaaaaaaaaaaaaaaaaaaaaaa"));
+		CHECK(RoundTrip(noise) == noise);
+		CHECK(RoundTrip(repeating) == repeating);
+		CHECK(RoundTrip(runs) == runs);
+	}
+
+	SECTION("Ratio")
+	{
+		std::vector<std::byte> repeating;
+		for (unsigned i = 0; i < 10000; ++i)
+		{
+			repeating.push_back(static_cast<std::byte>(i % 7));
+		}
+
+		std::vector<std::byte> compressed;
+		CompressLZ4(repeating, compressed);
+		CHECK(compressed.size() < repeating.size() / 50);
+	}
+
+	SECTION("Malformed")
+	{
+		std::vector<std::byte> data = ToBytes("the quick brown fox jumps over the lazy dog, the quick brown fox");
+		std::vector<std::byte> compressed;
+		CompressLZ4(data, compressed);
+
+		// The wrong size.
+		std::vector<std::byte> small(data.size() - 1);
+		std::vector<std::byte> large(data.size() + 1);
+		CHECK(!DecompressLZ4(compressed, small));
+		CHECK(!DecompressLZ4(compressed, large));
+
+		// Truncated.
+		std::vector<std::byte> result(data.size());
+		CHECK(!DecompressLZ4(std::span(compressed).first(compressed.size() / 2), result));
+
+		// An offset pointing before the start of the output.
+		const std::vector<std::byte> badOffset = { std::byte{ 0x10 }, std::byte{ 'a' }, std::byte{ 0xFF }, std::byte{ 0x00 } };
+		CHECK(!DecompressLZ4(badOffset, result));
+	}
+}
+
+TEST_CASE("BinaryReader")
+{
+	const std::vector<std::byte> data = ToBytes("\x01\x02\x03\x04" "abcdef");
+	BinaryReader reader(data);
+
+	uint32_t value = 0;
+	REQUIRE(reader.Read(value));
+	CHECK(value == 0x04030201);
+	CHECK(reader.GetPosition() == 4);
+
+	std::array<char, 2> chars;
+	REQUIRE(reader.Read(chars));
+	CHECK(chars[0] == 'a');
+	CHECK(chars[1] == 'b');
+
+	std::span<const std::byte> view;
+	REQUIRE(reader.View(3, view));
+	CHECK(view.data() == data.data() + 6);
+	CHECK(Equals(view, "cde"));
+
+	// Reading past the end fails without advancing.
+	CHECK(!reader.Read(value));
+	CHECK(!reader.View(2, view));
+	CHECK(!reader.Skip(2));
+	CHECK(reader.GetRemaining() == 1);
+	CHECK(!reader.IsAtEnd());
+
+	CHECK(reader.Skip(1));
+	CHECK(reader.IsAtEnd());
+}
+
+TEST_CASE("AssetPack")
+{
+	std::string compressible;
+	for (unsigned i = 0; i < 200; ++i)
+	{
+		compressible += "compressible ";
+	}
+
+	AssetPackWriter writer(64);
+	REQUIRE(writer.Add("Models/Cube.model", ToBytes("cube data")));
+	REQUIRE(writer.Add("textures\\Grass.texture", ToBytes("grass data")));
+	REQUIRE(writer.Add("./sounds/long.sound", ToBytes(compressible), AssetCompression::LZ4));
+	REQUIRE(writer.Add("fonts/tiny.font", ToBytes("x"), AssetCompression::LZ4));
+	REQUIRE(writer.Add("empty.model", {}));
+	CHECK(!writer.Add("MODELS/cube.model", ToBytes("duplicate")));
+	CHECK(writer.GetNumEntries() == 5);
+	REQUIRE(writer.Save("AssetPackTest.pack"));
+
+	SECTION("Table of Contents")
+	{
+		AssetPack pack;
+		REQUIRE(pack.Open("AssetPackTest.pack"));
+		REQUIRE(pack.GetEntries().size() == 5);
+		CHECK(std::ranges::is_sorted(pack.GetEntries(), {}, &AssetPackEntry::hash));
+
+		for (const AssetPackEntry& entry : pack.GetEntries())
+		{
+			CHECK(entry.offset % 64 == 0);
+			CHECK(entry.hash == HashAssetPath(pack.GetPath(entry)));
+		}
+
+		const AssetPackEntry* cube = pack.Find("models\\CUBE.model");
+		REQUIRE(cube);
+		CHECK(pack.GetPath(*cube) == "models/cube.model");
+		CHECK(Equals(pack.GetPayload(*cube), "cube data"));
+
+		CHECK(pack.Find("./Textures/grass.texture"));
+		CHECK(pack.Find("sounds/long.sound"));
+		CHECK(!pack.Find("models/sphere.model"));
+		CHECK(!pack.Find("cube.model"));
+
+		const AssetPackEntry* sound = pack.Find("sounds/long.sound");
+		REQUIRE(sound);
+		CHECK(sound->compression == AssetCompression::LZ4);
+		CHECK(sound->size < sound->originalSize);
+
+		std::span<const std::byte> contents;
+		std::vector<std::byte> storage;
+		REQUIRE(pack.Read(*sound, contents, storage));
+		CHECK(Equals(contents, compressible));
+
+		// Compression is skipped when it doesn't help.
+		const AssetPackEntry* font = pack.Find("fonts/tiny.font");
+		REQUIRE(font);
+		CHECK(font->compression == AssetCompression::None);
+
+		pack.Close();
+		CHECK(!pack.IsOpen());
+		CHECK(!pack.Find("models/cube.model"));
+	}
+
+	SECTION("AssetFile")
+	{
+		std::ofstream("AssetPackTest.model") << "loose data";
+
+		REQUIRE(MountAssetPack("AssetPackTest.pack"));
+
+		AssetFile file;
+		REQUIRE(file.Open("models/cube.model"));
+		CHECK(file.IsMapped());
+		CHECK(Equals(file.GetData(), "cube data"));
+
+		REQUIRE(file.Open("sounds/long.sound"));
+		CHECK(!file.IsMapped());
+		CHECK(Equals(file.GetData(), compressible));
+
+		REQUIRE(file.Open("empty.model"));
+		CHECK(file.GetData().empty());
+
+		// Files which aren't packed are read from the disk.
+		REQUIRE(file.Open("AssetPackTest.model"));
+		CHECK(!file.IsMapped());
+		CHECK(Equals(file.GetData(), "loose data"));
+
+		CHECK(!file.Open("models/sphere.model"));
+		CHECK(!file.IsOpen());
+
+		// Open files keep their pack alive after it is unmounted.
+		REQUIRE(file.Open("models/cube.model"));
+		REQUIRE(UnmountAssetPack("AssetPackTest.pack"));
+		CHECK(Equals(file.GetData(), "cube data"));
+		file.Close();
+
+		CHECK(!file.Open("models/cube.model"));
+		CHECK(!UnmountAssetPack("AssetPackTest.pack"));
+
+		std::remove("AssetPackTest.model");
+	}
+
+	SECTION("Mount Priority")
+	{
+		AssetPackWriter patch;
+		REQUIRE(patch.Add("models/cube.model", ToBytes("patched cube")));
+		REQUIRE(patch.Save("AssetPackTest.patch.pack"));
+
+		REQUIRE(MountAssetPack("AssetPackTest.pack"));
+		REQUIRE(MountAssetPack("AssetPackTest.patch.pack"));
+
+		AssetFile file;
+		REQUIRE(file.Open("models/cube.model"));
+		CHECK(Equals(file.GetData(), "patched cube"));
+		REQUIRE(file.Open("textures/grass.texture"));
+		CHECK(Equals(file.GetData(), "grass data"));
+
+		UnmountAllAssetPacks();
+		file.Close();
+		std::remove("AssetPackTest.patch.pack");
+	}
+
+	SECTION("Invalid")
+	{
+		std::ofstream("AssetPackTest.bad", std::ios::binary) << "not a pack, just some text";
+
+		AssetPack pack;
+		CHECK(!pack.Open("AssetPackTest.bad"));
+		CHECK(!pack.Open("AssetPackTest.missing"));
+		CHECK(!pack.IsOpen());
+
+		std::remove("AssetPackTest.bad");
+	}
+
+	std::remove("AssetPackTest.pack");
+}
@@ -0,0 +1,81 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Math/Math.h>
+#include <gemcutter/Math/Matrix.h>
+#include <gemcutter/Rendering/DebugDraw.h>
+
+using namespace gem;
+
+TEST_CASE("DebugDraw")
+{
+	DebugDrawList list;
+	const vec4 red(1.0f, 0.0f, 0.0f, 1.0f);
+
+	SECTION("Batching")
+	{
+		CHECK(list.IsEmpty());
+
+		list.AddLine(vec3(0.0f), vec3(1.0f), red);
+		list.AddLine(vec3(0.0f), vec3(2.0f), red, 0.0f, DebugDepth::Overlay);
+		list.AddTriangle(vec3(0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), red);
+		list.AddBox(vec3(-1.0f), vec3(1.0f), red);
+		list.AddSphere(vec3(0.0f), 2.0f, red);
+		CHECK_FALSE(list.IsEmpty());
+
+		// Each shape is made of lines, and each line is two vertices.
+		CHECK(list.GetLineVertices(DebugDepth::Tested).size() == (1 + 12 + DebugDrawList::SphereSegments * 3) * 2);
+		CHECK(list.GetLineVertices(DebugDepth::Overlay).size() == 2);
+		CHECK(list.GetTriangleVertices(DebugDepth::Tested).size() == 3);
+		CHECK(list.GetTriangleVertices(DebugDepth::Overlay).empty());
+
+		const DebugVertex& vertex = list.GetLineVertices(DebugDepth::Overlay)[1];
+		CHECK(vertex.position == vec3(2.0f));
+		CHECK(vertex.color[0] == 0xFFFF);
+		CHECK(vertex.color[1] == 0);
+
+		list.Clear();
+		CHECK(list.IsEmpty());
+	}
+
+	SECTION("Lifetimes")
+	{
+		list.AddLine(vec3(0.0f), vec3(1.0f), red);
+		list.AddLine(vec3(0.0f), vec3(2.0f), red, 1.0f);
+		list.AddLine(vec3(0.0f), vec3(3.0f), red, 0.5f);
+
+		// Single-frame primitives are only removed once they have been rendered.
+		list.Update(0.25f);
+		CHECK(list.GetLineVertices(DebugDepth::Tested).size() == 6);
+
+		list.EndFrame();
+		CHECK(list.GetLineVertices(DebugDepth::Tested).size() == 4);
+		CHECK(list.GetLineVertices(DebugDepth::Tested)[1].position == vec3(2.0f));
+
+		list.Update(0.25f);
+		CHECK(list.GetLineVertices(DebugDepth::Tested).size() == 2);
+		CHECK(list.GetLineVertices(DebugDepth::Tested)[1].position == vec3(2.0f));
+
+		// Timed primitives survive the end of the frame.
+		list.EndFrame();
+		CHECK(list.GetLineVertices(DebugDepth::Tested).size() == 2);
+
+		list.Update(0.5f);
+		CHECK(list.IsEmpty());
+	}
+
+	SECTION("Frustum")
+	{
+		const mat4 viewProj = mat4::OrthographicProjection(-2.0f, 2.0f, 3.0f, -3.0f, 1.0f, 5.0f);
+		list.AddFrustum(viewProj.GetInverse(), red);
+
+		const auto& vertices = list.GetLineVertices(DebugDepth::Tested);
+		REQUIRE(vertices.size() == 24);
+
+		// The volume's corners are recovered from the normalized device coordinates.
+		for (const DebugVertex& vertex : vertices)
+		{
+			CHECK(Equals(Abs(vertex.position.x), 2.0f, 0.001f));
+			CHECK(Equals(Abs(vertex.position.y), 3.0f, 0.001f));
+			CHECK((Equals(vertex.position.z, -1.0f, 0.001f) || Equals(vertex.position.z, -5.0f, 0.001f)));
+		}
+	}
+}
@@ -0,0 +1,68 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Rendering/FrameRing.h>
+#include "MockFence.h"
+
+using namespace gem;
+
+TEST_CASE("FrameRing")
+{
+	MockFence::Reset();
+	FrameRing<MockFence> ring;
+
+	SECTION("Initial State")
+	{
+		CHECK(ring.RegionCount == 3);
+		CHECK(ring.GetCurrentRegion() == 0);
+		CHECK(!ring.GetFence(0).pending);
+		CHECK(MockFence::callLog.empty());
+	}
+
+	SECTION("Region Cycling")
+	{
+		ring.Advance();
+		CHECK(ring.GetCurrentRegion() == 0);
+
+		ring.Advance();
+		CHECK(ring.GetCurrentRegion() == 1);
+
+		ring.Advance();
+		CHECK(ring.GetCurrentRegion() == 2);
+
+		ring.Advance();
+		CHECK(ring.GetCurrentRegion() == 0);
+	}
+
+	SECTION("Synchronization Order")
+	{
+		// The first region is never fenced before it is used.
+		ring.Advance();
+		CHECK(MockFence::callLog == "W0");
+
+		// The previous region is fenced before we wait on the next one.
+		ring.Advance();
+		ring.Advance();
+		CHECK(MockFence::callLog == "W0I0W1I1W2");
+
+		CHECK(ring.GetFence(0).pending);
+		CHECK(ring.GetFence(1).pending);
+		CHECK(!ring.GetFence(2).pending);
+
+		// Wrapping around must wait on the oldest region before it can be rewritten.
+		ring.Advance();
+		CHECK(MockFence::callLog == "W0I0W1I1W2I2W0");
+		CHECK(!ring.GetFence(0).pending);
+		CHECK(ring.GetFence(1).pending);
+		CHECK(ring.GetFence(2).pending);
+	}
+
+	SECTION("Double Buffering")
+	{
+		FrameRing<MockFence, 2> doubleRing;
+		CHECK(doubleRing.RegionCount == 2);
+
+		doubleRing.Advance();
+		doubleRing.Advance();
+		doubleRing.Advance();
+		CHECK(doubleRing.GetCurrentRegion() == 0);
+	}
+}
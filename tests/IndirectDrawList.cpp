@@ -0,0 +1,96 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Rendering/IndirectDrawList.h>
+
+using namespace gem;
+
+namespace
+{
+	// Tags each draw so that its position can be tracked after sorting.
+	IndirectDrawData MakeData(float tag)
+	{
+		IndirectDrawData data;
+		data.model[12] = tag;
+
+		return data;
+	}
+
+	DrawElementsIndirectCommand MakeCommand(unsigned firstIndex)
+	{
+		return { .count = 3, .firstIndex = firstIndex };
+	}
+}
+
+TEST_CASE("IndirectDrawList")
+{
+	IndirectDrawList list;
+
+	SECTION("Empty")
+	{
+		list.Build();
+
+		CHECK(list.GetNumDraws() == 0);
+		CHECK(list.GetCommands().empty());
+		CHECK(list.GetBatches().empty());
+	}
+
+	SECTION("Batching")
+	{
+		list.Add(1, 0, MakeCommand(0), MakeData(0.0f));
+		list.Add(0, 1, MakeCommand(3), MakeData(1.0f));
+		list.Add(0, 0, MakeCommand(6), MakeData(2.0f));
+		list.Add(1, 0, MakeCommand(9), MakeData(3.0f));
+		list.Add(0, 1, MakeCommand(12), MakeData(4.0f));
+		list.Build();
+
+		auto batches = list.GetBatches();
+		REQUIRE(batches.size() == 3);
+
+		CHECK(batches[0].group == 0);
+		CHECK(batches[0].pool == 0);
+		CHECK(batches[0].firstCommand == 0);
+		CHECK(batches[0].numCommands == 1);
+
+		CHECK(batches[1].group == 0);
+		CHECK(batches[1].pool == 1);
+		CHECK(batches[1].firstCommand == 1);
+		CHECK(batches[1].numCommands == 2);
+
+		CHECK(batches[2].group == 1);
+		CHECK(batches[2].pool == 0);
+		CHECK(batches[2].firstCommand == 3);
+		CHECK(batches[2].numCommands == 2);
+
+		// Draws keep their relative order within a batch, and their data stays with their command.
+		auto commands = list.GetCommands();
+		auto data = list.GetDrawData();
+		REQUIRE(commands.size() == 5);
+		REQUIRE(data.size() == 5);
+
+		const unsigned expectedIndices[] = { 6, 3, 12, 0, 9 };
+		const float expectedTags[] = { 2.0f, 1.0f, 4.0f, 0.0f, 3.0f };
+		for (unsigned i = 0; i < 5; ++i)
+		{
+			CHECK(commands[i].firstIndex == expectedIndices[i]);
+			CHECK(commands[i].instanceCount == 1);
+			CHECK(data[i].model[12] == expectedTags[i]);
+		}
+	}
+
+	SECTION("Clear")
+	{
+		list.Add(0, 0, MakeCommand(0), MakeData(0.0f));
+		list.Build();
+		list.Clear();
+
+		CHECK(list.GetNumDraws() == 0);
+		CHECK(list.GetCommands().empty());
+		CHECK(list.GetDrawData().empty());
+		CHECK(list.GetBatches().empty());
+
+		list.Add(2, 3, MakeCommand(0), MakeData(0.0f));
+		list.Build();
+		REQUIRE(list.GetBatches().size() == 1);
+		CHECK(list.GetBatches()[0].group == 2);
+		CHECK(list.GetBatches()[0].pool == 3);
+	}
+}
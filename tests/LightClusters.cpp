@@ -0,0 +1,101 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Math/Matrix.h>
+#include <gemcutter/Rendering/LightClusters.h>
+
+#include <algorithm>
+
+using namespace gem;
+
+TEST_CASE("LightClusters")
+{
+	// A square 90 degree view, so a tile's bounds at a given depth are easy to reason about.
+	const mat4 inverseProjection = mat4::InversePerspectiveProjection(90.0f, 1.0f, 1.0f, 100.0f);
+
+	LightClusters clusters;
+	clusters.SetGrid(4, 4, 8, inverseProjection, 1.0f, 100.0f);
+
+	auto HasLight = [&](unsigned x, unsigned y, unsigned z, uint32_t light) {
+		auto lights = clusters.GetLights(clusters.GetCluster(x, y, z));
+		return std::ranges::find(lights, light) != lights.end();
+	};
+
+	SECTION("Slices")
+	{
+		CHECK(clusters.GetNumClusters() == 128);
+		CHECK(clusters.GetSlice(0.5f) == 0);
+		CHECK(clusters.GetSlice(1.0f) == 0);
+		CHECK(clusters.GetSlice(99.0f) == 7);
+		CHECK(clusters.GetSlice(1000.0f) == 7);
+
+		// Each slice covers the same ratio of depths.
+		CHECK(clusters.GetSlice(3.0f) == 1);
+		CHECK(clusters.GetSlice(10.5f) == 4);
+	}
+
+	SECTION("Point Lights")
+	{
+		clusters.AddPointLight(0, vec3(0.0f, 0.0f, -10.5f), 1.0f);
+		// Behind the camera, and beyond the far plane.
+		clusters.AddPointLight(1, vec3(0.0f, 0.0f, 10.0f), 2.0f);
+		clusters.AddPointLight(2, vec3(0.0f, 0.0f, -150.0f), 2.0f);
+		// In the bottom-left corner of the view.
+		clusters.AddPointLight(3, vec3(-9.0f, -9.0f, -10.5f), 1.0f);
+		clusters.Build();
+
+		const unsigned slice = clusters.GetSlice(10.5f);
+		CHECK(HasLight(1, 1, slice, 0));
+		CHECK(HasLight(2, 2, slice, 0));
+		CHECK_FALSE(HasLight(0, 0, slice, 0));
+		CHECK_FALSE(HasLight(1, 1, 0, 0));
+		CHECK_FALSE(HasLight(1, 1, 7, 0));
+
+		CHECK(HasLight(0, 0, slice, 3));
+		CHECK_FALSE(HasLight(3, 3, slice, 3));
+
+		CHECK(std::ranges::find(clusters.GetIndices(), 1u) == clusters.GetIndices().end());
+		CHECK(std::ranges::find(clusters.GetIndices(), 2u) == clusters.GetIndices().end());
+
+		// A new frame starts empty.
+		clusters.Clear();
+		clusters.Build();
+		CHECK(clusters.GetIndices().empty());
+		CHECK(clusters.GetGrid().size() == 128);
+	}
+
+	SECTION("Spot Lights")
+	{
+		// A narrow cone from the camera, straight down the view direction.
+		clusters.AddSpotLight(0, vec3(0.0f), vec3(0.0f, 0.0f, -1.0f), 50.0f, 0.99f);
+		// Facing away from the view.
+		clusters.AddSpotLight(1, vec3(0.0f, 0.0f, -2.0f), vec3(0.0f, 0.0f, 1.0f), 50.0f, 0.99f);
+		clusters.Build();
+
+		const unsigned slice = clusters.GetSlice(30.0f);
+		CHECK(HasLight(1, 1, slice, 0));
+		CHECK(HasLight(2, 2, slice, 0));
+		CHECK_FALSE(HasLight(0, 0, slice, 0));
+		CHECK_FALSE(HasLight(3, 0, slice, 0));
+
+		CHECK_FALSE(HasLight(1, 1, slice, 1));
+		CHECK_FALSE(HasLight(1, 1, 7, 1));
+	}
+
+	SECTION("Packing")
+	{
+		for (unsigned i = 0; i < LightClusters::MaxLightsPerCluster + 10; ++i)
+		{
+			clusters.AddPointLight(i, vec3(0.0f, 0.0f, -10.5f), 0.5f);
+		}
+		clusters.Build();
+
+		const unsigned cluster = clusters.GetCluster(1, 1, clusters.GetSlice(10.5f));
+		auto lights = clusters.GetLights(cluster);
+		REQUIRE(lights.size() == LightClusters::MaxLightsPerCluster);
+		CHECK(std::ranges::is_sorted(lights));
+		CHECK(lights.front() == 0);
+
+		const uint32_t entry = clusters.GetGrid()[cluster];
+		CHECK((entry & 0xFF) == LightClusters::MaxLightsPerCluster);
+		CHECK(clusters.GetIndices()[(entry >> 8) + 1] == 1);
+	}
+}
@@ -0,0 +1,198 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Resource/MeshOptimizer.h>
+#include <gemcutter/Utilities/Random.h>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using namespace gem;
+
+namespace
+{
+	// A flat grid of 'size' by 'size' quads on the XY plane.
+	struct Grid
+	{
+		Grid(unsigned size)
+		{
+			for (unsigned y = 0; y <= size; ++y)
+			{
+				for (unsigned x = 0; x <= size; ++x)
+				{
+					positions.emplace_back(static_cast<float>(x), static_cast<float>(y), 0.0f);
+				}
+			}
+
+			for (unsigned y = 0; y < size; ++y)
+			{
+				for (unsigned x = 0; x < size; ++x)
+				{
+					const unsigned corner = y * (size + 1) + x;
+					indices.insert(indices.end(), { corner, corner + 1, corner + size + 2 });
+					indices.insert(indices.end(), { corner, corner + size + 2, corner + size + 1 });
+				}
+			}
+		}
+
+		unsigned GetNumVertices() const { return static_cast<unsigned>(positions.size()); }
+
+		std::vector<vec3> positions;
+		std::vector<unsigned> indices;
+	};
+
+	// Returns the triangles in a canonical order, with each one rotated to start from its smallest index.
+	// This allows the content of two meshes to be compared, including the winding order of the triangles.
+	std::vector<std::array<unsigned, 3>> GetTriangles(const std::vector<unsigned>& indices)
+	{
+		std::vector<std::array<unsigned, 3>> triangles;
+		for (unsigned i = 0; i < indices.size(); i += 3)
+		{
+			std::array<unsigned, 3> triangle = { indices[i], indices[i + 1], indices[i + 2] };
+			std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+
+			triangles.push_back(triangle);
+		}
+
+		std::ranges::sort(triangles);
+		return triangles;
+	}
+
+	void ShuffleTriangles(std::vector<unsigned>& indices, uint64_t seed)
+	{
+		RandomStream random(seed);
+
+		const unsigned numTriangles = static_cast<unsigned>(indices.size() / 3);
+		for (unsigned i = numTriangles - 1; i > 0; --i)
+		{
+			const unsigned j = random.Next() % (i + 1);
+			std::swap_ranges(indices.begin() + i * 3, indices.begin() + i * 3 + 3, indices.begin() + j * 3);
+		}
+	}
+}
+
+TEST_CASE("MeshOptimizer")
+{
+	SECTION("Deduplicate Vertices")
+	{
+		const Grid grid(8);
+
+		// Expand the grid into a list of unindexed vertices, each with a position and a tag.
+		struct Vertex
+		{
+			vec3 position;
+			float tag;
+		};
+
+		std::vector<Vertex> unindexed;
+		for (unsigned index : grid.indices)
+		{
+			unindexed.push_back({ grid.positions[index], 1.0f });
+		}
+
+		// The same position with a different attribute is a unique vertex.
+		unindexed.back().tag = 2.0f;
+
+		std::vector<std::byte> vertices;
+		std::vector<unsigned> indices;
+		const unsigned numVertices = DeduplicateVertices(std::as_bytes(std::span(unindexed)), sizeof(Vertex), vertices, indices);
+
+		CHECK(numVertices == grid.GetNumVertices() + 1);
+		CHECK(vertices.size() == numVertices * sizeof(Vertex));
+		REQUIRE(indices.size() == unindexed.size());
+
+		const auto* unique = reinterpret_cast<const Vertex*>(vertices.data());
+		for (unsigned i = 0; i < indices.size(); ++i)
+		{
+			REQUIRE(indices[i] < numVertices);
+			CHECK(unique[indices[i]].position == unindexed[i].position);
+			CHECK(unique[indices[i]].tag == unindexed[i].tag);
+		}
+	}
+
+	SECTION("Vertex Cache")
+	{
+		Grid grid(32);
+		ShuffleTriangles(grid.indices, 3);
+
+		const auto triangles = GetTriangles(grid.indices);
+		const float shuffledACMR = CalculateACMR(grid.indices, grid.GetNumVertices());
+
+		OptimizeVertexCache(grid.indices, grid.GetNumVertices());
+		const float optimizedACMR = CalculateACMR(grid.indices, grid.GetNumVertices());
+
+		CHECK(GetTriangles(grid.indices) == triangles);
+		CHECK(shuffledACMR > 2.0f);
+		CHECK(optimizedACMR < 0.8f);
+	}
+
+	SECTION("Overdraw")
+	{
+		// Two separate patches, each facing the -z direction.
+		// The one at z = -1 faces away from the center, so it should be drawn first.
+		Grid inner(4);
+		Grid outer(4);
+		for (vec3& position : inner.positions)
+		{
+			position.z = 1.0f;
+		}
+		for (vec3& position : outer.positions)
+		{
+			position.z = -1.0f;
+		}
+
+		std::vector<vec3> positions = inner.positions;
+		positions.insert(positions.end(), outer.positions.begin(), outer.positions.end());
+
+		// Flip the winding, so that the patches face -z.
+		std::vector<unsigned> indices;
+		for (unsigned i = 0; i < inner.indices.size(); i += 3)
+		{
+			indices.insert(indices.end(), { inner.indices[i], inner.indices[i + 2], inner.indices[i + 1] });
+		}
+		for (unsigned i = 0; i < outer.indices.size(); i += 3)
+		{
+			const unsigned offset = inner.GetNumVertices();
+			indices.insert(indices.end(), { outer.indices[i] + offset, outer.indices[i + 2] + offset, outer.indices[i + 1] + offset });
+		}
+
+		const unsigned numVertices = static_cast<unsigned>(positions.size());
+		OptimizeVertexCache(indices, numVertices);
+
+		const auto triangles = GetTriangles(indices);
+		const float cacheACMR = CalculateACMR(indices, numVertices);
+
+		OptimizeOverdraw(indices, positions, 1.05f);
+
+		CHECK(GetTriangles(indices) == triangles);
+		CHECK(positions[indices[0]].z == -1.0f);
+		CHECK(positions[indices.back()].z == 1.0f);
+		CHECK(CalculateACMR(indices, numVertices) <= cacheACMR * 1.05f + 0.01f);
+	}
+
+	SECTION("Vertex Fetch")
+	{
+		std::vector<std::byte> vertices = { std::byte{ 10 }, std::byte{ 11 }, std::byte{ 12 }, std::byte{ 13 }, std::byte{ 14 } };
+		std::vector<unsigned> indices = { 3, 1, 4, 4, 1, 0 };
+
+		CHECK(OptimizeVertexFetch(indices, vertices, 1) == 4);
+		CHECK(indices == std::vector<unsigned>{ 0, 1, 2, 2, 1, 3 });
+		CHECK(vertices == std::vector<std::byte>{ std::byte{ 13 }, std::byte{ 11 }, std::byte{ 14 }, std::byte{ 10 } });
+	}
+
+	SECTION("ACMR")
+	{
+		CHECK(CalculateACMR({}, 0) == 0.0f);
+
+		const std::vector<unsigned> triangle = { 0, 1, 2 };
+		CHECK(CalculateACMR(triangle, 3) == 3.0f);
+
+		// Repeating a triangle is free while its vertices are cached.
+		const std::vector<unsigned> repeated = { 0, 1, 2, 2, 1, 0 };
+		CHECK(CalculateACMR(repeated, 3) == 1.5f);
+
+		// Unless the cache is too small to hold them.
+		const std::vector<unsigned> quad = { 0, 1, 2, 0, 2, 3 };
+		CHECK(CalculateACMR(quad, 4, 16) == 2.0f);
+		CHECK(CalculateACMR(quad, 4, 1) == 3.0f);
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+
+// Stands in for a gem::Fence in the tests of the GPU ring buffers.
+// Records the synchronization calls made by the ring instead of talking to the GPU.
+struct MockFence
+{
+	// Fences are labeled in the order they are created, so the log shows which frame each call is made on.
+	static inline std::string callLog;
+	static inline unsigned nextIndex = 0;
+	// Decides whether the GPU has caught up to the fences.
+	static inline bool isGpuFinished = false;
+
+	// Should be called at the start of each test.
+	static void Reset()
+	{
+		callLog.clear();
+		nextIndex = 0;
+		isGpuFinished = false;
+	}
+
+	void Insert() { callLog += "I" + std::to_string(index); pending = true; }
+	void Wait()   { callLog += "W" + std::to_string(index); pending = false; }
+	void Clear()  { pending = false; }
+	bool IsSignalled() const { return !pending || isGpuFinished; }
+
+	unsigned index = nextIndex++;
+	bool pending = false;
+};
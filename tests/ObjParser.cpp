@@ -0,0 +1,260 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Resource/ObjParser.h>
+
+#include <charconv>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace gem;
+
+namespace
+{
+	void Append(std::string& text, auto value)
+	{
+		char buffer[32];
+		const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+		text.append(buffer, result.ptr);
+	}
+
+	// An OBJ file for a flat grid of 'size' by 'size' quads, each split into two triangles.
+	// Faces can refer to their vertices with either absolute or relative indices.
+	std::string GenerateGrid(unsigned size, bool relative = false)
+	{
+		const unsigned numVertices = (size + 1) * (size + 1);
+
+		std::string text = "# Grid\n";
+		text.reserve(numVertices * 64 + size * size * 96);
+
+		for (unsigned y = 0; y <= size; ++y)
+		{
+			for (unsigned x = 0; x <= size; ++x)
+			{
+				const float u = static_cast<float>(x) / size;
+				const float v = static_cast<float>(y) / size;
+
+				text += "v ";
+				Append(text, u * 10.0f);
+				text += ' ';
+				Append(text, v * -10.0f);
+				text += " 0.5\nvt ";
+				Append(text, u);
+				text += ' ';
+				Append(text, v);
+				text += "\nvn 0 0 1\n";
+			}
+		}
+
+		auto appendCorner = [&](unsigned index) {
+			const int value = relative
+				? static_cast<int>(index) - static_cast<int>(numVertices)
+				: static_cast<int>(index) + 1;
+
+			text += ' ';
+			Append(text, value);
+			text += '/';
+			Append(text, value);
+			text += '/';
+			Append(text, value);
+		};
+
+		for (unsigned y = 0; y < size; ++y)
+		{
+			for (unsigned x = 0; x < size; ++x)
+			{
+				const unsigned corner = y * (size + 1) + x;
+
+				text += 'f';
+				appendCorner(corner);
+				appendCorner(corner + 1);
+				appendCorner(corner + size + 2);
+				text += "\nf";
+				appendCorner(corner);
+				appendCorner(corner + size + 2);
+				appendCorner(corner + size + 1);
+				text += '\n';
+			}
+		}
+
+		return text;
+	}
+
+	bool Equals(const ObjCorner& a, const ObjCorner& b)
+	{
+		return a.position == b.position && a.uv == b.uv && a.normal == b.normal;
+	}
+}
+
+TEST_CASE("ObjParser")
+{
+	SECTION("Statements")
+	{
+		const std::string_view text =
+			"# A comment\r\n"
+			"o Shape\r\n"
+			"mtllib shape.mtl\r\n"
+			"v 1.0 -2.5 3e2\r\n"
+			"  v\t+4 5 6 1.0\r\n"
+			"v 7 8 9# Trailing comment\r\n"
+			"vt 0.25 0.75\r\n"
+			"vt 0.5 # Trailing comment\r\n"
+			"vn 0 1 0\r\n"
+			"s off\r\n"
+			"f 1/1/1 2/2/1 3/1/1 # Trailing comment\r\n"
+			"f 3 2 1#Trailing comment";
+
+		ObjMesh mesh;
+		REQUIRE(ParseObj(text, mesh));
+
+		REQUIRE(mesh.positions.size() == 3);
+		CHECK(mesh.positions[0] == vec3(1.0f, -2.5f, 300.0f));
+		CHECK(mesh.positions[1] == vec3(4.0f, 5.0f, 6.0f));
+		CHECK(mesh.positions[2] == vec3(7.0f, 8.0f, 9.0f));
+
+		REQUIRE(mesh.uvs.size() == 2);
+		CHECK(mesh.uvs[0] == vec2(0.25f, 0.75f));
+		CHECK(mesh.uvs[1] == vec2(0.5f, 0.0f));
+
+		REQUIRE(mesh.normals.size() == 1);
+		CHECK(mesh.normals[0] == vec3(0.0f, 1.0f, 0.0f));
+
+		REQUIRE(mesh.corners.size() == 6);
+		CHECK(Equals(mesh.corners[0], { 0, 0, 0 }));
+		CHECK(Equals(mesh.corners[1], { 1, 1, 0 }));
+		CHECK(Equals(mesh.corners[2], { 2, 0, 0 }));
+		CHECK(Equals(mesh.corners[3], { 2, ObjCorner::None, ObjCorner::None }));
+		CHECK(Equals(mesh.corners[5], { 0, ObjCorner::None, ObjCorner::None }));
+	}
+
+	SECTION("Faces")
+	{
+		const std::string_view text =
+			"v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n"
+			"vt 0 0\nvt 1 1\n"
+			"vn 0 0 1\n"
+			"f 1//1 2//1 3//1\n"
+			"f 1/2 2/1 3/2\n"
+			// Relative indices count back from the most recently defined element.
+			"f -4/-2/-1 -3/-1/-1 -2/-2/-1\n"
+			// Polygons are split into a fan.
+			"f 1 2 3 4\n";
+
+		ObjMesh mesh;
+		REQUIRE(ParseObj(text, mesh));
+		REQUIRE(mesh.corners.size() == 15);
+
+		CHECK(Equals(mesh.corners[0], { 0, ObjCorner::None, 0 }));
+		CHECK(Equals(mesh.corners[4], { 1, 0, ObjCorner::None }));
+		CHECK(Equals(mesh.corners[6], { 0, 0, 0 }));
+		CHECK(Equals(mesh.corners[7], { 1, 1, 0 }));
+		CHECK(Equals(mesh.corners[8], { 2, 0, 0 }));
+
+		for (unsigned i = 9; i < 15; ++i)
+		{
+			CHECK(mesh.corners[i].uv == ObjCorner::None);
+		}
+		CHECK(mesh.corners[9].position == 0);
+		CHECK(mesh.corners[10].position == 1);
+		CHECK(mesh.corners[11].position == 2);
+		CHECK(mesh.corners[12].position == 0);
+		CHECK(mesh.corners[13].position == 2);
+		CHECK(mesh.corners[14].position == 3);
+	}
+
+	SECTION("Errors")
+	{
+		ObjMesh mesh;
+		CHECK(ParseObj("", mesh));
+		CHECK(mesh.positions.empty());
+		CHECK(mesh.corners.empty());
+
+		const char* invalid[] = {
+			"v 1 2\n",
+			"v 1 2 x\n",
+			"vn 0 1\n",
+			"vt x\n",
+			"v 0 0 0\nf 1 1\n",
+			"v 0 0 0\nf 1 1 2\n",
+			"v 0 0 0\nf 0 1 1\n",
+			"v 0 0 0\nf 1 1 -2\n",
+			"v 0 0 0\nf 1/1 1 1\n",
+			"v 0 0 0\nf 1/ 1 1\n",
+			"v 0 0 0\nvn 0 0 1\nf 1//1 1//1 1//\n",
+			"v 0 0 0\nf 1 1 1a\n"
+		};
+
+		for (const char* text : invalid)
+		{
+			INFO(text);
+			CHECK_FALSE(ParseObj(text, mesh));
+			CHECK(mesh.positions.empty());
+		}
+	}
+
+	SECTION("Chunks")
+	{
+		// Large enough to be split into many chunks. Relative indices refer to vertices in earlier chunks.
+		for (bool relative : { false, true })
+		{
+			const std::string text = GenerateGrid(200, relative);
+
+			ObjMesh serial;
+			ObjMesh parallel;
+			REQUIRE(ParseObj(text, serial, 1));
+			REQUIRE(ParseObj(text, parallel, 8));
+
+			CHECK(serial.positions.size() == 201 * 201);
+			CHECK(serial.corners.size() == 200 * 200 * 6);
+			CHECK(serial.positions == parallel.positions);
+			CHECK(serial.uvs == parallel.uvs);
+			CHECK(serial.normals == parallel.normals);
+			REQUIRE(serial.corners.size() == parallel.corners.size());
+
+			bool isEqual = true;
+			for (size_t i = 0; i < serial.corners.size(); ++i)
+			{
+				isEqual &= Equals(serial.corners[i], parallel.corners[i]);
+			}
+			CHECK(isEqual);
+
+			CHECK(Equals(parallel.corners.back(), { 40399, 40399, 40399 }));
+		}
+	}
+
+	SECTION("File")
+	{
+		std::ofstream("ObjParserTest.obj") << GenerateGrid(4);
+
+		ObjMesh mesh;
+		CHECK(LoadObj("ObjParserTest.obj", mesh));
+		CHECK(mesh.positions.size() == 25);
+		CHECK(mesh.corners.size() == 96);
+
+		std::ofstream("ObjParserTest.obj");
+		CHECK(LoadObj("ObjParserTest.obj", mesh));
+		CHECK(mesh.corners.empty());
+
+		CHECK_FALSE(LoadObj("ObjParserTest.missing", mesh));
+
+		std::remove("ObjParserTest.obj");
+	}
+}
+
+TEST_CASE("ObjParser Benchmark", "[!benchmark]")
+{
+	// 10 million triangles.
+	const std::string text = GenerateGrid(2237);
+	ObjMesh mesh;
+
+	BENCHMARK("Parse 10M Faces (1 thread)")
+	{
+		ParseObj(text, mesh, 1);
+		return mesh.corners.size();
+	};
+
+	BENCHMARK("Parse 10M Faces")
+	{
+		ParseObj(text, mesh);
+		return mesh.corners.size();
+	};
+}
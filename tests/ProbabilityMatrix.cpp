@@ -0,0 +1,232 @@
+#include <catch/catch.hpp>
+#include <gemcutter/AI/ProbabilityMatrix.h>
+#include <gemcutter/Math/Math.h>
+#include <gemcutter/Utilities/Random.h>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+using namespace gem;
+
+namespace
+{
+	// The original cumulative-sum query, kept as a baseline for the benchmark.
+	unsigned QueryCumulative(const ProbabilityMatrix& matrix, unsigned state, RandomStream& stream)
+	{
+		const float randomVal = stream.Range(0.0f, 1.0f);
+		const unsigned numActions = matrix.GetNumActions();
+
+		float sum = 0.0f;
+		for (unsigned i = 0; i < numActions; ++i)
+		{
+			sum += matrix.GetValue(state, i);
+			if (randomVal <= sum)
+			{
+				return i;
+			}
+		}
+
+		return numActions - 1;
+	}
+}
+
+TEST_CASE("ProbabilityMatrix")
+{
+	ProbabilityMatrix matrix(3, 4);
+
+	SECTION("Normalization")
+	{
+		CHECK(Equals(matrix.GetValue(0, 0), 0.25f));
+
+		matrix.ReinforceLinear(1, 2, 1.0f);
+		CHECK(Equals(matrix.GetValue(1, 2), 1.25f / 2.0f));
+		CHECK(Equals(matrix.GetValue(1, 0), 0.25f / 2.0f));
+
+		// Other states are not affected.
+		CHECK(Equals(matrix.GetValue(0, 2), 0.25f));
+		CHECK(Equals(matrix.GetValue(2, 2), 0.25f));
+
+		// Reinforcing every action to zero restores a uniform distribution.
+		matrix.ReinforceBatch(std::array<Reinforcement, 4> {{
+			{ .state = 2, .action = 0, .scale = 0.0f },
+			{ .state = 2, .action = 1, .scale = 0.0f },
+			{ .state = 2, .action = 2, .scale = 0.0f },
+			{ .state = 2, .action = 3, .scale = 0.0f }
+		}});
+		CHECK(Equals(matrix.GetValue(2, 3), 0.25f));
+	}
+
+	SECTION("Batch Reinforcement")
+	{
+		ProbabilityMatrix sequential(3, 4);
+		sequential.ReinforceLinear(0, 1, 0.5f);
+		sequential.ReinforceLinear(2, 3, -0.1f);
+
+		matrix.ReinforceBatch(std::array<Reinforcement, 2> {{
+			{ .state = 0, .action = 1, .offset = 0.5f },
+			{ .state = 2, .action = 3, .offset = -0.1f }
+		}});
+
+		for (unsigned state = 0; state < 3; ++state)
+		{
+			for (unsigned action = 0; action < 4; ++action)
+			{
+				CHECK(Equals(matrix.GetValue(state, action), sequential.GetValue(state, action)));
+			}
+		}
+	}
+
+	SECTION("Sampling Distribution")
+	{
+		// Shape state 0 into [0.1, 0.2, 0.3, 0.4], and make action 0 of state 1 impossible.
+		matrix.ReinforceBatch(std::array<Reinforcement, 5> {{
+			{ .state = 0, .action = 0, .scale = 0.0f, .offset = 0.1f },
+			{ .state = 0, .action = 1, .scale = 0.0f, .offset = 0.2f },
+			{ .state = 0, .action = 2, .scale = 0.0f, .offset = 0.3f },
+			{ .state = 0, .action = 3, .scale = 0.0f, .offset = 0.4f },
+			{ .state = 1, .action = 0, .scale = 0.0f }
+		}});
+
+		RandomStream stream(5);
+		constexpr unsigned numSamples = 100000;
+		std::array<unsigned, 4> counts = {};
+		for (unsigned i = 0; i < numSamples; ++i)
+		{
+			counts[matrix.QueryAction(0, stream)]++;
+			CHECK(matrix.QueryAction(1, stream) != 0);
+		}
+
+		for (unsigned action = 0; action < 4; ++action)
+		{
+			const float frequency = static_cast<float>(counts[action]) / numSamples;
+			CHECK(Equals(frequency, matrix.GetValue(0, action), 0.01f));
+		}
+	}
+
+	SECTION("Batch Queries")
+	{
+		matrix.ReinforceLinear(0, 3, 2.0f);
+		matrix.ReinforceLinear(2, 1, 4.0f);
+
+		// Large enough to be split into several parallel jobs.
+		std::vector<unsigned> states(20000);
+		for (unsigned i = 0; i < states.size(); ++i)
+		{
+			states[i] = i % 3;
+		}
+
+		std::vector<unsigned> actions1(states.size());
+		std::vector<unsigned> actions2(states.size());
+
+		RandomStream stream1(6);
+		RandomStream stream2(6);
+		matrix.QueryActions(states, actions1, stream1);
+		matrix.QueryActions(states, actions2, stream2);
+
+		CHECK(actions1 == actions2);
+		for (unsigned action : actions1)
+		{
+			CHECK(action < 4);
+		}
+	}
+
+	SECTION("Concurrent Queries")
+	{
+		// The queries run on a freshly reinforced state, which must not need any further work.
+		matrix.ReinforceLinear(1, 0, 3.0f);
+
+		constexpr unsigned numThreads = 4;
+		constexpr unsigned numSamples = 1000;
+		std::array<std::vector<unsigned>, numThreads> results;
+
+		std::vector<std::thread> threads;
+		for (unsigned i = 0; i < numThreads; ++i)
+		{
+			threads.emplace_back([&matrix, &results, i] {
+				RandomStream stream(i);
+				for (unsigned j = 0; j < numSamples; ++j)
+				{
+					results[i].push_back(matrix.QueryAction(1, stream));
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+
+		for (unsigned i = 0; i < numThreads; ++i)
+		{
+			RandomStream stream(i);
+			for (unsigned j = 0; j < numSamples; ++j)
+			{
+				CHECK(results[i][j] == static_cast<unsigned>(matrix.QueryAction(1, stream)));
+			}
+		}
+	}
+}
+
+TEST_CASE("ProbabilityMatrix Benchmark", "[!benchmark]")
+{
+	constexpr unsigned numStates = 1000;
+	constexpr unsigned numActions = 64;
+	constexpr unsigned numQueries = 100000;
+
+	ProbabilityMatrix matrix(numStates, numActions);
+	RandomStream stream(7);
+
+	std::vector<Reinforcement> reinforcements(numStates * 8);
+	for (Reinforcement& reinforcement : reinforcements)
+	{
+		reinforcement.state = static_cast<unsigned>(stream.Range(0, numStates - 1));
+		reinforcement.action = static_cast<unsigned>(stream.Range(0, numActions - 1));
+		reinforcement.offset = stream.Range(0.0f, 1.0f);
+	}
+	matrix.ReinforceBatch(reinforcements);
+
+	std::vector<unsigned> states(numQueries);
+	for (unsigned& state : states)
+	{
+		state = static_cast<unsigned>(stream.Range(0, numStates - 1));
+	}
+	std::vector<unsigned> actions(numQueries);
+
+	BENCHMARK("Cumulative QueryAction")
+	{
+		for (unsigned i = 0; i < numQueries; ++i)
+		{
+			actions[i] = QueryCumulative(matrix, states[i], stream);
+		}
+		return actions[0];
+	};
+
+	BENCHMARK("Alias QueryAction")
+	{
+		for (unsigned i = 0; i < numQueries; ++i)
+		{
+			actions[i] = matrix.QueryAction(states[i], stream);
+		}
+		return actions[0];
+	};
+
+	BENCHMARK("Alias QueryActions")
+	{
+		matrix.QueryActions(states, actions, stream);
+		return actions[0];
+	};
+
+	BENCHMARK("ReinforceLinear")
+	{
+		for (const Reinforcement& reinforcement : reinforcements)
+		{
+			matrix.ReinforceLinear(reinforcement.state, reinforcement.action, reinforcement.offset);
+		}
+	};
+
+	BENCHMARK("ReinforceBatch")
+	{
+		matrix.ReinforceBatch(reinforcements);
+	};
+}
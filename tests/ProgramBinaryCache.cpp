@@ -0,0 +1,137 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Application/FileSystem.h>
+#include <gemcutter/Resource/ProgramBinaryCache.h>
+
+#include <filesystem>
+#include <fstream>
+
+using namespace gem;
+
+namespace
+{
+	ProgramBinary MakeBinary(uint32_t format, std::initializer_list<uint8_t> bytes)
+	{
+		ProgramBinary binary;
+		binary.format = format;
+		for (uint8_t byte : bytes)
+		{
+			binary.data.push_back(static_cast<std::byte>(byte));
+		}
+
+		return binary;
+	}
+}
+
+TEST_CASE("ProgramBinaryCache")
+{
+	namespace fs = std::filesystem;
+	fs::remove_all("ProgramBinaryCacheTest");
+
+	ProgramBinaryCache cache;
+	cache.SetDriver("Vendor", "Renderer", "4.6.0 Driver 1.0");
+	cache.SetDirectory("ProgramBinaryCacheTest/programs");
+
+	const std::string_view sources[] = { "#version 460\n", "void main() {}", "", "out vec4 color;" };
+	const uint64_t key = cache.ComputeKey(sources);
+
+	SECTION("Keys")
+	{
+		CHECK(cache.ComputeKey(sources) == key);
+
+		// Any change to the source changes the key, including moving text between stages.
+		const std::string_view modified[] = { "#version 460\n", "void main() { }", "", "out vec4 color;" };
+		const std::string_view moved[] = { "#version 460\nvoid main() {}", "", "", "out vec4 color;" };
+		CHECK(cache.ComputeKey(modified) != key);
+		CHECK(cache.ComputeKey(moved) != key);
+
+		// As does a different driver.
+		ProgramBinaryCache other;
+		other.SetDriver("Vendor", "Renderer", "4.6.0 Driver 1.1");
+		CHECK(other.GetDriverHash() != cache.GetDriverHash());
+		CHECK(other.ComputeKey(sources) != key);
+
+		CHECK(cache.GetDirectory() == "ProgramBinaryCacheTest/programs/");
+		CHECK(cache.GetFilePath(0x1234) == "ProgramBinaryCacheTest/programs/0000000000001234.program");
+	}
+
+	SECTION("Save and Load")
+	{
+		ProgramBinary binary;
+		CHECK_FALSE(cache.Load(key, binary));
+
+		REQUIRE(cache.Save(key, MakeBinary(7, { 1, 2, 3, 4, 5 })));
+		REQUIRE(cache.Load(key, binary));
+		CHECK(binary.format == 7);
+		CHECK(binary.data == MakeBinary(7, { 1, 2, 3, 4, 5 }).data);
+		CHECK_FALSE(FileExists(cache.GetFilePath(key) + ".tmp"));
+
+		// Binaries are overwritten.
+		REQUIRE(cache.Save(key, MakeBinary(8, { 9 })));
+		REQUIRE(cache.Load(key, binary));
+		CHECK(binary.format == 8);
+		CHECK(binary.data.size() == 1);
+
+		// Binaries from other drivers are never loaded, even if the file name matches.
+		ProgramBinaryCache other;
+		other.SetDriver("Vendor", "Renderer", "4.6.0 Driver 1.1");
+		other.SetDirectory(cache.GetDirectory());
+		CHECK_FALSE(other.Load(key, binary));
+
+		cache.Remove(key);
+		CHECK_FALSE(cache.Load(key, binary));
+	}
+
+	SECTION("Validation")
+	{
+		REQUIRE(cache.Save(key, MakeBinary(7, { 1, 2, 3, 4, 5 })));
+		const std::string file = cache.GetFilePath(key);
+		const auto size = fs::file_size(file);
+
+		ProgramBinary binary;
+		SECTION("Corrupted")
+		{
+			std::fstream stream(file, std::ios::in | std::ios::out | std::ios::binary);
+			stream.seekp(static_cast<std::streamoff>(size - 2));
+			stream.put(42);
+			stream.close();
+
+			CHECK_FALSE(cache.Load(key, binary));
+		}
+
+		SECTION("Truncated")
+		{
+			fs::resize_file(file, size - 1);
+			CHECK_FALSE(cache.Load(key, binary));
+		}
+
+		SECTION("Wrong Key")
+		{
+			fs::copy_file(file, cache.GetFilePath(key + 1));
+			CHECK_FALSE(cache.Load(key + 1, binary));
+		}
+	}
+
+	SECTION("Clear")
+	{
+		REQUIRE(cache.Save(1, MakeBinary(1, { 1 })));
+		REQUIRE(cache.Save(2, MakeBinary(1, { 2 })));
+		std::ofstream("ProgramBinaryCacheTest/programs/other.txt") << "not a program";
+
+		CHECK(cache.Clear() == 2);
+		CHECK(FileExists("ProgramBinaryCacheTest/programs/other.txt"));
+
+		ProgramBinary binary;
+		CHECK_FALSE(cache.Load(1, binary));
+	}
+
+	SECTION("Disabled")
+	{
+		cache.SetDirectory("");
+		CHECK_FALSE(cache.IsEnabled());
+		CHECK_FALSE(cache.Save(key, MakeBinary(1, { 1 })));
+		CHECK(cache.Clear() == 0);
+		CHECK_FALSE(fs::exists("ProgramBinaryCacheTest"));
+	}
+
+	fs::remove_all("ProgramBinaryCacheTest");
+}
@@ -0,0 +1,167 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Math/Math.h>
+#include <gemcutter/Math/Quantization.h>
+#include <gemcutter/Utilities/Random.h>
+
+#include <cmath>
+#include <limits>
+
+using namespace gem;
+
+namespace
+{
+	// Returns the angle in degrees. This is more precise than acos() for nearly parallel vectors.
+	float AngleBetween(const vec3& a, const vec3& b)
+	{
+		return ToDegree(std::atan2(Length(Cross(a, b)), Dot(a, b)));
+	}
+}
+
+TEST_CASE("Quantization")
+{
+	RandomStream random(11);
+
+	SECTION("Half")
+	{
+		// Exactly representable values survive a round trip.
+		for (float value : { 0.0f, 1.0f, -1.0f, 0.5f, 2048.0f, -0.125f, 65504.0f })
+		{
+			CHECK(HalfToFloat(FloatToHalf(value)) == value);
+		}
+
+		CHECK(FloatToHalf(1.0f) == 0x3C00);
+		CHECK(FloatToHalf(-2.0f) == 0xC000);
+		CHECK(FloatToHalf(65504.0f) == 0x7BFF);
+
+		// Ties round to the nearest even mantissa.
+		CHECK(FloatToHalf(1.0f + 1.0f / 2048.0f) == 0x3C00);
+		CHECK(FloatToHalf(1.0f + 3.0f / 2048.0f) == 0x3C02);
+
+		// Out of range values.
+		CHECK(FloatToHalf(65520.0f) == 0x7C00);
+		CHECK(FloatToHalf(-1e10f) == 0xFC00);
+		CHECK(std::isinf(HalfToFloat(FloatToHalf(std::numeric_limits<float>::infinity()))));
+		CHECK(std::isnan(HalfToFloat(FloatToHalf(std::numeric_limits<float>::quiet_NaN()))));
+
+		// Subnormals.
+		const float smallest = std::ldexp(1.0f, -24);
+		CHECK(FloatToHalf(smallest) == 0x0001);
+		CHECK(HalfToFloat(0x0001) == smallest);
+		CHECK(HalfToFloat(0x03FF) == std::ldexp(1023.0f, -24));
+		CHECK(FloatToHalf(smallest * 0.25f) == 0x0000);
+
+		// Normal values are within half of a unit in the last place, which is 2^-11 of the value.
+		float maxError = 0.0f;
+		for (unsigned i = 0; i < 10000; ++i)
+		{
+			const float value = random.Range(-1000.0f, 1000.0f);
+			if (std::abs(value) < 0.001f)
+			{
+				continue;
+			}
+
+			const float error = std::abs(HalfToFloat(FloatToHalf(value)) - value) / std::abs(value);
+			maxError = Max(maxError, error);
+		}
+
+		CHECK(maxError <= 1.0f / 2048.0f);
+	}
+
+	SECTION("Normalized Integers")
+	{
+		CHECK(QuantizeSNorm16(1.0f) == 32767);
+		CHECK(QuantizeSNorm16(-1.0f) == -32767);
+		CHECK(QuantizeSNorm16(5.0f) == 32767);
+		CHECK(DequantizeSNorm16(-32768) == -1.0f);
+		CHECK(QuantizeUNorm16(0.0f) == 0);
+		CHECK(QuantizeUNorm16(1.0f) == 65535);
+		CHECK(QuantizeUNorm16(-1.0f) == 0);
+
+		float maxSNormError = 0.0f;
+		float maxUNormError = 0.0f;
+		for (unsigned i = 0; i < 10000; ++i)
+		{
+			const float signedValue = random.Range(-1.0f, 1.0f);
+			const float unsignedValue = random.Range(0.0f, 1.0f);
+
+			maxSNormError = Max(maxSNormError, std::abs(DequantizeSNorm16(QuantizeSNorm16(signedValue)) - signedValue));
+			maxUNormError = Max(maxUNormError, std::abs(DequantizeUNorm16(QuantizeUNorm16(unsignedValue)) - unsignedValue));
+		}
+
+		CHECK(maxSNormError <= 0.5f / 32767.0f + 1e-7f);
+		CHECK(maxUNormError <= 0.5f / 65535.0f + 1e-7f);
+	}
+
+	SECTION("Positions")
+	{
+		// Positions are stored relative to the bounds of the mesh.
+		const vec3 minBounds(-20.0f, 0.0f, 5.0f);
+		const vec3 maxBounds(30.0f, 2.0f, 105.0f);
+		const vec3 extent = maxBounds - minBounds;
+		const vec3 center = (minBounds + maxBounds) * 0.5f;
+
+		float maxUNormError = 0.0f;
+		float maxHalfError = 0.0f;
+		for (unsigned i = 0; i < 10000; ++i)
+		{
+			const vec3 position(
+				random.Range(minBounds.x, maxBounds.x),
+				random.Range(minBounds.y, maxBounds.y),
+				random.Range(minBounds.z, maxBounds.z));
+
+			for (unsigned c = 0; c < 3; ++c)
+			{
+				const float unorm = minBounds[c] + DequantizeUNorm16(QuantizeUNorm16((position[c] - minBounds[c]) / extent[c])) * extent[c];
+				const float half = center[c] + HalfToFloat(FloatToHalf(position[c] - center[c]));
+
+				maxUNormError = Max(maxUNormError, std::abs(unorm - position[c]) / extent[c]);
+				maxHalfError = Max(maxHalfError, std::abs(half - position[c]) / extent[c]);
+			}
+		}
+
+		// Relative to the size of the mesh, 16-bit integers are precise to within one part in 131070.
+		CHECK(maxUNormError <= 0.5f / 65535.0f + 1e-6f);
+		// Half-floats lose precision away from the center, but remain within one part in 4096.
+		CHECK(maxHalfError <= 1.0f / 4096.0f);
+	}
+
+	SECTION("Octahedral")
+	{
+		const vec3 axes[] = {
+			vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f),
+			vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, -1.0f, 0.0f),
+			vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 0.0f, -1.0f)
+		};
+
+		for (const vec3& axis : axes)
+		{
+			const vec2 encoded = EncodeOctahedral(axis);
+			CHECK(Abs(encoded.x) <= 1.0f);
+			CHECK(Abs(encoded.y) <= 1.0f);
+			CHECK(Dot(DecodeOctahedral(encoded), axis) == Approx(1.0f));
+		}
+
+		// Unquantized directions are exact, apart from rounding.
+		// Quantized directions are within a small angle, measured in degrees.
+		float maxError = 0.0f;
+		float maxQuantizedError = 0.0f;
+		for (unsigned i = 0; i < 10000; ++i)
+		{
+			const vec3 direction = random.Direction();
+			const vec2 encoded = EncodeOctahedral(direction);
+			const vec2 quantized(
+				DequantizeSNorm16(QuantizeSNorm16(encoded.x)),
+				DequantizeSNorm16(QuantizeSNorm16(encoded.y)));
+
+			const vec3 decoded = DecodeOctahedral(encoded);
+			const vec3 decodedQuantized = DecodeOctahedral(quantized);
+			CHECK(Length(decodedQuantized) == Approx(1.0f));
+
+			maxError = Max(maxError, AngleBetween(decoded, direction));
+			maxQuantizedError = Max(maxQuantizedError, AngleBetween(decodedQuantized, direction));
+		}
+
+		CHECK(maxError < 0.001f);
+		CHECK(maxQuantizedError < 0.01f);
+	}
+}
@@ -0,0 +1,119 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Math/Math.h>
+#include <gemcutter/Math/Vector.h>
+#include <gemcutter/Utilities/Random.h>
+
+#include <array>
+#include <limits>
+
+using namespace gem;
+
+TEST_CASE("Random")
+{
+	SECTION("Reproducibility")
+	{
+		// These values must never change for a given seed, on any platform.
+		RandomStream stream(12345);
+		CHECK(stream.Next() == 0x89F4BEFDu);
+		CHECK(stream.Next() == 0x94E95A78u);
+		CHECK(stream.Next() == 0x7A8293BCu);
+		CHECK(stream.Next() == 0xF0F3CCF8u);
+
+		RandomStream a(42);
+		RandomStream b(42);
+		for (unsigned i = 0; i < 1000; ++i)
+		{
+			CHECK(a.Next() == b.Next());
+		}
+
+		a.Seed(7);
+		b.Seed(7);
+		CHECK(a.Range(-5.0f, 5.0f) == b.Range(-5.0f, 5.0f));
+		CHECK(a.Range(-5, 5) == b.Range(-5, 5));
+		CHECK(a.Direction() == b.Direction());
+
+		SeedRandomNumberGenerator(99);
+		const float first = RandomRange(0.0f, 1.0f);
+		const int second = RandomRange(0, 100);
+		SeedRandomNumberGenerator(99);
+		CHECK(RandomRange(0.0f, 1.0f) == first);
+		CHECK(RandomRange(0, 100) == second);
+	}
+
+	SECTION("Splitting")
+	{
+		RandomStream parent(1);
+		RandomStream reference(1);
+		RandomStream child = parent.Split();
+
+		// The child continues the parent's original sequence while the parent moves on.
+		bool parentDiffers = false;
+		for (unsigned i = 0; i < 100; ++i)
+		{
+			const uint32_t value = reference.Next();
+			CHECK(child.Next() == value);
+			parentDiffers |= parent.Next() != value;
+		}
+		CHECK(parentDiffers);
+
+		RandomStream split1 = RandomStream(1).Split();
+		RandomStream split2 = RandomStream(1).Split();
+		CHECK(split1.Next() == split2.Next());
+	}
+
+	SECTION("Ranges")
+	{
+		RandomStream stream(2);
+
+		bool hitMin = false;
+		bool hitMax = false;
+		for (unsigned i = 0; i < 1000; ++i)
+		{
+			const float f = stream.Range(-2.0f, 3.0f);
+			CHECK(f >= -2.0f);
+			CHECK(f <= 3.0f);
+
+			const int n = stream.Range(-1, 1);
+			CHECK(n >= -1);
+			CHECK(n <= 1);
+			hitMin |= n == -1;
+			hitMax |= n == 1;
+		}
+		CHECK(hitMin);
+		CHECK(hitMax);
+
+		CHECK(stream.Range(4.0f, 4.0f) == 4.0f);
+		CHECK(stream.Range(4, 4) == 4);
+
+		// The full range of int must not overflow.
+		stream.Range(std::numeric_limits<int>::min(), std::numeric_limits<int>::max());
+
+		for (unsigned i = 0; i < 100; ++i)
+		{
+			CHECK(stream.Bool(1.0f));
+			CHECK_FALSE(stream.Bool(0.0f));
+		}
+	}
+
+	SECTION("Batch Fill")
+	{
+		std::array<float, 64> values;
+		RandomStream(3).FillRange(values, 10.0f, 20.0f);
+
+		// Filling must produce the same sequence as individual calls.
+		RandomStream stream(3);
+		for (float value : values)
+		{
+			CHECK(value >= 10.0f);
+			CHECK(value <= 20.0f);
+			CHECK(value == stream.Range(10.0f, 20.0f));
+		}
+
+		std::array<vec3, 64> directions;
+		RandomStream(4).FillDirections(directions);
+		for (const vec3& direction : directions)
+		{
+			CHECK(Equals(Length(direction), 1.0f, 0.0001f));
+		}
+	}
+}
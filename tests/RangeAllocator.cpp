@@ -0,0 +1,91 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Rendering/RangeAllocator.h>
+
+using namespace gem;
+
+TEST_CASE("RangeAllocator")
+{
+	RangeAllocator allocator(100);
+
+	SECTION("Sequential Allocation")
+	{
+		CHECK(allocator.Allocate(10) == 0);
+		CHECK(allocator.Allocate(20) == 10);
+		CHECK(allocator.Allocate(70) == 30);
+		CHECK(allocator.GetUsedSize() == 100);
+
+		CHECK(allocator.Allocate(1) == RangeAllocator::InvalidOffset);
+		CHECK(allocator.Allocate(0) == RangeAllocator::InvalidOffset);
+		CHECK(allocator.GetLargestFreeRange() == 0);
+	}
+
+	SECTION("First Fit")
+	{
+		const unsigned a = allocator.Allocate(10);
+		const unsigned b = allocator.Allocate(30);
+		allocator.Allocate(10);
+
+		allocator.Free(a, 10);
+		allocator.Free(b, 30);
+
+		// The first two ranges merge into a single gap at the front.
+		CHECK(allocator.GetLargestFreeRange() == 50);
+		CHECK(allocator.Allocate(25) == 0);
+		CHECK(allocator.Allocate(15) == 25);
+		CHECK(allocator.Allocate(10) == 50);
+		CHECK(allocator.GetUsedSize() == 60);
+	}
+
+	SECTION("Merging")
+	{
+		const unsigned a = allocator.Allocate(25);
+		const unsigned b = allocator.Allocate(25);
+		const unsigned c = allocator.Allocate(25);
+		const unsigned d = allocator.Allocate(25);
+
+		allocator.Free(a, 25);
+		allocator.Free(c, 25);
+		CHECK(allocator.GetLargestFreeRange() == 25);
+		CHECK(allocator.Allocate(30) == RangeAllocator::InvalidOffset);
+
+		// Bridges the two gaps on either side.
+		allocator.Free(b, 25);
+		CHECK(allocator.GetLargestFreeRange() == 75);
+
+		allocator.Free(d, 25);
+		CHECK(allocator.GetLargestFreeRange() == 100);
+		CHECK(allocator.GetUsedSize() == 0);
+		CHECK(allocator.Allocate(100) == 0);
+	}
+
+	SECTION("Grow")
+	{
+		CHECK(allocator.Allocate(90) == 0);
+		CHECK(allocator.Allocate(20) == RangeAllocator::InvalidOffset);
+
+		// The new space joins the free range at the end.
+		allocator.Grow(150);
+		CHECK(allocator.GetCapacity() == 150);
+		CHECK(allocator.GetLargestFreeRange() == 60);
+		CHECK(allocator.Allocate(20) == 90);
+
+		allocator.Free(0, 90);
+		allocator.Grow(200);
+		CHECK(allocator.GetLargestFreeRange() == 90);
+		CHECK(allocator.Allocate(90) == 0);
+		CHECK(allocator.Allocate(90) == 110);
+	}
+
+	SECTION("Reset")
+	{
+		allocator.Allocate(60);
+		allocator.Reset(40);
+
+		CHECK(allocator.GetCapacity() == 40);
+		CHECK(allocator.GetUsedSize() == 0);
+		CHECK(allocator.Allocate(40) == 0);
+
+		allocator.Reset(0);
+		CHECK(allocator.Allocate(1) == RangeAllocator::InvalidOffset);
+	}
+}
@@ -0,0 +1,96 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Rendering/ReadbackRing.h>
+#include "MockFence.h"
+
+using namespace gem;
+
+TEST_CASE("ReadbackRing")
+{
+	MockFence::Reset();
+	ReadbackRing<MockFence, 2> ring;
+
+	SECTION("Initial State")
+	{
+		CHECK(ring.SlotCount == 2);
+		CHECK(ring.GetNumInUse() == 0);
+		CHECK_FALSE(ReadbackHandle{}.IsValid());
+		CHECK_FALSE(ring.IsValid({}));
+		CHECK_FALSE(ring.IsReady({}));
+	}
+
+	SECTION("Polling")
+	{
+		const ReadbackHandle handle = ring.Acquire();
+		REQUIRE(handle.IsValid());
+		ring.Submit(handle);
+
+		CHECK(ring.IsValid(handle));
+		CHECK(ring.GetFence(handle.slot).pending);
+		CHECK_FALSE(ring.IsReady(handle));
+
+		// The result becomes available once the GPU passes the fence.
+		MockFence::isGpuFinished = true;
+		CHECK(ring.IsReady(handle));
+
+		ring.Release(handle);
+		CHECK_FALSE(ring.IsValid(handle));
+		CHECK_FALSE(ring.IsReady(handle));
+		CHECK_FALSE(ring.GetFence(handle.slot).pending);
+		CHECK(ring.GetNumInUse() == 0);
+	}
+
+	SECTION("Waiting")
+	{
+		const ReadbackHandle handle = ring.Acquire();
+		ring.Submit(handle);
+		CHECK_FALSE(ring.IsReady(handle));
+
+		ring.Wait(handle);
+		CHECK(ring.IsReady(handle));
+	}
+
+	SECTION("Exhaustion")
+	{
+		const ReadbackHandle first = ring.Acquire();
+		const ReadbackHandle second = ring.Acquire();
+		CHECK(first.IsValid());
+		CHECK(second.IsValid());
+		CHECK(first.slot != second.slot);
+		CHECK(ring.GetNumInUse() == 2);
+
+		// Slots stay in use until released, even if the GPU is finished with them.
+		CHECK_FALSE(ring.Acquire().IsValid());
+
+		ring.Release(second);
+		const ReadbackHandle third = ring.Acquire();
+		CHECK(third.IsValid());
+		CHECK(third.slot == second.slot);
+	}
+
+	SECTION("Stale Handles")
+	{
+		const ReadbackHandle old = ring.Acquire();
+		ring.Release(old);
+
+		// Slots are handed out in order, so wrap around to reuse the first one.
+		ring.Release(ring.Acquire());
+		const ReadbackHandle reused = ring.Acquire();
+		REQUIRE(reused.slot == old.slot);
+
+		CHECK(ring.IsValid(reused));
+		CHECK_FALSE(ring.IsValid(old));
+	}
+
+	SECTION("Release All")
+	{
+		const ReadbackHandle first = ring.Acquire();
+		const ReadbackHandle second = ring.Acquire();
+		ring.Submit(first);
+
+		ring.ReleaseAll();
+		CHECK(ring.GetNumInUse() == 0);
+		CHECK_FALSE(ring.IsValid(first));
+		CHECK_FALSE(ring.IsValid(second));
+		CHECK_FALSE(ring.GetFence(first.slot).pending);
+	}
+}
@@ -0,0 +1,188 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Rendering/RenderGraph.h>
+
+#include <vector>
+
+using namespace gem;
+
+TEST_CASE("RenderGraph")
+{
+	RenderGraph graph;
+	auto Noop = [](const RenderGraph&) {};
+	auto Order = [&]() { return std::vector<unsigned>(graph.GetExecutionOrder().begin(), graph.GetExecutionOrder().end()); };
+
+	const RenderTargetDesc hdr = { 1280, 720, { TextureFormat::RGBA_16F } };
+	const RenderTargetDesc shadow = { 1024, 1024, {}, TextureFilter::Point, true };
+	const RenderGraphResource screen = graph.ImportTarget("Screen", nullptr);
+
+	SECTION("Culling")
+	{
+		auto unused = graph.CreateTarget("Unused", hdr);
+		auto scene = graph.CreateTarget("Scene", hdr);
+
+		const unsigned debug = graph.AddPass("Debug", Noop);
+		unused = graph.Write(debug, unused);
+
+		const unsigned geometry = graph.AddPass("Geometry", Noop);
+		scene = graph.Write(geometry, scene);
+
+		const unsigned present = graph.AddPass("Present", Noop);
+		graph.Read(present, scene);
+		graph.Write(present, screen);
+
+		const unsigned capture = graph.AddPass("Capture", Noop);
+		graph.SetSideEffects(capture);
+
+		REQUIRE(graph.Compile());
+		CHECK(graph.IsCulled(debug));
+		CHECK_FALSE(graph.IsCulled(geometry));
+		CHECK_FALSE(graph.IsCulled(present));
+		CHECK_FALSE(graph.IsCulled(capture));
+		CHECK(Order() == std::vector<unsigned>{ geometry, present, capture });
+
+		// Culled passes do not hold on to any targets.
+		CHECK(graph.GetPhysicalIndex(unused) == RenderGraphResource::InvalidIndex);
+		CHECK(graph.GetNumPhysicalTargets() == 1);
+	}
+
+	SECTION("Ordering")
+	{
+		auto shadows = graph.CreateTarget("Shadows", shadow);
+
+		// Passes can be declared before the passes they depend on.
+		const unsigned lighting = graph.AddPass("Lighting", Noop);
+		const unsigned shadowMap = graph.AddPass("ShadowMap", Noop);
+
+		shadows = graph.Write(shadowMap, shadows);
+		graph.Read(lighting, shadows);
+		graph.Write(lighting, screen);
+
+		REQUIRE(graph.Compile());
+		CHECK(Order() == std::vector<unsigned>{ shadowMap, lighting });
+	}
+
+	SECTION("Write After Read")
+	{
+		auto history = graph.CreateTarget("History", hdr);
+
+		const unsigned seed = graph.AddPass("Seed", Noop);
+		history = graph.Write(seed, history);
+		const RenderGraphResource seeded = history;
+
+		const unsigned update = graph.AddPass("Update", Noop);
+		history = graph.Write(update, history);
+
+		const unsigned sample = graph.AddPass("Sample", Noop);
+		graph.Read(sample, seeded);
+		const RenderGraphResource output = graph.Write(sample, screen);
+
+		const unsigned present = graph.AddPass("Present", Noop);
+		graph.Read(present, history);
+		graph.Write(present, output);
+
+		// The update overwrites the version that Sample reads, so it must wait for Sample to finish.
+		REQUIRE(graph.Compile());
+		CHECK(Order() == std::vector<unsigned>{ seed, sample, update, present });
+	}
+
+	SECTION("Culling Readers Of Overwritten Targets")
+	{
+		auto unused = graph.CreateTarget("Unused", hdr);
+
+		// Samples the back-buffer into a target that nothing reads.
+		const unsigned reader = graph.AddPass("Reader", Noop);
+		graph.Read(reader, screen);
+		unused = graph.Write(reader, unused);
+
+		const unsigned writer = graph.AddPass("Writer", Noop);
+		graph.Write(writer, screen);
+
+		// Having to run before the writer does not make the reader contribute to the output.
+		REQUIRE(graph.Compile());
+		CHECK(graph.IsCulled(reader));
+		CHECK_FALSE(graph.IsCulled(writer));
+		CHECK(Order() == std::vector<unsigned>{ writer });
+		CHECK(graph.GetNumPhysicalTargets() == 0);
+	}
+
+	SECTION("Outdated Write")
+	{
+		auto scene = graph.CreateTarget("Scene", hdr);
+		const unsigned first = graph.AddPass("First", Noop);
+		const unsigned second = graph.AddPass("Second", Noop);
+
+		CHECK(graph.Write(first, scene).IsValid());
+		CHECK_FALSE(graph.Write(second, scene).IsValid());
+	}
+
+	SECTION("Cycles")
+	{
+		auto a = graph.CreateTarget("A", hdr);
+		auto b = graph.CreateTarget("B", hdr);
+
+		const unsigned first = graph.AddPass("First", Noop);
+		const unsigned second = graph.AddPass("Second", Noop);
+		a = graph.Write(first, a);
+		b = graph.Write(second, b);
+		graph.Read(first, b);
+		graph.Read(second, a);
+		graph.SetSideEffects(first);
+
+		CHECK_FALSE(graph.Compile());
+		CHECK(graph.GetExecutionOrder().empty());
+	}
+
+	SECTION("Aliasing")
+	{
+		// A chain of post-processing passes, each reading the result of the last.
+		auto bright = graph.CreateTarget("Bright", hdr);
+		auto blurX = graph.CreateTarget("BlurX", hdr);
+		auto blurY = graph.CreateTarget("BlurY", hdr);
+		auto shadows = graph.CreateTarget("Shadows", shadow);
+
+		const unsigned extract = graph.AddPass("Extract", Noop);
+		bright = graph.Write(extract, bright);
+
+		const unsigned horizontal = graph.AddPass("BlurX", Noop);
+		graph.Read(horizontal, bright);
+		blurX = graph.Write(horizontal, blurX);
+
+		const unsigned shadowMap = graph.AddPass("ShadowMap", Noop);
+		shadows = graph.Write(shadowMap, shadows);
+
+		const unsigned vertical = graph.AddPass("BlurY", Noop);
+		graph.Read(vertical, blurX);
+		blurY = graph.Write(vertical, blurY);
+
+		const unsigned composite = graph.AddPass("Composite", Noop);
+		graph.Read(composite, blurY);
+		graph.Read(composite, shadows);
+		graph.Write(composite, screen);
+
+		REQUIRE(graph.Compile());
+
+		// Bright is no longer needed once BlurX has been rendered, so BlurY can take its place.
+		CHECK(graph.GetPhysicalIndex(bright) == graph.GetPhysicalIndex(blurY));
+		CHECK(graph.GetPhysicalIndex(bright) != graph.GetPhysicalIndex(blurX));
+
+		// Targets with different descriptions are never shared.
+		CHECK(graph.GetPhysicalIndex(shadows) != graph.GetPhysicalIndex(bright));
+		CHECK(graph.GetPhysicalIndex(shadows) != graph.GetPhysicalIndex(blurX));
+		CHECK(graph.GetNumPhysicalTargets() == 3);
+
+		// Imported targets are never pooled.
+		CHECK(graph.GetPhysicalIndex(screen) == RenderGraphResource::InvalidIndex);
+	}
+
+	SECTION("Clear")
+	{
+		const unsigned present = graph.AddPass("Present", Noop);
+		graph.Write(present, screen);
+		REQUIRE(graph.Compile());
+
+		graph.Clear();
+		CHECK(graph.GetNumPasses() == 0);
+		CHECK(graph.GetExecutionOrder().empty());
+		CHECK(graph.GetNumPhysicalTargets() == 0);
+	}
+}
@@ -0,0 +1,192 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Application/FileSystem.h>
+#include <gemcutter/Resource/Resource.h>
+#include <gemcutter/Resource/ResourceCache.h>
+#include "TestFiles.h"
+
+#include <algorithm>
+#include <string>
+
+using namespace gem;
+
+namespace
+{
+	// Uses one byte of CPU memory per character in the file, and 100 bytes of GPU memory.
+	class CacheAsset : public Resource<CacheAsset>
+	{
+	public:
+		static constexpr std::string_view Extension = ".cacheasset";
+
+		bool Load(std::string_view filePath)
+		{
+			return LoadFileAsString(filePath, contents);
+		}
+
+		MemoryUsage GetMemoryUsage() const
+		{
+			return { .cpuBytes = contents.size(), .gpuBytes = gpuBytes };
+		}
+
+		std::string contents;
+		size_t gpuBytes = 100;
+	};
+
+	// Holds onto other assets without using any memory itself, like a Material.
+	class CacheHolder : public Resource<CacheHolder>
+	{
+	public:
+		static constexpr std::string_view Extension = ".cacheholder";
+
+		bool Load(std::string_view filePath)
+		{
+			std::string contents;
+			if (!LoadFileAsString(filePath, contents))
+			{
+				return false;
+			}
+
+			held = gem::Load<CacheAsset>(contents);
+			return held != nullptr;
+		}
+
+		std::shared_ptr<CacheAsset> held;
+	};
+
+	bool IsCached(std::string path)
+	{
+		return Resource<CacheAsset>::Find(std::move(path)) != nullptr;
+	}
+}
+
+TEST_CASE("ResourceCache")
+{
+	TestFiles files({
+		{ "cache_a.cacheasset", std::string(10, 'a') },
+		{ "cache_b.cacheasset", std::string(20, 'b') },
+		{ "cache_c.cacheasset", std::string(30, 'c') },
+		{ "cache_holder.cacheholder", "cache_c" }
+	});
+
+	const MemoryUsage initialUsage = ResourceCache.GetUsage();
+
+	SECTION("Accounting")
+	{
+		auto a = Load<CacheAsset>("cache_a");
+		auto b = Load<CacheAsset>("cache_b");
+		REQUIRE(a);
+		REQUIRE(b);
+
+		CHECK(Resource<CacheAsset>::GetNumCached() == 2);
+		CHECK(Resource<CacheAsset>::GetCacheUsage().cpuBytes == 30);
+		CHECK(Resource<CacheAsset>::GetCacheUsage().gpuBytes == 200);
+		CHECK(Resource<CacheAsset>::GetCacheUsage().Total() == 230);
+		CHECK(ResourceCache.GetUsage().Total() == initialUsage.Total() + 230);
+
+		// Cache hits don't count twice.
+		CHECK(Load<CacheAsset>("cache_a") == a);
+		CHECK(Resource<CacheAsset>::GetCacheUsage().Total() == 230);
+
+		auto stats = ResourceCache.GetStats();
+		auto itr = std::ranges::find(stats, CacheAsset::Extension, &ResourceCacheStats::extension);
+		REQUIRE(itr != stats.end());
+		CHECK(itr->numAssets == 2);
+		CHECK(itr->usage.Total() == 230);
+
+		UnloadAll<CacheAsset>();
+		CHECK(Resource<CacheAsset>::GetNumCached() == 0);
+		CHECK(Resource<CacheAsset>::GetCacheUsage().Total() == 0);
+		CHECK(Resource<CacheAsset>::GetPeakCacheUsage().Total() >= 230);
+		CHECK(ResourceCache.GetUsage().Total() == initialUsage.Total());
+		CHECK(ResourceCache.GetPeakUsage().Total() >= initialUsage.Total() + 230);
+	}
+
+	SECTION("Least Recently Used")
+	{
+		Resource<CacheAsset>::SetCacheBudget(250);
+
+		// Loaded without keeping any references.
+		Load<CacheAsset>("cache_a");
+		Load<CacheAsset>("cache_b");
+		CHECK(Resource<CacheAsset>::GetNumCached() == 2);
+
+		// Using 'a' makes 'b' the least recently used.
+		CHECK(IsCached("cache_a"));
+
+		auto c = Load<CacheAsset>("cache_c");
+		REQUIRE(c);
+		CHECK(IsCached("cache_a"));
+		CHECK(!IsCached("cache_b"));
+		CHECK(IsCached("cache_c"));
+		CHECK(Resource<CacheAsset>::GetCacheUsage().Total() == 240);
+	}
+
+	SECTION("Referenced Assets")
+	{
+		Resource<CacheAsset>::SetCacheBudget(150);
+
+		auto a = Load<CacheAsset>("cache_a");
+		auto b = Load<CacheAsset>("cache_b");
+
+		// Nothing can be evicted while the assets are in use.
+		CHECK(Resource<CacheAsset>::GetNumCached() == 2);
+		CHECK(ResourceCache.Trim() == 0);
+
+		b.reset();
+		CHECK(ResourceCache.Trim() == 1);
+		CHECK(IsCached("cache_a"));
+		CHECK(!IsCached("cache_b"));
+	}
+
+	SECTION("Global Budget")
+	{
+		ResourceCache.SetBudget(initialUsage.Total() + 250);
+
+		Load<CacheAsset>("cache_a");
+		Load<CacheAsset>("cache_b");
+		Load<CacheAsset>("cache_c");
+
+		CHECK(!IsCached("cache_a"));
+		CHECK(IsCached("cache_b"));
+		CHECK(IsCached("cache_c"));
+		CHECK(ResourceCache.GetUsage().Total() <= ResourceCache.GetBudget());
+
+		ResourceCache.SetBudget(0);
+	}
+
+	SECTION("Measured Again")
+	{
+		Resource<CacheAsset>::SetCacheBudget(1000);
+
+		auto a = Load<CacheAsset>("cache_a");
+		Load<CacheAsset>("cache_b");
+		CHECK(Resource<CacheAsset>::GetCacheUsage().Total() == 230);
+
+		// Assets can grow after they are loaded, such as when a texture streams in more detail.
+		a->gpuBytes = 1000;
+		CHECK(ResourceCache.Trim() == 1);
+		CHECK(!IsCached("cache_b"));
+		CHECK(Resource<CacheAsset>::GetCacheUsage().Total() == 1010);
+		CHECK(Resource<CacheAsset>::GetPeakCacheUsage().gpuBytes >= 1100);
+	}
+
+	SECTION("Evict Unused")
+	{
+		auto holder = Load<CacheHolder>("cache_holder");
+		REQUIRE(holder);
+		Load<CacheAsset>("cache_a");
+
+		CHECK(ResourceCache.EvictUnused() == 1);
+		CHECK(!IsCached("cache_a"));
+		CHECK(IsCached("cache_c"));
+
+		// Releasing the holder also releases the asset it holds.
+		holder.reset();
+		CHECK(ResourceCache.EvictUnused() == 2);
+		CHECK(!IsCached("cache_c"));
+		CHECK(Resource<CacheHolder>::GetNumCached() == 0);
+	}
+
+	Resource<CacheAsset>::SetCacheBudget(0);
+	UnloadAll<CacheHolder>();
+	UnloadAll<CacheAsset>();
+}
@@ -0,0 +1,163 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Application/FileSystem.h>
+#include <gemcutter/Resource/Resource.h>
+#include <gemcutter/Resource/ResourceLoader.h>
+#include "TestFiles.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace gem;
+
+namespace
+{
+	// An asset loaded in two steps, like a Texture or Model.
+	class SplitAsset : public Resource<SplitAsset>
+	{
+	public:
+		static constexpr std::string_view Extension = ".splitasset";
+
+		bool Load(std::string_view filePath) { return LoadData(filePath) && Upload(); }
+
+		bool LoadData(std::string_view filePath)
+		{
+			++numReads;
+			readThread = std::this_thread::get_id();
+
+			return LoadFileAsString(filePath, contents);
+		}
+
+		bool Upload()
+		{
+			uploadThread = std::this_thread::get_id();
+			uploaded = true;
+
+			return contents != "bad upload";
+		}
+
+		std::string contents;
+		std::thread::id readThread;
+		std::thread::id uploadThread;
+		bool uploaded = false;
+
+		static inline std::atomic<unsigned> numReads = 0;
+	};
+
+	// An asset which can only be loaded all at once, like a Font.
+	class WholeAsset : public Resource<WholeAsset>
+	{
+	public:
+		static constexpr std::string_view Extension = ".wholeasset";
+
+		bool Load(std::string_view filePath)
+		{
+			loadThread = std::this_thread::get_id();
+			return LoadFileAsString(filePath, contents);
+		}
+
+		std::string contents;
+		std::thread::id loadThread;
+	};
+
+}
+
+TEST_CASE("ResourceLoader")
+{
+	TestFiles files({ "async_1.splitasset", "async_2.splitasset", "async_3.wholeasset" });
+	SplitAsset::numReads = 0;
+
+	SECTION("Load")
+	{
+		auto future = LoadAsync<SplitAsset>("async_1");
+		REQUIRE(future.IsValid());
+
+		auto asset = future.Get();
+		REQUIRE(asset);
+		CHECK(future.IsReady());
+		CHECK(future.GetStatus() == LoadStatus::Loaded);
+		CHECK(asset->contents == "async_1.splitasset");
+		CHECK(asset->GetPath() == "async_1.splitasset");
+		CHECK(asset->uploaded);
+		CHECK(asset->uploadThread == std::this_thread::get_id());
+		CHECK(ResourceLoader.GetNumPending() == 0);
+
+		// The finished asset is now in the cache.
+		CHECK(Resource<SplitAsset>::Find("async_1") == asset);
+		CHECK(Load<SplitAsset>("async_1") == asset);
+
+		auto cached = LoadAsync<SplitAsset>("ASYNC_1");
+		CHECK(cached.IsReady());
+		CHECK(cached.TryGet() == asset);
+		CHECK(SplitAsset::numReads == 1);
+	}
+
+	SECTION("Deduplication")
+	{
+		auto future1 = LoadAsync<SplitAsset>("async_2");
+		auto future2 = LoadAsync<SplitAsset>("Async_2.splitasset");
+		auto loaded = Load<SplitAsset>("async_2");
+
+		REQUIRE(loaded);
+		CHECK(future1.Get() == loaded);
+		CHECK(future2.Get() == loaded);
+		CHECK(SplitAsset::numReads == 1);
+	}
+
+	SECTION("Many")
+	{
+		std::vector<ResourceFuture<SplitAsset>> futures;
+		for (unsigned i = 0; i < 32; ++i)
+		{
+			futures.push_back(LoadAsync<SplitAsset>(i % 2 == 0 ? "async_1" : "async_2"));
+		}
+
+		ResourceLoader.WaitAll();
+		CHECK(ResourceLoader.GetNumPending() == 0);
+		CHECK(SplitAsset::numReads == 2);
+
+		for (auto& future : futures)
+		{
+			CHECK(future.IsReady());
+			REQUIRE(future.TryGet());
+			CHECK(future.TryGet()->uploadThread == std::this_thread::get_id());
+		}
+	}
+
+	SECTION("Load Only")
+	{
+		// Assets without a separate LoadData() step are loaded on the main thread.
+		auto asset = LoadAsync<WholeAsset>("async_3").Get();
+		REQUIRE(asset);
+		CHECK(asset->contents == "async_3.wholeasset");
+		CHECK(asset->loadThread == std::this_thread::get_id());
+	}
+
+	SECTION("Main Thread")
+	{
+		// The caches are only safe to use from the thread which started the program.
+		CHECK(ResourceLoader.IsMainThread());
+
+		bool isMainThread = true;
+		std::jthread([&] { isMainThread = ResourceLoader.IsMainThread(); }).join();
+		CHECK_FALSE(isMainThread);
+	}
+
+	SECTION("Failure")
+	{
+		auto future = LoadAsync<SplitAsset>("async_missing");
+		CHECK(future.Get() == nullptr);
+		CHECK(future.GetStatus() == LoadStatus::Failed);
+
+		// Failed loads are not cached, and can be retried.
+		CHECK(Resource<SplitAsset>::Find("async_missing") == nullptr);
+		CHECK(LoadAsync<SplitAsset>("async_missing").Get() == nullptr);
+		CHECK(SplitAsset::numReads == 2);
+
+		CHECK(!ResourceFuture<SplitAsset>().IsValid());
+	}
+
+	UnloadAll<SplitAsset>();
+	UnloadAll<WholeAsset>();
+}
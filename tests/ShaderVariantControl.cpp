@@ -0,0 +1,132 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Resource/ShaderVariantControl.h>
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace gem;
+
+TEST_CASE("ShaderVariantControl")
+{
+	const ShaderKeyword alpha("TEST_VARIANT_ALPHA");
+	const ShaderKeyword beta("TEST_VARIANT_BETA");
+	const ShaderKeyword count("TEST_VARIANT_COUNT");
+
+	SECTION("Keywords")
+	{
+		CHECK(alpha.GetIndex() != beta.GetIndex());
+		CHECK(ShaderKeyword("TEST_VARIANT_ALPHA").GetIndex() == alpha.GetIndex());
+		CHECK(alpha.GetName() == "TEST_VARIANT_ALPHA");
+		CHECK(ShaderKeyword::GetNumKeywords() >= 3);
+	}
+
+	SECTION("Define")
+	{
+		ShaderVariantControl variant;
+		CHECK(variant.IsEmpty());
+
+		variant.Define(alpha);
+		variant.Define(count, 3);
+		CHECK(variant.IsDefined(alpha));
+		CHECK_FALSE(variant.IsDefined(beta));
+		CHECK(variant.GetValue(count) == 3);
+		CHECK(variant.GetString() == "#define TEST_VARIANT_ALPHA \n#define TEST_VARIANT_COUNT 3\n");
+
+		variant.Define(count, 0);
+		CHECK(variant.GetString() == "#define TEST_VARIANT_ALPHA \n#define TEST_VARIANT_COUNT 0\n");
+
+		variant.Toggle(alpha);
+		variant.Switch(beta, true);
+		CHECK_FALSE(variant.IsDefined(alpha));
+		CHECK(variant.IsDefined(beta));
+
+		variant.Undefine(count);
+		CHECK(variant.GetValue(count) == 0);
+		CHECK(variant.GetString() == "#define TEST_VARIANT_BETA \n");
+
+		variant.Reset();
+		CHECK(variant.IsEmpty());
+		CHECK(variant.GetString().empty());
+	}
+
+	SECTION("Equality")
+	{
+		// The order of the defines does not matter.
+		ShaderVariantControl a;
+		a.Define(alpha);
+		a.Define(count, 2);
+
+		ShaderVariantControl b;
+		b.Define(count, 2);
+		b.Define(alpha);
+		CHECK(a == b);
+		CHECK(a.GetHash() == b.GetHash());
+
+		// Values are compared exactly, as is a define with and without a value.
+		b.Define(count, 4);
+		CHECK(a != b);
+		b.Define(count);
+		CHECK(a != b);
+		b.Define(count, 2);
+		CHECK(a == b);
+
+		b.Switch(beta, true);
+		b.Switch(beta, false);
+		CHECK(a == b);
+
+		std::unordered_set<ShaderVariantControl> set;
+		set.insert(a);
+		set.insert(b);
+		set.insert(ShaderVariantControl());
+		CHECK(set.size() == 2);
+	}
+
+	SECTION("Many Keywords")
+	{
+		// The keywords created here are removed afterwards, so that they do not leak into other tests.
+		const unsigned numKeywords = ShaderKeyword::GetNumKeywords();
+
+		std::vector<ShaderKeyword> keywords;
+		for (unsigned i = 0; i < 200; ++i)
+		{
+			keywords.emplace_back("TEST_VARIANT_MANY_" + std::to_string(i));
+		}
+
+		const ShaderKeyword& first = keywords.front();
+		const ShaderKeyword& last = keywords.back();
+		CHECK(last.GetIndex() >= 64 * 3);
+		CHECK(last.GetName() == "TEST_VARIANT_MANY_199");
+
+		// Nothing past the first 64 keywords is dropped.
+		ShaderVariantControl a;
+		a.Define(last, 5);
+		a.Define(first);
+		CHECK(a.IsDefined(first));
+		CHECK(a.IsDefined(last));
+		CHECK_FALSE(a.IsDefined(keywords[150]));
+		CHECK(a.GetValue(last) == 5);
+		CHECK(a.GetString() == "#define TEST_VARIANT_MANY_0 \n#define TEST_VARIANT_MANY_199 5\n");
+
+		ShaderVariantControl b;
+		b.Define(first);
+		CHECK(a != b);
+		b.Define(last, 5);
+		CHECK(a == b);
+		CHECK(a.GetHash() == b.GetHash());
+
+		// Removing the last of the higher keywords must compare equal to never having defined them.
+		b.Define(keywords[150]);
+		b.Undefine(keywords[150]);
+		CHECK(a == b);
+		a.Undefine(last);
+		a.Undefine(first);
+		CHECK(a.IsEmpty());
+		CHECK(a == ShaderVariantControl());
+
+		ShaderKeyword::ResetKeywords(numKeywords);
+		CHECK(ShaderKeyword::GetNumKeywords() == numKeywords);
+		CHECK(ShaderKeyword("TEST_VARIANT_MANY_0").GetIndex() == numKeywords);
+		ShaderKeyword::ResetKeywords(numKeywords);
+	}
+}
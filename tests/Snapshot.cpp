@@ -0,0 +1,257 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Entity/Entity.h>
+#include <gemcutter/Entity/Hierarchy.h>
+#include <gemcutter/Entity/Snapshot.h>
+#include <gemcutter/Application/Reflection.h>
+#include <gemcutter/Math/Vector.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace gem;
+
+class SnapshotStats : public Component<SnapshotStats>
+{
+public:
+	SnapshotStats(Entity& owner) : Component(owner) {}
+
+	int health = 100;
+	float speed = 1.0f;
+	vec3 spawn;
+	std::string title = "default";
+	// Not reflected, so it always keeps its constructor value.
+	int transient = 7;
+};
+
+class SnapshotPod : public Component<SnapshotPod>
+{
+public:
+	using TriviallyClonable = SnapshotPod;
+
+	SnapshotPod(Entity& owner) : Component(owner) {}
+
+	// Small enough to be placed in the tail padding of the ComponentBase by some compilers.
+	short priority = 0;
+	unsigned values[4] = {};
+	vec2 offset;
+};
+
+class SnapshotTagA : public Tag<SnapshotTagA> {};
+class SnapshotTagB : public Tag<SnapshotTagB> {};
+
+namespace
+{
+	// Creates a small scene:
+	// root [SnapshotStats, TagA]
+	//   child1 [SnapshotPod, TagB]
+	//     grandchild [SnapshotStats (disabled)]
+	//   child2 (disabled) [SnapshotPod]
+	Entity::Ptr MakeScene()
+	{
+		auto root = Entity::MakeNewRoot();
+		root->position = vec3(1.0f, 2.0f, 3.0f);
+		root->Tag<SnapshotTagA>();
+
+		auto& rootStats = root->Add<SnapshotStats>();
+		rootStats.health = 42;
+		rootStats.speed = 3.5f;
+		rootStats.spawn = vec3(-1.0f, 0.0f, 5.0f);
+		rootStats.title = "root";
+		rootStats.transient = 13;
+
+		auto child1 = root->Get<Hierarchy>().CreateChild();
+		child1->scale = vec3(2.0f);
+		child1->Tag<SnapshotTagB>();
+		auto& pod = child1->Add<SnapshotPod>();
+		pod.priority = -3;
+		pod.values[0] = 1;
+		pod.values[3] = 4;
+		pod.offset = vec2(0.5f, -0.5f);
+
+		auto grandchild = child1->Require<Hierarchy>().CreateChild();
+		auto& grandchildStats = grandchild->Add<SnapshotStats>();
+		grandchildStats.title = "grandchild";
+		grandchild->Disable(grandchildStats);
+
+		auto child2 = root->Get<Hierarchy>().CreateChild();
+		child2->Add<SnapshotPod>().values[1] = 9;
+		child2->Disable();
+
+		return root;
+	}
+
+	template<class Range>
+	unsigned Count(Range&& range)
+	{
+		unsigned count = 0;
+		for ([[maybe_unused]] auto& element : range)
+		{
+			++count;
+		}
+
+		return count;
+	}
+
+	std::vector<Entity::Ptr> Children(const Entity& entity)
+	{
+		return entity.Get<Hierarchy>().GetChildren();
+	}
+
+	void CheckScene(const Entity::Ptr& root)
+	{
+		REQUIRE(root);
+		CHECK(root->position == vec3(1.0f, 2.0f, 3.0f));
+		CHECK(root->IsEnabled());
+		CHECK(root->Has<SnapshotTagA>());
+		CHECK(root->Has<HierarchyRoot>());
+
+		auto& rootStats = root->Get<SnapshotStats>();
+		CHECK(rootStats.health == 42);
+		CHECK(rootStats.speed == 3.5f);
+		CHECK(rootStats.spawn == vec3(-1.0f, 0.0f, 5.0f));
+		CHECK(rootStats.title == "root");
+		CHECK(rootStats.transient == 7);
+
+		auto children = Children(*root);
+		REQUIRE(children.size() == 2);
+
+		auto& child1 = *children[0];
+		CHECK(child1.scale == vec3(2.0f));
+		CHECK(child1.Has<SnapshotTagB>());
+		CHECK(!child1.Has<HierarchyRoot>());
+		CHECK(child1.IsEnabled());
+		CHECK(child1.Get<Hierarchy>().GetParent() == root);
+
+		auto& pod = child1.Get<SnapshotPod>();
+		CHECK(pod.priority == -3);
+		CHECK(pod.values[0] == 1);
+		CHECK(pod.values[1] == 0);
+		CHECK(pod.values[3] == 4);
+		CHECK(pod.offset == vec2(0.5f, -0.5f));
+
+		auto grandchildren = Children(child1);
+		REQUIRE(grandchildren.size() == 1);
+		auto& grandchildStats = grandchildren[0]->Get<SnapshotStats>();
+		CHECK(grandchildStats.title == "grandchild");
+		CHECK(!grandchildStats.IsComponentEnabled());
+
+		auto& child2 = *children[1];
+		CHECK(!child2.IsEnabled());
+		CHECK(child2.Get<SnapshotPod>().values[1] == 9);
+	}
+}
+
+REFLECT_COMPONENT(SnapshotStats, gem::ComponentBase)
+	MEMBERS {
+		REF_MEMBER(health)
+		REF_MEMBER(speed)
+		REF_MEMBER(spawn)
+		REF_MEMBER(title)
+	}
+REF_END;
+
+REFLECT_COMPONENT(SnapshotPod, gem::ComponentBase) REF_END;
+
+REFLECT_TAG(SnapshotTagA);
+REFLECT_TAG(SnapshotTagB);
+
+TEST_CASE("Snapshot")
+{
+	auto scene = MakeScene();
+
+	SECTION("Instantiate Prefab")
+	{
+		auto clone = Instantiate(*scene);
+		CHECK(clone != scene);
+		CheckScene(clone);
+
+		// The clone is independent of the source.
+		clone->Get<SnapshotStats>().title = "changed";
+		CHECK(scene->Get<SnapshotStats>().title == "root");
+	}
+
+	SECTION("Capture / Instantiate")
+	{
+		const Snapshot snapshot = Snapshot::Capture(*scene);
+		REQUIRE(!snapshot.IsEmpty());
+
+		CheckScene(snapshot.Instantiate());
+
+		// Each instantiation creates a new set of Entities.
+		auto first = snapshot.Instantiate();
+		auto second = snapshot.Instantiate();
+		CHECK(first != second);
+		CHECK(Children(*first)[0] != Children(*second)[0]);
+	}
+
+	SECTION("Save / Load")
+	{
+		const Snapshot snapshot = Snapshot::Capture(*scene);
+		REQUIRE(snapshot.Save("SnapshotTest.snapshot"));
+
+		Snapshot loaded;
+		REQUIRE(loaded.Load("SnapshotTest.snapshot"));
+		CHECK(std::ranges::equal(loaded.GetData(), snapshot.GetData()));
+		CheckScene(loaded.Instantiate());
+
+		std::remove("SnapshotTest.snapshot");
+	}
+
+	SECTION("Queries")
+	{
+		const unsigned numStats = Count(All<SnapshotStats>());
+		const unsigned numTagged = Count(With<SnapshotTagB>());
+
+		// Instantiated Entities are immediately visible to queries, except for those that were disabled.
+		auto clone = Instantiate(*scene);
+		CHECK(Count(All<SnapshotStats>()) == numStats + 1);
+		CHECK(Count(With<SnapshotTagB>()) == numTagged + 1);
+		CHECK(Count(With<SnapshotTagA, SnapshotStats>()) == 2);
+
+		clone.reset();
+		CHECK(Count(All<SnapshotStats>()) == numStats);
+		CHECK(Count(With<SnapshotTagB>()) == numTagged);
+	}
+
+	SECTION("BulkEnable")
+	{
+		std::vector<Entity::Ptr> entities;
+		std::vector<Entity*> pointers;
+		for (unsigned i = 0; i < 100; ++i)
+		{
+			auto entity = Entity::MakeNew();
+			entity->Disable();
+			entity->Add<SnapshotPod>();
+			if (i % 2 == 0)
+			{
+				entity->Tag<SnapshotTagA>();
+			}
+
+			pointers.push_back(entity.get());
+			entities.push_back(std::move(entity));
+		}
+
+		const unsigned numPods = Count(All<SnapshotPod>());
+		Entity::BulkEnable(pointers);
+
+		CHECK(Count(All<SnapshotPod>()) == numPods + 100);
+		CHECK(Count(With<SnapshotTagA, SnapshotPod>()) == 50);
+		for (auto& entity : entities)
+		{
+			CHECK(entity->IsEnabled());
+		}
+
+		// Entities that are already enabled are ignored.
+		Entity::BulkEnable(pointers);
+		CHECK(Count(All<SnapshotPod>()) == numPods + 100);
+	}
+
+	SECTION("Missing File")
+	{
+		Snapshot snapshot;
+		CHECK(!snapshot.Load("SnapshotTest.missing"));
+		CHECK(snapshot.IsEmpty());
+	}
+}
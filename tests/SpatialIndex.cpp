@@ -0,0 +1,271 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Entity/Entity.h>
+#include <gemcutter/Entity/SpatialIndex.h>
+#include <gemcutter/Math/Math.h>
+#include <gemcutter/Utilities/Random.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace gem;
+
+namespace
+{
+	struct Scene
+	{
+		Scene(unsigned count, float size, RandomStream& stream)
+		{
+			entities.reserve(count);
+			bounds.reserve(count);
+			proxies.reserve(count);
+
+			for (unsigned i = 0; i < count; ++i)
+			{
+				const vec3 center(stream.Range(-size, size), stream.Range(-size, size), stream.Range(-size, size));
+
+				entities.push_back(Entity::MakeNew());
+				bounds.push_back(AABB::FromSphere(center, stream.Range(0.1f, 1.0f)));
+				proxies.push_back(index.Insert(*entities.back(), bounds.back()));
+			}
+		}
+
+		// Moves every entity by a small random offset.
+		void Jitter(float distance, RandomStream& stream)
+		{
+			for (unsigned i = 0; i < entities.size(); ++i)
+			{
+				const vec3 offset = stream.Direction() * distance;
+				bounds[i].min += offset;
+				bounds[i].max += offset;
+
+				index.Move(proxies[i], bounds[i]);
+			}
+		}
+
+		template<class Predicate>
+		std::vector<Entity*> BruteForce(Predicate&& predicate) const
+		{
+			std::vector<Entity*> result;
+			for (unsigned i = 0; i < entities.size(); ++i)
+			{
+				if (predicate(bounds[i]))
+				{
+					result.push_back(entities[i].get());
+				}
+			}
+
+			return result;
+		}
+
+		SpatialIndex index;
+		std::vector<Entity::Ptr> entities;
+		std::vector<AABB> bounds;
+		std::vector<unsigned> proxies;
+	};
+
+	std::vector<Entity*> Sorted(std::vector<Entity*> entities)
+	{
+		std::sort(entities.begin(), entities.end());
+		return entities;
+	}
+}
+
+TEST_CASE("SpatialIndex")
+{
+	RandomStream stream(29);
+	Scene scene(2000, 50.0f, stream);
+
+	SECTION("Structure")
+	{
+		CHECK(scene.index.GetNumProxies() == 2000);
+
+		// A balanced tree of 2000 leaves would be 11 levels deep.
+		CHECK(scene.index.GetHeight() < 22);
+
+		for (unsigned i = 0; i < scene.entities.size(); ++i)
+		{
+			CHECK(scene.index.GetEntity(scene.proxies[i]) == scene.entities[i]);
+			CHECK(scene.index.GetFatBounds(scene.proxies[i]).Contains(scene.bounds[i]));
+		}
+
+		scene.index.Clear();
+		CHECK(scene.index.GetNumProxies() == 0);
+		CHECK(scene.index.GetHeight() == 0);
+	}
+
+	SECTION("Incremental Updates")
+	{
+		// Small movements stay within the fattened bounds.
+		AABB bounds = scene.bounds[0];
+		bounds.min.x += scene.index.GetMargin() * 0.5f;
+		bounds.max.x += scene.index.GetMargin() * 0.5f;
+		CHECK(!scene.index.Move(scene.proxies[0], bounds));
+		CHECK(scene.index.GetBounds(scene.proxies[0]) == bounds);
+
+		bounds.min.x += 10.0f;
+		bounds.max.x += 10.0f;
+		CHECK(scene.index.Move(scene.proxies[0], bounds));
+		CHECK(scene.index.GetFatBounds(scene.proxies[0]).Contains(bounds));
+
+		// Removed proxies are no longer found, and their slots are reused.
+		const AABB everything(vec3(-100.0f), vec3(100.0f));
+		scene.index.Remove(scene.proxies[1]);
+		std::vector<Entity*> results;
+		scene.index.QueryAABB(everything, results);
+		CHECK(results.size() == 1999);
+		CHECK(std::find(results.begin(), results.end(), scene.entities[1].get()) == results.end());
+
+		auto entity = Entity::MakeNew();
+		CHECK(scene.index.Insert(*entity, AABB::FromSphere(vec3::Zero, 1.0f)) == scene.proxies[1]);
+		scene.index.Remove(scene.proxies[1]);
+	}
+
+	SECTION("Queries")
+	{
+		scene.Jitter(5.0f, stream);
+		CHECK(scene.index.GetHeight() < 22);
+
+		for (unsigned i = 0; i < 20; ++i)
+		{
+			const vec3 point(stream.Range(-50.0f, 50.0f), stream.Range(-50.0f, 50.0f), stream.Range(-50.0f, 50.0f));
+
+			const AABB box(point - vec3(10.0f), point + vec3(10.0f));
+			std::vector<Entity*> results;
+			scene.index.QueryAABB(box, results);
+			CHECK(Sorted(results) == Sorted(scene.BruteForce([&](const AABB& bounds) { return bounds.Intersects(box); })));
+
+			const float radius = stream.Range(1.0f, 15.0f);
+			results.clear();
+			scene.index.QuerySphere(point, radius, results);
+			CHECK(Sorted(results) == Sorted(scene.BruteForce([&](const AABB& bounds) { return bounds.IntersectsSphere(point, radius); })));
+
+			std::vector<Entity*> nearest;
+			scene.index.QueryNearest(point, 8, nearest);
+			REQUIRE(nearest.size() == 8);
+
+			std::vector<unsigned> order(scene.entities.size());
+			for (unsigned j = 0; j < order.size(); ++j)
+			{
+				order[j] = j;
+			}
+			std::partial_sort(order.begin(), order.begin() + 8, order.end(), [&](unsigned a, unsigned b) {
+				return scene.bounds[a].DistanceSquared(point) < scene.bounds[b].DistanceSquared(point);
+			});
+
+			// Compare distances rather than entities, since overlapping bounds can tie.
+			for (unsigned j = 0; j < 8; ++j)
+			{
+				const unsigned proxy = static_cast<unsigned>(std::find_if(scene.entities.begin(), scene.entities.end(), [&](const Entity::Ptr& e) {
+					return e.get() == nearest[j];
+				}) - scene.entities.begin());
+
+				CHECK(Equals(scene.bounds[proxy].DistanceSquared(point), scene.bounds[order[j]].DistanceSquared(point)));
+			}
+		}
+	}
+
+	SECTION("Raycast")
+	{
+		for (unsigned i = 0; i < 20; ++i)
+		{
+			const vec3 origin = stream.Direction() * 80.0f;
+			const vec3 direction = Normalize(stream.Direction() * 10.0f - origin);
+
+			const RaycastHit hit = scene.index.Raycast(origin, direction, 200.0f);
+
+			float closest = 200.0f;
+			Entity* expected = nullptr;
+			for (unsigned j = 0; j < scene.entities.size(); ++j)
+			{
+				const float distance = scene.bounds[j].IntersectRay(origin, direction, closest);
+				if (distance >= 0.0f)
+				{
+					closest = distance;
+					expected = scene.entities[j].get();
+				}
+			}
+
+			CHECK(hit.entity == expected);
+			if (expected)
+			{
+				CHECK(Equals(hit.distance, closest));
+			}
+		}
+
+		// Rays which only point away from everything never hit.
+		CHECK(scene.index.Raycast(vec3(0.0f, 200.0f, 0.0f), vec3::Up, 1000.0f).entity == nullptr);
+	}
+}
+
+TEST_CASE("SpatialIndex Benchmark", "[!benchmark]")
+{
+	constexpr unsigned numEntities = 100000;
+	constexpr unsigned numQueries = 100;
+
+	RandomStream stream(30);
+	Scene scene(numEntities, 500.0f, stream);
+
+	std::vector<vec3> points(numQueries);
+	for (vec3& point : points)
+	{
+		point = vec3(stream.Range(-500.0f, 500.0f), stream.Range(-500.0f, 500.0f), stream.Range(-500.0f, 500.0f));
+	}
+
+	std::vector<Entity*> results;
+
+	BENCHMARK("Move 100k")
+	{
+		scene.Jitter(0.05f, stream);
+	};
+
+	BENCHMARK("Move 100k (escaping bounds)")
+	{
+		scene.Jitter(1.0f, stream);
+	};
+
+	BENCHMARK("Linear QuerySphere")
+	{
+		results.clear();
+		for (const vec3& point : points)
+		{
+			for (unsigned i = 0; i < numEntities; ++i)
+			{
+				if (scene.bounds[i].IntersectsSphere(point, 20.0f))
+				{
+					results.push_back(scene.entities[i].get());
+				}
+			}
+		}
+		return results.size();
+	};
+
+	BENCHMARK("QuerySphere")
+	{
+		results.clear();
+		for (const vec3& point : points)
+		{
+			scene.index.QuerySphere(point, 20.0f, results);
+		}
+		return results.size();
+	};
+
+	BENCHMARK("QueryNearest")
+	{
+		results.clear();
+		for (const vec3& point : points)
+		{
+			scene.index.QueryNearest(point, 16, results);
+		}
+		return results.size();
+	};
+
+	BENCHMARK("Raycast")
+	{
+		unsigned hits = 0;
+		for (const vec3& point : points)
+		{
+			hits += scene.index.Raycast(point, Normalize(-point), 1000.0f).entity != nullptr;
+		}
+		return hits;
+	};
+}
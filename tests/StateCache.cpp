@@ -0,0 +1,149 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Rendering/StateCache.h>
+
+#include <string>
+#include <vector>
+
+using namespace gem;
+
+namespace
+{
+	// Records the changes which reach the backend.
+	class RecordingBackend final : public StateBackend
+	{
+	public:
+		void UseProgram(unsigned program) override { Record("UseProgram", program); }
+		void BindVertexArray(unsigned vertexArray) override { Record("BindVertexArray", vertexArray); }
+		void BindTexture(unsigned unit, unsigned, unsigned texture) override { Record("BindTexture" + std::to_string(unit), texture); }
+		void BindUniformBuffer(unsigned slot, unsigned buffer, size_t, size_t) override { Record("BindUniformBuffer" + std::to_string(slot), buffer); }
+		void SetCullFunc(CullFunc func) override { Record("SetCullFunc", static_cast<unsigned>(func)); }
+		void SetBlendFunc(BlendFunc func) override { Record("SetBlendFunc", static_cast<unsigned>(func)); }
+		void SetDepthFunc(DepthFunc func) override { Record("SetDepthFunc", static_cast<unsigned>(func)); }
+		void SetWireframe(bool enabled) override { Record("SetWireframe", enabled); }
+		void SetScissor(bool enabled) override { Record("SetScissor", enabled); }
+		void SetScissorRect(unsigned, unsigned, unsigned width, unsigned) override { Record("SetScissorRect", width); }
+		void SetViewport(unsigned, unsigned, unsigned width, unsigned) override { Record("SetViewport", width); }
+
+		std::vector<std::string> calls;
+
+	private:
+		void Record(const std::string& name, unsigned value)
+		{
+			calls.push_back(name + ' ' + std::to_string(value));
+		}
+	};
+}
+
+TEST_CASE("StateCache")
+{
+	RecordingBackend backend;
+	StateCache cache(backend);
+
+	SECTION("Redundant Changes")
+	{
+		// The initial state is unknown, so the first change is always issued.
+		cache.UseProgram(0);
+		cache.UseProgram(0);
+		cache.UseProgram(5);
+		cache.UseProgram(5);
+		cache.BindVertexArray(2);
+		cache.BindVertexArray(2);
+		cache.SetBlendFunc(BlendFunc::Linear);
+		cache.SetBlendFunc(BlendFunc::Linear);
+		cache.SetDepthFunc(DepthFunc::Normal);
+		cache.SetCullFunc(CullFunc::Clockwise);
+		cache.SetCullFunc(CullFunc::None);
+		cache.SetViewport(0, 0, 640, 480);
+		cache.SetViewport(0, 0, 640, 480);
+		cache.SetScissorRect(0, 0, 640, 480);
+		cache.SetScissor(false);
+		cache.SetScissor(false);
+		cache.SetWireframe(false);
+
+		CHECK(backend.calls == std::vector<std::string>{
+			"UseProgram 0",
+			"UseProgram 5",
+			"BindVertexArray 2",
+			"SetBlendFunc 1",
+			"SetDepthFunc 3",
+			"SetCullFunc 1",
+			"SetCullFunc 0",
+			"SetViewport 640",
+			"SetScissorRect 640",
+			"SetScissor 0",
+			"SetWireframe 0"
+		});
+		CHECK(cache.GetNumIssued() == 11);
+		CHECK(cache.GetNumElided() == 6);
+
+		cache.ResetCounters();
+		CHECK(cache.GetNumIssued() == 0);
+		CHECK(cache.GetNumElided() == 0);
+	}
+
+	SECTION("Textures")
+	{
+		// Each unit is tracked separately, along with the target.
+		cache.BindTexture(0, 1, 10);
+		cache.BindTexture(3, 1, 10);
+		cache.BindTexture(0, 1, 10);
+		cache.BindTexture(3, 2, 10);
+		CHECK(backend.calls.size() == 3);
+		CHECK(cache.GetActiveTextureUnit() == 3);
+
+		// A texture bound directly on the active unit for editing.
+		cache.InvalidateActiveTexture();
+		cache.BindTexture(3, 2, 10);
+		cache.BindTexture(0, 1, 10);
+		CHECK(backend.calls.size() == 4);
+		CHECK(backend.calls.back() == "BindTexture3 10");
+
+		// A new texture could reuse the same name.
+		cache.OnTextureDeleted(10);
+		cache.BindTexture(0, 1, 10);
+		cache.BindTexture(3, 2, 10);
+		CHECK(backend.calls.size() == 6);
+	}
+
+	SECTION("Uniform Buffers")
+	{
+		cache.BindUniformBuffer(10, 4);
+		cache.BindUniformBuffer(10, 4);
+		cache.BindUniformBuffer(11, 4);
+
+		// Ranges of the same buffer are different bindings.
+		cache.BindUniformBuffer(10, 4, 256, 64);
+		cache.BindUniformBuffer(10, 4, 256, 64);
+		cache.BindUniformBuffer(10, 4, 512, 64);
+		CHECK(backend.calls.size() == 4);
+
+		cache.OnBufferDeleted(4);
+		cache.BindUniformBuffer(11, 4);
+		CHECK(backend.calls.size() == 5);
+	}
+
+	SECTION("Invalidate")
+	{
+		cache.UseProgram(5);
+		cache.BindVertexArray(2);
+		cache.BindTexture(0, 1, 10);
+		cache.SetDepthFunc(DepthFunc::None);
+
+		cache.Invalidate();
+		cache.UseProgram(5);
+		cache.BindVertexArray(2);
+		cache.BindTexture(0, 1, 10);
+		cache.SetDepthFunc(DepthFunc::None);
+		CHECK(backend.calls.size() == 8);
+
+		cache.OnProgramDeleted(5);
+		cache.OnVertexArrayDeleted(3);
+		cache.UseProgram(5);
+		cache.BindVertexArray(2);
+		CHECK(backend.calls.size() == 9);
+
+		cache.InvalidateVertexArray();
+		cache.BindVertexArray(2);
+		CHECK(backend.calls.size() == 10);
+	}
+}
@@ -0,0 +1,110 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Rendering/StreamRing.h>
+#include "MockFence.h"
+
+using namespace gem;
+
+TEST_CASE("StreamRing")
+{
+	MockFence::Reset();
+	StreamRing<MockFence> ring(100);
+
+	SECTION("Initial State")
+	{
+		CHECK(ring.GetCapacity() == 100);
+		CHECK(ring.GetUsedSize() == 0);
+		CHECK(ring.GetNumFramesInFlight() == 0);
+	}
+
+	SECTION("Sequential Allocation")
+	{
+		CHECK(ring.Allocate(10) == 0);
+		CHECK(ring.Allocate(10) == 12);
+		CHECK(ring.Allocate(6, 20) == 40);
+		CHECK(ring.GetUsedSize() == 46);
+
+		CHECK(ring.Allocate(0) == ring.InvalidOffset);
+		CHECK(MockFence::callLog.empty());
+	}
+
+	SECTION("Frame Fencing")
+	{
+		ring.Allocate(40);
+		ring.EndFrame();
+		CHECK(MockFence::callLog == "I0");
+		CHECK(ring.GetNumFramesInFlight() == 1);
+
+		// Frames without any allocations are not fenced.
+		ring.EndFrame();
+		CHECK(MockFence::callLog == "I0");
+
+		ring.Allocate(40);
+		ring.EndFrame();
+		CHECK(MockFence::callLog == "I0I1");
+		CHECK(ring.GetUsedSize() == 80);
+	}
+
+	SECTION("Waiting For Space")
+	{
+		ring.Allocate(40);
+		ring.EndFrame();
+		ring.Allocate(40);
+		ring.EndFrame();
+
+		// Only the oldest frame needs to be released to make room at the start of the buffer.
+		CHECK(ring.Allocate(30) == 0);
+		CHECK(MockFence::callLog == "I0I1W0");
+		CHECK(ring.GetNumFramesInFlight() == 1);
+
+		// The space at the end is skipped, and counts as used until the frame is released.
+		CHECK(ring.GetUsedSize() == 40 + 20 + 30);
+	}
+
+	SECTION("Finished Frames")
+	{
+		ring.Allocate(60);
+		ring.EndFrame();
+
+		// Frames the GPU has already passed are released without waiting.
+		MockFence::isGpuFinished = true;
+		CHECK(ring.Allocate(60) == 0);
+		CHECK(MockFence::callLog == "I0");
+		CHECK(ring.GetNumFramesInFlight() == 0);
+	}
+
+	SECTION("Frame Limit")
+	{
+		for (unsigned i = 0; i < 4; ++i)
+		{
+			ring.Allocate(10);
+			ring.EndFrame();
+		}
+
+		// Only three frames can be in flight, so the fourth must wait on the first.
+		CHECK(MockFence::callLog == "I0I1I2W0I0");
+		CHECK(ring.GetNumFramesInFlight() == 3);
+	}
+
+	SECTION("Overflow")
+	{
+		CHECK(ring.Allocate(101) == ring.InvalidOffset);
+
+		// The current frame cannot wait on itself.
+		CHECK(ring.Allocate(60) == 0);
+		CHECK(ring.Allocate(60) == ring.InvalidOffset);
+		CHECK(MockFence::callLog.empty());
+	}
+
+	SECTION("Reset")
+	{
+		ring.Allocate(60);
+		ring.EndFrame();
+		ring.Allocate(20);
+
+		ring.Reset(200);
+		CHECK(MockFence::callLog == "I0W0");
+		CHECK(ring.GetCapacity() == 200);
+		CHECK(ring.GetUsedSize() == 0);
+		CHECK(ring.Allocate(150) == 0);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdio>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Creates files in the working directory for the duration of a test.
+struct TestFiles
+{
+	// Each file contains its own name.
+	TestFiles(std::initializer_list<std::string_view> names)
+	{
+		for (std::string_view name : names)
+		{
+			Add(name, name);
+		}
+	}
+
+	// Pairs of file names and their contents.
+	TestFiles(std::initializer_list<std::pair<std::string_view, std::string_view>> contents)
+	{
+		for (auto& [name, data] : contents)
+		{
+			Add(name, data);
+		}
+	}
+
+	~TestFiles()
+	{
+		for (const std::string& file : files)
+		{
+			std::remove(file.c_str());
+		}
+	}
+
+	TestFiles(const TestFiles&) = delete;
+	TestFiles& operator=(const TestFiles&) = delete;
+
+	std::vector<std::string> files;
+
+private:
+	void Add(std::string_view name, std::string_view data)
+	{
+		std::ofstream(files.emplace_back(name)) << data;
+	}
+};
@@ -0,0 +1,217 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Resource/TextureProcessing.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace gem;
+
+namespace
+{
+	ImageRGBA8 MakeImage(unsigned width, unsigned height, auto function)
+	{
+		ImageRGBA8 image;
+		image.width = width;
+		image.height = height;
+		image.pixels.resize(width * height * 4);
+
+		for (unsigned y = 0; y < height; ++y)
+		{
+			for (unsigned x = 0; x < width; ++x)
+			{
+				const std::array<uint8_t, 4> texel = function(x, y);
+				std::copy(texel.begin(), texel.end(), image.pixels.begin() + (y * width + x) * 4);
+			}
+		}
+
+		return image;
+	}
+
+	// A smooth image with some detail, similar to a photograph.
+	ImageRGBA8 MakeTestImage(unsigned width, unsigned height)
+	{
+		return MakeImage(width, height, [](unsigned x, unsigned y) -> std::array<uint8_t, 4> {
+			const float wave = std::sin(x * 0.3f) * std::cos(y * 0.2f);
+			return {
+				static_cast<uint8_t>(x * 255 / 63),
+				static_cast<uint8_t>(y * 255 / 63),
+				static_cast<uint8_t>(128 + wave * 100.0f),
+				static_cast<uint8_t>(255 - (x + y) * 2)
+			};
+		});
+	}
+
+	std::array<uint8_t, 4> Flat(unsigned, unsigned)
+	{
+		return { 77, 77, 77, 77 };
+	}
+
+	// Returns the root mean square error of the channels between the images.
+	float ComputeError(const ImageRGBA8& a, const ImageRGBA8& b, unsigned numChannels)
+	{
+		REQUIRE(a.width == b.width);
+		REQUIRE(a.height == b.height);
+
+		float sum = 0.0f;
+		for (size_t i = 0; i < a.pixels.size(); i += 4)
+		{
+			for (unsigned c = 0; c < numChannels; ++c)
+			{
+				const float delta = static_cast<float>(a.pixels[i + c]) - static_cast<float>(b.pixels[i + c]);
+				sum += delta * delta;
+			}
+		}
+
+		return std::sqrt(sum / (a.width * a.height * numChannels));
+	}
+
+	float ComputeCompressionError(const ImageRGBA8& image, TextureCompression compression, unsigned numChannels)
+	{
+		const auto data = CompressImage(image, compression);
+		return ComputeError(image, DecompressImage(data, image.width, image.height, compression), numChannels);
+	}
+}
+
+TEST_CASE("TextureProcessing")
+{
+	SECTION("Conversion")
+	{
+		const uint8_t rgb[] = { 1, 2, 3, 4, 5, 6 };
+		const ImageRGBA8 image = ConvertToRGBA8(reinterpret_cast<const std::byte*>(rgb), 2, 1, 3);
+
+		CHECK(image.width == 2);
+		CHECK(image.height == 1);
+		CHECK(image.pixels == std::vector<uint8_t>{ 1, 2, 3, 255, 4, 5, 6, 255 });
+	}
+
+	SECTION("Mip Chain")
+	{
+		const ImageRGBA8 image = MakeTestImage(12, 5);
+		const auto levels = GenerateMipChain(image, 4, MipFilter::Box, false);
+
+		REQUIRE(levels.size() == 4);
+		CHECK(levels[0].pixels == image.pixels);
+		CHECK((levels[1].width == 6 && levels[1].height == 2));
+		CHECK((levels[2].width == 3 && levels[2].height == 1));
+		CHECK((levels[3].width == 1 && levels[3].height == 1));
+		CHECK(levels[3].pixels.size() == 4);
+
+		// Flat colors are preserved by both filters.
+		const ImageRGBA8 flat = MakeImage(16, 16, Flat);
+		for (MipFilter filter : { MipFilter::Box, MipFilter::Kaiser })
+		{
+			for (const ImageRGBA8& level : GenerateMipChain(flat, 5, filter, true))
+			{
+				CHECK(level.pixels[0] == 77);
+				CHECK(level.pixels[3] == 77);
+			}
+		}
+	}
+
+	SECTION("Gamma Correct Filtering")
+	{
+		// Black and white stripes.
+		const ImageRGBA8 stripes = MakeImage(4, 4, [](unsigned x, unsigned) -> std::array<uint8_t, 4> {
+			const uint8_t value = (x % 2) ? 255 : 0;
+			return { value, value, value, value };
+		});
+
+		const auto linear = GenerateMipChain(stripes, 2, MipFilter::Box, false);
+		const auto sRGB = GenerateMipChain(stripes, 2, MipFilter::Box, true);
+
+		// Half intensity in linear space is much brighter when stored as sRGB. Alpha is always linear.
+		CHECK(linear[1].pixels[0] == 128);
+		CHECK(sRGB[1].pixels[0] == 188);
+		CHECK(sRGB[1].pixels[3] == 128);
+	}
+
+	SECTION("Kaiser")
+	{
+		// A wave with a period of 16 texels, which becomes 4 texels after two levels.
+		const ImageRGBA8 wave = MakeImage(64, 1, [](unsigned x, unsigned) -> std::array<uint8_t, 4> {
+			const auto value = static_cast<uint8_t>(128.0f + 100.0f * std::sin(x * 3.14159265f / 8.0f));
+			return { value, value, value, 255 };
+		});
+
+		auto computeRange = [](const ImageRGBA8& image) {
+			uint8_t min = 255;
+			uint8_t max = 0;
+			for (size_t i = 0; i < image.pixels.size(); i += 4)
+			{
+				min = std::min(min, image.pixels[i]);
+				max = std::max(max, image.pixels[i]);
+			}
+
+			return max - min;
+		};
+
+		const auto box = GenerateMipChain(wave, 3, MipFilter::Box, false);
+		const auto kaiser = GenerateMipChain(wave, 3, MipFilter::Kaiser, false);
+		REQUIRE(kaiser[2].width == 16);
+
+		// The Kaiser filter keeps more of the detail which the smaller level can still represent.
+		CHECK(computeRange(kaiser[2]) > computeRange(box[2]));
+		CHECK(computeRange(kaiser[2]) <= 200);
+	}
+
+	SECTION("Formats")
+	{
+		CHECK(ResolveCompressedFormat(TextureCompression::BC1, false) == TextureFormat::BC1);
+		CHECK(ResolveCompressedFormat(TextureCompression::BC1, true) == TextureFormat::BC1_sRGB);
+		CHECK(ResolveCompressedFormat(TextureCompression::BC3, true) == TextureFormat::BC3_sRGB);
+		CHECK(ResolveCompressedFormat(TextureCompression::BC4, true) == TextureFormat::BC4);
+		CHECK(ResolveCompressedFormat(TextureCompression::BC5, true) == TextureFormat::BC5);
+		CHECK(ResolveCompressedFormat(TextureCompression::BC7, false) == TextureFormat::BC7);
+	}
+
+	SECTION("Compression")
+	{
+		const ImageRGBA8 image = MakeTestImage(64, 64);
+
+		CHECK(CompressImage(image, TextureCompression::BC1).size() == 16 * 16 * 8);
+		CHECK(CompressImage(image, TextureCompression::BC3).size() == 16 * 16 * 16);
+		CHECK(CompressImage(image, TextureCompression::BC4).size() == 16 * 16 * 8);
+		CHECK(CompressImage(image, TextureCompression::BC5).size() == 16 * 16 * 16);
+		CHECK(CompressImage(image, TextureCompression::BC7).size() == 16 * 16 * 16);
+
+		const float errorBC1 = ComputeCompressionError(image, TextureCompression::BC1, 3);
+		const float errorBC3 = ComputeCompressionError(image, TextureCompression::BC3, 4);
+		const float errorBC4 = ComputeCompressionError(image, TextureCompression::BC4, 1);
+		const float errorBC5 = ComputeCompressionError(image, TextureCompression::BC5, 2);
+		const float errorBC7 = ComputeCompressionError(image, TextureCompression::BC7, 4);
+
+		CHECK(errorBC1 < 6.0f);
+		CHECK(errorBC3 < 6.0f);
+		CHECK(errorBC4 < 2.0f);
+		CHECK(errorBC5 < 2.0f);
+		CHECK(errorBC7 < errorBC3);
+	}
+
+	SECTION("Compression Edge Cases")
+	{
+		// Partial blocks are padded.
+		const ImageRGBA8 image = MakeTestImage(6, 5);
+		const auto data = CompressImage(image, TextureCompression::BC1);
+		CHECK(data.size() == 2 * 2 * 8);
+
+		const ImageRGBA8 decoded = DecompressImage(data, 6, 5, TextureCompression::BC1);
+		CHECK(decoded.pixels.size() == 6 * 5 * 4);
+		CHECK(ComputeError(image, decoded, 3) < 8.0f);
+
+		// Blocks of two colors lying exactly on the endpoints are reproduced exactly.
+		const ImageRGBA8 checkers = MakeImage(4, 4, [](unsigned x, unsigned y) -> std::array<uint8_t, 4> {
+			const uint8_t value = ((x + y) % 2) ? 255 : 0;
+			return { value, value, value, value };
+		});
+
+		CHECK(ComputeCompressionError(checkers, TextureCompression::BC1, 3) == 0.0f);
+		CHECK(ComputeCompressionError(checkers, TextureCompression::BC3, 4) == 0.0f);
+		CHECK(ComputeCompressionError(checkers, TextureCompression::BC7, 4) == 0.0f);
+
+		// Single channel blocks reproduce flat values exactly.
+		const ImageRGBA8 flat = MakeImage(4, 4, Flat);
+		CHECK(DecompressImage(CompressImage(flat, TextureCompression::BC3), 4, 4, TextureCompression::BC3).pixels[3] == 77);
+		CHECK(DecompressImage(CompressImage(flat, TextureCompression::BC4), 4, 4, TextureCompression::BC4).pixels[0] == 77);
+		CHECK(DecompressImage(CompressImage(flat, TextureCompression::BC5), 4, 4, TextureCompression::BC5).pixels[1] == 77);
+	}
+}
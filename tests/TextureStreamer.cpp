@@ -0,0 +1,202 @@
+#include <catch/catch.hpp>
+#include <gemcutter/Resource/TextureStreamer.h>
+
+#include <vector>
+
+using namespace gem;
+
+namespace
+{
+	// Four bytes per texel. The 64x64 level is 16KB.
+	size_t LevelBytes(unsigned size)
+	{
+		return size * size * 4;
+	}
+
+	// Streams until nothing changes, requesting the same sizes every frame.
+	void StreamAll(MipResidency& residency, const std::vector<std::pair<unsigned, float>>& requests)
+	{
+		for (unsigned i = 0; i < 32; ++i)
+		{
+			for (auto& [id, pixels] : requests)
+			{
+				residency.RequestScreenSize(id, pixels);
+			}
+
+			if (residency.Update().empty())
+			{
+				return;
+			}
+		}
+
+		FAIL("Streaming did not settle.");
+	}
+}
+
+TEST_CASE("TextureStreamer")
+{
+	MipResidency residency;
+
+	SECTION("ComputeLevel")
+	{
+		CHECK(MipResidency::ComputeLevel(1024, 1024, 11, 300.0f) == 1);
+		CHECK(MipResidency::ComputeLevel(1024, 1024, 11, 256.0f) == 2);
+		CHECK(MipResidency::ComputeLevel(1024, 512, 11, 2000.0f) == 0);
+		CHECK(MipResidency::ComputeLevel(1024, 1024, 11, 1.0f) == 10);
+		CHECK(MipResidency::ComputeLevel(1024, 1024, 11, 0.0f) == 10);
+		CHECK(MipResidency::ComputeLevel(1024, 1024, 3, 1.0f) == 2);
+	}
+
+	SECTION("Tail")
+	{
+		// Textures start with their levels of 64x64 and smaller.
+		const unsigned id = residency.Add(1024, 1024, 1, 11, TextureFormat::RGBA_8);
+		CHECK(residency.GetResidentLevel(id) == 4);
+		CHECK(residency.GetResidentBytes(id) == (LevelBytes(64) * 4 - 4) / 3);
+
+		// Small textures are always fully resident.
+		const unsigned small = residency.Add(32, 16, 6, 6, TextureFormat::RGBA_8);
+		CHECK(residency.GetResidentLevel(small) == 0);
+		CHECK(residency.GetTotalResidentBytes() == residency.GetResidentBytes(id) + residency.GetResidentBytes(small));
+
+		// Textures which are not drawn stay as they are.
+		CHECK(residency.Update().empty());
+		CHECK(residency.GetNumTextures() == 2);
+	}
+
+	SECTION("Streaming")
+	{
+		const unsigned id = residency.Add(1024, 1024, 1, 11, TextureFormat::RGBA_8);
+
+		// One level is streamed in per frame, until the level matching the screen size is resident.
+		residency.RequestScreenSize(id, 100.0f);
+		residency.RequestScreenSize(id, 300.0f);
+		auto changes = residency.Update();
+		REQUIRE(changes.size() == 1);
+		CHECK(changes[0].id == id);
+		CHECK(changes[0].residentLevel == 3);
+		CHECK(residency.GetTargetLevel(id) == 1);
+		CHECK(residency.GetUploadedBytes() == LevelBytes(128));
+
+		StreamAll(residency, { { id, 300.0f } });
+		CHECK(residency.GetResidentLevel(id) == 1);
+
+		// Levels are kept once they are no longer needed, since there is no memory budget.
+		StreamAll(residency, { { id, 10.0f } });
+		CHECK(residency.GetResidentLevel(id) == 1);
+
+		// Ids are reused once removed.
+		residency.Remove(id);
+		CHECK(residency.GetNumTextures() == 0);
+		CHECK(residency.GetTotalResidentBytes() == 0);
+		CHECK(residency.Add(64, 64, 1, 7, TextureFormat::RGBA_8) == id);
+	}
+
+	SECTION("Upload Budget")
+	{
+		const unsigned near = residency.Add(1024, 1024, 1, 11, TextureFormat::RGBA_8);
+		const unsigned far = residency.Add(1024, 1024, 1, 11, TextureFormat::RGBA_8);
+		residency.SetUploadBudget(LevelBytes(128) + LevelBytes(256));
+
+		// The most magnified texture is streamed first.
+		residency.RequestScreenSize(far, 200.0f);
+		residency.RequestScreenSize(near, 1000.0f);
+		auto changes = residency.Update();
+		REQUIRE(changes.size() == 2);
+		CHECK(changes[0].id == near);
+		CHECK(changes[1].id == far);
+
+		residency.RequestScreenSize(far, 200.0f);
+		residency.RequestScreenSize(near, 1000.0f);
+		changes = residency.Update();
+		REQUIRE(changes.size() == 1);
+		CHECK(changes[0].id == near);
+		CHECK(residency.GetResidentLevel(near) == 2);
+
+		// A level larger than the budget is still streamed, one per frame.
+		residency.SetUploadBudget(1);
+		residency.RequestScreenSize(far, 200.0f);
+		residency.RequestScreenSize(near, 1000.0f);
+		changes = residency.Update();
+		REQUIRE(changes.size() == 1);
+		CHECK(residency.GetUploadedBytes() == LevelBytes(512));
+	}
+
+	SECTION("Memory Budget")
+	{
+		const unsigned a = residency.Add(256, 256, 1, 9, TextureFormat::RGBA_8);
+		const unsigned b = residency.Add(256, 256, 1, 9, TextureFormat::RGBA_8);
+		const size_t tailBytes = residency.GetResidentBytes(a);
+		residency.SetRetainFrames(2);
+
+		StreamAll(residency, { { a, 256.0f }, { b, 256.0f } });
+		CHECK(residency.GetResidentLevel(a) == 0);
+		CHECK(residency.GetResidentLevel(b) == 0);
+
+		// Textures which have not been drawn recently lose their levels first.
+		for (unsigned i = 0; i < 3; ++i)
+		{
+			residency.RequestScreenSize(b, 256.0f);
+			CHECK(residency.Update().empty());
+		}
+
+		residency.SetMemoryBudget(residency.GetResidentBytes(a) + tailBytes + LevelBytes(128));
+		residency.RequestScreenSize(b, 256.0f);
+		auto changes = residency.Update();
+		REQUIRE(changes.size() == 1);
+		CHECK(changes[0].id == a);
+		CHECK(changes[0].residentLevel == 1);
+		CHECK(residency.GetTotalResidentBytes() == residency.GetMemoryBudget());
+
+		// Once both are drawn, the most magnified texture takes priority.
+		StreamAll(residency, { { a, 300.0f }, { b, 256.0f } });
+		CHECK(residency.GetResidentLevel(a) == 0);
+		CHECK(residency.GetResidentLevel(b) == 1);
+		CHECK(residency.GetTotalResidentBytes() == residency.GetMemoryBudget());
+	}
+
+	SECTION("Needed Levels")
+	{
+		const unsigned near = residency.Add(256, 256, 1, 9, TextureFormat::RGBA_8);
+		const unsigned far = residency.Add(256, 256, 1, 9, TextureFormat::RGBA_8);
+		const size_t tailBytes = residency.GetResidentBytes(near);
+
+		// When every level is needed, the texture drawn the smallest relative to its resolution is reduced.
+		residency.SetMemoryBudget(tailBytes * 2 + LevelBytes(256) + LevelBytes(128) * 2);
+		StreamAll(residency, { { near, 256.0f }, { far, 140.0f } });
+		CHECK(residency.GetResidentLevel(near) == 0);
+		CHECK(residency.GetResidentLevel(far) == 1);
+		CHECK(residency.GetTotalResidentBytes() == residency.GetMemoryBudget());
+
+		// Levels are released from whichever texture would be magnified the least, keeping the quality balanced.
+		residency.SetMemoryBudget(tailBytes * 2 + LevelBytes(256));
+		StreamAll(residency, { { near, 256.0f }, { far, 140.0f } });
+		CHECK(residency.GetResidentLevel(near) == 1);
+		CHECK(residency.GetResidentLevel(far) == 1);
+		CHECK(residency.GetTotalResidentBytes() <= residency.GetMemoryBudget());
+
+		// The smallest levels are resident, regardless of the budget.
+		residency.SetMemoryBudget(1);
+		StreamAll(residency, { { near, 256.0f }, { far, 140.0f } });
+		CHECK(residency.GetTotalResidentBytes() == tailBytes * 2);
+	}
+
+	SECTION("Cubemaps and Compression")
+	{
+		const unsigned id = residency.Add(128, 128, 6, 8, TextureFormat::BC1);
+		CHECK(residency.GetResidentLevel(id) == 1);
+
+		StreamAll(residency, { { id, 1000.0f } });
+		CHECK(residency.GetResidentLevel(id) == 0);
+
+		// 8 bytes per 4x4 block, for each of the six faces. Levels smaller than a block use a whole block.
+		size_t expected = 0;
+		for (unsigned size = 128; size >= 4; size /= 2)
+		{
+			expected += (size / 4) * (size / 4) * 8 * 6;
+		}
+		expected += 8 * 6 * 2;
+
+		CHECK(residency.GetResidentBytes(id) == expected);
+	}
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2026 Emilian Cioca
+#include "FontEncoder/FontEncoder.h"
+#include "MaterialEncoder/MaterialEncoder.h"
+#include "MeshEncoder/MeshEncoder.h"
+#include "SoundEncoder/SoundEncoder.h"
+#include "TextureEncoder/TextureEncoder.h"
+
+#include <gemcutter/Application/CmdArgs.h>
+#include <gemcutter/Application/Logging.h>
+#include <gemcutter/Application/Reflection.h>
+#include <gemcutter/Resource/AssetBuilder.h>
+
+namespace
+{
+	constexpr std::string_view usage =
+		"Gemcutter asset builder.\nUsage:\n"
+		"  asset_builder.exe -update -workspace <folder>\n"
+		"  asset_builder.exe -build -workspace <folder> -dest <folder> [-threads <count>] [-rebuild]\n"
+		"Options:\n"
+		"  -update     Ensures that the metadata of every asset in the workspace is up to date.\n"
+		"  -build      Encodes the workspace into the destination folder. Unchanged assets are skipped.\n"
+		"  -threads    The number of assets to encode at once. Defaults to the number of hardware threads.\n"
+		"  -rebuild    Ignores the build cache and encodes every asset.";
+}
+
+int main()
+{
+	gem::InitializeReflectionTables();
+
+	const bool update = gem::HasCommandLineArg("-update");
+	const bool build = gem::HasCommandLineArg("-build");
+	if (!update && !build)
+	{
+		gem::Log(usage);
+		return EXIT_FAILURE;
+	}
+
+	const char* workspace = nullptr;
+	if (!gem::GetCommandLineArg("-workspace", workspace))
+	{
+		gem::Error("Invalid command line parameters: Missing '-workspace <folder>'");
+		gem::Log(usage);
+		return EXIT_FAILURE;
+	}
+
+	unsigned numThreads = 0;
+	if (gem::HasCommandLineArg("-threads") && !gem::GetCommandLineArg("-threads", numThreads))
+	{
+		gem::Error("Invalid command line parameters: Expected '-threads <count>'");
+		gem::Log(usage);
+		return EXIT_FAILURE;
+	}
+
+	// Matches the default encoders of the AssetManager's workspace.
+	FontEncoder fontEncoder;
+	MaterialEncoder materialEncoder;
+	// Meshes are either encoded alongside other assets, or '-threads 1' limits the whole build to one thread.
+	// Either way, each one is parsed on a single thread.
+	MeshEncoder meshEncoder(1);
+	SoundEncoder soundEncoder;
+	TextureEncoder textureEncoder;
+
+	gem::AssetBuilder builder;
+	builder.AddEncoder(".ttf", fontEncoder);
+	builder.AddEncoder(".mat", materialEncoder);
+	builder.AddEncoder(".obj", meshEncoder);
+	builder.AddEncoder(".wav", soundEncoder);
+	builder.AddEncoder(".flac", soundEncoder);
+	builder.AddEncoder(".ogg", soundEncoder);
+	builder.AddEncoder(".mp3", soundEncoder);
+	builder.AddEncoder(".png", textureEncoder);
+	builder.AddEncoder(".jpg", textureEncoder);
+	builder.AddEncoder(".tga", textureEncoder);
+	builder.AddEncoder(".bmp", textureEncoder);
+
+	if (update && !builder.Update(workspace, numThreads))
+	{
+		return EXIT_FAILURE;
+	}
+
+	if (build)
+	{
+		const char* dest = nullptr;
+		if (!gem::GetCommandLineArg("-dest", dest))
+		{
+			gem::Error("Invalid command line parameters: Missing '-dest <folder>'");
+			gem::Log(usage);
+			return EXIT_FAILURE;
+		}
+
+		if (!builder.Build(workspace, dest, numThreads, gem::HasCommandLineArg("-rebuild")))
+		{
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}
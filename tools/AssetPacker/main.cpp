@@ -0,0 +1,85 @@
+// Copyright (c) 2026 Emilian Cioca
+#include <gemcutter/Application/CmdArgs.h>
+#include <gemcutter/Application/FileSystem.h>
+#include <gemcutter/Application/Logging.h>
+#include <gemcutter/Resource/AssetPack.h>
+
+#include <string>
+
+namespace
+{
+	constexpr std::string_view usage =
+		"Gemcutter asset packer.\nUsage:\n"
+		"  asset_packer.exe -src <folder> -dest <file> [-compress]\n"
+		"Options:\n"
+		"  -src        The folder of packed assets to archive.\n"
+		"  -dest       The AssetPack file to create.\n"
+		"  -compress   Compress the files with LZ4. Compressed files cannot be read directly from the mapped pack.";
+
+	// Recursively adds the contents of the folder to the pack, relative to the root folder.
+	bool AddDirectory(gem::AssetPackWriter& writer, const std::string& root, const std::string& relativePath, gem::AssetCompression compression)
+	{
+		gem::DirectoryData directory;
+		if (!gem::ParseDirectory(directory, root + relativePath))
+		{
+			gem::Error("Unable to read directory \"%s%s\".", root.c_str(), relativePath.c_str());
+			return false;
+		}
+
+		for (const std::string& file : directory.files)
+		{
+			const std::string path = relativePath + file;
+			if (!writer.AddFile(path, root + path, compression))
+			{
+				return false;
+			}
+		}
+
+		for (const std::string& folder : directory.folders)
+		{
+			if (!AddDirectory(writer, root, relativePath + folder + "/", compression))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+int main()
+{
+	const char* src = nullptr;
+	if (!gem::GetCommandLineArg("-src", src))
+	{
+		gem::Error("Invalid command line parameters: Missing '-src <folder>'");
+		gem::Log(usage);
+		return EXIT_FAILURE;
+	}
+
+	const char* dest = nullptr;
+	if (!gem::GetCommandLineArg("-dest", dest))
+	{
+		gem::Error("Invalid command line parameters: Missing '-dest <file>'");
+		gem::Log(usage);
+		return EXIT_FAILURE;
+	}
+
+	const auto compression = gem::HasCommandLineArg("-compress") ? gem::AssetCompression::LZ4 : gem::AssetCompression::None;
+
+	std::string root = src;
+	if (!root.ends_with('/') && !root.ends_with('\\'))
+	{
+		root += '/';
+	}
+
+	gem::AssetPackWriter writer;
+	if (!AddDirectory(writer, root, "", compression) || !writer.Save(dest))
+	{
+		return EXIT_FAILURE;
+	}
+
+	gem::Log("Packed %u files into \"%s\".", writer.GetNumEntries(), dest);
+
+	return EXIT_SUCCESS;
+}
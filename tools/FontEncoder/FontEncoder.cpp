@@ -123,9 +123,14 @@ bool FontEncoder::Validate(const gem::ConfigTable& metadata, unsigned loadedVers
 	return true;
 }
 
+std::string_view FontEncoder::GetOutputExtension() const
+{
+	return ".font";
+}
+
 bool FontEncoder::Convert(std::string_view source, std::string_view destination, const gem::ConfigTable& metadata) const
 {
-	const std::string outputFile = std::string(destination) + gem::ExtractFilename(source) + ".font";
+	const std::string outputFile = GetOutputFile(source, destination);
 	const unsigned width  = static_cast<unsigned>(metadata.GetInt("width"));
 	const unsigned height = static_cast<unsigned>(metadata.GetInt("height"));
 	const auto filter = gem::StringToEnum<gem::TextureFilter>(metadata.GetString("texture_filter")).value();
@@ -156,9 +156,14 @@ bool MaterialEncoder::Validate(const gem::ConfigTable& metadata, unsigned loaded
 	return true;
 }
 
+std::string_view MaterialEncoder::GetOutputExtension() const
+{
+	return ".material";
+}
+
 bool MaterialEncoder::Convert(std::string_view source, std::string_view destination, const gem::ConfigTable& metadata) const
 {
-	const std::string outputFile = std::string(destination) + gem::ExtractFilename(source) + ".material";
+	const std::string outputFile = GetOutputFile(source, destination);
 	const std::string shader = metadata.GetString("shader");
 	const std::vector<int> units = metadata.GetIntArray("texture_bind_points");
 	const std::vector<std::string> textures = metadata.GetStringArray("textures");
@@ -1,31 +1,26 @@
 // Copyright (c) 2017 Emilian Cioca
 #include "MeshEncoder.h"
 
+#include <gemcutter/Application/Reflection.h>
 #include <gemcutter/Math/Matrix.h>
+#include <gemcutter/Math/Quantization.h>
 #include <gemcutter/Math/Vector.h>
 #include <gemcutter/Resource/Encoder.h>
+#include <gemcutter/Resource/MeshOptimizer.h>
+#include <gemcutter/Resource/Model.h>
+#include <gemcutter/Resource/ObjParser.h>
 #include <gemcutter/Resource/VertexArray.h>
 
-#include <fstream>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <vector>
 
-#define CURRENT_VERSION 2
-#define CHAR_BUFFER_SIZE 128
+#define CURRENT_VERSION 4
 
-// Indices for three points; one triangle. v1/vt1/vn1 v2/vt2/vn2 v3/vt3/vn3
-struct MeshFace
-{
-	unsigned vertices[3];
-	unsigned textures[3];
-	unsigned normals[3];
-
-	// Calculated after indices have been read.
-	// xyz = normalized tangent, w = handedness.
-	gem::vec4 tangent[3];
-};
-
-MeshEncoder::MeshEncoder()
+MeshEncoder::MeshEncoder(unsigned _parseThreads)
 	: Encoder(CURRENT_VERSION)
+	, parseThreads(_parseThreads)
 {
 }
 
@@ -38,6 +33,10 @@ gem::ConfigTable MeshEncoder::GetDefault() const
 	defaultConfig.SetBool("uvs", true);
 	defaultConfig.SetBool("normals", true);
 	defaultConfig.SetBool("tangents", true);
+	defaultConfig.SetBool("optimize", true);
+	defaultConfig.SetString("position_format", gem::EnumToString(gem::PositionFormat::Float));
+	defaultConfig.SetString("uv_format", gem::EnumToString(gem::UVFormat::Float));
+	defaultConfig.SetString("normal_format", gem::EnumToString(gem::NormalFormat::Float));
 
 	return defaultConfig;
 }
@@ -86,6 +85,71 @@ bool MeshEncoder::Validate(const gem::ConfigTable& metadata, unsigned loadedVers
 		}
 		break;
 
+	case 3:
+		if (!metadata.HasSetting("tangents"))
+		{
+			gem::Error("Missing \"tangents\" value.");
+			return false;
+		}
+
+		if (!metadata.HasSetting("optimize"))
+		{
+			gem::Error("Missing \"optimize\" value.");
+			return false;
+		}
+
+		if (metadata.GetSize() != 6)
+		{
+			gem::Error("Incorrect number of value entries.");
+			return false;
+		}
+		break;
+
+	case 4:
+		if (!metadata.HasSetting("tangents"))
+		{
+			gem::Error("Missing \"tangents\" value.");
+			return false;
+		}
+
+		if (!metadata.HasSetting("optimize"))
+		{
+			gem::Error("Missing \"optimize\" value.");
+			return false;
+		}
+
+		if (!metadata.HasSetting("position_format"))
+		{
+			gem::Error("Missing \"position_format\" value.");
+			return false;
+		}
+
+		if (!metadata.HasSetting("uv_format"))
+		{
+			gem::Error("Missing \"uv_format\" value.");
+			return false;
+		}
+
+		if (!metadata.HasSetting("normal_format"))
+		{
+			gem::Error("Missing \"normal_format\" value.");
+			return false;
+		}
+
+		if (!gem::ValidateEnumValue<gem::PositionFormat>("position_format", metadata.GetString("position_format")) ||
+			!gem::ValidateEnumValue<gem::UVFormat>("uv_format", metadata.GetString("uv_format")) ||
+			!gem::ValidateEnumValue<gem::NormalFormat>("normal_format", metadata.GetString("normal_format")))
+		{
+			return false;
+		}
+
+		if (metadata.GetSize() != 9)
+		{
+			gem::Error("Incorrect number of value entries.");
+			return false;
+		}
+		break;
+
 	default:
 		gem::Error("Missing validation code for version %d", loadedVersion);
 		return false;
@@ -94,159 +158,60 @@ bool MeshEncoder::Validate(const gem::ConfigTable& metadata, unsigned loadedVers
 	return true;
 }
 
+std::string_view MeshEncoder::GetOutputExtension() const
+{
+	return ".model";
+}
+
 bool MeshEncoder::Convert(std::string_view source, std::string_view destination, const gem::ConfigTable& metadata) const
 {
-	const std::string outputFile = std::string(destination) + gem::ExtractFilename(source) + ".model";
+	const std::string outputFile = GetOutputFile(source, destination);
 	const float scale = metadata.GetFloat("scale");
 	const bool packUvs = metadata.GetBool("uvs");
 	const bool packNormals = metadata.GetBool("normals");
 	const bool packTangents = metadata.GetBool("tangents");
+	const bool optimize = metadata.GetBool("optimize");
+	const auto positionFormat = gem::StringToEnum<gem::PositionFormat>(metadata.GetString("position_format")).value();
+	const auto uvFormat = gem::StringToEnum<gem::UVFormat>(metadata.GetString("uv_format")).value();
+	const auto normalFormat = gem::StringToEnum<gem::NormalFormat>(metadata.GetString("normal_format")).value();
 
-	// Load ASCII file.
-	std::ifstream input;
-	input.open(source.data());
-	if (!input)
+	gem::ObjMesh mesh;
+	if (!gem::LoadObj(source, mesh, parseThreads))
 	{
 		gem::Error("Input file could not be opened or processed.");
 		return false;
 	}
 
-	char inputString[CHAR_BUFFER_SIZE] = { '\0' };
-	bool hasUvs = false;
-	bool hasNormals = false;
-
-	// Unique data.
-	std::vector<gem::vec3> vertexData;
-	std::vector<gem::vec2> textureData;
-	std::vector<gem::vec3> normalData;
-	// Indexing data.
-	std::vector<MeshFace> faceData;
-
-	vertexData.reserve(128);
-	textureData.reserve(128);
-	normalData.reserve(128);
-	faceData.reserve(256);
-
-	gem::vec3 minBounds{ FLT_MAX };
-	gem::vec3 maxBounds{ FLT_MIN };
+	const bool hasUvs = !mesh.uvs.empty();
+	const bool hasNormals = !mesh.normals.empty();
+	const bool useUvs = packUvs && hasUvs;
+	const bool useNormals = packNormals && hasNormals;
+	const bool useTangents = packTangents && hasUvs && hasNormals;
 
-	while (!input.eof())
+	// Every face must provide the attributes which are being packed.
+	for (const gem::ObjCorner& corner : mesh.corners)
 	{
-		input.getline(inputString, CHAR_BUFFER_SIZE);
-
-		if (inputString[0] == 'v')
+		if (((useUvs || useTangents) && corner.uv == gem::ObjCorner::None) ||
+			((useNormals || useTangents) && corner.normal == gem::ObjCorner::None))
 		{
-			if (inputString[1] == 't')
-			{
-				hasUvs = true;
-
-				if (!(packUvs || packTangents))
-					continue;
-
-				// Load texture coordinates.
-				char* endPtr;
-				gem::vec2 temp;
-				temp.x = std::strtof(inputString + 3, &endPtr);
-				temp.y = std::strtof(endPtr + 1, nullptr);
-
-				textureData.push_back(temp);
-			}
-			else if (inputString[1] == 'n')
-			{
-				hasNormals = true;
-
-				if (!(packNormals || packTangents))
-					continue;
-
-				// Load normals.
-				char* endPtr;
-				gem::vec3 temp;
-				temp.x = std::strtof(inputString + 3, &endPtr);
-				temp.y = std::strtof(endPtr + 1, &endPtr);
-				temp.z = std::strtof(endPtr + 1, nullptr);
-
-				normalData.push_back(temp);
-			}
-			else
-			{
-				// Load vertices.
-				char* endPtr;
-				gem::vec3 temp;
-				temp.x = std::strtof(inputString + 2, &endPtr);
-				temp.y = std::strtof(endPtr + 1, &endPtr);
-				temp.z = std::strtof(endPtr + 1, nullptr);
-
-				if (temp.x < minBounds.x) minBounds.x = temp.x;
-				if (temp.y < minBounds.y) minBounds.y = temp.y;
-				if (temp.z < minBounds.z) minBounds.z = temp.z;
-
-				if (temp.x > maxBounds.x) maxBounds.x = temp.x;
-				if (temp.y > maxBounds.y) maxBounds.y = temp.y;
-				if (temp.z > maxBounds.z) maxBounds.z = temp.z;
-
-				vertexData.push_back(temp);
-			}
+			gem::Error("Some faces are missing vertex attributes which are being packed.");
+			return false;
 		}
-		else if (inputString[0] == 'f')
-		{
-			// Load face indices.
-			MeshFace face;
-			char* endPtr;
-
-			// Each permutation of data formats.
-			if (hasUvs && hasNormals)
-			{
-				// Format of "f #/#/# #/#/# #/#/#"
-				face.vertices[0] = std::strtol(inputString + 2, &endPtr, 10);
-				face.textures[0] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.normals[0] = std::strtol(endPtr + 1, &endPtr, 10);
-
-				face.vertices[1] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.textures[1] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.normals[1] = std::strtol(endPtr + 1, &endPtr, 10);
-
-				face.vertices[2] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.textures[2] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.normals[2] = std::strtol(endPtr + 1, nullptr, 10);
-			}
-			else if (hasUvs && !hasNormals)
-			{
-				// Format: "f #/# #/# #/#"
-				face.vertices[0] = std::strtol(inputString + 2, &endPtr, 10);
-				face.textures[0] = std::strtol(endPtr + 1, &endPtr, 10);
-
-				face.vertices[1] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.textures[1] = std::strtol(endPtr + 1, &endPtr, 10);
-
-				face.vertices[2] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.textures[2] = std::strtol(endPtr + 1, nullptr, 10);
-			}
-			else if (!hasUvs && hasNormals)
-			{
-				// Format: "f #//# #//# #//#"
-				face.vertices[0] = std::strtol(inputString + 2, &endPtr, 10);
-				face.normals[0] = std::strtol(endPtr + 2, &endPtr, 10);
+	}
 
-				face.vertices[1] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.normals[1] = std::strtol(endPtr + 2, &endPtr, 10);
+	std::vector<gem::vec3>& vertexData = mesh.positions;
+	const std::vector<gem::vec2>& textureData = mesh.uvs;
+	const std::vector<gem::vec3>& normalData = mesh.normals;
+	const std::vector<gem::ObjCorner>& corners = mesh.corners;
 
-				face.vertices[2] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.normals[2] = std::strtol(endPtr + 2, nullptr, 10);
-			}
-			else
-			{
-				// Format: "f # # #"
-				face.vertices[0] = std::strtol(inputString + 2, &endPtr, 10);
-				face.vertices[1] = std::strtol(endPtr + 1, &endPtr, 10);
-				face.vertices[2] = std::strtol(endPtr + 1, nullptr, 10);
-			}
-
-			faceData.push_back(face);
-		}
+	gem::vec3 minBounds{ FLT_MAX };
+	gem::vec3 maxBounds{ -FLT_MAX };
+	for (const gem::vec3& vertex : vertexData)
+	{
+		minBounds = gem::Min(minBounds, vertex);
+		maxBounds = gem::Max(maxBounds, vertex);
 	}
 
-	input.close();
-
 	// Apply scale.
 	if (scale != 1.0f)
 	{
@@ -254,32 +219,29 @@ bool MeshEncoder::Convert(std::string_view source, std::string_view destination,
 		{
 			vertex *= scale;
 		}
-	}
 
-	const bool useUvs = packUvs && hasUvs;
-	const bool useNormals = packNormals && hasNormals;
-	const bool useTangents = packTangents && hasUvs && hasNormals;
+		minBounds *= scale;
+		maxBounds *= scale;
+		if (scale < 0.0f)
+		{
+			std::swap(minBounds, maxBounds);
+		}
+	}
 
-	// Generate tangent vectors.
+	// Generate tangent vectors. xyz = normalized tangent, w = handedness.
+	std::vector<gem::vec4> tangentData;
 	if (useTangents)
 	{
-		for (unsigned i = 0; i < faceData.size(); ++i)
+		tangentData.resize(corners.size());
+		for (size_t i = 0; i < corners.size(); i += 3)
 		{
-			const gem::vec3 edge1 =
-				vertexData[faceData[i].vertices[0] - 1] -
-				vertexData[faceData[i].vertices[1] - 1];
-
-			const gem::vec3 edge2 =
-				vertexData[faceData[i].vertices[0] - 1] -
-				vertexData[faceData[i].vertices[2] - 1];
+			const gem::ObjCorner* face = &corners[i];
 
-			const gem::vec2 edgeUV1 =
-				textureData[faceData[i].textures[0] - 1] -
-				textureData[faceData[i].textures[1] - 1];
+			const gem::vec3 edge1 = vertexData[face[0].position] - vertexData[face[1].position];
+			const gem::vec3 edge2 = vertexData[face[0].position] - vertexData[face[2].position];
 
-			const gem::vec2 edgeUV2 =
-				textureData[faceData[i].textures[0] - 1] -
-				textureData[faceData[i].textures[2] - 1];
+			const gem::vec2 edgeUV1 = textureData[face[0].uv] - textureData[face[1].uv];
+			const gem::vec2 edgeUV2 = textureData[face[0].uv] - textureData[face[2].uv];
 
 			const gem::mat2 UVs = gem::mat2(
 				edgeUV1.x, edgeUV1.y,
@@ -298,7 +260,7 @@ bool MeshEncoder::Convert(std::string_view source, std::string_view destination,
 			// Each face's tangent is further refined per-vertex by using their respective normals.
 			for (unsigned v = 0; v < 3; ++v)
 			{
-				const gem::vec3 normal = normalData[faceData[i].normals[v] - 1];
+				const gem::vec3 normal = normalData[face[v].normal];
 
 				// Calculate handedness.
 				const float handedness = gem::Dot(gem::Cross(normal, tangent), bitangent) < 0.0f ? -1.0f : 1.0f;
@@ -306,59 +268,135 @@ bool MeshEncoder::Convert(std::string_view source, std::string_view destination,
 				// Orthonormalize the tangent with respect to the normal.
 				const gem::vec3 t = gem::Normalize(tangent - normal * gem::Dot(normal, tangent));
 
-				faceData[i].tangent[v] = gem::vec4(t, handedness);
+				tangentData[i + v] = gem::vec4(t, handedness);
 			}
 		}
 	}
 
-	const unsigned numVertices = static_cast<unsigned>(faceData.size() * 3);
-	if (numVertices >= gem::VertexBuffer::RESTART_INDEX)
-	{
-		gem::Error("The mesh is too large. It has %d vertices, but needs less than %d.", numVertices, gem::VertexBuffer::RESTART_INDEX);
-		return false;
-	}
+	unsigned vertexSize = (positionFormat == gem::PositionFormat::Float) ? sizeof(float) * 3 : sizeof(uint16_t) * 4;
+	if (useUvs) vertexSize += (uvFormat == gem::UVFormat::Float) ? sizeof(float) * 2 : sizeof(uint16_t) * 2;
+	if (useNormals) vertexSize += (normalFormat == gem::NormalFormat::Float) ? sizeof(float) * 3 : sizeof(int16_t) * 2;
+	if (useTangents) vertexSize += (normalFormat == gem::NormalFormat::Float) ? sizeof(float) * 4 : sizeof(int16_t) * 4;
 
-	unsigned bufferSize = numVertices * 3;
-	if (useUvs) bufferSize += numVertices * 2;
-	if (useNormals) bufferSize += numVertices * 3;
-	if (useTangents) bufferSize += numVertices * 4;
+	std::vector<std::byte> data;
+	data.reserve(corners.size() * vertexSize);
 
-	float* data = static_cast<float*>(malloc(sizeof(float) * bufferSize));
-	defer{ free(data); };
+	auto write = [&data](const auto& value) {
+		const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+		data.insert(data.end(), bytes, bytes + sizeof(value));
+	};
+
+	const gem::mat4 positionDecode = gem::Model::ComputePositionDecode(positionFormat, minBounds, maxBounds);
+	const gem::mat4 positionEncode = positionDecode.GetInverse();
 
 	// Unpack the data.
-	unsigned pen = 0;
-	for (unsigned i = 0; i < faceData.size(); ++i)
+	for (size_t i = 0; i < corners.size(); ++i)
 	{
-		for (unsigned j = 0; j < 3; ++j)
+		const gem::ObjCorner& corner = corners[i];
+
+		const gem::vec3& position = vertexData[corner.position];
+		const gem::vec4 encoded = positionEncode * gem::vec4(position, 1.0f);
+		switch (positionFormat)
+		{
+		case gem::PositionFormat::Float:
+			write(std::array{ position.x, position.y, position.z });
+			break;
+		case gem::PositionFormat::Half:
+			write(std::array{ gem::FloatToHalf(encoded.x), gem::FloatToHalf(encoded.y), gem::FloatToHalf(encoded.z), gem::FloatToHalf(1.0f) });
+			break;
+		case gem::PositionFormat::UNorm16:
+			write(std::array{ gem::QuantizeUNorm16(encoded.x), gem::QuantizeUNorm16(encoded.y), gem::QuantizeUNorm16(encoded.z), gem::QuantizeUNorm16(1.0f) });
+			break;
+		}
+
+		if (useUvs)
+		{
+			const gem::vec2& uv = textureData[corner.uv];
+			if (uvFormat == gem::UVFormat::Half)
+			{
+				write(std::array{ gem::FloatToHalf(uv.x), gem::FloatToHalf(uv.y) });
+			}
+			else
+			{
+				write(std::array{ uv.x, uv.y });
+			}
+		}
+
+		if (useNormals)
 		{
-			data[pen++] = vertexData[faceData[i].vertices[j] - 1].x;
-			data[pen++] = vertexData[faceData[i].vertices[j] - 1].y;
-			data[pen++] = vertexData[faceData[i].vertices[j] - 1].z;
+			const gem::vec3& normal = normalData[corner.normal];
+			if (normalFormat == gem::NormalFormat::Octahedral)
+			{
+				const gem::vec2 octahedral = gem::EncodeOctahedral(normal);
+				write(std::array{ gem::QuantizeSNorm16(octahedral.x), gem::QuantizeSNorm16(octahedral.y) });
+			}
+			else
+			{
+				write(std::array{ normal.x, normal.y, normal.z });
+			}
+		}
 
-			if (useUvs)
+		if (useTangents)
+		{
+			const gem::vec4& tangent = tangentData[i];
+			if (normalFormat == gem::NormalFormat::Octahedral)
 			{
-				data[pen++] = textureData[faceData[i].textures[j] - 1].x;
-				data[pen++] = textureData[faceData[i].textures[j] - 1].y;
+				const gem::vec2 octahedral = gem::EncodeOctahedral(gem::vec3(tangent.x, tangent.y, tangent.z));
+				write(std::array{ gem::QuantizeSNorm16(octahedral.x), gem::QuantizeSNorm16(octahedral.y), gem::QuantizeSNorm16(tangent.w), int16_t{ 0 } });
 			}
+			else
+			{
+				write(std::array{ tangent.x, tangent.y, tangent.z, tangent.w });
+			}
+		}
+	}
+
+	// Build the index buffer from the unique vertices.
+	std::vector<std::byte> vertices;
+	std::vector<unsigned> indices;
+	unsigned numVertices = gem::DeduplicateVertices(data, vertexSize, vertices, indices);
+	const unsigned numIndices = static_cast<unsigned>(indices.size());
+
+	if (optimize)
+	{
+		gem::OptimizeVertexCache(indices, numVertices);
 
-			if (useNormals)
+		// Overdraw is measured with the decoded positions.
+		std::vector<gem::vec3> positions(numVertices);
+		for (unsigned i = 0; i < numVertices; ++i)
+		{
+			const std::byte* vertex = vertices.data() + i * vertexSize;
+			if (positionFormat == gem::PositionFormat::Float)
 			{
-				data[pen++] = normalData[faceData[i].normals[j] - 1].x;
-				data[pen++] = normalData[faceData[i].normals[j] - 1].y;
-				data[pen++] = normalData[faceData[i].normals[j] - 1].z;
+				std::memcpy(&positions[i], vertex, sizeof(gem::vec3));
+				continue;
 			}
 
-			if (useTangents)
+			std::array<uint16_t, 4> encoded;
+			std::memcpy(encoded.data(), vertex, sizeof(encoded));
+
+			gem::vec4 decoded;
+			for (unsigned c = 0; c < 3; ++c)
 			{
-				data[pen++] = faceData[i].tangent[j].x;
-				data[pen++] = faceData[i].tangent[j].y;
-				data[pen++] = faceData[i].tangent[j].z;
-				data[pen++] = faceData[i].tangent[j].w;
+				decoded[c] = (positionFormat == gem::PositionFormat::Half)
+					? gem::HalfToFloat(encoded[c])
+					: gem::DequantizeUNorm16(encoded[c]);
 			}
+			decoded.w = 1.0f;
+			decoded = positionDecode * decoded;
+
+			positions[i] = gem::vec3(decoded.x, decoded.y, decoded.z);
 		}
+
+		gem::OptimizeOverdraw(indices, positions);
 	}
 
+	numVertices = gem::OptimizeVertexFetch(indices, vertices, vertexSize);
+
+	// The restart index is reserved, so it cannot be used to reference a vertex.
+	const uint8_t indexSize = (numVertices < gem::VertexBuffer::RESTART_INDEX) ? sizeof(uint16_t) : sizeof(uint32_t);
+	const uint8_t padding = 0;
+
 	// Save file.
 	FILE* modelFile = fopen(outputFile.c_str(), "wb");
 	if (modelFile == nullptr)
@@ -368,15 +406,38 @@ bool MeshEncoder::Convert(std::string_view source, std::string_view destination,
 	}
 
 	// Write header.
-	fwrite(&minBounds,   sizeof(minBounds),   1, modelFile);
-	fwrite(&maxBounds,   sizeof(maxBounds),   1, modelFile);
-	fwrite(&useUvs,      sizeof(useUvs),      1, modelFile);
-	fwrite(&useNormals,  sizeof(useNormals),  1, modelFile);
-	fwrite(&useTangents, sizeof(useTangents), 1, modelFile);
-	fwrite(&numVertices, sizeof(numVertices), 1, modelFile);
+	fwrite(gem::Model::FileTag.data(), sizeof(char), gem::Model::FileTag.size(), modelFile);
+	fwrite(&gem::Model::FileVersion, sizeof(gem::Model::FileVersion), 1, modelFile);
+	fwrite(&minBounds,      sizeof(minBounds),      1, modelFile);
+	fwrite(&maxBounds,      sizeof(maxBounds),      1, modelFile);
+	fwrite(&useUvs,         sizeof(useUvs),         1, modelFile);
+	fwrite(&useNormals,     sizeof(useNormals),     1, modelFile);
+	fwrite(&useTangents,    sizeof(useTangents),    1, modelFile);
+	fwrite(&indexSize,      sizeof(indexSize),      1, modelFile);
+	fwrite(&positionFormat, sizeof(positionFormat), 1, modelFile);
+	fwrite(&uvFormat,       sizeof(uvFormat),       1, modelFile);
+	fwrite(&normalFormat,   sizeof(normalFormat),   1, modelFile);
+	fwrite(&padding,        sizeof(padding),        1, modelFile);
+	fwrite(&numVertices,    sizeof(numVertices),    1, modelFile);
+	fwrite(&numIndices,     sizeof(numIndices),     1, modelFile);
 
 	// Write Data.
-	fwrite(data, sizeof(data[0]), bufferSize, modelFile);
+	fwrite(vertices.data(), sizeof(vertices[0]), vertices.size(), modelFile);
+	if (indexSize == sizeof(uint16_t))
+	{
+		std::vector<uint16_t> shortIndices;
+		shortIndices.reserve(indices.size());
+		for (unsigned index : indices)
+		{
+			shortIndices.push_back(static_cast<uint16_t>(index));
+		}
+
+		fwrite(shortIndices.data(), sizeof(shortIndices[0]), shortIndices.size(), modelFile);
+	}
+	else
+	{
+		fwrite(indices.data(), sizeof(indices[0]), indices.size(), modelFile);
+	}
 	auto result = fclose(modelFile);
 
 	// Report results.
@@ -419,6 +480,18 @@ bool MeshEncoder::Upgrade(gem::ConfigTable& metadata, unsigned loadedVersion) co
 		// Added tangents field.
 		metadata.SetBool("tangents", true);
 		break;
+
+	case 2:
+		// Added optimize field.
+		metadata.SetBool("optimize", true);
+		break;
+
+	case 3:
+		// Added quantized vertex formats.
+		metadata.SetString("position_format", gem::EnumToString(gem::PositionFormat::Float));
+		metadata.SetString("uv_format", gem::EnumToString(gem::UVFormat::Float));
+		metadata.SetString("normal_format", gem::EnumToString(gem::NormalFormat::Float));
+		break;
 	}
 
 	return true;
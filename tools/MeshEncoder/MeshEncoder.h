@@ -5,14 +5,18 @@
 class MeshEncoder final : public gem::Encoder
 {
 public:
-	MeshEncoder();
+	// 'parseThreads' is passed to gem::LoadObj(). A value of 0 uses all of the available hardware threads.
+	MeshEncoder(unsigned parseThreads = 0);
 
 	gem::ConfigTable GetDefault() const override;
 
 	bool Validate(const gem::ConfigTable& metadata, unsigned loadedVersion) const override;
 
 private:
+	std::string_view GetOutputExtension() const override;
 	bool Convert(std::string_view source, std::string_view destination, const gem::ConfigTable& metadata) const override;
 
 	bool Upgrade(gem::ConfigTable& metadata, unsigned loadedVersion) const override;
+
+	const unsigned parseThreads;
 };
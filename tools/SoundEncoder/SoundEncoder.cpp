@@ -3,7 +3,7 @@
 #include <gemcutter/Resource/Sound.h>
 #include <gemcutter/Utilities/String.h>
 
-#define CURRENT_VERSION 2
+#define CURRENT_VERSION 3
 
 SoundEncoder::SoundEncoder()
 	: gem::Encoder(CURRENT_VERSION)
@@ -23,6 +23,7 @@ gem::ConfigTable SoundEncoder::GetDefault() const
 	defaultConfig.SetFloat("volume", 1.0f);
 	defaultConfig.SetFloat("3d_min_distance", 1.0f);
 	defaultConfig.SetFloat("3d_max_distance", 100.0f);
+	defaultConfig.SetBool("stream", false);
 
 	return defaultConfig;
 }
@@ -129,6 +130,20 @@ bool SoundEncoder::Validate(const gem::ConfigTable& metadata, unsigned loadedVer
 		}
 		break;
 
+	case 3:
+		if (!metadata.HasSetting("stream"))
+		{
+			gem::Error("Missing \"stream\" value.");
+			return false;
+		}
+
+		if (metadata.GetSize() != 10)
+		{
+			gem::Error("Incorrect number of value entries.");
+			return false;
+		}
+		break;
+
 	default:
 		gem::Error("Missing validation code for version %d", loadedVersion);
 		return false;
@@ -137,9 +152,14 @@ bool SoundEncoder::Validate(const gem::ConfigTable& metadata, unsigned loadedVer
 	return true;
 }
 
+std::string_view SoundEncoder::GetOutputExtension() const
+{
+	return ".sound";
+}
+
 bool SoundEncoder::Convert(std::string_view source, std::string_view destination, const gem::ConfigTable& metadata) const
 {
-	const std::string outputFile = std::string(destination) + gem::ExtractFilename(source) + ".sound";
+	const std::string outputFile = GetOutputFile(source, destination);
 	const bool is3D = metadata.GetBool("3d");
 	const bool loop = metadata.GetBool("loop");
 	const bool unique = metadata.GetBool("unique_instance");
@@ -148,6 +168,7 @@ bool SoundEncoder::Convert(std::string_view source, std::string_view destination
 	const float volume = metadata.GetFloat("volume");
 	const float minDistance = metadata.GetFloat("3d_min_distance");
 	const float maxDistance = metadata.GetFloat("3d_max_distance");
+	const bool stream = metadata.GetBool("stream");
 
 	FILE* soundFile = fopen(outputFile.c_str(), "wb");
 	if (soundFile == nullptr)
@@ -156,6 +177,9 @@ bool SoundEncoder::Convert(std::string_view source, std::string_view destination
 		return false;
 	}
 
+	fwrite(gem::Sound::FileTag.data(), sizeof(char), gem::Sound::FileTag.size(), soundFile);
+	fwrite(&gem::Sound::FileVersion, sizeof(gem::Sound::FileVersion), 1, soundFile);
+
 	fwrite(&is3D, sizeof(is3D), 1, soundFile);
 	fwrite(&loop, sizeof(loop), 1, soundFile);
 	fwrite(&unique, sizeof(unique), 1, soundFile);
@@ -164,6 +188,7 @@ bool SoundEncoder::Convert(std::string_view source, std::string_view destination
 	fwrite(&volume, sizeof(volume), 1, soundFile);
 	fwrite(&minDistance, sizeof(minDistance), 1, soundFile);
 	fwrite(&maxDistance, sizeof(maxDistance), 1, soundFile);
+	fwrite(&stream, sizeof(stream), 1, soundFile);
 
 	std::vector<std::byte> rawSoundFile;
 	if (!gem::LoadFileAsBinary(source, rawSoundFile))
@@ -194,6 +219,11 @@ bool SoundEncoder::Upgrade(gem::ConfigTable& metadata, unsigned loadedVersion) c
 		// Enums became case sensitive.
 		metadata.SetString("3d_attenuation", gem::FixEnumCasing(metadata.GetString("3d_attenuation"), gem::AttenuationFunc::None));
 		break;
+
+	case 2:
+		// Added support for streaming.
+		metadata.SetBool("stream", false);
+		break;
 	}
 
 	return true;
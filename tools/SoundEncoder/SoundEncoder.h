@@ -12,6 +12,7 @@ public:
 	bool Validate(const gem::ConfigTable& metadata, unsigned loadedVersion) const override;
 
 private:
+	std::string_view GetOutputExtension() const override;
 	bool Convert(std::string_view source, std::string_view destination, const gem::ConfigTable& metadata) const override;
 
 	bool Upgrade(gem::ConfigTable& metadata, unsigned loadedVersion) const override;
@@ -2,9 +2,52 @@
 #include "TextureEncoder.h"
 #include <gemcutter/Rendering/Rendering.h>
 #include <gemcutter/Resource/Texture.h>
+#include <gemcutter/Resource/TextureProcessing.h>
 #include <gemcutter/Utilities/String.h>
 
-#define CURRENT_VERSION 3
+#define CURRENT_VERSION 4
+
+namespace
+{
+	gem::ImageRGBA8 CropImage(const gem::ImageRGBA8& image, unsigned startX, unsigned startY, unsigned size)
+	{
+		gem::ImageRGBA8 result;
+		result.width = size;
+		result.height = size;
+		result.pixels.resize(size * size * 4);
+
+		for (unsigned y = 0; y < size; ++y)
+		{
+			const uint8_t* row = &image.pixels[((startY + y) * image.width + startX) * 4];
+			memcpy(&result.pixels[y * size * 4], row, size * 4);
+		}
+
+		return result;
+	}
+
+	bool WriteLevel(FILE* file, const gem::ImageRGBA8& level, gem::TextureCompression compression, unsigned numChannels)
+	{
+		if (compression != gem::TextureCompression::None)
+		{
+			const auto data = gem::CompressImage(level, compression);
+			return fwrite(data.data(), sizeof(std::byte), data.size(), file) == data.size();
+		}
+
+		if (numChannels == 4)
+		{
+			return fwrite(level.pixels.data(), sizeof(uint8_t), level.pixels.size(), file) == level.pixels.size();
+		}
+
+		// Strip the alpha channel back out of RGB images.
+		std::vector<uint8_t> data(level.width * level.height * 3);
+		for (size_t i = 0; i < level.width * level.height; ++i)
+		{
+			memcpy(&data[i * 3], &level.pixels[i * 4], 3);
+		}
+
+		return fwrite(data.data(), sizeof(uint8_t), data.size(), file) == data.size();
+	}
+}
 
 TextureEncoder::TextureEncoder()
 	: gem::Encoder(CURRENT_VERSION)
@@ -22,6 +65,8 @@ gem::ConfigTable TextureEncoder::GetDefault() const
 	defaultConfig.SetString("filter", gem::EnumToString(gem::TextureFilter::Linear));
 	defaultConfig.SetString("wrap_x", gem::EnumToString(gem::TextureWrap::Clamp));
 	defaultConfig.SetString("wrap_y", gem::EnumToString(gem::TextureWrap::Clamp));
+	defaultConfig.SetString("mip_filter", gem::EnumToString(gem::MipFilter::Box));
+	defaultConfig.SetString("compression", gem::EnumToString(gem::TextureCompression::None));
 
 	return defaultConfig;
 }
@@ -105,6 +150,38 @@ bool TextureEncoder::Validate(const gem::ConfigTable& metadata, unsigned loadedV
 		}
 		break;
 
+	case 4:
+		if (!metadata.HasSetting("s_rgb"))
+		{
+			gem::Error("Missing \"s_rgb\" value.");
+			return false;
+		}
+
+		if (!metadata.HasSetting("mip_filter"))
+		{
+			gem::Error("Missing \"mip_filter\" value.");
+			return false;
+		}
+
+		if (!metadata.HasSetting("compression"))
+		{
+			gem::Error("Missing \"compression\" value.");
+			return false;
+		}
+
+		if (!gem::ValidateEnumValue<gem::MipFilter>("mip_filter", metadata.GetString("mip_filter")) ||
+			!gem::ValidateEnumValue<gem::TextureCompression>("compression", metadata.GetString("compression")))
+		{
+			return false;
+		}
+
+		if (metadata.GetSize() != 9)
+		{
+			gem::Error("Incorrect number of value entries.");
+			return false;
+		}
+		break;
+
 	default:
 		gem::Error("Missing validation code for version %d", loadedVersion);
 		return false;
@@ -113,36 +190,45 @@ bool TextureEncoder::Validate(const gem::ConfigTable& metadata, unsigned loadedV
 	return true;
 }
 
+std::string_view TextureEncoder::GetOutputExtension() const
+{
+	return ".texture";
+}
+
 bool TextureEncoder::Convert(std::string_view source, std::string_view destination, const gem::ConfigTable& metadata) const
 {
-	const std::string outputFile = std::string(destination) + gem::ExtractFilename(source) + ".texture";
+	const std::string outputFile = GetOutputFile(source, destination);
 	const float anisotropicLevel = metadata.GetFloat("anisotropic_level");
 	const bool isCubemap = metadata.GetBool("cubemap");
-	const bool isSRGB = metadata.GetBool("s_rgb");
+	bool isSRGB = metadata.GetBool("s_rgb");
 	const auto filter = gem::StringToEnum<gem::TextureFilter>(metadata.GetString("filter")).value();
 	const auto wrapX  = gem::StringToEnum<gem::TextureWrap>(metadata.GetString("wrap_x")).value();
 	const auto wrapY  = gem::StringToEnum<gem::TextureWrap>(metadata.GetString("wrap_y")).value();
+	const auto mipFilter   = gem::StringToEnum<gem::MipFilter>(metadata.GetString("mip_filter")).value();
+	const auto compression = gem::StringToEnum<gem::TextureCompression>(metadata.GetString("compression")).value();
+
+	if (isSRGB && (compression == gem::TextureCompression::BC4 || compression == gem::TextureCompression::BC5))
+	{
+		gem::Warning("BC4 and BC5 textures store linear data. Ignoring \"s_rgb\".");
+		isSRGB = false;
+	}
 
 	auto image = gem::RawImage::Load(source, !isCubemap, isSRGB);
 	if (image.data == nullptr)
 		return false;
 
 	const unsigned elementCount = gem::CountChannels(image.format);
+	const gem::ImageRGBA8 sourceImage = gem::ConvertToRGBA8(image.data, image.width, image.height, elementCount);
 
-	// Save file.
-	FILE* textureFile = fopen(outputFile.c_str(), "wb");
-	if (textureFile == nullptr)
-	{
-		gem::Error("Output file could not be created.");
-		return false;
-	}
-
+	// The faces of cubemaps are processed separately, in the order of +X, -X, +Y, -Y, +Z, -Z.
+	std::vector<gem::ImageRGBA8> faces;
+	gem::TextureWrap outputWrapX = wrapX;
+	gem::TextureWrap outputWrapY = wrapY;
 	if (isCubemap)
 	{
 		// Validate size. Width to height ratio must be 4/3.
 		if (image.width * 3 != image.height * 4)
 		{
-			fclose(textureFile);
 			gem::Error("Cubemap texture layout is incorrect.");
 			return false;
 		}
@@ -153,67 +239,70 @@ bool TextureEncoder::Convert(std::string_view source, std::string_view destinati
 			gem::Warning("Cubemaps must have \"Clamp\" wrap modes. Forcing wrap modes to \"Clamp\".");
 		}
 
-		const int faceSize = image.width / 4;
-		const gem::TextureWrap cubeMapWrapMode = gem::TextureWrap::Clamp;
-
-		// Write header.
-		fwrite(&isCubemap, sizeof(isCubemap), 1, textureFile);
-		fwrite(&faceSize, sizeof(faceSize), 1, textureFile);
-		fwrite(&faceSize, sizeof(faceSize), 1, textureFile);
-		fwrite(&image.format, sizeof(image.format), 1, textureFile);
-		fwrite(&filter, sizeof(filter), 1, textureFile);
-		fwrite(&cubeMapWrapMode, sizeof(cubeMapWrapMode), 1, textureFile);
-		fwrite(&cubeMapWrapMode, sizeof(cubeMapWrapMode), 1, textureFile);
-		fwrite(&anisotropicLevel, sizeof(anisotropicLevel), 1, textureFile);
-
-		// Write faces.
-		const unsigned textureSize = faceSize * faceSize * elementCount;
-		std::byte* data = static_cast<std::byte*>(malloc(sizeof(std::byte) * textureSize * 6));
-		defer { free(data); };
+		outputWrapX = gem::TextureWrap::Clamp;
+		outputWrapY = gem::TextureWrap::Clamp;
 
 		// Strip out the dead space of the source texture, the final data is 6 textures in sequence.
-		auto copyFace = [&image, faceSize, elementCount](std::byte* dest, unsigned startX, unsigned startY)
-		{
-			for (unsigned y = startY; y < startY + faceSize; ++y)
-			{
-				for (unsigned x = startX; x < startX + faceSize; ++x)
-				{
-					unsigned index = (x + y * image.width) * elementCount;
-
-					memcpy(dest, image.data + index, elementCount);
-					dest += elementCount;
-				}
-			}
-		};
-
-		copyFace(data, faceSize * 2, faceSize);						// +X
-		copyFace(data + 1 * textureSize, 0, faceSize);				// -X
-		copyFace(data + 2 * textureSize, faceSize, 0);				// +Y
-		copyFace(data + 3 * textureSize, faceSize, faceSize * 2);	// -Y
-		copyFace(data + 4 * textureSize, faceSize, faceSize);		// +Z
-		copyFace(data + 5 * textureSize, faceSize * 3, faceSize);	// -Z
-
-		fwrite(data, sizeof(std::byte), textureSize * 6, textureFile);
+		const unsigned faceSize = image.width / 4;
+		faces.push_back(CropImage(sourceImage, faceSize * 2, faceSize, faceSize));		// +X
+		faces.push_back(CropImage(sourceImage, 0, faceSize, faceSize));					// -X
+		faces.push_back(CropImage(sourceImage, faceSize, 0, faceSize));					// +Y
+		faces.push_back(CropImage(sourceImage, faceSize, faceSize * 2, faceSize));		// -Y
+		faces.push_back(CropImage(sourceImage, faceSize, faceSize, faceSize));			// +Z
+		faces.push_back(CropImage(sourceImage, faceSize * 3, faceSize, faceSize));		// -Z
 	}
 	else
 	{
-		// Write header.
-		fwrite(&isCubemap,        sizeof(isCubemap),        1, textureFile);
-		fwrite(&image.width,      sizeof(image.width),      1, textureFile);
-		fwrite(&image.height,     sizeof(image.height),     1, textureFile);
-		fwrite(&image.format,     sizeof(image.format),     1, textureFile);
-		fwrite(&filter,           sizeof(filter),           1, textureFile);
-		fwrite(&wrapX,            sizeof(wrapX),            1, textureFile);
-		fwrite(&wrapY,            sizeof(wrapY),            1, textureFile);
-		fwrite(&anisotropicLevel, sizeof(anisotropicLevel), 1, textureFile);
-
-		// Write Data.
-		const unsigned textureSize = image.width * image.height * elementCount;
-		fwrite(image.data, sizeof(std::byte), textureSize, textureFile);
+		faces.push_back(sourceImage);
+	}
+
+	const int width  = static_cast<int>(faces[0].width);
+	const int height = static_cast<int>(faces[0].height);
+	const uint32_t numLevels = gem::CountMipLevels(width, height, filter);
+	const gem::TextureFormat format = (compression == gem::TextureCompression::None)
+		? image.format
+		: gem::ResolveCompressedFormat(compression, isSRGB);
+
+	// Mip levels are generated here rather than by the driver at load time.
+	std::vector<std::vector<gem::ImageRGBA8>> mipChains;
+	for (const gem::ImageRGBA8& face : faces)
+	{
+		mipChains.push_back(gem::GenerateMipChain(face, numLevels, mipFilter, isSRGB));
+	}
+
+	// Save file.
+	FILE* textureFile = fopen(outputFile.c_str(), "wb");
+	if (textureFile == nullptr)
+	{
+		gem::Error("Output file could not be created.");
+		return false;
+	}
+
+	// Write header.
+	fwrite(gem::Texture::FileTag.data(), sizeof(char), gem::Texture::FileTag.size(), textureFile);
+	fwrite(&gem::Texture::FileVersion, sizeof(gem::Texture::FileVersion), 1, textureFile);
+	fwrite(&isCubemap,        sizeof(isCubemap),        1, textureFile);
+	fwrite(&width,            sizeof(width),            1, textureFile);
+	fwrite(&height,           sizeof(height),           1, textureFile);
+	fwrite(&format,           sizeof(format),           1, textureFile);
+	fwrite(&filter,           sizeof(filter),           1, textureFile);
+	fwrite(&outputWrapX,      sizeof(outputWrapX),      1, textureFile);
+	fwrite(&outputWrapY,      sizeof(outputWrapY),      1, textureFile);
+	fwrite(&anisotropicLevel, sizeof(anisotropicLevel), 1, textureFile);
+	fwrite(&numLevels,        sizeof(numLevels),        1, textureFile);
+
+	// Write data. Levels are written from largest to smallest, each with all of its faces.
+	bool success = true;
+	for (unsigned level = 0; level < numLevels; ++level)
+	{
+		for (const auto& mipChain : mipChains)
+		{
+			success = success && WriteLevel(textureFile, mipChain[level], compression, elementCount);
+		}
 	}
 
 	auto result = fclose(textureFile);
-	if (result != 0)
+	if (!success || result != 0)
 	{
 		gem::Error("Failed to generate Texture Binary\nOutput file could not be saved.");
 		return false;
@@ -237,6 +326,12 @@ bool TextureEncoder::Upgrade(gem::ConfigTable& metadata, unsigned loadedVersion)
 		metadata.SetString("wrap_x", gem::FixEnumCasing(metadata.GetString("wrap_x"), gem::TextureWrap::Clamp));
 		metadata.SetString("wrap_y", gem::FixEnumCasing(metadata.GetString("wrap_y"), gem::TextureWrap::Clamp));
 		break;
+
+	case 3:
+		// Added offline mip generation and block compression.
+		metadata.SetString("mip_filter", gem::EnumToString(gem::MipFilter::Box));
+		metadata.SetString("compression", gem::EnumToString(gem::TextureCompression::None));
+		break;
 	}
 
 	return true;